@@ -1,11 +1,19 @@
 // AppDelegate.m - App lifecycle implementation
 #import "AppDelegate.h"
+#import "GameState.h"
+#import "SimProfile.h"
 
 @implementation AppDelegate
 
 - (void)windowWillClose:(NSNotification *)notification {
     CGAssociateMouseAndMouseCursorPosition(true);
     [NSCursor unhide];
+    [[GameState shared] finishReplay];
+
+    // Trace of the last frames, when built with FPS_PROFILE
+    const char *tracePath = getenv("FPS_TRACE");
+    if (tracePath) simProfileWriteChromeTrace(tracePath);
+
     [NSApp terminate:self];
 }
 
@@ -1,9 +1,9 @@
 // Collision.c - Collision detection implementation
-#import "Collision.h"
-#import <math.h>
+#include "Collision.h"
+#include <math.h>
 
-RayHitResult rayIntersectAABB(simd_float3 rayOrigin, simd_float3 rayDir,
-                              simd_float3 boxMin, simd_float3 boxMax) {
+RayHitResult rayIntersectAABB(SimVec3 rayOrigin, SimVec3 rayDir,
+                              SimVec3 boxMin, SimVec3 boxMax) {
     float tmin = -INFINITY, tmax = INFINITY;
     float rayO[3] = {rayOrigin.x, rayOrigin.y, rayOrigin.z};
     float rayD[3] = {rayDir.x, rayDir.y, rayDir.z};
@@ -17,6 +17,10 @@ RayHitResult rayIntersectAABB(simd_float3 rayOrigin, simd_float3 rayDir,
             if (t1 > t2) { float tmp = t1; t1 = t2; t2 = tmp; }
             if (t1 > tmin) tmin = t1;
             if (t2 < tmax) tmax = t2;
+        } else if (rayO[axis] < bMin[axis] || rayO[axis] > bMax[axis]) {
+            // Parallel to this slab and outside it
+            RayHitResult miss = {NO, 0};
+            return miss;
         }
     }
 
@@ -2,12 +2,18 @@
 #ifndef COLLISION_H
 #define COLLISION_H
 
-#import "GameTypes.h"
-#import "GameConfig.h"
+#include "SimTypes.h"
+#include "GameConfig.h"
+
+// Ray-AABB intersection result
+typedef struct {
+    BOOL hit;
+    float t;  // distance to hit
+} RayHitResult;
 
 // Ray-AABB intersection test
-RayHitResult rayIntersectAABB(simd_float3 rayOrigin, simd_float3 rayDir,
-                              simd_float3 boxMin, simd_float3 boxMax);
+RayHitResult rayIntersectAABB(SimVec3 rayOrigin, SimVec3 rayDir,
+                              SimVec3 boxMin, SimVec3 boxMax);
 
 // ============================================
 // Collision System Types
@@ -0,0 +1,446 @@
+// CollisionBVH.c - Bounding volume hierarchy broadphase implementation
+#include "CollisionBVH.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Number of buckets used when evaluating split candidates (binned SAH)
+#define BVH_SAH_BINS 12
+
+typedef struct {
+    float minX, minY, minZ;
+    float maxX, maxY, maxZ;
+    int count;
+} BVHBin;
+
+static float itemCentroid(const BVHItem *item, int axis) {
+    if (axis == 0) return (item->minX + item->maxX) * 0.5f;
+    if (axis == 1) return (item->minY + item->maxY) * 0.5f;
+    return (item->minZ + item->maxZ) * 0.5f;
+}
+
+static float boxArea(float minX, float minY, float minZ, float maxX, float maxY, float maxZ) {
+    float dx = maxX - minX;
+    float dy = maxY - minY;
+    float dz = maxZ - minZ;
+    return dx * dy + dy * dz + dz * dx;
+}
+
+static void binReset(BVHBin *bin) {
+    bin->minX = bin->minY = bin->minZ = INFINITY;
+    bin->maxX = bin->maxY = bin->maxZ = -INFINITY;
+    bin->count = 0;
+}
+
+static void binGrow(BVHBin *bin, const BVHItem *item) {
+    bin->minX = fminf(bin->minX, item->minX);
+    bin->minY = fminf(bin->minY, item->minY);
+    bin->minZ = fminf(bin->minZ, item->minZ);
+    bin->maxX = fmaxf(bin->maxX, item->maxX);
+    bin->maxY = fmaxf(bin->maxY, item->maxY);
+    bin->maxZ = fmaxf(bin->maxZ, item->maxZ);
+}
+
+static void binMerge(BVHBin *bin, const BVHBin *other) {
+    bin->minX = fminf(bin->minX, other->minX);
+    bin->minY = fminf(bin->minY, other->minY);
+    bin->minZ = fminf(bin->minZ, other->minZ);
+    bin->maxX = fmaxf(bin->maxX, other->maxX);
+    bin->maxY = fmaxf(bin->maxY, other->maxY);
+    bin->maxZ = fmaxf(bin->maxZ, other->maxZ);
+    bin->count += other->count;
+}
+
+static float binArea(const BVHBin *bin) {
+    if (bin->count == 0) return 0.0f;
+    return boxArea(bin->minX, bin->minY, bin->minZ, bin->maxX, bin->maxY, bin->maxZ);
+}
+
+static int binIndex(float centroid, float axisMin, float scale) {
+    int b = (int)((centroid - axisMin) * scale);
+    if (b < 0) b = 0;
+    if (b >= BVH_SAH_BINS) b = BVH_SAH_BINS - 1;
+    return b;
+}
+
+static void updateNodeBounds(CollisionBVH *bvh, BVHNode *node) {
+    node->minX = node->minY = node->minZ = INFINITY;
+    node->maxX = node->maxY = node->maxZ = -INFINITY;
+    node->flags = 0;
+
+    for (int i = 0; i < node->count; i++) {
+        const BVHItem *item = &bvh->itemBounds[bvh->items[node->leftFirst + i]];
+        node->minX = fminf(node->minX, item->minX);
+        node->minY = fminf(node->minY, item->minY);
+        node->minZ = fminf(node->minZ, item->minZ);
+        node->maxX = fmaxf(node->maxX, item->maxX);
+        node->maxY = fmaxf(node->maxY, item->maxY);
+        node->maxZ = fmaxf(node->maxZ, item->maxZ);
+        node->flags |= item->flags;
+    }
+}
+
+static void subdivide(CollisionBVH *bvh, int nodeIndex, int depth) {
+    BVHNode *node = &bvh->nodes[nodeIndex];
+    int first = node->leftFirst;
+    int count = node->count;
+
+    if (count <= BVH_MAX_LEAF_ITEMS || depth >= BVH_MAX_DEPTH - 1) return;
+
+    // Bounds of item centroids - split planes are chosen inside this range
+    float cMin[3] = {INFINITY, INFINITY, INFINITY};
+    float cMax[3] = {-INFINITY, -INFINITY, -INFINITY};
+    for (int i = 0; i < count; i++) {
+        const BVHItem *item = &bvh->itemBounds[bvh->items[first + i]];
+        for (int axis = 0; axis < 3; axis++) {
+            float c = itemCentroid(item, axis);
+            cMin[axis] = fminf(cMin[axis], c);
+            cMax[axis] = fmaxf(cMax[axis], c);
+        }
+    }
+
+    // Binned surface area heuristic - find the cheapest split across all three axes
+    int bestAxis = -1;
+    int bestSplit = 0;
+    float bestCost = INFINITY;
+
+    for (int axis = 0; axis < 3; axis++) {
+        float extent = cMax[axis] - cMin[axis];
+        if (extent < 1e-6f) continue;
+        float scale = BVH_SAH_BINS / extent;
+
+        BVHBin bins[BVH_SAH_BINS];
+        for (int b = 0; b < BVH_SAH_BINS; b++) binReset(&bins[b]);
+
+        for (int i = 0; i < count; i++) {
+            const BVHItem *item = &bvh->itemBounds[bvh->items[first + i]];
+            BVHBin *bin = &bins[binIndex(itemCentroid(item, axis), cMin[axis], scale)];
+            binGrow(bin, item);
+            bin->count++;
+        }
+
+        // Sweep from the left, then from the right, accumulating area and count
+        float leftArea[BVH_SAH_BINS - 1];
+        int leftCount[BVH_SAH_BINS - 1];
+        BVHBin acc;
+        binReset(&acc);
+        for (int s = 0; s < BVH_SAH_BINS - 1; s++) {
+            binMerge(&acc, &bins[s]);
+            leftArea[s] = binArea(&acc);
+            leftCount[s] = acc.count;
+        }
+
+        binReset(&acc);
+        for (int s = BVH_SAH_BINS - 2; s >= 0; s--) {
+            binMerge(&acc, &bins[s + 1]);
+            if (leftCount[s] == 0 || acc.count == 0) continue;
+            float cost = leftCount[s] * leftArea[s] + acc.count * binArea(&acc);
+            if (cost < bestCost) {
+                bestCost = cost;
+                bestAxis = axis;
+                bestSplit = s;
+            }
+        }
+    }
+
+    int mid = first + count / 2;
+    if (bestAxis >= 0) {
+        // Small nodes stay leaves when no split beats testing every item
+        float leafCost = count * boxArea(node->minX, node->minY, node->minZ,
+                                         node->maxX, node->maxY, node->maxZ);
+        if (bestCost >= leafCost && count <= BVH_MAX_LEAF_ITEMS * 4) return;
+
+        // Partition item indices in place around the chosen bin boundary
+        float scale = BVH_SAH_BINS / (cMax[bestAxis] - cMin[bestAxis]);
+        int i = first;
+        int j = first + count - 1;
+        while (i <= j) {
+            const BVHItem *item = &bvh->itemBounds[bvh->items[i]];
+            if (binIndex(itemCentroid(item, bestAxis), cMin[bestAxis], scale) <= bestSplit) {
+                i++;
+            } else {
+                int tmp = bvh->items[i];
+                bvh->items[i] = bvh->items[j];
+                bvh->items[j] = tmp;
+                j--;
+            }
+        }
+        if (i != first && i != first + count) mid = i;
+    }
+    // No usable split (all centroids coincide) - fall back to splitting the range in half
+
+    int leftIndex = bvh->nodeCount;
+    bvh->nodeCount += 2;
+
+    BVHNode *left = &bvh->nodes[leftIndex];
+    BVHNode *right = &bvh->nodes[leftIndex + 1];
+    left->leftFirst = first;
+    left->count = mid - first;
+    right->leftFirst = mid;
+    right->count = first + count - mid;
+    updateNodeBounds(bvh, left);
+    updateNodeBounds(bvh, right);
+
+    node->leftFirst = leftIndex;
+    node->count = 0;
+
+    subdivide(bvh, leftIndex, depth + 1);
+    subdivide(bvh, leftIndex + 1, depth + 1);
+}
+
+bool bvhBuild(CollisionBVH *bvh, const BVHItem *items, int count) {
+    // Empty tree until the build succeeds, so a failed build never exposes stale indices
+    bvh->itemCount = 0;
+    bvh->nodeCount = 0;
+
+    if (count > bvh->capacity) {
+        int newCapacity = bvh->capacity > 0 ? bvh->capacity : 64;
+        while (newCapacity < count) newCapacity *= 2;
+
+        BVHNode *nodes = realloc(bvh->nodes, sizeof(BVHNode) * (size_t)(2 * newCapacity - 1));
+        if (!nodes) return false;
+        bvh->nodes = nodes;
+
+        int *indices = realloc(bvh->items, sizeof(int) * (size_t)newCapacity);
+        if (!indices) return false;
+        bvh->items = indices;
+
+        BVHItem *bounds = realloc(bvh->itemBounds, sizeof(BVHItem) * (size_t)newCapacity);
+        if (!bounds) return false;
+        bvh->itemBounds = bounds;
+
+        bvh->capacity = newCapacity;
+    }
+
+    bvh->itemCount = count;
+    if (count == 0) return true;
+
+    memcpy(bvh->itemBounds, items, sizeof(BVHItem) * (size_t)count);
+    for (int i = 0; i < count; i++) {
+        bvh->items[i] = i;
+    }
+
+    BVHNode *root = &bvh->nodes[0];
+    root->leftFirst = 0;
+    root->count = count;
+    bvh->nodeCount = 1;
+    updateNodeBounds(bvh, root);
+    subdivide(bvh, 0, 0);
+
+    return true;
+}
+
+void bvhRefit(CollisionBVH *bvh, const BVHItem *items) {
+    if (bvh->nodeCount == 0) return;
+    memcpy(bvh->itemBounds, items, sizeof(BVHItem) * (size_t)bvh->itemCount);
+
+    // Children are always allocated after their parent, so a reverse sweep sees them first
+    for (int n = bvh->nodeCount - 1; n >= 0; n--) {
+        BVHNode *node = &bvh->nodes[n];
+        if (node->count > 0) {
+            updateNodeBounds(bvh, node);
+            continue;
+        }
+        const BVHNode *left = &bvh->nodes[node->leftFirst];
+        const BVHNode *right = &bvh->nodes[node->leftFirst + 1];
+        node->minX = fminf(left->minX, right->minX);
+        node->minY = fminf(left->minY, right->minY);
+        node->minZ = fminf(left->minZ, right->minZ);
+        node->maxX = fmaxf(left->maxX, right->maxX);
+        node->maxY = fmaxf(left->maxY, right->maxY);
+        node->maxZ = fmaxf(left->maxZ, right->maxZ);
+        node->flags = left->flags | right->flags;
+    }
+}
+
+void bvhFree(CollisionBVH *bvh) {
+    free(bvh->nodes);
+    free(bvh->items);
+    free(bvh->itemBounds);
+    memset(bvh, 0, sizeof(*bvh));
+}
+
+bool bvhValidate(const CollisionBVH *bvh) {
+    if (bvh->itemCount < 0 || bvh->nodeCount < 0) return false;
+    if (bvh->nodeCount == 0) return true;
+    if (bvh->nodeCount > 2 * bvh->itemCount - 1) return false;
+
+    for (int i = 0; i < bvh->itemCount; i++) {
+        if (bvh->items[i] < 0 || bvh->items[i] >= bvh->itemCount) return false;
+    }
+
+    // Children after their parent (what bvhRefit relies on), leaves inside the item range
+    for (int n = 0; n < bvh->nodeCount; n++) {
+        const BVHNode *node = &bvh->nodes[n];
+        if (node->count > 0) {
+            if (node->leftFirst < 0 || node->leftFirst > bvh->itemCount - node->count) return false;
+        } else if (node->count < 0 || node->leftFirst <= n || node->leftFirst >= bvh->nodeCount - 1) {
+            return false;
+        }
+    }
+
+    // Every node reached exactly once from the root, no deeper than the query stacks allow
+    int stackNode[BVH_MAX_DEPTH + 1];
+    int stackDepth[BVH_MAX_DEPTH + 1];
+    int sp = 0;
+    int visited = 0;
+    stackNode[sp] = 0;
+    stackDepth[sp++] = 0;
+
+    while (sp > 0) {
+        sp--;
+        const BVHNode *node = &bvh->nodes[stackNode[sp]];
+        int depth = stackDepth[sp];
+        if (++visited > bvh->nodeCount) return false;
+        if (node->count > 0) continue;
+        if (depth + 1 >= BVH_MAX_DEPTH) return false;
+
+        stackNode[sp] = node->leftFirst + 1;
+        stackDepth[sp++] = depth + 1;
+        stackNode[sp] = node->leftFirst;
+        stackDepth[sp++] = depth + 1;
+    }
+    return visited == bvh->nodeCount;
+}
+
+// ============================================
+// QUERIES
+// ============================================
+
+int bvhQueryAABB(const CollisionBVH *bvh,
+                 float minX, float minY, float minZ,
+                 float maxX, float maxY, float maxZ,
+                 unsigned int flagMask, int *outItems, int maxOut) {
+    if (bvh->nodeCount == 0) return 0;
+
+    int stack[BVH_MAX_DEPTH + 1];
+    int sp = 0;
+    int found = 0;
+    stack[sp++] = 0;
+
+    while (sp > 0) {
+        const BVHNode *node = &bvh->nodes[stack[--sp]];
+        if (!(node->flags & flagMask)) continue;
+        if (node->minX > maxX || node->maxX < minX) continue;
+        if (node->minY > maxY || node->maxY < minY) continue;
+        if (node->minZ > maxZ || node->maxZ < minZ) continue;
+
+        if (node->count > 0) {
+            for (int i = 0; i < node->count; i++) {
+                int item = bvh->items[node->leftFirst + i];
+                const BVHItem *b = &bvh->itemBounds[item];
+                if (!(b->flags & flagMask)) continue;
+                if (b->minX > maxX || b->maxX < minX) continue;
+                if (b->minY > maxY || b->maxY < minY) continue;
+                if (b->minZ > maxZ || b->maxZ < minZ) continue;
+                if (found < maxOut) outItems[found] = item;
+                found++;
+            }
+        } else {
+            stack[sp++] = node->leftFirst;
+            stack[sp++] = node->leftFirst + 1;
+        }
+    }
+
+    return found;
+}
+
+// Slab test against a node - returns entry distance (negative when starting inside),
+// or INFINITY on a miss. Mirrors the per-shape slab test so pruning stays conservative.
+static float rayNodeEntry(const BVHNode *node,
+                          float ox, float oy, float oz,
+                          float dx, float dy, float dz) {
+    float tmin = -INFINITY, tmax = INFINITY;
+
+    if (fabsf(dx) > 0.0001f) {
+        float t1 = (node->minX - ox) / dx;
+        float t2 = (node->maxX - ox) / dx;
+        if (t1 > t2) { float tmp = t1; t1 = t2; t2 = tmp; }
+        tmin = fmaxf(tmin, t1);
+        tmax = fminf(tmax, t2);
+    } else if (ox < node->minX || ox > node->maxX) {
+        return INFINITY;
+    }
+
+    if (fabsf(dy) > 0.0001f) {
+        float t1 = (node->minY - oy) / dy;
+        float t2 = (node->maxY - oy) / dy;
+        if (t1 > t2) { float tmp = t1; t1 = t2; t2 = tmp; }
+        tmin = fmaxf(tmin, t1);
+        tmax = fminf(tmax, t2);
+    } else if (oy < node->minY || oy > node->maxY) {
+        return INFINITY;
+    }
+
+    if (fabsf(dz) > 0.0001f) {
+        float t1 = (node->minZ - oz) / dz;
+        float t2 = (node->maxZ - oz) / dz;
+        if (t1 > t2) { float tmp = t1; t1 = t2; t2 = tmp; }
+        tmin = fmaxf(tmin, t1);
+        tmax = fminf(tmax, t2);
+    } else if (oz < node->minZ || oz > node->maxZ) {
+        return INFINITY;
+    }
+
+    if (tmin > tmax || tmax <= 0) return INFINITY;
+    return tmin;
+}
+
+float bvhRaycast(const CollisionBVH *bvh,
+                 float ox, float oy, float oz,
+                 float dx, float dy, float dz,
+                 float maxT, unsigned int flagMask,
+                 BVHRayLeafFn leafFn, void *context) {
+    float closestT = maxT;
+    if (bvh->nodeCount == 0) return closestT;
+
+    int stackNode[BVH_MAX_DEPTH + 1];
+    float stackT[BVH_MAX_DEPTH + 1];
+    int sp = 0;
+
+    float rootT = rayNodeEntry(&bvh->nodes[0], ox, oy, oz, dx, dy, dz);
+    if (rootT > closestT) return closestT;
+    stackNode[sp] = 0;
+    stackT[sp] = rootT;
+    sp++;
+
+    while (sp > 0) {
+        sp--;
+        // Closest hit may have shrunk since this node was pushed
+        if (stackT[sp] > closestT) continue;
+        const BVHNode *node = &bvh->nodes[stackNode[sp]];
+        if (!(node->flags & flagMask)) continue;
+
+        if (node->count > 0) {
+            for (int i = 0; i < node->count; i++) {
+                int item = bvh->items[node->leftFirst + i];
+                if (!(bvh->itemBounds[item].flags & flagMask)) continue;
+                closestT = leafFn(context, item, closestT);
+            }
+            continue;
+        }
+
+        int nearIndex = node->leftFirst;
+        int farIndex = node->leftFirst + 1;
+        float nearT = rayNodeEntry(&bvh->nodes[nearIndex], ox, oy, oz, dx, dy, dz);
+        float farT = rayNodeEntry(&bvh->nodes[farIndex], ox, oy, oz, dx, dy, dz);
+        if (farT < nearT) {
+            int ti = nearIndex; nearIndex = farIndex; farIndex = ti;
+            float tt = nearT; nearT = farT; farT = tt;
+        }
+
+        // Push far child first so the near child is visited first
+        if (farT <= closestT) {
+            stackNode[sp] = farIndex;
+            stackT[sp] = farT;
+            sp++;
+        }
+        if (nearT <= closestT) {
+            stackNode[sp] = nearIndex;
+            stackT[sp] = nearT;
+            sp++;
+        }
+    }
+
+    return closestT;
+}
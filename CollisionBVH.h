@@ -0,0 +1,81 @@
+// CollisionBVH.h - Bounding volume hierarchy broadphase for collision queries
+#ifndef COLLISIONBVH_H
+#define COLLISIONBVH_H
+
+#include <stdbool.h>
+
+// Max items stored in a single leaf before the builder tries to split it
+#define BVH_MAX_LEAF_ITEMS 2
+
+// Max tree depth - deeper ranges are kept as one leaf so traversal stacks stay fixed-size
+#define BVH_MAX_DEPTH 48
+
+// ============================================
+// BVH TYPES
+// ============================================
+
+// Item to insert into the tree - bounds plus query flags
+typedef struct {
+    float minX, minY, minZ;
+    float maxX, maxY, maxZ;
+    unsigned int flags;         // Caller-defined bits, used to skip whole subtrees
+} BVHItem;
+
+// Flattened tree node - children of an internal node are stored adjacent
+typedef struct {
+    float minX, minY, minZ;
+    float maxX, maxY, maxZ;
+    int leftFirst;              // Internal: index of left child (right = left + 1). Leaf: first item slot
+    int count;                  // Number of items in leaf (0 = internal node)
+    unsigned int flags;         // OR of all item flags in this subtree
+} BVHNode;
+
+typedef struct {
+    BVHNode *nodes;
+    int nodeCount;
+    int *items;                 // Item indices, ordered so each leaf owns a contiguous range
+    BVHItem *itemBounds;        // Copy of the build input, indexed by item index
+    int itemCount;
+    int capacity;               // Items the arrays are sized for
+} CollisionBVH;
+
+// Leaf callback for raycasts - tests one item and returns the new closest hit distance
+// (or closestT unchanged on a miss)
+typedef float (*BVHRayLeafFn)(void *context, int item, float closestT);
+
+// ============================================
+// BVH FUNCTIONS
+// ============================================
+
+// Build the tree over items[0..count). Reuses existing allocations when large enough.
+// Returns false if memory could not be allocated.
+bool bvhBuild(CollisionBVH *bvh, const BVHItem *items, int count);
+
+// Update item bounds in place and refit every node, keeping the tree topology.
+// items must be in the same order and count as the last build. Cheap enough to run
+// per tick for moving items; quality degrades if items travel far from where they were built.
+void bvhRefit(CollisionBVH *bvh, const BVHItem *items);
+
+// Release all memory held by the tree
+void bvhFree(CollisionBVH *bvh);
+
+// Check that every node and item index stays in range and the tree fits the traversal
+// stacks. For trees not made by bvhBuild (e.g. read back from a file).
+bool bvhValidate(const CollisionBVH *bvh);
+
+// Collect indices of items whose bounds overlap the query box and share a flag with flagMask.
+// Writes at most maxOut indices, returns the total number found.
+int bvhQueryAABB(const CollisionBVH *bvh,
+                 float minX, float minY, float minZ,
+                 float maxX, float maxY, float maxZ,
+                 unsigned int flagMask, int *outItems, int maxOut);
+
+// Walk the tree front-to-back along a ray (t is measured in units of dir).
+// Subtrees entered beyond the current closest hit are skipped. Returns the final closest t.
+float bvhRaycast(const CollisionBVH *bvh,
+                 float ox, float oy, float oz,
+                 float dx, float dy, float dz,
+                 float maxT, unsigned int flagMask,
+                 BVHRayLeafFn leafFn, void *context);
+
+#endif // COLLISIONBVH_H
@@ -0,0 +1,165 @@
+// CollisionCache.c - Versioned binary cache file implementation
+#include "CollisionCache.h"
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static uint64_t alignUp(uint64_t value) {
+    return (value + CACHE_SECTION_ALIGN - 1) & ~(uint64_t)(CACHE_SECTION_ALIGN - 1);
+}
+
+uint64_t cacheHash(const void *data, size_t size, uint64_t seed) {
+    const unsigned char *bytes = data;
+    uint64_t hash = seed;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+// ============================================
+// WRITING
+// ============================================
+
+static bool writePadding(FILE *file, uint64_t from, uint64_t to) {
+    static const unsigned char zeros[CACHE_SECTION_ALIGN] = {0};
+    while (from < to) {
+        size_t chunk = (size_t)(to - from);
+        if (chunk > sizeof(zeros)) chunk = sizeof(zeros);
+        if (fwrite(zeros, 1, chunk, file) != chunk) return false;
+        from += chunk;
+    }
+    return true;
+}
+
+bool cacheWrite(const char *path, uint32_t version, uint64_t contentKey,
+                const CacheSectionData *sections, int sectionCount) {
+    if (sectionCount < 0 || sectionCount > CACHE_MAX_SECTIONS) return false;
+
+    // Lay out the sections after the header
+    CacheHeader header;
+    memset(&header, 0, sizeof(header));
+    header.magic = CACHE_MAGIC;
+    header.version = version;
+    header.endianTag = CACHE_ENDIAN_TAG;
+    header.sectionCount = (uint32_t)sectionCount;
+    header.contentKey = contentKey;
+
+    uint64_t offset = alignUp(sizeof(CacheHeader));
+    for (int i = 0; i < sectionCount; i++) {
+        header.sections[i].tag = sections[i].tag;
+        header.sections[i].elemSize = sections[i].elemSize;
+        header.sections[i].offset = offset;
+        header.sections[i].count = sections[i].count;
+        offset = alignUp(offset + sections[i].count * sections[i].elemSize);
+    }
+    header.fileSize = offset;
+
+    char tmpPath[1024];
+    int n = snprintf(tmpPath, sizeof(tmpPath), "%s.tmp.%d", path, (int)getpid());
+    if (n < 0 || n >= (int)sizeof(tmpPath)) return false;
+
+    // Owner-only, and never through a file or link that is already there
+    int fd = open(tmpPath, O_WRONLY | O_CREAT | O_EXCL, 0600);
+    if (fd < 0) return false;
+    FILE *file = fdopen(fd, "wb");
+    if (!file) {
+        close(fd);
+        unlink(tmpPath);
+        return false;
+    }
+
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1;
+    uint64_t written = sizeof(header);
+    for (int i = 0; ok && i < sectionCount; i++) {
+        ok = writePadding(file, written, header.sections[i].offset);
+        written = header.sections[i].offset;
+
+        size_t bytes = (size_t)(sections[i].count * sections[i].elemSize);
+        if (ok && bytes > 0) ok = fwrite(sections[i].data, 1, bytes, file) == bytes;
+        written += bytes;
+    }
+    if (ok) ok = writePadding(file, written, header.fileSize);
+
+    if (fclose(file) != 0) ok = false;
+    if (ok) ok = rename(tmpPath, path) == 0;
+    if (!ok) unlink(tmpPath);
+    return ok;
+}
+
+// ============================================
+// LOADING
+// ============================================
+
+static bool headerValid(const CacheHeader *header, size_t fileSize, uint32_t version, uint64_t contentKey) {
+    if (header->magic != CACHE_MAGIC) return false;
+    if (header->endianTag != CACHE_ENDIAN_TAG) return false;
+    if (header->version != version) return false;
+    if (header->contentKey != contentKey) return false;
+    if (header->fileSize != fileSize) return false;
+    if (header->sectionCount > CACHE_MAX_SECTIONS) return false;
+
+    for (uint32_t i = 0; i < header->sectionCount; i++) {
+        const CacheSection *section = &header->sections[i];
+        if (section->offset % CACHE_SECTION_ALIGN != 0) return false;
+        if (section->offset < sizeof(CacheHeader) || section->offset > fileSize) return false;
+        if (section->elemSize > 0 && section->count > (fileSize - section->offset) / section->elemSize) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool cacheOpen(CollisionCache *cache, const char *path, uint32_t version, uint64_t contentKey) {
+    memset(cache, 0, sizeof(*cache));
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return false;
+
+    // Only map a regular file of ours that nobody else can rewrite under us
+    struct stat st;
+    if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_uid != geteuid() ||
+        (st.st_mode & (S_IWGRP | S_IWOTH)) != 0 || st.st_size < (off_t)sizeof(CacheHeader)) {
+        close(fd);
+        return false;
+    }
+
+    // Private writable mapping - pages stay shared with other processes until written
+    size_t size = (size_t)st.st_size;
+    void *base = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) return false;
+
+    if (!headerValid(base, size, version, contentKey)) {
+        munmap(base, size);
+        return false;
+    }
+
+    cache->base = base;
+    cache->size = size;
+    cache->header = base;
+    return true;
+}
+
+void *cacheSection(const CollisionCache *cache, uint32_t tag, uint32_t elemSize, uint64_t *outCount) {
+    if (!cache->header) return NULL;
+
+    for (uint32_t i = 0; i < cache->header->sectionCount; i++) {
+        const CacheSection *section = &cache->header->sections[i];
+        if (section->tag != tag) continue;
+        if (section->elemSize != elemSize) return NULL;
+        if (outCount) *outCount = section->count;
+        return (char *)cache->base + section->offset;
+    }
+    return NULL;
+}
+
+void cacheClose(CollisionCache *cache) {
+    if (cache->base) munmap(cache->base, cache->size);
+    memset(cache, 0, sizeof(*cache));
+}
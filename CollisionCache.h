@@ -0,0 +1,90 @@
+// CollisionCache.h - Versioned binary cache file for baked collision data, loaded with mmap
+#ifndef COLLISIONCACHE_H
+#define COLLISIONCACHE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// 'FPCC' - first four bytes of every cache file
+#define CACHE_MAGIC 0x43435046u
+
+// Written as-is; reads back differently on a machine with the other byte order
+#define CACHE_ENDIAN_TAG 0x01020304u
+
+#define CACHE_MAX_SECTIONS 16
+
+// Section data starts on this boundary (covers simd_float4 and cache lines)
+#define CACHE_SECTION_ALIGN 64
+
+// Four-character section tag, e.g. CACHE_TAG('S','H','A','P')
+#define CACHE_TAG(a, b, c, d) \
+    ((uint32_t)(a) | ((uint32_t)(b) << 8) | ((uint32_t)(c) << 16) | ((uint32_t)(d) << 24))
+
+// ============================================
+// CACHE FILE LAYOUT
+// ============================================
+
+// Section table entry - a flat array of count elements of elemSize bytes
+typedef struct {
+    uint32_t tag;
+    uint32_t elemSize;          // Checked on load so a struct layout change reads as a miss
+    uint64_t offset;            // From the start of the file, CACHE_SECTION_ALIGN aligned
+    uint64_t count;
+} CacheSection;
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;           // Format/content version chosen by the caller
+    uint32_t endianTag;
+    uint32_t sectionCount;
+    uint64_t contentKey;        // Caller hash of the build inputs - a mismatch means stale
+    uint64_t fileSize;
+    CacheSection sections[CACHE_MAX_SECTIONS];
+} CacheHeader;
+
+// ============================================
+// CACHE TYPES
+// ============================================
+
+// Section to write
+typedef struct {
+    uint32_t tag;
+    uint32_t elemSize;
+    const void *data;
+    uint64_t count;
+} CacheSectionData;
+
+// Open cache - the whole file mapped copy-on-write. Section pointers stay valid until close.
+typedef struct {
+    void *base;
+    size_t size;
+    const CacheHeader *header;
+} CollisionCache;
+
+// ============================================
+// CACHE FUNCTIONS
+// ============================================
+
+// Hash bytes into a content key (FNV-1a). Chain calls by passing the previous key as seed.
+uint64_t cacheHash(const void *data, size_t size, uint64_t seed);
+#define CACHE_HASH_SEED 0xcbf29ce484222325ull
+
+// Write sections to path. Goes through a temporary file and a rename, so readers
+// never map a half-written cache. Returns false on any I/O error.
+bool cacheWrite(const char *path, uint32_t version, uint64_t contentKey,
+                const CacheSectionData *sections, int sectionCount);
+
+// Map path and check owner, magic, byte order, version, key and section bounds. Only the
+// layout is checked - indices inside the sections are the caller's to validate.
+// Returns false (cache left closed) if the file is missing, not ours, stale or malformed.
+bool cacheOpen(CollisionCache *cache, const char *path, uint32_t version, uint64_t contentKey);
+
+// Section data, or NULL if the tag is missing or its element size differs.
+// outCount receives the element count.
+void *cacheSection(const CollisionCache *cache, uint32_t tag, uint32_t elemSize, uint64_t *outCount);
+
+// Unmap the file
+void cacheClose(CollisionCache *cache);
+
+#endif // COLLISIONCACHE_H
@@ -1,99 +1,26 @@
-// CollisionWorld.h - Abstract collision detection system
+// CollisionWorld.h - App-wide collision world (Objective-C front end for SimCollision)
 #ifndef COLLISIONWORLD_H
 #define COLLISIONWORLD_H
 
 #import <Foundation/Foundation.h>
 #import <simd/simd.h>
 #import "GameConfig.h"
+#import "SimCollision.h"
+#import "SimJobs.h"
 
-// ============================================
-// COLLISION SHAPE TYPES
-// ============================================
-
-typedef enum {
-    CollisionShapeTypeWall,         // Solid wall - blocks movement
-    CollisionShapeTypePlatform,     // Can stand on top, blocks from sides
-    CollisionShapeTypeRamp,         // Sloped surface
-    CollisionShapeTypeFloor,        // Ground level surface
-    CollisionShapeTypeTrigger,      // Non-solid, triggers events
-} CollisionShapeType;
-
-typedef enum {
-    CollisionLayerWorld     = 1 << 0,   // Static world geometry
-    CollisionLayerPlayer    = 1 << 1,   // Player collision
-    CollisionLayerEnemy     = 1 << 2,   // Enemy collision
-    CollisionLayerProjectile = 1 << 3,  // Bullets/rockets
-    CollisionLayerPickup    = 1 << 4,   // Pickups
-    CollisionLayerAll       = 0xFFFF
-} CollisionLayer;
-
-// ============================================
-// COLLISION SHAPE STRUCTURE
-// ============================================
-
-typedef struct {
-    // Bounds (axis-aligned bounding box)
-    float minX, minY, minZ;
-    float maxX, maxY, maxZ;
-
-    // Shape properties
-    CollisionShapeType type;
-    CollisionLayer layer;
-
-    // Surface properties
-    BOOL isWalkable;            // Can player stand on top
-    BOOL blocksMovement;        // Blocks horizontal movement
-    BOOL blocksProjectiles;     // Blocks raycast shots
-
-    // Ramp-specific properties
-    BOOL isRamp;
-    float rampStartY;           // Y at ramp start
-    float rampEndY;             // Y at ramp end
-    int rampAxis;               // 0=X, 2=Z - which axis the ramp slopes along
-    float rampDirection;        // 1.0 or -1.0 for slope direction
-
-    // Identification
-    int shapeId;                // Unique ID for this shape
-    const char *debugName;      // For debugging
-} CollisionShape;
-
-// ============================================
-// COLLISION RESULTS
-// ============================================
-
-typedef struct {
-    BOOL hit;
-    float distance;             // Distance to hit point
-    simd_float3 hitPoint;       // World position of hit
-    simd_float3 hitNormal;      // Surface normal at hit
-    int shapeId;                // ID of shape that was hit
-    CollisionShapeType shapeType;
-} RaycastResult;
-
-typedef struct {
-    BOOL onGround;
-    float groundY;              // Y position of ground surface
-    BOOL onRamp;                // Standing on a ramp
-    int groundShapeId;          // ID of ground shape
-} GroundResult;
-
-typedef struct {
-    BOOL collided;
-    simd_float3 pushOut;        // Vector to push player out of collision
-    simd_float3 newVelocity;    // Adjusted velocity after collision
-    int hitShapeId;             // ID of shape collided with
-} MoveResult;
-
-// ============================================
-// COLLISION WORLD SINGLETON
-// ============================================
-
-#define MAX_COLLISION_SHAPES 256
+// Shape types, results and the world itself live in the portable SimCollision.
+// This wraps the process-wide world for the app, with simd vectors and the app's job system.
 
 @interface CollisionWorld : NSObject
 
 + (instancetype)shared;
 
+// The underlying world - what the simulation runs against
+@property (nonatomic, readonly) SimCollision *simCollision;
+
+// The app's worker threads - the simulation runs its per-tick jobs on them too
+@property (nonatomic, readonly) SimJobSystem *jobSystem;
+
 // Shape management
 - (int)addBoxWithMinX:(float)minX minY:(float)minY minZ:(float)minZ
                  maxX:(float)maxX maxY:(float)maxY maxZ:(float)maxZ
@@ -112,12 +39,33 @@ typedef struct {
                       topY:(float)topY thickness:(float)thickness
                       name:(const char *)name;
 
+// Dynamic shapes - moved every tick (doors, moving platforms). Kept apart from the
+// static set: moving one only refits its bounds, and they are seen by every query.
+// They are not baked into the ground height field.
+- (int)addDynamicBoxWithMinX:(float)minX minY:(float)minY minZ:(float)minZ
+                        maxX:(float)maxX maxY:(float)maxY maxZ:(float)maxZ
+                        type:(CollisionShapeType)type
+                    walkable:(BOOL)walkable
+                        name:(const char *)name;
+
+// Set new bounds for a dynamic shape. Returns NO if shapeId isn't a live dynamic shape.
+- (BOOL)moveDynamicShape:(int)shapeId
+                    minX:(float)minX minY:(float)minY minZ:(float)minZ
+                    maxX:(float)maxX maxY:(float)maxY maxZ:(float)maxZ;
+
 - (void)removeShape:(int)shapeId;
 - (void)clearAllShapes;
 
+// Rebuild the query BVHs now (otherwise done lazily on the next query).
+// Call after editing a shape returned by getShape: in place.
+- (void)rebuildBroadphase;
+
 // Shape queries
+// O(1) handle lookup - NULL if the shape was removed. The pointer is only
+// valid until the next add/remove, since storage may grow or compact.
 - (CollisionShape *)getShape:(int)shapeId;
-- (int)getShapeCount;
+- (int)getShapeCount;           // Static plus dynamic
+- (int)getDynamicShapeCount;
 
 // Collision detection
 - (RaycastResult)raycastFrom:(simd_float3)origin
@@ -125,6 +73,15 @@ typedef struct {
                    maxDistance:(float)maxDistance
                    layerMask:(CollisionLayer)layerMask;
 
+// Batched raycast - tests all rays against the static shape table 4 shapes at a time (SIMD),
+// then against the dynamic shapes. results[i] matches raycastFrom: for origins[i] / directions[i].
+- (void)raycastBatch:(const simd_float3 *)origins
+          directions:(const simd_float3 *)directions
+               count:(int)count
+         maxDistance:(float)maxDistance
+           layerMask:(CollisionLayer)layerMask
+             results:(RaycastResult *)results;
+
 - (GroundResult)checkGroundAt:(float)x y:(float)y z:(float)z
                    playerRadius:(float)radius
                    playerHeight:(float)height;
@@ -134,9 +91,51 @@ typedef struct {
                    radius:(float)radius
                    height:(float)height;
 
+// Swept move-and-slide: moves the player box by velocity (one tick of displacement),
+// stopping at the first blocking shape and sliding along it. Catches thin shapes
+// that a fast move would otherwise skip over. Uses the same box as movePlayerFrom.
+- (SweepMoveResult)sweepPlayerFrom:(simd_float3)position
+                          velocity:(simd_float3)velocity
+                            radius:(float)radius
+                            height:(float)height;
+
+// Batched kinematics for many bodies (bots, players) in one call. Each body runs
+// sweepPlayerFrom:, then checkGroundAt: and a snap onto the ground, then movePlayerFrom:
+// push-out. Large batches are split into chunks across cores.
+- (void)resolveKinematicsBatch:(const simd_float3 *)positions
+                    velocities:(const simd_float3 *)velocities
+                         radii:(const float *)radii
+                       heights:(const float *)heights
+                         count:(int)count
+                       results:(KinematicResult *)results;
+
+// Line of sight against world geometry (layer World, projectile blockers), dynamic shapes
+// included - traced through the BVH.
+- (BOOL)hasLineOfSightFrom:(simd_float3)from to:(simd_float3)to;
+
+// Bake the walkable grid bots find their paths on. Shape changes invalidate it (bots
+// steer straight at their goals) until this is called again.
+- (void)buildNavGrid;
+
+// Bake the cover points bots take cover at, from the shapes and the nav grid. Shape changes
+// invalidate them (bots find no cover) until this is called again.
+- (void)buildCoverPoints;
+
 // World initialization
 - (void)buildMilitaryBaseCollision;
 
+// Baked cache - static shapes plus their BVH, ground height field, nav grid and cover
+// points in one versioned file. init maps it when current, otherwise builds the base and writes it.
+// Path comes from FPS_COLLISION_CACHE, or a file in the per-user cache directory (nil if
+// there is none we own).
++ (NSString *)defaultBakedCachePath;
+- (BOOL)writeBakedCacheToPath:(NSString *)path;
+
+// Replace every shape with the baked set, mapped in place (nothing is parsed or copied).
+// Returns NO if the file is missing, from another version or malformed. Handles from
+// before the load must not be used. The mapping is copied out on the first static change.
+- (BOOL)loadBakedCacheFromPath:(NSString *)path;
+
 @end
 
 #endif // COLLISIONWORLD_H
@@ -0,0 +1,102 @@
+// CoverMap.c - Baked cover points with a uniform grid index implementation
+#include "CoverMap.h"
+#include <limits.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+static int clampIndex(int i, int size) {
+    if (i < 0) return 0;
+    if (i >= size) return size - 1;
+    return i;
+}
+
+static int cellOf(const CoverMap *map, float x, float z) {
+    int cx = clampIndex((int)floorf((x - map->minX) / map->cellSize), map->sizeX);
+    int cz = clampIndex((int)floorf((z - map->minZ) / map->cellSize), map->sizeZ);
+    return cz * map->sizeX + cx;
+}
+
+bool coverMapBuild(CoverMap *map, float minX, float minZ, float maxX, float maxZ, float cellSize,
+                   const CoverPoint *points, int count) {
+    memset(map, 0, sizeof(*map));
+    if (cellSize <= 0 || count < 0) return false;
+
+    map->minX = minX;
+    map->minZ = minZ;
+    map->cellSize = cellSize;
+    map->sizeX = (int)ceilf((maxX - minX) / cellSize);
+    map->sizeZ = (int)ceilf((maxZ - minZ) / cellSize);
+    if (map->sizeX <= 0 || map->sizeZ <= 0) return false;
+
+    map->cellCount = map->sizeX * map->sizeZ;
+    map->pointCount = count;
+    map->points = malloc(sizeof(CoverPoint) * (size_t)(count > 0 ? count : 1));
+    map->cellStart = calloc((size_t)map->cellCount + 1, sizeof(int));
+    if (!map->points || !map->cellStart) {
+        coverMapFree(map);
+        return false;
+    }
+
+    // Counting sort by cell - count, prefix sum, then place (stable, so input order is kept)
+    for (int i = 0; i < count; i++) {
+        map->cellStart[cellOf(map, points[i].x, points[i].z) + 1]++;
+    }
+    for (int c = 0; c < map->cellCount; c++) {
+        map->cellStart[c + 1] += map->cellStart[c];
+    }
+    int *next = malloc(sizeof(int) * (size_t)map->cellCount);
+    if (!next) {
+        coverMapFree(map);
+        return false;
+    }
+    memcpy(next, map->cellStart, sizeof(int) * (size_t)map->cellCount);
+    for (int i = 0; i < count; i++) {
+        map->points[next[cellOf(map, points[i].x, points[i].z)]++] = points[i];
+    }
+    free(next);
+    return true;
+}
+
+void coverMapFree(CoverMap *map) {
+    free(map->points);
+    free(map->cellStart);
+    memset(map, 0, sizeof(*map));
+}
+
+bool coverMapValidate(const CoverMap *map) {
+    if (!(map->cellSize > 0) || !isfinite(map->minX) || !isfinite(map->minZ)) return false;
+    if (map->sizeX <= 0 || map->sizeZ <= 0 || map->sizeX > (INT_MAX - 1) / map->sizeZ) return false;
+    if (map->cellCount != map->sizeX * map->sizeZ || map->pointCount < 0) return false;
+
+    if (map->cellStart[0] != 0 || map->cellStart[map->cellCount] != map->pointCount) return false;
+    for (int c = 0; c < map->cellCount; c++) {
+        if (map->cellStart[c + 1] < map->cellStart[c]) return false;
+    }
+    return true;
+}
+
+int coverMapQuery(const CoverMap *map, float x, float z, float radius, int *outIndices, int maxIndices) {
+    if (map->pointCount == 0) return 0;
+
+    int x0 = clampIndex((int)floorf((x - radius - map->minX) / map->cellSize), map->sizeX);
+    int x1 = clampIndex((int)floorf((x + radius - map->minX) / map->cellSize), map->sizeX);
+    int z0 = clampIndex((int)floorf((z - radius - map->minZ) / map->cellSize), map->sizeZ);
+    int z1 = clampIndex((int)floorf((z + radius - map->minZ) / map->cellSize), map->sizeZ);
+
+    // Rows of cells are contiguous runs of points, so each row is one range to scan
+    int found = 0;
+    float radiusSq = radius * radius;
+    for (int cz = z0; cz <= z1; cz++) {
+        int begin = map->cellStart[cz * map->sizeX + x0];
+        int end = map->cellStart[cz * map->sizeX + x1 + 1];
+        for (int i = begin; i < end; i++) {
+            float dx = map->points[i].x - x;
+            float dz = map->points[i].z - z;
+            if (dx * dx + dz * dz > radiusSq) continue;
+            if (found < maxIndices) outIndices[found] = i;
+            found++;
+        }
+    }
+    return found;
+}
@@ -0,0 +1,51 @@
+// CoverMap.h - Baked cover points with a uniform grid index for nearby-cover queries
+#ifndef COVERMAP_H
+#define COVERMAP_H
+
+#include <stdbool.h>
+
+// ============================================
+// COVER MAP TYPES
+// ============================================
+
+// A spot next to something that blocks shots
+typedef struct {
+    float x, y, z;              // Feet position
+    float normalX, normalZ;     // Unit XZ direction from the spot into the blocker
+    float height;               // Blocker height above the feet
+    float exposure;             // Fraction of sampled sight lines that reach the spot (0 = hidden)
+} CoverPoint;
+
+// Points sorted by the XZ grid cell they fall in. The points of cell c are
+// points[cellStart[c]] up to (not including) points[cellStart[c + 1]].
+typedef struct {
+    float minX, minZ;
+    float cellSize;
+    int sizeX, sizeZ;
+    int cellCount;
+    int pointCount;
+    CoverPoint *points;
+    int *cellStart;             // cellCount + 1 entries
+} CoverMap;
+
+// ============================================
+// COVER MAP FUNCTIONS
+// ============================================
+
+// Index a copy of points over [minX,maxX] x [minZ,maxZ] (points outside go to the edge
+// cells). Points keep their relative order within a cell. Returns false on bad size or no memory.
+bool coverMapBuild(CoverMap *map, float minX, float minZ, float maxX, float maxZ, float cellSize,
+                   const CoverPoint *points, int count);
+
+// Release all memory held by the map
+void coverMapFree(CoverMap *map);
+
+// Check the size and that the cell ranges run in order from 0 to pointCount.
+// For maps not made by coverMapBuild (e.g. read back from a file).
+bool coverMapValidate(const CoverMap *map);
+
+// Points within radius of (x, z) in XZ, in index order. Writes up to maxIndices to
+// outIndices; returns the total found (may be more than maxIndices).
+int coverMapQuery(const CoverMap *map, float x, float z, float radius, int *outIndices, int maxIndices);
+
+#endif // COVERMAP_H
@@ -6,13 +6,9 @@
 #import "GameConfig.h"
 #import "GameState.h"
 
+// Animation, collision and proximity live in the portable SimDoor and run in simStep
+
 // Get door AABB based on current angle
 void getDoorAABB(simd_float3 *outMin, simd_float3 *outMax);
 
-// Update door animation
-void updateDoorAnimation(void);
-
-// Check if player is near door
-BOOL checkPlayerNearDoor(simd_float3 camPos);
-
 #endif // DOORSYSTEM_H
@@ -2,6 +2,8 @@
 #ifndef GAMECONFIG_H
 #define GAMECONFIG_H
 
+// Counts that size the tables below are enum constants so this header also builds as plain C
+
 // Physics
 static const float GRAVITY = 0.008f;
 static const float MOVE_ACCEL = 0.014f;
@@ -28,7 +30,7 @@ static const int PLAYER_MAX_HEALTH = 100;
 static const int ENEMY_MAX_HEALTH = 30;
 static const int PLAYER_DAMAGE = 15;  // 2 shots to kill enemy
 static const int ENEMY_DAMAGE = 20;   // 5 shots to kill player
-static const int NUM_ENEMIES = 6;
+enum { NUM_ENEMIES = 6 };  // Single-player roster - a world can be created with room for more
 static const int ENEMY_RESPAWN_DELAY = 180;  // 3 seconds at 60fps
 static const int PLAYER_FIRE_RATE = 8;
 static const int ENEMY_FIRE_RATE_MIN = 30;
@@ -115,7 +117,7 @@ static const float SPAWN_PROTECTION_RADIUS = 8.0f;  // Enemies stay away from sp
 // BOT AI CONFIGURATION
 // ============================================
 
-static const int NUM_WAYPOINTS = 12;
+enum { NUM_WAYPOINTS = 12 };
 static const float BOT_DETECTION_RANGE = 25.0f;
 static const float BOT_CHASE_RANGE = 20.0f;
 static const float BOT_STRAFE_RANGE = 10.0f;
@@ -133,11 +135,10 @@ static const float WAYPOINT_X[NUM_WAYPOINTS] = {
 static const float WAYPOINT_Z[NUM_WAYPOINTS] = {
     0.0f, 15.0f, 15.0f, 15.0f, 0.0f, -15.0f, -15.0f, -15.0f, 8.0f, -8.0f, 0.0f, 0.0f
 };
-
-// Cover positions (near structures)
-static const int NUM_COVER_POINTS = 8;
-static const float COVER_X[NUM_COVER_POINTS] = {6.0f, -6.0f, 10.0f, -10.0f, 5.0f, -5.0f, 12.0f, -12.0f};
-static const float COVER_Z[NUM_COVER_POINTS] = {4.0f, 4.0f, 8.0f, 8.0f, -4.0f, -4.0f, -10.0f, -10.0f};
+// Feet height: the floor (FLOOR_Y), or the top of a guard tower (PLATFORM_LEVEL) at the corners
+static const float WAYPOINT_Y[NUM_WAYPOINTS] = {
+    -1.0f, 2.0f, -1.0f, 2.0f, -1.0f, 2.0f, -1.0f, 2.0f, -1.0f, -1.0f, -1.0f, -1.0f
+};
 
 // Bot stats by difficulty [Easy, Medium, Hard]
 static const float BOT_MOVE_SPEED[3] = {0.03f, 0.05f, 0.07f};
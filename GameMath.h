@@ -3,8 +3,16 @@
 #define GAMEMATH_H
 
 #import "GameTypes.h"
+#import "Collision.h"
 
 // Compute camera basis vectors from yaw and pitch
 CameraBasis computeCameraBasis(float yaw, float pitch);
 
+// Ray-AABB intersection test on simd vectors
+static inline RayHitResult rayIntersectAABBSimd(simd_float3 rayOrigin, simd_float3 rayDir,
+                                                simd_float3 boxMin, simd_float3 boxMax) {
+    return rayIntersectAABB(simVec3FromSimd(rayOrigin), simVec3FromSimd(rayDir),
+                            simVec3FromSimd(boxMin), simVec3FromSimd(boxMax));
+}
+
 #endif // GAMEMATH_H
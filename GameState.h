@@ -1,32 +1,20 @@
-// GameState.h - Global game state singleton
+// GameState.h - Global game state singleton (app view of the simulation world)
 #ifndef GAMESTATE_H
 #define GAMESTATE_H
 
 #import <Foundation/Foundation.h>
 #import "GameConfig.h"
 #import "GameTypes.h"
-#import "WeaponSystem.h"
-
-// Multiplayer constants
-static const int RESPAWN_DELAY = 180;  // 3 seconds at 60fps
-static const int DEFAULT_KILL_LIMIT = 10;
-static const int NUM_SPAWN_POINTS = 6;
-
-// Spawn protection constants
-static const int SPAWN_PROTECTION_TIME = 180;  // 3 seconds at 60fps
-
-// Spawn point structure
-typedef struct {
-    float x;
-    float y;
-    float z;
-    float yaw;  // Initial facing direction
-} SpawnPoint;
+#import "SimWorld.h"
 
 @interface GameState : NSObject
 
 + (instancetype)shared;
 
+// Simulation world behind the game properties - the local player is players[0] and
+// the remote player's proxy is players[1]. The properties below read and write it.
+@property (nonatomic, readonly) SimWorld *world;
+
 // Player state (local player in multiplayer)
 @property (nonatomic) int playerHealth;
 @property (nonatomic) int playerArmor;           // Armor points (reduces damage by 50%)
@@ -56,7 +44,9 @@ typedef struct {
 @property (nonatomic) float doorAngle;
 @property (nonatomic) BOOL playerNearDoor;
 
-// Enemy state (C arrays for performance) - used in single-player mode
+// Enemy state (C arrays for performance) - used in single-player mode.
+// Indexed by bot slot up to enemyCount; free slots are never alive.
+@property (nonatomic, readonly) int enemyCount;
 @property (nonatomic, readonly) BOOL *enemyAlive;
 @property (nonatomic, readonly) int *enemyHealth;
 @property (nonatomic, readonly) float *enemyX;
@@ -132,6 +122,13 @@ typedef struct {
 @property (nonatomic) float respawnZ;
 @property (nonatomic) float respawnYaw;
 
+// Correction from an authoritative host (set by MultiplayerController, read by Renderer) - moves the
+// predicted player without touching the view or velocity
+@property (nonatomic) BOOL needsServerCorrection;
+@property (nonatomic) float correctionX;
+@property (nonatomic) float correctionY;
+@property (nonatomic) float correctionZ;
+
 // Spawn point indices for current match
 @property (nonatomic) int localSpawnIndex;
 
@@ -148,6 +145,18 @@ typedef struct {
 // Reset state for new multiplayer match
 - (void)resetForMultiplayer;
 
+// Advance the world one tick (inputs has SIM_MAX_PLAYERS entries) and record it to the match
+// replay. Each match is recorded to FPS_REPLAY_DIR (default $TMPDIR/fpsarena_replays) unless
+// FPS_REPLAY=0.
+- (void)stepWithInputs:(const SimInput *)inputs;
+
+// Put the world back as it was just before the given tick ran (up to
+// SIM_SNAPSHOT_DEFAULT_CAPACITY ticks ago, this match). Returns NO if that's too far back.
+- (BOOL)rewindToTick:(unsigned int)tick;
+
+// Write out the current match replay (on quit - a new match does this itself)
+- (void)finishReplay;
+
 // Get spawn point by index (returns pointer to spawn point, or NULL if invalid index)
 - (SpawnPoint *)getSpawnPoint:(int)index;
 
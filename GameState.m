@@ -1,19 +1,23 @@
 // GameState.m - Global game state singleton implementation
 #import "GameState.h"
-#import "WeaponSystem.h"
+#import "CollisionWorld.h"
+#import "SimReplay.h"
+#import "SimSnapshot.h"
+
+// Local player and the remote player's proxy in the world
+enum {
+    LOCAL_PLAYER = 0,
+    REMOTE_PLAYER = 1,
+};
+
+// Recorded matches kept in the replay directory, the one being started included
+static const NSUInteger REPLAY_KEEP_COUNT = 20;
 
 @implementation GameState {
-    // Single-player enemy arrays
-    BOOL _enemyAliveStorage[NUM_ENEMIES];
-    int _enemyHealthStorage[NUM_ENEMIES];
-    float _enemyXStorage[NUM_ENEMIES];
-    float _enemyYStorage[NUM_ENEMIES];
-    float _enemyZStorage[NUM_ENEMIES];
-    int _enemyFireTimerStorage[NUM_ENEMIES];
-    int _enemyRespawnTimerStorage[NUM_ENEMIES];
-
-    // Multiplayer spawn points
-    SpawnPoint _spawnPointsStorage[NUM_SPAWN_POINTS];
+    SimWorld *_world;
+    SimReplayWriter *_replay;
+    BOOL _replayPending;        // Match reset - start a new replay on the next tick
+    SimSnapshotRing *_snapshots; // World before each of the last ticks, for rewinding
 }
 
 + (instancetype)shared {
@@ -28,62 +32,19 @@
 - (instancetype)init {
     self = [super init];
     if (self) {
-        // Initialize spawn points in SAFE locations with cover nearby
-        // All spawns face toward center of map where action is
-
-        // Spawn 0: Inside command building (protected by walls on 3 sides)
-        // Position near back wall, facing the door
-        _spawnPointsStorage[0] = (SpawnPoint){
-            .x = CMD_BUILDING_X,
-            .y = FLOOR_Y + PLAYER_HEIGHT,
-            .z = CMD_BUILDING_Z - (CMD_BUILDING_DEPTH / 2.0f) + 1.5f,  // Near back wall
-            .yaw = 0.0f  // Face south toward door/exit
-        };
-
-        // Spawn 1: Inside bunker (underground, fully protected)
-        // Position in center of bunker room
-        _spawnPointsStorage[1] = (SpawnPoint){
-            .x = BUNKER_X,
-            .y = BASEMENT_LEVEL + PLAYER_HEIGHT,  // Underground level
-            .z = BUNKER_Z,
-            .yaw = M_PI * 0.5f  // Face east toward stairs/exit
-        };
-
-        // Spawn 2: Behind cargo containers (east side, has cover nearby)
-        // Position behind container cluster
-        _spawnPointsStorage[2] = (SpawnPoint){
-            .x = 12.0f,  // Behind containers on east side
-            .y = FLOOR_Y + PLAYER_HEIGHT,
-            .z = -6.0f,
-            .yaw = M_PI * 0.75f  // Face toward center (northwest)
-        };
-
-        // Spawn 3: On northeast guard tower platform (elevated, railings for cover)
-        _spawnPointsStorage[3] = (SpawnPoint){
-            .x = TOWER_OFFSET,
-            .y = PLATFORM_LEVEL + PLAYER_HEIGHT,  // On tower platform
-            .z = TOWER_OFFSET,
-            .yaw = M_PI * 1.25f  // Face toward center (southwest)
-        };
-
-        // Spawn 4: Behind sandbag wall near west side (good cover position)
-        _spawnPointsStorage[4] = (SpawnPoint){
-            .x = -12.0f,  // West side behind sandbags
-            .y = FLOOR_Y + PLAYER_HEIGHT,
-            .z = 0.0f,
-            .yaw = 0.0f  // Face east toward center
-        };
-
-        // Spawn 5: On southwest guard tower platform (elevated, opposite corner from spawn 3)
-        _spawnPointsStorage[5] = (SpawnPoint){
-            .x = -TOWER_OFFSET,
-            .y = PLATFORM_LEVEL + PLAYER_HEIGHT,  // On tower platform
-            .z = -TOWER_OFFSET,
-            .yaw = M_PI * 0.25f  // Face toward center (northeast)
-        };
-
-        // Set default kill limit
-        _killLimit = DEFAULT_KILL_LIMIT;
+        // World starts with the local player; add the remote player's proxy
+        _world = simCreate([CollisionWorld shared].simCollision);
+        if (!_world) {
+            return nil;
+        }
+        simSetJobSystem(_world, [CollisionWorld shared].jobSystem);
+        simAddPlayer(_world, 0, YES);
+
+        _snapshots = simSnapshotRingCreate(SIM_SNAPSHOT_DEFAULT_CAPACITY, _world);
+        if (!_snapshots) {
+            simDestroy(_world);
+            return nil;
+        }
 
         // Default mouse sensitivity
         _mouseSensitivity = MOUSE_SENSITIVITY;
@@ -96,285 +57,288 @@
     return self;
 }
 
+- (void)dealloc {
+    [self finishReplay];
+    simSnapshotRingDestroy(_snapshots);
+    simDestroy(_world);
+}
+
+- (SimWorld *)world {
+    return _world;
+}
+
+// ============================================
+// WORLD-BACKED PROPERTIES
+// ============================================
+
+#define PLAYER_PROPERTY(type, getter, setter, index, field) \
+    - (type)getter { return _world->players[index].field; } \
+    - (void)setter:(type)value { _world->players[index].field = value; }
+
+#define WORLD_PROPERTY(type, getter, setter, field) \
+    - (type)getter { return _world->field; } \
+    - (void)setter:(type)value { _world->field = value; }
+
+// Local player
+PLAYER_PROPERTY(int, playerHealth, setPlayerHealth, LOCAL_PLAYER, health)
+PLAYER_PROPERTY(int, playerArmor, setPlayerArmor, LOCAL_PLAYER, armor)
+PLAYER_PROPERTY(float, bloodLevel, setBloodLevel, LOCAL_PLAYER, bloodLevel)
+PLAYER_PROPERTY(int, bloodFlashTimer, setBloodFlashTimer, LOCAL_PLAYER, bloodFlashTimer)
+PLAYER_PROPERTY(int, damageCooldownTimer, setDamageCooldownTimer, LOCAL_PLAYER, damageCooldownTimer)
+PLAYER_PROPERTY(int, regenTickTimer, setRegenTickTimer, LOCAL_PLAYER, regenTickTimer)
+PLAYER_PROPERTY(int, footstepTimer, setFootstepTimer, LOCAL_PLAYER, footstepTimer)
+PLAYER_PROPERTY(int, spawnProtectionTimer, setSpawnProtectionTimer, LOCAL_PLAYER, spawnProtectionTimer)
+PLAYER_PROPERTY(int, killCount, setKillCount, LOCAL_PLAYER, botKills)
+PLAYER_PROPERTY(BOOL, hasWeaponShotgun, setHasWeaponShotgun, LOCAL_PLAYER, hasWeapon[WeaponTypeShotgun])
+PLAYER_PROPERTY(BOOL, hasWeaponAssaultRifle, setHasWeaponAssaultRifle, LOCAL_PLAYER, hasWeapon[WeaponTypeAssaultRifle])
+PLAYER_PROPERTY(BOOL, hasWeaponRocketLauncher, setHasWeaponRocketLauncher, LOCAL_PLAYER, hasWeapon[WeaponTypeRocketLauncher])
+PLAYER_PROPERTY(int, ammoSmall, setAmmoSmall, LOCAL_PLAYER, ammoSmall)
+PLAYER_PROPERTY(int, ammoHeavy, setAmmoHeavy, LOCAL_PLAYER, ammoHeavy)
+PLAYER_PROPERTY(BOOL, playerNearDoor, setPlayerNearDoor, LOCAL_PLAYER, nearDoor)
+PLAYER_PROPERTY(int, muzzleFlashTimer, setMuzzleFlashTimer, LOCAL_PLAYER, muzzleFlashTimer)
+PLAYER_PROPERTY(int, localPlayerId, setLocalPlayerId, LOCAL_PLAYER, playerId)
+PLAYER_PROPERTY(int, localPlayerKills, setLocalPlayerKills, LOCAL_PLAYER, kills)
+PLAYER_PROPERTY(int, localRespawnTimer, setLocalRespawnTimer, LOCAL_PLAYER, respawnTimer)
+
+// Remote player
+PLAYER_PROPERTY(int, remotePlayerId, setRemotePlayerId, REMOTE_PLAYER, playerId)
+PLAYER_PROPERTY(float, remotePlayerPosX, setRemotePlayerPosX, REMOTE_PLAYER, position.x)
+PLAYER_PROPERTY(float, remotePlayerPosY, setRemotePlayerPosY, REMOTE_PLAYER, position.y)
+PLAYER_PROPERTY(float, remotePlayerPosZ, setRemotePlayerPosZ, REMOTE_PLAYER, position.z)
+PLAYER_PROPERTY(float, remotePlayerCamYaw, setRemotePlayerCamYaw, REMOTE_PLAYER, yaw)
+PLAYER_PROPERTY(float, remotePlayerCamPitch, setRemotePlayerCamPitch, REMOTE_PLAYER, pitch)
+PLAYER_PROPERTY(int, remotePlayerHealth, setRemotePlayerHealth, REMOTE_PLAYER, health)
+PLAYER_PROPERTY(BOOL, remotePlayerAlive, setRemotePlayerAlive, REMOTE_PLAYER, alive)
+PLAYER_PROPERTY(BOOL, remotePlayerShooting, setRemotePlayerShooting, REMOTE_PLAYER, shooting)
+PLAYER_PROPERTY(int, remotePlayerKills, setRemotePlayerKills, REMOTE_PLAYER, kills)
+PLAYER_PROPERTY(int, remoteRespawnTimer, setRemoteRespawnTimer, REMOTE_PLAYER, respawnTimer)
+
+// Match, door and combat
+WORLD_PROPERTY(BOOL, isMultiplayer, setIsMultiplayer, isMultiplayer)
+WORLD_PROPERTY(int, killLimit, setKillLimit, killLimit)
+WORLD_PROPERTY(BOOL, gameWon, setGameWon, gameWon)
+WORLD_PROPERTY(int, winnerId, setWinnerId, winnerId)
+WORLD_PROPERTY(BOOL, doorOpen, setDoorOpen, doorOpen)
+WORLD_PROPERTY(float, doorAngle, setDoorAngle, doorAngle)
+WORLD_PROPERTY(int, enemyMuzzleFlashTimer, setEnemyMuzzleFlashTimer, enemyMuzzleFlashTimer)
+WORLD_PROPERTY(int, lastFiringEnemy, setLastFiringEnemy, lastFiringEnemy)
+
+#undef PLAYER_PROPERTY
+#undef WORLD_PROPERTY
+
+// Game over while the local player is dead, or once the match is won
+- (BOOL)gameOver {
+    return !_world->players[LOCAL_PLAYER].alive || _world->gameWon;
+}
+
+- (void)setGameOver:(BOOL)gameOver {
+    _world->players[LOCAL_PLAYER].alive = !gameOver;
+}
+
+- (simd_float3)enemyMuzzlePos {
+    return simdFromSimVec3(_world->enemyMuzzlePos);
+}
+
+- (void)setEnemyMuzzlePos:(simd_float3)enemyMuzzlePos {
+    _world->enemyMuzzlePos = simVec3FromSimd(enemyMuzzlePos);
+}
+
 // Accessors for enemy arrays (single-player mode)
-- (BOOL *)enemyAlive { return _enemyAliveStorage; }
-- (int *)enemyHealth { return _enemyHealthStorage; }
-- (float *)enemyX { return _enemyXStorage; }
-- (float *)enemyY { return _enemyYStorage; }
-- (float *)enemyZ { return _enemyZStorage; }
-- (int *)enemyFireTimer { return _enemyFireTimerStorage; }
-- (int *)enemyRespawnTimer { return _enemyRespawnTimerStorage; }
+- (int)enemyCount { return _world->botPool.count; }
+- (BOOL *)enemyAlive { return simBots(_world).alive; }
+- (int *)enemyHealth { return simBots(_world).health; }
+- (float *)enemyX { return simBots(_world).x; }
+- (float *)enemyY { return simBots(_world).y; }
+- (float *)enemyZ { return simBots(_world).z; }
+- (int *)enemyFireTimer { return simBots(_world).fireTimer; }
+- (int *)enemyRespawnTimer { return simBots(_world).respawnTimer; }
 
 // Accessor for spawn points
-- (SpawnPoint *)spawnPoints { return _spawnPointsStorage; }
+- (SpawnPoint *)spawnPoints { return _world->spawnPoints; }
 
-// Weapon system accessors (delegate to WeaponSystem singleton)
+// Weapon state of the local player
 - (WeaponType)currentWeaponType {
-    return [[WeaponSystem shared] getCurrentWeapon];
+    return _world->players[LOCAL_PLAYER].weapons.currentWeapon;
 }
 
 - (BOOL)isWeaponReloading {
-    return [[WeaponSystem shared] isReloading];
+    return _world->players[LOCAL_PLAYER].weapons.isReloading;
+}
+
+// ============================================
+// GAME FLOW
+// ============================================
+
+// Fresh match seed, so each game plays out differently
+- (void)chooseMatchSeed {
+    _world->seed = ((uint64_t)arc4random() << 32) | arc4random();
 }
 
 - (void)resetGame {
-    // Player state
-    _playerHealth = PLAYER_MAX_HEALTH;
-    _playerArmor = 0;
-    _gameOver = NO;
+    // Players, bots, door and combat state
+    [self chooseMatchSeed];
+    simResetGame(_world);
+    simSnapshotRingClear(_snapshots);
+    [self finishReplay];
+    _replayPending = YES;
+
+    // UI state
     _isPaused = NO;
     _showPauseMenu = NO;
     _pauseMenuSelection = -1;
     _pickupNotificationTimer = 0;
     _pickupNotificationText = nil;
-    _bloodLevel = 0.0f;
-    _bloodFlashTimer = 0;
-    _damageCooldownTimer = 0;
-    _regenTickTimer = 0;
-    _footstepTimer = 0;
-    _spawnProtectionTimer = SPAWN_PROTECTION_TIME;  // 3 seconds of spawn protection
-    _killCount = 0;
-
-    // Weapon ownership (start with pistol only)
-    _hasWeaponShotgun = NO;
-    _hasWeaponAssaultRifle = NO;
-    _hasWeaponRocketLauncher = NO;
-
-    // Ammo counts
-    _ammoSmall = 50;    // Starting pistol/rifle ammo
-    _ammoHeavy = 0;     // No heavy ammo to start
-
-    // Door state
-    _doorOpen = NO;
-    _doorAngle = 0.0f;
-    _playerNearDoor = NO;
-
-    // Enemy state (for single-player mode)
-    for (int i = 0; i < NUM_ENEMIES; i++) {
-        _enemyAliveStorage[i] = YES;
-        _enemyHealthStorage[i] = ENEMY_MAX_HEALTH;
-        _enemyXStorage[i] = ENEMY_START_X[i];
-        _enemyYStorage[i] = ENEMY_START_Y[i];
-        _enemyZStorage[i] = ENEMY_START_Z[i];
-        _enemyFireTimerStorage[i] = 0;
-    }
-
-    // Combat state
-    _muzzleFlashTimer = 0;
-    _enemyMuzzleFlashTimer = 0;
-    _enemyMuzzlePos = (simd_float3){0, 0, 0};
-    _lastFiringEnemy = -1;
-
-    // Reset weapon system
-    [[WeaponSystem shared] resetWeapons];
 
     // Reset multiplayer state to single-player defaults
-    _isMultiplayer = NO;
     _isHost = NO;
     _isConnected = NO;
-    _localPlayerId = 0;
-    _remotePlayerId = 0;
-
-    // Remote player state (inactive in single-player)
-    _remotePlayerPosX = 0.0f;
-    _remotePlayerPosY = 0.0f;
-    _remotePlayerPosZ = 0.0f;
-    _remotePlayerCamYaw = 0.0f;
-    _remotePlayerCamPitch = 0.0f;
-    _remotePlayerHealth = 0;
-    _remotePlayerAlive = NO;
-
-    // Scoring
-    _localPlayerKills = 0;
-    _remotePlayerKills = 0;
-    // Note: killLimit is preserved (set in init or by caller)
-    _gameWon = NO;
-    _winnerId = -1;
-
-    // Respawn timers
-    _localRespawnTimer = 0;
-    _remoteRespawnTimer = 0;
+    _world->players[LOCAL_PLAYER].playerId = 0;
+    _world->players[REMOTE_PLAYER].playerId = 0;
 }
 
 - (void)resetForMultiplayer {
-    // Enable multiplayer mode
-    _isMultiplayer = YES;
     _isConnected = NO;  // Will be set to YES when connection established
-    _gameOver = NO;
     _isPaused = NO;
-    _gameWon = NO;
-    _winnerId = -1;
-
-    // Reset scores
-    _localPlayerKills = 0;
-    _remotePlayerKills = 0;
-
-    // Reset local player state
-    _playerHealth = PLAYER_MAX_HEALTH;
-    _playerArmor = 0;
-    _bloodLevel = 0.0f;
-    _bloodFlashTimer = 0;
-    _damageCooldownTimer = 0;
-    _regenTickTimer = 0;
-    _localRespawnTimer = 0;
-    _spawnProtectionTimer = SPAWN_PROTECTION_TIME;  // 3 seconds of spawn protection
-
-    // Reset weapon ownership
-    _hasWeaponShotgun = NO;
-    _hasWeaponAssaultRifle = NO;
-    _hasWeaponRocketLauncher = NO;
-    _ammoSmall = 50;
-    _ammoHeavy = 0;
-
-    // Reset remote player state
-    _remotePlayerHealth = PLAYER_MAX_HEALTH;
-    _remotePlayerAlive = YES;
-    _remoteRespawnTimer = 0;
-
-    // Position players at OPPOSITE spawn points - deterministic based on host/client
-    // Spawn 0 (command building) and Spawn 2 (east cargo) are far apart
-    // Host ALWAYS gets spawn 0, Client ALWAYS gets spawn 2
-    int hostSpawnIndex = 0;   // Command building
-    int clientSpawnIndex = 2; // East cargo (opposite side of map)
-
-    int localSpawnIndex = _isHost ? hostSpawnIndex : clientSpawnIndex;
-    int remoteSpawnIndex = _isHost ? clientSpawnIndex : hostSpawnIndex;
-
-    SpawnPoint *localSpawn = [self getSpawnPoint:localSpawnIndex];
-    SpawnPoint *remoteSpawn = [self getSpawnPoint:remoteSpawnIndex];
-
-    if (remoteSpawn) {
-        _remotePlayerPosX = remoteSpawn->x;
-        _remotePlayerPosY = remoteSpawn->y;
-        _remotePlayerPosZ = remoteSpawn->z;
-        _remotePlayerCamYaw = remoteSpawn->yaw;
-        _remotePlayerCamPitch = 0.0f;
-    }
+
+    // Scores, health and ownership reset; bots off; remote player at the opposite spawn
+    [self chooseMatchSeed];
+    simResetForMultiplayer(_world, _isHost);
+    simSnapshotRingClear(_snapshots);
+    [self finishReplay];
+    _replayPending = YES;
 
     // Store local spawn index for resetPlayerWithPosX to use
-    _localSpawnIndex = localSpawnIndex;
-
-    // Combat state
-    _muzzleFlashTimer = 0;
-    _enemyMuzzleFlashTimer = 0;
-    _enemyMuzzlePos = (simd_float3){0, 0, 0};
-    _lastFiringEnemy = -1;
-
-    // Door state (reset for fair start)
-    _doorOpen = NO;
-    _doorAngle = 0.0f;
-    _playerNearDoor = NO;
-
-    // Disable AI enemies in multiplayer mode
-    for (int i = 0; i < NUM_ENEMIES; i++) {
-        _enemyAliveStorage[i] = NO;
-        _enemyHealthStorage[i] = 0;
-    }
+    _localSpawnIndex = _world->players[LOCAL_PLAYER].spawnIndex;
 }
 
-- (SpawnPoint *)getSpawnPoint:(int)index {
-    if (index < 0 || index >= NUM_SPAWN_POINTS) {
-        return NULL;
+// ============================================
+// TICK AND REPLAY
+// ============================================
+
+// Delete the oldest recorded matches so at most keep - 1 are left for the new one to join.
+// Only our own match-<timestamp>-<n>.fpsreplay files count; the timestamp makes name order
+// recording order.
+- (void)pruneReplaysInDirectory:(NSString *)directory keep:(NSUInteger)keep {
+    NSFileManager *fileManager = [NSFileManager defaultManager];
+    NSMutableArray<NSString *> *replays = [NSMutableArray array];
+    for (NSString *name in [fileManager contentsOfDirectoryAtPath:directory error:nil]) {
+        if ([name hasPrefix:@"match-"] && [name.pathExtension isEqualToString:@"fpsreplay"]) {
+            [replays addObject:name];
+        }
+    }
+    if (replays.count < keep) return;
+
+    [replays sortUsingSelector:@selector(compare:)];
+    NSUInteger excess = replays.count - (keep - 1);
+    for (NSUInteger i = 0; i < excess; i++) {
+        NSString *path = [directory stringByAppendingPathComponent:replays[i]];
+        if (![fileManager removeItemAtPath:path error:nil]) {
+            NSLog(@"[REPLAY] Can't remove old replay %@", path);
+        }
     }
-    return &_spawnPointsStorage[index];
 }
 
-- (BOOL)checkWinCondition {
-    // Only check in multiplayer mode
-    if (!_isMultiplayer) {
-        return NO;
-    }
+- (void)startReplay {
+    NSDictionary<NSString *, NSString *> *environment = [NSProcessInfo processInfo].environment;
+    if ([environment[@"FPS_REPLAY"] isEqualToString:@"0"]) return;
 
-    // Already won
-    if (_gameWon) {
-        return YES;
+    NSString *directory = environment[@"FPS_REPLAY_DIR"];
+    if (directory.length == 0) {
+        directory = [NSTemporaryDirectory() stringByAppendingPathComponent:@"fpsarena_replays"];
     }
-
-    // Check if local player reached kill limit
-    if (_localPlayerKills >= _killLimit) {
-        _gameWon = YES;
-        _winnerId = _localPlayerId;
-        _gameOver = YES;
-        return YES;
+    if (![[NSFileManager defaultManager] createDirectoryAtPath:directory
+                                   withIntermediateDirectories:YES
+                                                    attributes:nil
+                                                         error:nil]) {
+        NSLog(@"[REPLAY] Can't create %@", directory);
+        return;
     }
 
-    // Check if remote player reached kill limit
-    if (_remotePlayerKills >= _killLimit) {
-        _gameWon = YES;
-        _winnerId = _remotePlayerId;
-        _gameOver = YES;
-        return YES;
+    // Bounded: FPS_REPLAY_KEEP matches (REPLAY_KEEP_COUNT by default), oldest dropped first
+    NSInteger keep = environment[@"FPS_REPLAY_KEEP"].integerValue;
+    [self pruneReplaysInDirectory:directory keep:keep > 0 ? (NSUInteger)keep : REPLAY_KEEP_COUNT];
+
+    // Fixed-width ASCII digits in UTC whatever the user's locale, calendar and daylight saving,
+    // so name order stays recording order; the counter keeps matches started in the same
+    // millisecond apart
+    NSDateFormatter *formatter = [[NSDateFormatter alloc] init];
+    formatter.locale = [NSLocale localeWithLocaleIdentifier:@"en_US_POSIX"];
+    formatter.timeZone = [NSTimeZone timeZoneForSecondsFromGMT:0];
+    formatter.dateFormat = @"yyyyMMdd-HHmmss-SSS";
+    NSString *timestamp = [formatter stringFromDate:[NSDate date]];
+
+    NSString *path = nil;
+    for (int n = 0; n < 100 && !path; n++) {
+        NSString *name = [NSString stringWithFormat:@"match-%@-%02d.fpsreplay", timestamp, n];
+        NSString *candidate = [directory stringByAppendingPathComponent:name];
+        if (![[NSFileManager defaultManager] fileExistsAtPath:candidate]) path = candidate;
+    }
+    if (!path) {
+        NSLog(@"[REPLAY] No free recording name in %@", directory);
+        return;
     }
 
-    return NO;
+    _replay = simReplayWriterOpen(path.fileSystemRepresentation, _world, REPLAY_DEFAULT_KEYFRAME_INTERVAL);
+    if (_replay) {
+        NSLog(@"[REPLAY] Recording to %@", path);
+    }
 }
 
-- (void)resetPlayerWithPosX:(float *)posX posY:(float *)posY posZ:(float *)posZ
-                     camYaw:(float *)camYaw camPitch:(float *)camPitch
-                  velocityX:(float *)velocityX velocityY:(float *)velocityY velocityZ:(float *)velocityZ
-                   onGround:(BOOL *)onGround {
+- (void)stepWithInputs:(const SimInput *)inputs {
+    if (_replayPending) {
+        _replayPending = NO;
+        [self startReplay];
+    }
 
-    // Reset spawn protection timer
-    _spawnProtectionTimer = SPAWN_PROTECTION_TIME;
-
-    if (_isMultiplayer) {
-        // In multiplayer, find spawn point furthest from remote player
-        int bestSpawn = _localSpawnIndex;  // Default to assigned spawn
-        float bestDistance = 0.0f;
-
-        for (int i = 0; i < NUM_SPAWN_POINTS; i++) {
-            SpawnPoint *spawn = [self getSpawnPoint:i];
-            if (spawn) {
-                float dx = spawn->x - _remotePlayerPosX;
-                float dz = spawn->z - _remotePlayerPosZ;
-                float dist = sqrtf(dx * dx + dz * dz);
-
-                // Prefer spawn points far from remote player
-                if (dist > bestDistance) {
-                    bestDistance = dist;
-                    bestSpawn = i;
-                }
-            }
-        }
+    simSnapshotSave(_snapshots, _world);
 
-        SpawnPoint *spawn = [self getSpawnPoint:bestSpawn];
-
-        if (spawn) {
-            *posX = spawn->x;
-            *posY = spawn->y;
-            *posZ = spawn->z;
-            *camYaw = spawn->yaw;
-        } else {
-            // Fallback to default position
-            *posX = PLAYER_START_X;
-            *posY = FLOOR_Y + PLAYER_HEIGHT;
-            *posZ = PLAYER_START_Z;
-            *camYaw = M_PI;
+    if (_replay) {
+        if (!simReplayWriterStep(_replay, _world, inputs)) {
+            // Disk full or gone - keep playing without recording
+            [self finishReplay];
         }
     } else {
-        // Single-player: randomly select from safe spawn points
-        int spawnIndex = arc4random_uniform(NUM_SPAWN_POINTS);
-        SpawnPoint *spawn = [self getSpawnPoint:spawnIndex];
-
-        if (spawn) {
-            *posX = spawn->x;
-            *posY = spawn->y;
-            *posZ = spawn->z;
-            *camYaw = spawn->yaw;
-        } else {
-            // Fallback to spawn 0 (inside command building)
-            *posX = CMD_BUILDING_X;
-            *posY = FLOOR_Y + PLAYER_HEIGHT;
-            *posZ = CMD_BUILDING_Z - (CMD_BUILDING_DEPTH / 2.0f) + 1.5f;
-            *camYaw = 0.0f;
-        }
+        simStep(_world, inputs);
     }
+}
 
-    *camPitch = 0.0f;
-    *velocityX = 0.0f;
-    *velocityY = 0.0f;
-    *velocityZ = 0.0f;
-    *onGround = YES;
+- (BOOL)rewindToTick:(unsigned int)tick {
+    // The replay sees the jump as a change from outside the tick and keyframes it
+    return simSnapshotRestore(_snapshots, _world, tick);
+}
+
+- (void)finishReplay {
+    if (_replay) {
+        simReplayWriterClose(_replay);
+        _replay = NULL;
+    }
+}
+
+- (SpawnPoint *)getSpawnPoint:(int)index {
+    return simGetSpawnPoint(_world, index);
+}
+
+- (BOOL)checkWinCondition {
+    return simCheckWinCondition(_world);
+}
+
+- (void)resetPlayerWithPosX:(float *)posX posY:(float *)posY posZ:(float *)posZ
+                     camYaw:(float *)camYaw camPitch:(float *)camPitch
+                  velocityX:(float *)velocityX velocityY:(float *)velocityY velocityZ:(float *)velocityZ
+                   onGround:(BOOL *)onGround {
+    // Furthest spawn from the remote player in multiplayer, a random one in single-player
+    simRespawnPlayer(_world, LOCAL_PLAYER, simChooseSpawnPoint(_world, LOCAL_PLAYER));
+
+    SimPlayer *player = &_world->players[LOCAL_PLAYER];
+    *posX = player->position.x;
+    *posY = player->position.y;
+    *posZ = player->position.z;
+    *camYaw = player->yaw;
+    *camPitch = player->pitch;
+    *velocityX = player->velocity.x;
+    *velocityY = player->velocity.y;
+    *velocityZ = player->velocity.z;
+    *onGround = player->onGround;
 }
 
 @end
@@ -3,17 +3,7 @@
 #define GAMETYPES_H
 
 #import <simd/simd.h>
-#import <stdbool.h>
-
-// For Objective-C, BOOL is already defined by the runtime
-// For pure C, we need to define it
-#ifdef __OBJC__
-#import <objc/objc.h>  // Provides BOOL, YES, NO in Objective-C
-#else
-typedef bool BOOL;
-#define YES true
-#define NO false
-#endif
+#import "SimTypes.h"
 
 // Vertex structure for rendering
 typedef struct {
@@ -21,12 +11,6 @@ typedef struct {
     simd_float3 color;
 } Vertex;
 
-// Ray-AABB intersection result
-typedef struct {
-    BOOL hit;
-    float t;  // distance to hit
-} RayHitResult;
-
 // Camera basis vectors
 typedef struct {
     simd_float3 forward;
@@ -34,6 +18,15 @@ typedef struct {
     simd_float3 up;
 } CameraBasis;
 
+// Simulation vectors <-> simd vectors
+static inline SimVec3 simVec3FromSimd(simd_float3 v) {
+    return (SimVec3){v.x, v.y, v.z};
+}
+
+static inline simd_float3 simdFromSimVec3(SimVec3 v) {
+    return (simd_float3){v.x, v.y, v.z};
+}
+
 // Identity matrix constant
 static const simd_float4x4 IDENTITY_MATRIX = {{
     {1, 0, 0, 0}, {0, 1, 0, 0}, {0, 0, 1, 0}, {0, 0, 0, 1}
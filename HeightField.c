@@ -0,0 +1,112 @@
+// HeightField.c - Baked multi-layer 2.5D ground height field implementation
+#include "HeightField.h"
+#include <limits.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+static int clampIndex(int i, int size) {
+    if (i < 0) return 0;
+    if (i >= size) return size - 1;
+    return i;
+}
+
+bool hfBuild(HeightField *field,
+             float minX, float minZ, float maxX, float maxZ,
+             float texelSize, float margin,
+             const HeightFieldItem *items, int count) {
+    if (texelSize <= 0) return false;
+
+    int sizeX = (int)ceilf((maxX - minX) / texelSize);
+    int sizeZ = (int)ceilf((maxZ - minZ) / texelSize);
+    if (sizeX <= 0 || sizeZ <= 0) return false;
+
+    if (sizeX != field->sizeX || sizeZ != field->sizeZ || !field->layerCount) {
+        hfFree(field);
+        size_t texels = (size_t)sizeX * (size_t)sizeZ;
+        field->layerCount = calloc(texels, sizeof(unsigned char));
+        field->layers = malloc(texels * HF_MAX_LAYERS * sizeof(HeightFieldLayer));
+        if (!field->layerCount || !field->layers) {
+            hfFree(field);
+            return false;
+        }
+        field->sizeX = sizeX;
+        field->sizeZ = sizeZ;
+    } else {
+        memset(field->layerCount, 0, (size_t)sizeX * (size_t)sizeZ);
+    }
+
+    field->minX = minX;
+    field->minZ = minZ;
+    field->texelSize = texelSize;
+    field->margin = margin;
+
+    // Items are visited in order, so each texel's layers stay sorted by item index
+    for (int i = 0; i < count; i++) {
+        const HeightFieldItem *item = &items[i];
+        int x0 = clampIndex((int)floorf((item->minX - margin - minX) / texelSize), sizeX);
+        int x1 = clampIndex((int)floorf((item->maxX + margin - minX) / texelSize), sizeX);
+        int z0 = clampIndex((int)floorf((item->minZ - margin - minZ) / texelSize), sizeZ);
+        int z1 = clampIndex((int)floorf((item->maxZ + margin - minZ) / texelSize), sizeZ);
+
+        for (int tz = z0; tz <= z1; tz++) {
+            for (int tx = x0; tx <= x1; tx++) {
+                int texel = tz * sizeX + tx;
+                unsigned char n = field->layerCount[texel];
+                if (n == HF_OVERFLOW) continue;
+                if (n == HF_MAX_LAYERS) {
+                    field->layerCount[texel] = HF_OVERFLOW;
+                    continue;
+                }
+                HeightFieldLayer *layer = &field->layers[texel * HF_MAX_LAYERS + n];
+                layer->surfaceMinY = item->surfaceMinY;
+                layer->surfaceMaxY = item->surfaceMaxY;
+                layer->item = i;
+                field->layerCount[texel] = n + 1;
+            }
+        }
+    }
+
+    return true;
+}
+
+void hfFree(HeightField *field) {
+    free(field->layerCount);
+    free(field->layers);
+    memset(field, 0, sizeof(*field));
+}
+
+bool hfValidate(const HeightField *field, int itemCount) {
+    if (!(field->texelSize > 0) || !isfinite(field->minX) || !isfinite(field->minZ)) return false;
+    if (field->sizeX <= 0 || field->sizeZ <= 0 || field->sizeX > INT_MAX / HF_MAX_LAYERS / field->sizeZ) return false;
+
+    int texels = field->sizeX * field->sizeZ;
+    for (int t = 0; t < texels; t++) {
+        int count = field->layerCount[t];
+        if (count == HF_OVERFLOW) continue;
+        if (count > HF_MAX_LAYERS) return false;
+        const HeightFieldLayer *layers = &field->layers[(size_t)t * HF_MAX_LAYERS];
+        for (int l = 0; l < count; l++) {
+            if (layers[l].item < 0 || layers[l].item >= itemCount) return false;
+        }
+    }
+    return true;
+}
+
+int hfLayersAt(const HeightField *field, float x, float z, const HeightFieldLayer **outLayers) {
+    if (!field->layerCount) return -1;
+
+    float fx = (x - field->minX) / field->texelSize;
+    float fz = (z - field->minZ) / field->texelSize;
+    if (!(fx >= 0 && fz >= 0)) return -1;
+
+    int tx = (int)fx, tz = (int)fz;
+    if (tx >= field->sizeX || tz >= field->sizeZ) return -1;
+
+    int texel = tz * field->sizeX + tx;
+    unsigned char n = field->layerCount[texel];
+    if (n == HF_OVERFLOW) return -1;
+
+    *outLayers = &field->layers[texel * HF_MAX_LAYERS];
+    return n;
+}
@@ -0,0 +1,65 @@
+// HeightField.h - Baked multi-layer 2.5D ground height field for ground queries
+#ifndef HEIGHTFIELD_H
+#define HEIGHTFIELD_H
+
+#include <stdbool.h>
+
+// Walkable surfaces stored per texel (floor, second floor, catwalk, container top, ...)
+#define HF_MAX_LAYERS 8
+
+// Texel layer count marking a texel with more surfaces than HF_MAX_LAYERS
+#define HF_OVERFLOW 0xFF
+
+// ============================================
+// HEIGHT FIELD TYPES
+// ============================================
+
+// Walkable surface to bake - XZ footprint plus the Y range its top surface spans
+typedef struct {
+    float minX, minZ;
+    float maxX, maxZ;
+    float surfaceMinY;          // Lowest point of the walkable top (ramp start, or box top)
+    float surfaceMaxY;          // Highest point of the walkable top
+} HeightFieldItem;
+
+// One surface under a texel
+typedef struct {
+    float surfaceMinY;
+    float surfaceMaxY;
+    int item;                   // Index into the build input
+} HeightFieldLayer;
+
+// Uniform XZ grid. Each texel lists (in item order) every surface whose footprint,
+// grown by margin, touches the texel.
+typedef struct {
+    float minX, minZ;
+    float texelSize;
+    float margin;               // Footprint growth - the largest query radius the field answers
+    int sizeX, sizeZ;
+    unsigned char *layerCount;  // Per texel, HF_OVERFLOW if layers were dropped
+    HeightFieldLayer *layers;   // HF_MAX_LAYERS slots per texel
+} HeightField;
+
+// ============================================
+// HEIGHT FIELD FUNCTIONS
+// ============================================
+
+// Bake items[0..count) into a grid covering [minX,maxX] x [minZ,maxZ].
+// Reuses existing allocations when the grid size is unchanged. Returns false on no memory.
+bool hfBuild(HeightField *field,
+             float minX, float minZ, float maxX, float maxZ,
+             float texelSize, float margin,
+             const HeightFieldItem *items, int count);
+
+// Release all memory held by the field
+void hfFree(HeightField *field);
+
+// Check the size, layer counts and that every layer's item is below itemCount.
+// For fields not made by hfBuild (e.g. read back from a file).
+bool hfValidate(const HeightField *field, int itemCount);
+
+// Layers under (x, z). Returns the layer count, or -1 if the point is outside the
+// field or the texel overflowed - the caller must then fall back to a full search.
+int hfLayersAt(const HeightField *field, float x, float z, const HeightFieldLayer **outLayers);
+
+#endif // HEIGHTFIELD_H
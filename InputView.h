@@ -32,6 +32,10 @@
 @property (nonatomic) BOOL keySpace;
 @property (nonatomic) float currentHeight;  // Interpolated height for smooth crouch transition
 @property (nonatomic) BOOL wantsClick;
+// Key presses latched for the next tick's SimInput, so an authoritative host gets them too
+@property (nonatomic) BOOL wantsReload;
+@property (nonatomic) BOOL wantsUse;
+@property (nonatomic) int wantsWeaponSlot;  // WeaponType to switch to, or -1
 @property (nonatomic) BOOL mouseHeld;
 @property (nonatomic) BOOL keyTab;
 @property (nonatomic) int fireTimer;
@@ -304,37 +304,37 @@
                 }
             } else if (!state.gameOver) {
                 // Not dead - R key reloads weapon
-                [[WeaponSystem shared] reload];
+                _wantsReload = YES;
             }
             break;
         case ' ':
             _keySpace = YES;
             break;
         case 'e':
-            if (state.playerNearDoor && !state.gameOver) {
-                state.doorOpen = !state.doorOpen;
-                [[SoundManager shared] playDoorSound];
+            // The tick toggles the door if the player is near it
+            if (!state.gameOver) {
+                _wantsUse = YES;
             }
             break;
         // Weapon switching with number keys 1-4
         case '1':
             if (!state.gameOver) {
-                [[WeaponSystem shared] switchWeapon:WeaponTypePistol];
+                _wantsWeaponSlot = WeaponTypePistol;
             }
             break;
         case '2':
             if (!state.gameOver) {
-                [[WeaponSystem shared] switchWeapon:WeaponTypeShotgun];
+                _wantsWeaponSlot = WeaponTypeShotgun;
             }
             break;
         case '3':
             if (!state.gameOver) {
-                [[WeaponSystem shared] switchWeapon:WeaponTypeAssaultRifle];
+                _wantsWeaponSlot = WeaponTypeAssaultRifle;
             }
             break;
         case '4':
             if (!state.gameOver) {
-                [[WeaponSystem shared] switchWeapon:WeaponTypeRocketLauncher];
+                _wantsWeaponSlot = WeaponTypeRocketLauncher;
             }
             break;
         // Sensitivity adjustment with [ and ]
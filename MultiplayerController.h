@@ -4,6 +4,7 @@
 
 #import <Foundation/Foundation.h>
 #import "GameState.h"
+#include "NetProtocol.h"
 
 @class NetworkManager;
 
@@ -15,6 +16,9 @@
 @property (nonatomic, readonly) BOOL isConnected;
 @property (nonatomic, readonly) BOOL isInGame;
 
+// The host simulates every player from their inputs (dedicated server) - the local game only predicts
+@property (nonatomic, readonly) BOOL isServerAuthoritative;
+
 // Lobby actions
 - (void)hostGame;
 - (void)joinGameAtHost:(NSString *)hostIP;
@@ -30,6 +34,10 @@
                 camYaw:(float)camYaw camPitch:(float)camPitch
             isShooting:(BOOL)isShooting;
 
+// Send this tick's controls to an authoritative host - after the tick has run, so where they took
+// the local player is recorded before the host's state for them can arrive
+- (void)sendLocalInput:(const SimInput *)input;
+
 // Called when local player shoots and hits remote player
 - (void)sendHitOnRemotePlayer:(int)damage;
 
@@ -39,6 +47,12 @@
 // Handle respawn
 - (void)requestRespawn;
 
+// An authoritative host's word on the local player
+- (void)applyServerState:(PlayerNetState)netState forInput:(uint32_t)inputSequence;
+- (void)applyServerHit;
+- (void)applyServerDeath;
+- (void)applyServerRespawn:(PlayerNetState)netState;
+
 @end
 
 #endif // MULTIPLAYERCONTROLLER_H
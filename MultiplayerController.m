@@ -2,15 +2,27 @@
 #import "MultiplayerController.h"
 #import "NetworkManager.h"
 #import "GameConfig.h"
-#import "Combat.h"
 #import "WeaponSystem.h"
 
+// Predicted positions kept to check an authoritative host's state against - about a second at 60 Hz
+enum { PREDICTION_HISTORY = 64 };
+
+// How far our prediction may drift from an authoritative host before we move to match it
+static const float SERVER_CORRECTION_DISTANCE = 0.5f;
+
+typedef struct {
+    uint32_t inputSequence;     // Input that took the player here, 0 when unused
+    SimVec3 position;
+} PredictedPosition;
+
 @interface MultiplayerController () <NetworkManagerDelegate>
 @end
 
 @implementation MultiplayerController {
     NetworkManager *_networkManager;
     uint32_t _localSequence;
+    uint32_t _lastInputSequence;
+    PredictedPosition _predicted[PREDICTION_HISTORY];
 }
 
 + (instancetype)shared {
@@ -76,6 +88,7 @@
     // Called on client when receiving game start from host
     GameState *state = [GameState shared];
     [state resetForMultiplayer];
+    [self resetPrediction];
     _isInGame = YES;
     _isConnected = YES;
 
@@ -112,7 +125,9 @@
     if (state.isMultiplayer && _isInGame) {
         if (state.localRespawnTimer > 0) {
             state.localRespawnTimer--;
-            if (state.localRespawnTimer == 0) {
+
+            // An authoritative host respawns us itself and says where
+            if (state.localRespawnTimer == 0 && !self.isServerAuthoritative) {
                 [self doLocalRespawn];
             }
         }
@@ -225,10 +240,15 @@
 
 #pragma mark - Sending State
 
+- (BOOL)isServerAuthoritative {
+    return _networkManager.hostIsAuthoritative;
+}
+
 - (void)sendLocalState:(float)posX posY:(float)posY posZ:(float)posZ
                 camYaw:(float)camYaw camPitch:(float)camPitch
             isShooting:(BOOL)isShooting {
-    if (!_isConnected || !_isInGame) return;
+    // An authoritative host moves us from our inputs instead
+    if (!_isConnected || !_isInGame || self.isServerAuthoritative) return;
 
     GameState *state = [GameState shared];
 
@@ -245,7 +265,29 @@
     [_networkManager sendStateUpdate:netState];
 }
 
+- (void)sendLocalInput:(const SimInput *)input {
+    if (!_isConnected || !_isInGame || !self.isServerAuthoritative) return;
+
+    InputPacket packet = {0};
+    packet.buttons = (uint16_t)input->buttons;
+    packet.weaponSlot = (int8_t)input->weaponSlot;
+    packet.yaw = input->yaw;
+    packet.pitch = input->pitch;
+    packet.active = input->active ? 1 : 0;
+    _lastInputSequence = [_networkManager sendInput:packet];
+    if (_lastInputSequence == 0) return;
+
+    // The local player stands where this input took it
+    GameState *state = [GameState shared];
+    PredictedPosition *entry = &_predicted[_lastInputSequence % PREDICTION_HISTORY];
+    entry->inputSequence = _lastInputSequence;
+    entry->position = state.world->players[0].position;
+}
+
 - (void)sendHitOnRemotePlayer:(int)damage {
+    // An authoritative host decides hits itself
+    if (self.isServerAuthoritative) return;
+
     if (!_isConnected || !_isInGame) {
         NSLog(@"sendHitOnRemotePlayer: NOT sending - connected:%d inGame:%d", _isConnected, _isInGame);
         return;
@@ -268,7 +310,7 @@
     NSLog(@"[DEATH] Remote player kills updated to: %d", state.remotePlayerKills);
 
     // Send death notification to remote player so they can update their scoreboard
-    [_networkManager sendKill:(uint32_t)state.localPlayerId];
+    [_networkManager sendKill:(uint32_t)state.localPlayerId killedBy:(uint32_t)state.remotePlayerId];
 
     // Start respawn timer
     state.localRespawnTimer = RESPAWN_DELAY;
@@ -279,6 +321,80 @@
     [self handleLocalDeath];
 }
 
+#pragma mark - Authoritative Host
+
+- (void)resetPrediction {
+    memset(_predicted, 0, sizeof(_predicted));
+    _lastInputSequence = 0;
+}
+
+- (void)applyServerState:(PlayerNetState)netState forInput:(uint32_t)inputSequence {
+    GameState *state = [GameState shared];
+    if (state.gameOver) return;
+    state.playerHealth = netState.health;
+
+    // Compare with where we predicted that input would take us - the host's state is a round trip old
+    PredictedPosition *entry = &_predicted[inputSequence % PREDICTION_HISTORY];
+    if (inputSequence == 0 || entry->inputSequence != inputSequence) return;
+
+    float dx = netState.posX - entry->position.x;
+    float dy = netState.posY - entry->position.y;
+    float dz = netState.posZ - entry->position.z;
+    if (dx * dx + dy * dy + dz * dz <= SERVER_CORRECTION_DISTANCE * SERVER_CORRECTION_DISTANCE) return;
+
+    // Move by the error, and shift the predictions still in flight with it so they aren't corrected twice
+    SimVec3 position = state.world->players[0].position;
+    state.needsServerCorrection = YES;
+    state.correctionX = position.x + dx;
+    state.correctionY = position.y + dy;
+    state.correctionZ = position.z + dz;
+    for (int i = 0; i < PREDICTION_HISTORY; i++) {
+        _predicted[i].position = simVec3(_predicted[i].position.x + dx, _predicted[i].position.y + dy,
+                                         _predicted[i].position.z + dz);
+    }
+    NSLog(@"[PREDICTION] Corrected by (%.2f, %.2f, %.2f) at input %u", dx, dy, dz, inputSequence);
+}
+
+- (void)applyServerHit {
+    GameState *state = [GameState shared];
+    if (state.gameOver) return;
+
+    // The host has applied the damage - its state updates bring the health, this is the feedback
+    state.damageCooldownTimer = 0;
+    state.bloodLevel += 0.25f;
+    if (state.bloodLevel > 1.0f) state.bloodLevel = 1.0f;
+    state.bloodFlashTimer = 8;
+}
+
+- (void)applyServerDeath {
+    GameState *state = [GameState shared];
+    state.playerHealth = 0;
+    state.gameOver = YES;
+
+    // Counts down the death screen - the host's respawn packet ends it
+    state.localRespawnTimer = RESPAWN_DELAY;
+    NSLog(@"[DEATH] Killed, waiting for the host to respawn us");
+}
+
+- (void)applyServerRespawn:(PlayerNetState)netState {
+    GameState *state = [GameState shared];
+    state.playerHealth = PLAYER_MAX_HEALTH;
+    state.playerArmor = 0;
+    state.bloodLevel = 0;
+    state.gameOver = NO;
+    state.localRespawnTimer = 0;
+    [[WeaponSystem shared] resetWeapons];
+
+    state.needsRespawnTeleport = YES;
+    state.respawnX = netState.posX;
+    state.respawnY = netState.posY;
+    state.respawnZ = netState.posZ;
+    state.respawnYaw = netState.camYaw;
+    [self resetPrediction];
+
+    NSLog(@"[RESPAWN] Host respawned us at (%.1f, %.1f, %.1f)", netState.posX, netState.posY, netState.posZ);
+}
+
 - (void)requestRespawn {
     // Respawn is handled automatically by timer
 }
@@ -0,0 +1,503 @@
+// NavGrid.c - Baked walkable grid, A* path search and flow fields implementation
+#include "NavGrid.h"
+#include <limits.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Surfaces closer than this in one cell count as one (the highest is kept)
+#define NAV_SURFACE_MERGE 0.3f
+
+// Height change between neighbouring nodes that makes the path keep a corner there, so the
+// follower sees each jump or drop coming
+#define NAV_CORNER_RISE 0.3f
+
+// Extra cost, in cells, of a link that needs a jump
+#define NAV_JUMP_PENALTY 1.0f
+
+// Length of a diagonal step, in cells
+#define NAV_DIAGONAL 1.41421356f
+
+// Surface height differences count this many times their size when picking a node for a point
+#define NAV_PICK_HEIGHT_WEIGHT 2.0f
+
+static const int DIRECTION_X[NAV_DIRECTIONS] = {1, -1, 0, 0, 1, 1, -1, -1};
+static const int DIRECTION_Z[NAV_DIRECTIONS] = {0, 0, 1, -1, 1, -1, 1, -1};
+
+struct NavHeapEntry {
+    float priority;
+    int node;
+};
+
+bool navGridInit(NavGrid *grid, float minX, float minZ, float maxX, float maxZ, float cellSize) {
+    memset(grid, 0, sizeof(*grid));
+    if (cellSize <= 0) return false;
+
+    grid->minX = minX;
+    grid->minZ = minZ;
+    grid->cellSize = cellSize;
+    grid->sizeX = (int)ceilf((maxX - minX) / cellSize);
+    grid->sizeZ = (int)ceilf((maxZ - minZ) / cellSize);
+    if (grid->sizeX <= 0 || grid->sizeZ <= 0) return false;
+
+    grid->cellCount = grid->sizeX * grid->sizeZ;
+    size_t nodes = (size_t)grid->cellCount * NAV_MAX_LAYERS;
+    grid->layerCount = calloc((size_t)grid->cellCount, sizeof(unsigned char));
+    grid->surfaceY = calloc(nodes, sizeof(float));
+    grid->links = calloc(nodes, NAV_DIRECTIONS);
+    if (!grid->layerCount || !grid->surfaceY || !grid->links) {
+        navGridFree(grid);
+        return false;
+    }
+    return true;
+}
+
+void navGridFree(NavGrid *grid) {
+    free(grid->layerCount);
+    free(grid->surfaceY);
+    free(grid->links);
+    memset(grid, 0, sizeof(*grid));
+}
+
+bool navGridValidate(const NavGrid *grid) {
+    if (!(grid->cellSize > 0) || !isfinite(grid->minX) || !isfinite(grid->minZ)) return false;
+    if (grid->sizeX <= 0 || grid->sizeZ <= 0 || grid->sizeX > INT_MAX / NAV_MAX_LAYERS / grid->sizeZ) return false;
+    if (grid->cellCount != grid->sizeX * grid->sizeZ) return false;
+
+    for (int cell = 0; cell < grid->cellCount; cell++) {
+        if (grid->layerCount[cell] > NAV_MAX_LAYERS) return false;
+    }
+
+    // A link may only name a layer the neighbouring cell has, and never leave the grid
+    for (int cell = 0; cell < grid->cellCount; cell++) {
+        int ix = cell % grid->sizeX;
+        int iz = cell / grid->sizeX;
+        for (int d = 0; d < NAV_DIRECTIONS; d++) {
+            int nx = ix + DIRECTION_X[d];
+            int nz = iz + DIRECTION_Z[d];
+            bool inside = nx >= 0 && nx < grid->sizeX && nz >= 0 && nz < grid->sizeZ;
+            unsigned int allowed = inside ? (1u << grid->layerCount[nz * grid->sizeX + nx]) - 1 : 0;
+            for (int layer = 0; layer < NAV_MAX_LAYERS; layer++) {
+                int node = cell * NAV_MAX_LAYERS + layer;
+                if (grid->links[node * NAV_DIRECTIONS + d] & ~allowed) return false;
+            }
+        }
+    }
+    return true;
+}
+
+static void cellCenter(const NavGrid *grid, int cell, float *x, float *z) {
+    *x = grid->minX + ((float)(cell % grid->sizeX) + 0.5f) * grid->cellSize;
+    *z = grid->minZ + ((float)(cell / grid->sizeX) + 0.5f) * grid->cellSize;
+}
+
+void navGridNodePosition(const NavGrid *grid, int node, float out[3]) {
+    int cell = node / NAV_MAX_LAYERS;
+    cellCenter(grid, cell, &out[0], &out[2]);
+    out[1] = grid->surfaceY[node];
+}
+
+void navGridBuildSurfaces(NavGrid *grid, int row, NavSurfacesFn surfaces, void *context) {
+    for (int ix = 0; ix < grid->sizeX; ix++) {
+        int cell = row * grid->sizeX + ix;
+        float x, z;
+        cellCenter(grid, cell, &x, &z);
+
+        float found[NAV_MAX_LAYERS * 2];
+        int foundCount = surfaces(context, x, z, found, NAV_MAX_LAYERS * 2);
+
+        // Lowest first; surfaces a step apart or less are one surface
+        float *kept = &grid->surfaceY[cell * NAV_MAX_LAYERS];
+        int keptCount = 0;
+        for (int i = 0; i < foundCount; i++) {
+            if (keptCount > 0 && found[i] - kept[keptCount - 1] < NAV_SURFACE_MERGE) {
+                kept[keptCount - 1] = found[i];
+            } else if (keptCount < NAV_MAX_LAYERS) {
+                kept[keptCount++] = found[i];
+            }
+        }
+        grid->layerCount[cell] = (unsigned char)keptCount;
+    }
+}
+
+void navGridBuildLinks(NavGrid *grid, int row, NavStepFn canStep, void *context) {
+    for (int ix = 0; ix < grid->sizeX; ix++) {
+        int cell = row * grid->sizeX + ix;
+        for (int layer = 0; layer < grid->layerCount[cell]; layer++) {
+            int node = cell * NAV_MAX_LAYERS + layer;
+            float from[3];
+            navGridNodePosition(grid, node, from);
+
+            for (int d = 0; d < NAV_DIRECTIONS; d++) {
+                int nx = ix + DIRECTION_X[d];
+                int nz = row + DIRECTION_Z[d];
+                if (nx < 0 || nx >= grid->sizeX || nz < 0 || nz >= grid->sizeZ) continue;
+                int neighbour = nz * grid->sizeX + nx;
+
+                unsigned char mask = 0;
+                for (int other = 0; other < grid->layerCount[neighbour]; other++) {
+                    float to[3];
+                    navGridNodePosition(grid, neighbour * NAV_MAX_LAYERS + other, to);
+                    if (canStep(context, from, to)) mask |= (unsigned char)(1 << other);
+                }
+                grid->links[(size_t)node * NAV_DIRECTIONS + d] = mask;
+            }
+        }
+    }
+}
+
+int navGridNodeAt(const NavGrid *grid, float x, float y, float z, int searchCells) {
+    int cx = (int)floorf((x - grid->minX) / grid->cellSize);
+    int cz = (int)floorf((z - grid->minZ) / grid->cellSize);
+
+    int best = -1;
+    float bestScore = 0.0f;
+    for (int dz = -searchCells; dz <= searchCells; dz++) {
+        for (int dx = -searchCells; dx <= searchCells; dx++) {
+            int ix = cx + dx;
+            int iz = cz + dz;
+            if (ix < 0 || ix >= grid->sizeX || iz < 0 || iz >= grid->sizeZ) continue;
+
+            int cell = iz * grid->sizeX + ix;
+            float centerX, centerZ;
+            cellCenter(grid, cell, &centerX, &centerZ);
+            float across = sqrtf((centerX - x) * (centerX - x) + (centerZ - z) * (centerZ - z));
+            for (int layer = 0; layer < grid->layerCount[cell]; layer++) {
+                int node = cell * NAV_MAX_LAYERS + layer;
+                float score = across + fabsf(grid->surfaceY[node] - y) * NAV_PICK_HEIGHT_WEIGHT;
+                if (best < 0 || score < bestScore) {
+                    best = node;
+                    bestScore = score;
+                }
+            }
+        }
+    }
+    return best;
+}
+
+// ============================================
+// A* SEARCH
+// ============================================
+
+static bool reserveSearch(NavSearch *search, int nodeCount) {
+    if (nodeCount <= search->nodeCapacity) return true;
+
+    float *cost = realloc(search->cost, sizeof(float) * nodeCount);
+    if (!cost) return false;
+    search->cost = cost;
+    int *parent = realloc(search->parent, sizeof(int) * nodeCount);
+    if (!parent) return false;
+    search->parent = parent;
+    int *trail = realloc(search->trail, sizeof(int) * nodeCount);
+    if (!trail) return false;
+    search->trail = trail;
+    unsigned char *closed = realloc(search->closed, sizeof(unsigned char) * nodeCount);
+    if (!closed) return false;
+    search->closed = closed;
+
+    // Fresh stamps - nothing in the grown arrays counts as visited
+    unsigned int *visit = calloc((size_t)nodeCount, sizeof(unsigned int));
+    if (!visit) return false;
+    free(search->visit);
+    search->visit = visit;
+    search->stamp = 0;
+
+    search->nodeCapacity = nodeCount;
+    return true;
+}
+
+static bool heapPush(NavSearch *search, int *count, float priority, int node) {
+    if (*count >= search->heapCapacity) {
+        int capacity = search->heapCapacity > 0 ? search->heapCapacity * 2 : 1024;
+        struct NavHeapEntry *heap = realloc(search->heap, sizeof(struct NavHeapEntry) * capacity);
+        if (!heap) return false;
+        search->heap = heap;
+        search->heapCapacity = capacity;
+    }
+
+    struct NavHeapEntry *heap = search->heap;
+    int i = (*count)++;
+    while (i > 0) {
+        int up = (i - 1) / 2;
+        if (heap[up].priority <= priority) break;
+        heap[i] = heap[up];
+        i = up;
+    }
+    heap[i].priority = priority;
+    heap[i].node = node;
+    return true;
+}
+
+static int heapPop(NavSearch *search, int *count) {
+    struct NavHeapEntry *heap = search->heap;
+    int top = heap[0].node;
+    struct NavHeapEntry last = heap[--(*count)];
+
+    int i = 0;
+    for (;;) {
+        int child = i * 2 + 1;
+        if (child >= *count) break;
+        if (child + 1 < *count && heap[child + 1].priority < heap[child].priority) child++;
+        if (heap[child].priority >= last.priority) break;
+        heap[i] = heap[child];
+        i = child;
+    }
+    heap[i] = last;
+    return top;
+}
+
+// Octile distance between two cells - never more than the cost of the cheapest path
+static float estimate(const NavGrid *grid, int cellA, int cellB) {
+    int dx = abs(cellA % grid->sizeX - cellB % grid->sizeX);
+    int dz = abs(cellA / grid->sizeX - cellB / grid->sizeX);
+    int straight = abs(dx - dz);
+    int diagonal = dx < dz ? dx : dz;
+    return ((float)straight + (float)diagonal * NAV_DIAGONAL) * grid->cellSize;
+}
+
+// First node of the neighbouring cell in direction d
+static int neighbourBase(const NavGrid *grid, int node, int d) {
+    int cell = node / NAV_MAX_LAYERS;
+    return (cell + DIRECTION_Z[d] * grid->sizeX + DIRECTION_X[d]) * NAV_MAX_LAYERS;
+}
+
+// Cost of the link from node to its neighbour next in direction d
+static float stepCost(const NavGrid *grid, int node, int next, int d) {
+    float step = (d < 4 ? 1.0f : NAV_DIAGONAL) * grid->cellSize;
+    if (grid->surfaceY[next] - grid->surfaceY[node] > NAV_CORNER_RISE) step += NAV_JUMP_PENALTY * grid->cellSize;
+    return step;
+}
+
+// Keep a node of the path when the way turns or climbs there
+static bool isCorner(const NavGrid *grid, int previous, int node, int next) {
+    int cell = node / NAV_MAX_LAYERS;
+    int inStep = cell - previous / NAV_MAX_LAYERS;
+    int outStep = next / NAV_MAX_LAYERS - cell;
+    if (inStep != outStep) return true;
+    return fabsf(grid->surfaceY[node] - grid->surfaceY[previous]) > NAV_CORNER_RISE ||
+           fabsf(grid->surfaceY[next] - grid->surfaceY[node]) > NAV_CORNER_RISE;
+}
+
+int navGridFindPath(const NavGrid *grid, NavSearch *search, int start, int goal,
+                    NavBlockedFn blocked, void *context, int maxExpansions,
+                    int *outNodes, int maxNodes) {
+    int nodeCount = grid->cellCount * NAV_MAX_LAYERS;
+    if (start < 0 || goal < 0 || start >= nodeCount || goal >= nodeCount) return -1;
+    if (start == goal) return 0;
+    if (!reserveSearch(search, nodeCount)) return -1;
+
+    // New stamp - every node's cost and parent from earlier searches goes stale at once
+    if (++search->stamp == 0) {
+        memset(search->visit, 0, sizeof(unsigned int) * nodeCount);
+        search->stamp = 1;
+    }
+    unsigned int stamp = search->stamp;
+    int goalCell = goal / NAV_MAX_LAYERS;
+
+    int open = 0;
+    search->visit[start] = stamp;
+    search->cost[start] = 0.0f;
+    search->parent[start] = -1;
+    search->closed[start] = 0;
+    if (!heapPush(search, &open, estimate(grid, start / NAV_MAX_LAYERS, goalCell), start)) return -1;
+
+    bool found = false;
+    int expansions = 0;
+    while (open > 0) {
+        int node = heapPop(search, &open);
+        if (search->closed[node]) continue;        // Stale entry - reached cheaper since
+        if (node == goal) {
+            found = true;
+            break;
+        }
+        if (++expansions > maxExpansions) break;
+        search->closed[node] = 1;
+
+        for (int d = 0; d < NAV_DIRECTIONS; d++) {
+            unsigned int mask = grid->links[(size_t)node * NAV_DIRECTIONS + d];
+            for (int layer = 0; mask; layer++, mask >>= 1) {
+                if (!(mask & 1)) continue;
+                int next = neighbourBase(grid, node, d) + layer;
+                if (search->visit[next] == stamp && search->closed[next]) continue;
+
+                float position[3];
+                navGridNodePosition(grid, next, position);
+                if (blocked && blocked(context, position)) continue;
+
+                float cost = search->cost[node] + stepCost(grid, node, next, d);
+                if (search->visit[next] == stamp && cost >= search->cost[next]) continue;
+
+                search->visit[next] = stamp;
+                search->cost[next] = cost;
+                search->parent[next] = node;
+                search->closed[next] = 0;
+                if (!heapPush(search, &open, cost + estimate(grid, next / NAV_MAX_LAYERS, goalCell), next)) {
+                    return -1;
+                }
+            }
+        }
+    }
+    if (!found) return -1;
+
+    // Walk back from the goal, then write the corners start to goal
+    int length = 0;
+    for (int node = goal; node >= 0; node = search->parent[node]) {
+        search->trail[length++] = node;
+    }
+
+    int written = 0;
+    for (int i = length - 2; i >= 0 && written < maxNodes; i--) {
+        int node = search->trail[i];
+        if (i == 0 || isCorner(grid, search->trail[i + 1], node, search->trail[i - 1])) {
+            outNodes[written++] = node;
+        }
+    }
+    return written;
+}
+
+void navSearchFree(NavSearch *search) {
+    free(search->cost);
+    free(search->parent);
+    free(search->visit);
+    free(search->closed);
+    free(search->heap);
+    free(search->trail);
+    memset(search, 0, sizeof(*search));
+}
+
+// ============================================
+// FLOW FIELDS
+// ============================================
+
+// Flow field link costs in whole units (a straight step is NAV_FLOW_STRAIGHT), so the open
+// list can be a ring of buckets, one per cost, instead of a heap
+#define NAV_FLOW_STRAIGHT 5
+#define NAV_FLOW_DIAGONAL 7
+#define NAV_FLOW_JUMP 5
+#define NAV_FLOW_BUCKETS (NAV_FLOW_DIAGONAL + NAV_FLOW_JUMP + 1)
+
+// Bucket lists are doubly linked through the search's parent (next) and trail (previous)
+// arrays, so a node whose cost drops moves bucket in O(1)
+static void bucketInsert(NavSearch *search, int *heads, int node, int cost) {
+    int *head = &heads[cost % NAV_FLOW_BUCKETS];
+    search->parent[node] = *head;
+    search->trail[node] = -1;
+    if (*head >= 0) search->trail[*head] = node;
+    *head = node;
+}
+
+static void bucketRemove(NavSearch *search, int *heads, int node, int cost) {
+    int next = search->parent[node];
+    int previous = search->trail[node];
+    if (previous >= 0) search->parent[previous] = next;
+    else heads[cost % NAV_FLOW_BUCKETS] = next;
+    if (next >= 0) search->trail[next] = previous;
+}
+
+bool navFlowFieldBuild(const NavGrid *grid, NavFlowField *field, NavSearch *search, int goal,
+                       NavBlockedFn blocked, void *context) {
+    int nodeCount = grid->cellCount * NAV_MAX_LAYERS;
+    if (nodeCount > field->nodeCapacity) {
+        unsigned char *step = realloc(field->step, (size_t)nodeCount);
+        if (!step) return false;
+        field->step = step;
+        field->nodeCapacity = nodeCount;
+    }
+    memset(field->step, NAV_NO_STEP, (size_t)nodeCount);
+    field->goal = goal;
+    if (goal < 0 || goal >= nodeCount) return true;
+    if (!reserveSearch(search, nodeCount)) return false;
+
+    if (++search->stamp == 0) {
+        memset(search->visit, 0, sizeof(unsigned int) * nodeCount);
+        search->stamp = 1;
+    }
+    unsigned int stamp = search->stamp;
+
+    // cost holds whole units here
+    int heads[NAV_FLOW_BUCKETS];
+    for (int b = 0; b < NAV_FLOW_BUCKETS; b++) heads[b] = -1;
+    search->visit[goal] = stamp;
+    search->cost[goal] = 0.0f;
+    search->closed[goal] = 0;
+    bucketInsert(search, heads, goal, 0);
+    int open = 1;
+
+    for (int current = 0; open > 0; current++) {
+        while (heads[current % NAV_FLOW_BUCKETS] >= 0) {
+            int node = heads[current % NAV_FLOW_BUCKETS];
+            bucketRemove(search, heads, node, current);
+            open--;
+            search->closed[node] = 1;
+
+            // Nodes in the cell behind each direction that link forward onto this one
+            int cell = node / NAV_MAX_LAYERS;
+            int layerBit = 1 << (node % NAV_MAX_LAYERS);
+            int ix = cell % grid->sizeX;
+            int iz = cell / grid->sizeX;
+            for (int d = 0; d < NAV_DIRECTIONS; d++) {
+                int px = ix - DIRECTION_X[d];
+                int pz = iz - DIRECTION_Z[d];
+                if (px < 0 || px >= grid->sizeX || pz < 0 || pz >= grid->sizeZ) continue;
+                int previousCell = pz * grid->sizeX + px;
+
+                for (int layer = 0; layer < grid->layerCount[previousCell]; layer++) {
+                    int previous = previousCell * NAV_MAX_LAYERS + layer;
+                    if (!(grid->links[(size_t)previous * NAV_DIRECTIONS + d] & layerBit)) continue;
+                    bool queued = search->visit[previous] == stamp;
+                    if (queued && search->closed[previous]) continue;
+
+                    int cost = current + (d < 4 ? NAV_FLOW_STRAIGHT : NAV_FLOW_DIAGONAL);
+                    if (grid->surfaceY[node] - grid->surfaceY[previous] > NAV_CORNER_RISE) cost += NAV_FLOW_JUMP;
+                    if (queued && cost >= (int)search->cost[previous]) continue;
+
+                    if (!queued) {
+                        float position[3];
+                        navGridNodePosition(grid, previous, position);
+                        if (blocked && blocked(context, position)) {
+                            search->visit[previous] = stamp;    // Closed for good
+                            search->closed[previous] = 1;
+                            continue;
+                        }
+                        open++;
+                    } else {
+                        bucketRemove(search, heads, previous, (int)search->cost[previous]);
+                    }
+
+                    search->visit[previous] = stamp;
+                    search->cost[previous] = (float)cost;
+                    search->closed[previous] = 0;
+                    field->step[previous] = (unsigned char)(d * NAV_MAX_LAYERS + node % NAV_MAX_LAYERS);
+                    bucketInsert(search, heads, previous, cost);
+                }
+            }
+        }
+    }
+    return true;
+}
+
+int navFlowFieldAhead(const NavGrid *grid, const NavFlowField *field, int node, int maxSteps) {
+    if (!field->step || node < 0 || node >= field->nodeCapacity) return node;
+
+    int first = field->step[node];
+    if (first == NAV_NO_STEP) return node;
+    for (int i = 0; i < maxSteps; i++) {
+        int step = field->step[node];
+        if (step == NAV_NO_STEP) break;
+        int next = neighbourBase(grid, node, step / NAV_MAX_LAYERS) + step % NAV_MAX_LAYERS;
+
+        // Stop at the first turn, and at a jump or drop (it's the spot to jump from or to)
+        if (i > 0 && (step / NAV_MAX_LAYERS != first / NAV_MAX_LAYERS ||
+                      fabsf(grid->surfaceY[next] - grid->surfaceY[node]) > NAV_CORNER_RISE)) {
+            break;
+        }
+        node = next;
+    }
+    return node;
+}
+
+void navFlowFieldFree(NavFlowField *field) {
+    free(field->step);
+    memset(field, 0, sizeof(*field));
+    field->goal = -1;
+}
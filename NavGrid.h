@@ -0,0 +1,118 @@
+// NavGrid.h - Baked walkable grid, A* path search and flow fields for bot navigation
+#ifndef NAVGRID_H
+#define NAVGRID_H
+
+#include <stdbool.h>
+
+// Walkable surfaces kept per cell (floor, second floor, stair step, catwalk, ...)
+#define NAV_MAX_LAYERS 4
+
+// Neighbours per node - 4 straight, then 4 diagonal
+#define NAV_DIRECTIONS 8
+
+// Flow field step for a node that can't reach the goal (or is the goal)
+#define NAV_NO_STEP 0xFF
+
+// ============================================
+// NAV GRID TYPES
+// ============================================
+
+// Standable surfaces at (x, z) for the build, lowest first. Returns how many were written
+// (at most maxSurfaces).
+typedef int (*NavSurfacesFn)(void *context, float x, float z, float *outY, int maxSurfaces);
+
+// Movement test for the build - returns true if a body standing at from (feet) can walk,
+// jump up or drop down to to
+typedef bool (*NavStepFn)(void *context, const float from[3], const float to[3]);
+
+// Search-time filter - returns true if a body may not stand at position (feet)
+typedef bool (*NavBlockedFn)(void *context, const float position[3]);
+
+// Uniform XZ grid. A node is one walkable surface in one cell: node = cell * NAV_MAX_LAYERS
+// + layer. Each node stores, per direction, which layers of the neighbouring cell it links to.
+typedef struct {
+    float minX, minZ;
+    float cellSize;
+    int sizeX, sizeZ;
+    int cellCount;
+    unsigned char *layerCount;  // Per cell
+    float *surfaceY;            // NAV_MAX_LAYERS per cell, lowest first
+    unsigned char *links;       // NAV_DIRECTIONS per node: bit l set links to neighbour layer l
+} NavGrid;
+
+// A* scratch - one per thread, grown on first use to the grid's node count
+typedef struct {
+    float *cost;                // Best cost found so far, per node
+    int *parent;                // Node reached from, per node
+    unsigned int *visit;        // Search stamp that set cost/parent (stale otherwise), per node
+    unsigned char *closed;      // Expanded in the search stamped visit
+    int nodeCapacity;
+    struct NavHeapEntry *heap;  // Open list (binary heap, lazy decrease-key)
+    int heapCapacity;
+    int *trail;                 // Nodes from goal back to start while building the result
+    unsigned int stamp;
+} NavSearch;
+
+// Every node's next step toward one goal node - built in one sweep, looked up in O(1)
+typedef struct {
+    unsigned char *step;        // Per node: direction * NAV_MAX_LAYERS + neighbour layer, or NAV_NO_STEP
+    int nodeCapacity;
+    int goal;                   // Goal node of the last build, -1 before the first
+} NavFlowField;
+
+// ============================================
+// NAV GRID FUNCTIONS
+// ============================================
+
+// Allocate an empty grid (no surfaces, no links) covering [minX,maxX] x [minZ,maxZ].
+// Returns false on bad size or no memory.
+bool navGridInit(NavGrid *grid, float minX, float minZ, float maxX, float maxZ, float cellSize);
+
+// Release all memory held by the grid
+void navGridFree(NavGrid *grid);
+
+// Check the size, per-cell layer counts and that every link names an existing neighbour
+// layer. For grids not made by navGridInit and the builders (e.g. read back from a file).
+bool navGridValidate(const NavGrid *grid);
+
+// Fill one row of cells (fixed z) with their surfaces. Rows touch disjoint memory, so
+// different rows may be built on different threads.
+void navGridBuildSurfaces(NavGrid *grid, int row, NavSurfacesFn surfaces, void *context);
+
+// Link one row of nodes to every neighbouring surface canStep accepts - every row's
+// surfaces must be built first
+void navGridBuildLinks(NavGrid *grid, int row, NavStepFn canStep, void *context);
+
+// Node nearest (x, y, z) among the cells up to searchCells away from the one under (x, z),
+// height differences counting double. -1 if there is nothing in range.
+int navGridNodeAt(const NavGrid *grid, float x, float y, float z, int searchCells);
+
+// Feet position of a node - the cell center at its surface
+void navGridNodePosition(const NavGrid *grid, int node, float out[3]);
+
+// A* from start to goal over the links, skipping nodes that blocked rejects (never start;
+// blocked may be NULL). Gives up after maxExpansions nodes. Writes the path's corner
+// nodes - start left out, goal last, straight runs merged - to outNodes, up to maxNodes.
+// Returns the count written (0 when start == goal), or -1 when there is no path or the
+// search gave up.
+int navGridFindPath(const NavGrid *grid, NavSearch *search, int start, int goal,
+                    NavBlockedFn blocked, void *context, int maxExpansions,
+                    int *outNodes, int maxNodes);
+
+// Release the search scratch
+void navSearchFree(NavSearch *search);
+
+// Dijkstra out from goal over the links backwards, so every node that can reach the goal
+// gets the first step of its cheapest way there (navGridFindPath's costs, in fifths of a step).
+// Nodes that blocked rejects are never stepped onto. Returns false if out of memory.
+bool navFlowFieldBuild(const NavGrid *grid, NavFlowField *field, NavSearch *search, int goal,
+                       NavBlockedFn blocked, void *context);
+
+// Node to head for from node: the field's steps followed while they keep the same direction
+// and height, up to maxSteps. Returns node itself when it has no step.
+int navFlowFieldAhead(const NavGrid *grid, const NavFlowField *field, int node, int maxSteps);
+
+// Release the field
+void navFlowFieldFree(NavFlowField *field);
+
+#endif // NAVGRID_H
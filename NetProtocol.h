@@ -0,0 +1,159 @@
+// NetProtocol.h - LAN multiplayer wire format shared by the game client and the dedicated server
+#ifndef NETPROTOCOL_H
+#define NETPROTOCOL_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <arpa/inet.h>
+
+// Network configuration
+static const uint16_t NET_DEFAULT_PORT = 7777;
+static const uint16_t NET_DISCOVERY_PORT = 7778;
+enum {
+    NET_MAX_PLAYERS = 8,
+    NET_MAX_PACKET_SIZE = 512,
+};
+static const double NET_STATE_UPDATE_INTERVAL = 1.0 / 60.0;  // 60 Hz
+static const double NET_DISCOVERY_INTERVAL = 1.0;  // 1 Hz for discovery broadcasts
+
+// The host (or dedicated server) is always player 1, clients start at 2
+enum { NET_HOST_PLAYER_ID = 1 };
+
+// ConnectAccept hostFlags
+enum {
+    NET_HOST_AUTHORITATIVE = 1 << 0,  // Host simulates every player from their inputs (dedicated server)
+};
+
+// Magic number for packet validation
+static const uint32_t NET_MAGIC = 0x46505347;  // "FPSG"
+
+// Packet types
+typedef enum {
+    PacketTypeStateUpdate = 0,  // Player position/rotation (UDP, unreliable)
+    PacketTypeShoot = 1,        // Player fired weapon (TCP, reliable)
+    PacketTypeHit = 2,          // Player was hit (TCP, reliable)
+    PacketTypeKill = 3,         // Player was killed (TCP, reliable, KillPacket)
+    PacketTypeRespawn = 4,      // Player respawned (TCP, reliable)
+    PacketTypeLobby = 5,        // Lobby management (TCP, reliable)
+    PacketTypeDiscovery = 6,    // LAN discovery broadcast
+    PacketTypeDiscoveryResponse = 7,  // Response to discovery
+    PacketTypeConnect = 8,      // Client connection request
+    PacketTypeConnectAccept = 9,  // Host accepts connection
+    PacketTypeDisconnect = 10,  // Player disconnecting
+    PacketTypePing = 11,        // Ping for latency measurement
+    PacketTypePong = 12,        // Pong response
+    PacketTypeGameStart = 13,   // Host signals game start
+    PacketTypeInput = 14        // Player's controls for one tick (UDP, unreliable, authoritative hosts only)
+} PacketType;
+
+#pragma pack(push, 1)
+
+// Every TCP and UDP message starts with this header (both fields in network byte order)
+typedef struct {
+    uint32_t magic;
+    uint16_t length;            // Payload bytes after the header
+} PacketHeader;
+
+// Player network state - packed for efficient transmission
+typedef struct {
+    uint32_t playerId;
+    float posX, posY, posZ;
+    float camYaw, camPitch;
+    uint8_t isShooting;
+    int32_t health;
+} PlayerNetState;
+
+// Game packet structure
+typedef struct {
+    uint8_t packetType;
+    uint32_t sequence;
+    PlayerNetState player;
+} GamePacket;
+
+// A player was killed, and by whom
+typedef struct {
+    uint8_t packetType;
+    uint32_t victimId;
+    uint32_t killerId;
+} KillPacket;
+
+// Controls for one tick, sent instead of state updates to an authoritative host. Buttons are
+// SimButton bits. The host queues them and runs each for one tick, in order; its state updates
+// carry the sequence of the input each player's tick ran.
+typedef struct {
+    uint8_t packetType;
+    uint32_t sequence;
+    uint32_t playerId;
+    uint16_t buttons;
+    int8_t weaponSlot;          // WeaponType to switch to, or -1
+    float yaw, pitch;
+    uint8_t active;
+} InputPacket;
+
+// Discovery packet for LAN broadcast
+typedef struct {
+    uint8_t packetType;
+    char serverName[32];
+    uint8_t currentPlayers;
+    uint8_t maxPlayers;
+    uint16_t port;
+} DiscoveryPacket;
+
+// Connection packet for handshake
+typedef struct {
+    uint8_t packetType;
+    uint32_t playerId;
+    char playerName[32];
+    uint8_t hostFlags;          // NET_HOST_* bits (ConnectAccept)
+} ConnectionPacket;
+
+#pragma pack(pop)
+
+// ============================================
+// FRAMING
+// ============================================
+
+// Header and payload into buffer. Returns the message length, or 0 if it doesn't fit.
+static inline size_t netEncodeMessage(uint8_t *buffer, size_t capacity, const void *payload, size_t length) {
+    if (length > UINT16_MAX || sizeof(PacketHeader) + length > capacity) return 0;
+
+    PacketHeader header;
+    header.magic = htonl(NET_MAGIC);
+    header.length = htons((uint16_t)length);
+    memcpy(buffer, &header, sizeof(header));
+    memcpy(buffer + sizeof(header), payload, length);
+    return sizeof(header) + length;
+}
+
+// Payload length from the header at the start of data, or -1 if there isn't a whole header
+// or its magic is wrong. The payload itself may not all have arrived yet.
+static inline int netDecodeHeader(const uint8_t *data, size_t available) {
+    if (available < sizeof(PacketHeader)) return -1;
+
+    PacketHeader header;
+    memcpy(&header, data, sizeof(header));
+    if (ntohl(header.magic) != NET_MAGIC) return -1;
+    return ntohs(header.length);
+}
+
+// One datagram holding a state update into packet. Returns false if it isn't one.
+static inline bool netDecodeStateUpdate(const uint8_t *data, size_t available, GamePacket *packet) {
+    int length = netDecodeHeader(data, available);
+    if (length < (int)sizeof(GamePacket) || available < sizeof(PacketHeader) + sizeof(GamePacket)) return false;
+
+    memcpy(packet, data + sizeof(PacketHeader), sizeof(*packet));
+    return packet->packetType == PacketTypeStateUpdate;
+}
+
+// One datagram holding an input packet into packet. Returns false if it isn't one.
+static inline bool netDecodeInput(const uint8_t *data, size_t available, InputPacket *packet) {
+    int length = netDecodeHeader(data, available);
+    if (length < (int)sizeof(InputPacket) || available < sizeof(PacketHeader) + sizeof(InputPacket)) return false;
+
+    memcpy(packet, data + sizeof(PacketHeader), sizeof(*packet));
+    return packet->packetType == PacketTypeInput;
+}
+
+#endif // NETPROTOCOL_H
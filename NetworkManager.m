@@ -1,5 +1,6 @@
 // NetworkManager.m - Core networking implementation for LAN multiplayer
 #import "NetworkManager.h"
+#import "SimProfile.h"
 
 #include <sys/socket.h>
 #include <sys/types.h>
@@ -13,17 +14,6 @@
 #include <ifaddrs.h>
 #include <net/if.h>
 
-// Magic number for packet validation
-static const uint32_t NET_MAGIC = 0x46505347;  // "FPSG"
-
-// Internal packet header
-#pragma pack(push, 1)
-typedef struct {
-    uint32_t magic;
-    uint16_t length;
-} PacketHeader;
-#pragma pack(pop)
-
 @implementation DiscoveredHost
 @end
 
@@ -67,6 +57,7 @@ typedef struct {
 @property (nonatomic, readwrite) NetworkMode mode;
 @property (nonatomic, readwrite) ConnectionState connectionState;
 @property (nonatomic, readwrite) uint32_t localPlayerId;
+@property (nonatomic, readwrite) BOOL hostIsAuthoritative;
 @property (nonatomic, strong) NSMutableArray<RemotePlayer *> *mutableConnectedPlayers;
 @property (nonatomic, strong) NSMutableArray<DiscoveredHost *> *mutableDiscoveredHosts;
 
@@ -260,7 +251,7 @@ typedef struct {
 
     _mode = NetworkModeHost;
     _connectionState = ConnectionStateLobby;
-    _localPlayerId = 1;  // Host is always player 1
+    _localPlayerId = NET_HOST_PLAYER_ID;
 
     NSLog(@"NetworkManager: Host started on port %d", port);
     return YES;
@@ -507,6 +498,17 @@ typedef struct {
     [self sendUDPPacket:&packet length:sizeof(packet)];
 }
 
+- (uint32_t)sendInput:(InputPacket)input {
+    if (_mode != NetworkModeClient) return 0;
+
+    input.packetType = PacketTypeInput;
+    input.sequence = ++_sendSequence;
+    input.playerId = _localPlayerId;
+
+    [self sendUDPPacket:&input length:sizeof(input)];
+    return input.sequence;
+}
+
 - (void)sendShoot:(PlayerNetState)state {
     if (_mode == NetworkModeNone) return;
 
@@ -533,21 +535,20 @@ typedef struct {
     [self sendReliableGamePacket:&packet];
 }
 
-- (void)sendKill:(uint32_t)victimId {
+- (void)sendKill:(uint32_t)victimId killedBy:(uint32_t)killerId {
     if (_mode == NetworkModeNone) {
         NSLog(@"[NET] sendKill: mode is None, not sending");
         return;
     }
 
-    NSLog(@"[NET] sendKill: Sending kill packet for victim %u", victimId);
+    NSLog(@"[NET] sendKill: Sending kill packet for victim %u, killer %u", victimId, killerId);
 
-    GamePacket packet;
-    memset(&packet, 0, sizeof(packet));
+    KillPacket packet;
     packet.packetType = PacketTypeKill;
-    packet.sequence = ++_sendSequence;
-    packet.player.playerId = victimId;
+    packet.victimId = victimId;
+    packet.killerId = killerId;
 
-    [self sendReliableGamePacket:&packet];
+    [self sendReliablePayload:&packet length:sizeof(packet)];
 }
 
 - (void)sendRespawn:(PlayerNetState)state {
@@ -633,34 +634,42 @@ typedef struct {
 
             sendto(_udpSocket, _sendBuffer, totalLength, 0,
                    (struct sockaddr *)&addr, sizeof(addr));
+            SIM_PROFILE_COUNT(SimCounterPacketsSent, 1);
         }
     } else {
         // Send to host
         sendto(_udpSocket, _sendBuffer, totalLength, 0,
                (struct sockaddr *)&_hostAddress, sizeof(_hostAddress));
+        SIM_PROFILE_COUNT(SimCounterPacketsSent, 1);
     }
 }
 
 - (void)sendReliableGamePacket:(GamePacket *)packet {
+    [self sendReliablePayload:packet length:sizeof(GamePacket)];
+}
+
+- (void)sendReliablePayload:(const void *)payload length:(size_t)length {
     PacketHeader header;
     header.magic = htonl(NET_MAGIC);
-    header.length = htons(sizeof(GamePacket));
+    header.length = htons(length);
 
     memcpy(_sendBuffer, &header, sizeof(header));
-    memcpy(_sendBuffer + sizeof(header), packet, sizeof(GamePacket));
+    memcpy(_sendBuffer + sizeof(header), payload, length);
 
-    size_t totalLength = sizeof(header) + sizeof(GamePacket);
+    size_t totalLength = sizeof(header) + length;
 
     if (_mode == NetworkModeHost) {
         NSArray *players = [_mutableConnectedPlayers copy];
         for (RemotePlayer *player in players) {
             if (player.tcpSocket >= 0) {
                 send(player.tcpSocket, _sendBuffer, totalLength, 0);
+                SIM_PROFILE_COUNT(SimCounterPacketsSent, 1);
             }
         }
     } else {
         if (_tcpClientSocket >= 0) {
             send(_tcpClientSocket, _sendBuffer, totalLength, 0);
+            SIM_PROFILE_COUNT(SimCounterPacketsSent, 1);
         }
     }
 }
@@ -676,6 +685,7 @@ typedef struct {
     memcpy(_sendBuffer + sizeof(header), data, length);
 
     send(sock, _sendBuffer, sizeof(header) + length, 0);
+    SIM_PROFILE_COUNT(SimCounterPacketsSent, 1);
 }
 
 - (void)sendDisconnectToPlayer:(RemotePlayer *)player {
@@ -838,6 +848,7 @@ typedef struct {
                 uint8_t *payload = _recvBuffer + sizeof(PacketHeader);
 
                 if (received >= (ssize_t)(sizeof(PacketHeader) + length)) {
+                    SIM_PROFILE_COUNT(SimCounterPacketsReceived, 1);
                     [self handleTCPPacket:payload length:length fromPlayer:player socket:sock];
 
                     if (player) {
@@ -879,6 +890,7 @@ typedef struct {
 
                 if (received >= (ssize_t)(sizeof(PacketHeader) + length) && length >= sizeof(GamePacket)) {
                     GamePacket *packet = (GamePacket *)payload;
+                    SIM_PROFILE_COUNT(SimCounterPacketsReceived, 1);
                     [self handleUDPGamePacket:packet fromAddress:&senderAddr];
                 }
             }
@@ -953,9 +965,11 @@ typedef struct {
             if (_mode == NetworkModeClient && length >= sizeof(ConnectionPacket)) {
                 ConnectionPacket *packet = (ConnectionPacket *)data;
                 _localPlayerId = packet->playerId;
+                _hostIsAuthoritative = (packet->hostFlags & NET_HOST_AUTHORITATIVE) != 0;
                 _connectionState = ConnectionStateConnected;
 
-                NSLog(@"NetworkManager: Connected to server, assigned player ID %u", _localPlayerId);
+                NSLog(@"NetworkManager: Connected to server, assigned player ID %u%@", _localPlayerId,
+                      _hostIsAuthoritative ? @" (authoritative host)" : @"");
 
                 if ([_delegate respondsToSelector:@selector(networkManagerDidConnect:withPlayerId:)]) {
                     [_delegate networkManagerDidConnect:self withPlayerId:_localPlayerId];
@@ -971,7 +985,7 @@ typedef struct {
                 if (length >= sizeof(GamePacket)) {
                     GamePacket *disconnectPacket = (GamePacket *)data;
                     uint32_t disconnectedPlayerId = disconnectPacket->player.playerId;
-                    if (disconnectedPlayerId == 1) {
+                    if (disconnectedPlayerId == NET_HOST_PLAYER_ID) {
                         // Host disconnected
                         [self handleHostDisconnect];
                     } else {
@@ -989,6 +1003,14 @@ typedef struct {
             }
             break;
 
+        case PacketTypeKill:
+            if (length >= sizeof(KillPacket)) {
+                KillPacket packet;
+                memcpy(&packet, data, sizeof(packet));
+                [self handleKillPacket:&packet];
+            }
+            break;
+
         case PacketTypePing:
             [self handlePingFromSocket:sock];
             break;
@@ -1044,6 +1066,11 @@ typedef struct {
                 break;
             }
         }
+    } else if (_hostIsAuthoritative && playerId == _localPlayerId) {
+        // Our own player as the host simulated it, with the input it had reached
+        if ([_delegate respondsToSelector:@selector(networkManager:didReceiveServerState:forInput:)]) {
+            [_delegate networkManager:self didReceiveServerState:packet->player forInput:packet->sequence];
+        }
     } else {
         // Client received state from another player (relayed by host)
         if ([_delegate respondsToSelector:@selector(networkManager:didReceiveStateUpdate:fromPlayer:)]) {
@@ -1052,6 +1079,17 @@ typedef struct {
     }
 }
 
+- (void)handleKillPacket:(const KillPacket *)packet {
+    NSLog(@"[NET] Received kill packet: victim=%u, killer=%u", packet->victimId, packet->killerId);
+
+    if ([_delegate respondsToSelector:@selector(networkManager:didReceiveKill:killedBy:)]) {
+        [_delegate networkManager:self didReceiveKill:packet->victimId killedBy:packet->killerId];
+    }
+    if (_mode == NetworkModeHost) {
+        [self relayReliablePayload:packet length:sizeof(*packet) exceptPlayer:packet->victimId];
+    }
+}
+
 - (void)handleReliableGamePacket:(GamePacket *)packet fromPlayer:(RemotePlayer *)player {
     uint32_t playerId = packet->player.playerId;
 
@@ -1079,21 +1117,6 @@ typedef struct {
             break;
         }
 
-        case PacketTypeKill: {
-            uint32_t victimId = packet->player.playerId;
-            uint32_t killerId = _localPlayerId;  // The receiver is the killer
-
-            NSLog(@"[NET] Received kill packet: victim=%u, killer=%u (local)", victimId, killerId);
-
-            if ([_delegate respondsToSelector:@selector(networkManager:didReceiveKill:killedBy:)]) {
-                [_delegate networkManager:self didReceiveKill:victimId killedBy:killerId];
-            }
-            if (_mode == NetworkModeHost) {
-                [self relayReliablePacketToOtherPlayers:packet exceptPlayer:victimId];
-            }
-            break;
-        }
-
         case PacketTypeRespawn:
             if ([_delegate respondsToSelector:@selector(networkManager:didReceiveRespawn:atPosition:)]) {
                 [_delegate networkManager:self didReceiveRespawn:playerId atPosition:packet->player];
@@ -1139,17 +1162,21 @@ typedef struct {
 }
 
 - (void)relayReliablePacketToOtherPlayers:(GamePacket *)packet exceptPlayer:(uint32_t)excludeId {
+    [self relayReliablePayload:packet length:sizeof(GamePacket) exceptPlayer:excludeId];
+}
+
+- (void)relayReliablePayload:(const void *)payload length:(size_t)length exceptPlayer:(uint32_t)excludeId {
     PacketHeader header;
     header.magic = htonl(NET_MAGIC);
-    header.length = htons(sizeof(GamePacket));
+    header.length = htons(length);
 
     memcpy(_sendBuffer, &header, sizeof(header));
-    memcpy(_sendBuffer + sizeof(header), packet, sizeof(GamePacket));
+    memcpy(_sendBuffer + sizeof(header), payload, length);
 
     NSArray *players = [_mutableConnectedPlayers copy];
     for (RemotePlayer *player in players) {
         if (player.playerId != excludeId && player.tcpSocket >= 0) {
-            send(player.tcpSocket, _sendBuffer, sizeof(header) + sizeof(GamePacket), 0);
+            send(player.tcpSocket, _sendBuffer, sizeof(header) + length, 0);
         }
     }
 }
@@ -1241,7 +1268,7 @@ typedef struct {
     } else {
         if (_tcpClientSocket >= 0) {
             send(_tcpClientSocket, buffer, sizeof(buffer), 0);
-            _pingSendTimes[@(1)] = @(now);  // Ping to host (ID 1)
+            _pingSendTimes[@(NET_HOST_PLAYER_ID)] = @(now);  // Ping to host
         }
     }
 }
@@ -1312,6 +1339,7 @@ typedef struct {
     _mode = NetworkModeNone;
     _connectionState = ConnectionStateDisconnected;
     _localPlayerId = 0;
+    _hostIsAuthoritative = NO;
     _sendSequence = 0;
     _isDiscovering = NO;
 }
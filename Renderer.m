@@ -7,13 +7,12 @@
 #import "Collision.h"
 #import "DoorSystem.h"
 #import "SoundManager.h"
-#import "Combat.h"
-#import "Enemy.h"
 #import "GeometryBuilder.h"
 #import "MultiplayerController.h"
 #import "PickupSystem.h"
 #import "WeaponSystem.h"
 #import "CollisionWorld.h"
+#import "SimProfile.h"
 
 @interface MetalRenderer ()
 @property (nonatomic, strong) id<MTLRenderPipelineState> pipelineState;
@@ -105,6 +104,7 @@
         view.camYaw = M_PI;
         view.camPitch = 0.0;
         view.controlsActive = YES;
+        view.wantsWeaponSlot = -1;
         view.onGround = YES;
         view.velocityY = 0;
         CGAssociateMouseAndMouseCursorPosition(false);
@@ -232,10 +232,13 @@
     MTLRenderPassDescriptor *passDescriptor = view.currentRenderPassDescriptor;
     if (!passDescriptor) return;
 
+    SIM_PROFILE_ZONE("frame");
     GameState *state = [GameState shared];
 
     // Update multiplayer network state
+    SIM_PROFILE_BEGIN(networkZone, "network send");
     [_metalView sendNetworkState];
+    SIM_PROFILE_END(networkZone);
 
     // Handle respawn teleport
     if (state.needsRespawnTeleport) {
@@ -252,145 +255,30 @@
         NSLog(@"[RENDERER] Teleported to respawn point");
     }
 
+    // Handle server correction - our prediction drifted from the authoritative host
+    if (state.needsServerCorrection) {
+        state.needsServerCorrection = NO;
+        _metalView.posX = state.correctionX;
+        _metalView.posY = state.correctionY;
+        _metalView.posZ = state.correctionZ;
+    }
+
     // ============================================
-    // PHYSICS SYSTEM - Proper collision order
-    // ============================================
-    // 1. Apply input to velocity
-    // 2. Apply gravity to velocity
-    // 3. Move player by velocity (with collision detection)
-    // 4. Resolve collisions and set onGround flag
+    // SIMULATION TICK
     // ============================================
+    // Player physics, door, shooting, bots, pickups and combat timers all run in
+    // simStep. The view owns the camera and keys; trigger timing and recoil stay here.
 
-    // Skip physics when paused
-    if (!state.gameOver && !state.isPaused) {
-
-        // --- STEP 1: Apply input acceleration ---
-        if (_metalView.controlsActive) {
-            float fwdX = sinf(_metalView.camYaw);
-            float fwdZ = -cosf(_metalView.camYaw);
-            float rgtX = cosf(_metalView.camYaw);
-            float rgtZ = sinf(_metalView.camYaw);
-
-            float strafeAccel = MOVE_ACCEL * STRAFE_MULTIPLIER;
-            if (_metalView.keyW) { _metalView.velocityX += fwdX * MOVE_ACCEL; _metalView.velocityZ += fwdZ * MOVE_ACCEL; }
-            if (_metalView.keyS) { _metalView.velocityX -= fwdX * MOVE_ACCEL; _metalView.velocityZ -= fwdZ * MOVE_ACCEL; }
-            if (_metalView.keyA) { _metalView.velocityX -= rgtX * strafeAccel; _metalView.velocityZ -= rgtZ * strafeAccel; }
-            if (_metalView.keyD) { _metalView.velocityX += rgtX * strafeAccel; _metalView.velocityZ += rgtZ * strafeAccel; }
-        }
-
-        // Clamp horizontal speed
-        float hSpeed = sqrtf(_metalView.velocityX * _metalView.velocityX + _metalView.velocityZ * _metalView.velocityZ);
-        if (hSpeed > MAX_SPEED) {
-            _metalView.velocityX *= MAX_SPEED / hSpeed;
-            _metalView.velocityZ *= MAX_SPEED / hSpeed;
-        }
-
-        // Apply friction to horizontal movement
-        _metalView.velocityX *= MOVE_FRICTION;
-        _metalView.velocityZ *= MOVE_FRICTION;
-
-        // --- STEP 2: Apply gravity ---
-        _metalView.velocityY -= GRAVITY;
-
-        // Clamp terminal velocity
-        if (_metalView.velocityY < -0.5f) _metalView.velocityY = -0.5f;
-
-        // Store original position for collision detection
-        float origX = _metalView.posX;
-        float origY = _metalView.posY;
-        float origZ = _metalView.posZ;
-
-        // --- STEP 3: Move player ---
-        _metalView.posX += _metalView.velocityX;
-        _metalView.posY += _metalView.velocityY;
-        _metalView.posZ += _metalView.velocityZ;
-
-        // --- STEP 4: Collision detection using CollisionWorld ---
-        CollisionWorld *collisionWorld = [CollisionWorld shared];
-        BOOL wasOnGround = _metalView.onGround;
-        _metalView.onGround = NO;
-
-        float px = _metalView.posX;
-        float py = _metalView.posY;
-        float pz = _metalView.posZ;
-        // --- GROUND DETECTION using CollisionWorld ---
-        GroundResult groundResult = [collisionWorld checkGroundAt:px y:py z:pz
-                                                     playerRadius:PLAYER_RADIUS
-                                                     playerHeight:PLAYER_HEIGHT];
-
-        // Apply ground collision
-        if (groundResult.onGround) {
-            _metalView.posY = groundResult.groundY + PLAYER_HEIGHT;
-            _metalView.velocityY = 0;
-            _metalView.onGround = YES;
-
-            // Auto-jump when holding space (bunny hop)
-            if (_metalView.keySpace) {
-                _metalView.velocityY = JUMP_VELOCITY;
-                _metalView.onGround = NO;
-
-                // Bhop acceleration - boost horizontal speed each hop
-                float hSpeed = sqrtf(_metalView.velocityX * _metalView.velocityX + _metalView.velocityZ * _metalView.velocityZ);
-                if (hSpeed > 0.01f && hSpeed < BHOP_MAX_SPEED) {
-                    float boost = fminf(BHOP_SPEED_BOOST, BHOP_MAX_SPEED / hSpeed);
-                    _metalView.velocityX *= boost;
-                    _metalView.velocityZ *= boost;
-                }
-            }
-        }
-
-        // Update position after ground snap
-        px = _metalView.posX;
-        py = _metalView.posY;
-        pz = _metalView.posZ;
-
-        // --- WALL COLLISION using CollisionWorld ---
-        simd_float3 playerPos = {px, py, pz};
-        simd_float3 playerVel = {_metalView.velocityX, _metalView.velocityY, _metalView.velocityZ};
-        MoveResult moveResult = [collisionWorld movePlayerFrom:playerPos
-                                                      velocity:playerVel
-                                                        radius:PLAYER_RADIUS
-                                                        height:PLAYER_HEIGHT];
-
-        if (moveResult.collided) {
-            _metalView.posX += moveResult.pushOut.x;
-            _metalView.posY += moveResult.pushOut.y;
-            _metalView.posZ += moveResult.pushOut.z;
-            _metalView.velocityX = moveResult.newVelocity.x;
-            _metalView.velocityY = moveResult.newVelocity.y;
-            _metalView.velocityZ = moveResult.newVelocity.z;
-
-            // Check if we landed on something
-            if (moveResult.pushOut.y > 0 && _metalView.velocityY == 0) {
-                _metalView.onGround = YES;
-            }
-        }
-
-        // --- Footstep sounds ---
-        float currentSpeed = sqrtf(_metalView.velocityX * _metalView.velocityX +
-                                   _metalView.velocityZ * _metalView.velocityZ);
-        if (_metalView.onGround && currentSpeed > 0.03f) {
-            state.footstepTimer++;
-            if (state.footstepTimer >= 20) {
-                state.footstepTimer = 0;
-                [[SoundManager shared] playFootstepSound];
-            }
-        } else {
-            state.footstepTimer = 12;
-        }
-
-    } // End of physics/collision block
-
-    simd_float3 camPos = {_metalView.posX, _metalView.posY, _metalView.posZ};
+    SimWorld *world = state.world;
+    SimPlayer *localPlayer = &world->players[0];
 
-    // Update door proximity
-    state.playerNearDoor = checkPlayerNearDoor(camPos);
+    // The view's position may have been changed outside the tick (respawn, restart)
+    localPlayer->position = simVec3(_metalView.posX, _metalView.posY, _metalView.posZ);
+    localPlayer->velocity = simVec3(_metalView.velocityX, _metalView.velocityY, _metalView.velocityZ);
+    localPlayer->onGround = _metalView.onGround;
 
     // Skip all game logic updates when paused
     if (!state.isPaused) {
-        // Animate door
-        updateDoorAnimation();
-
         // Gun recoil decay
         if (_metalView.gunRecoil > 0) {
             _metalView.gunRecoil *= 0.85f;
@@ -404,70 +292,114 @@
         BOOL shouldFire = _metalView.wantsClick || (_metalView.mouseHeld && _metalView.fireTimer == 0);
         _metalView.wantsClick = NO;
 
+        SimInput inputs[SIM_MAX_PLAYERS] = {{0}};
+        SimInput *input = &inputs[0];
+        input->active = _metalView.controlsActive;
+        input->weaponSlot = _metalView.wantsWeaponSlot;
+        input->yaw = _metalView.camYaw;
+        input->pitch = _metalView.camPitch;
+        if (_metalView.keyW) input->buttons |= SimButtonForward;
+        if (_metalView.keyS) input->buttons |= SimButtonBack;
+        if (_metalView.keyA) input->buttons |= SimButtonLeft;
+        if (_metalView.keyD) input->buttons |= SimButtonRight;
+        if (_metalView.keySpace) input->buttons |= SimButtonJump;
+        if (_metalView.wantsReload) input->buttons |= SimButtonReload;
+        if (_metalView.wantsUse) input->buttons |= SimButtonUse;
+        _metalView.wantsWeaponSlot = -1;
+        _metalView.wantsReload = NO;
+        _metalView.wantsUse = NO;
+
         if (shouldFire && _metalView.controlsActive && !state.gameOver) {
             _metalView.fireTimer = PLAYER_FIRE_RATE;
             _metalView.gunRecoil = 0.6f;
-            CombatHitResult hitResult = processPlayerShooting(camPos, _metalView.camYaw, _metalView.camPitch);
-
-            // In multiplayer, send hit notification if we hit the remote player
-            if (state.isMultiplayer && hitResult.type == HitResultRemotePlayer) {
-                NSLog(@"HIT DETECTED on remote player! Sending damage: %d", PVP_DAMAGE);
-                [[MultiplayerController shared] sendHitOnRemotePlayer:PVP_DAMAGE];
-            } else if (state.isMultiplayer) {
-                NSLog(@"Shot fired - hitType: %d, isMP: %d, remoteAlive: %d", hitResult.type, state.isMultiplayer, state.remotePlayerAlive);
-            }
+            input->buttons |= SimButtonFire;
         }
 
-        // Enemy AI
-        updateEnemyAI(camPos, _metalView.controlsActive);
-
-        // Update pickup system
-        PickupSystem *pickupSystem = [PickupSystem shared];
-        [pickupSystem updatePickups:1.0f];  // 1 frame delta
-
-        // Check for pickup collection
-        if (!state.gameOver) {
-            PickupResult result = [pickupSystem checkPlayerPickup:camPos];
-            if (result.collected) {
-                // Set notification based on pickup type
-                state.pickupNotificationTimer = 180;  // 3 seconds at 60fps
-                switch (result.type) {
-                    case PickupTypeHealthPack:
-                        state.pickupNotificationText = @"+50 HEALTH";
-                        break;
-                    case PickupTypeAmmoSmall:
-                        state.pickupNotificationText = @"+30 AMMO";
-                        break;
-                    case PickupTypeAmmoHeavy:
-                        state.pickupNotificationText = @"+10 HEAVY AMMO";
-                        break;
-                    case PickupTypeShotgun:
-                        state.pickupNotificationText = @"SHOTGUN ACQUIRED";
-                        break;
-                    case PickupTypeAssaultRifle:
-                        state.pickupNotificationText = @"ASSAULT RIFLE ACQUIRED";
-                        break;
-                    case PickupTypeRocketLauncher:
-                        state.pickupNotificationText = @"ROCKET LAUNCHER ACQUIRED";
-                        break;
-                    case PickupTypeArmor:
-                        state.pickupNotificationText = @"+50 ARMOR";
-                        break;
-                }
+        SIM_PROFILE_BEGIN(tickZone, "simulation tick");
+        [state stepWithInputs:inputs];
+        SIM_PROFILE_END(tickZone);
+
+        // An authoritative host runs the same tick from these controls
+        [[MultiplayerController shared] sendLocalInput:input];
+
+        _metalView.posX = localPlayer->position.x;
+        _metalView.posY = localPlayer->position.y;
+        _metalView.posZ = localPlayer->position.z;
+        _metalView.velocityX = localPlayer->velocity.x;
+        _metalView.velocityY = localPlayer->velocity.y;
+        _metalView.velocityZ = localPlayer->velocity.z;
+        _metalView.onGround = localPlayer->onGround;
+
+        // Present what happened this tick
+        SIM_PROFILE_BEGIN(eventsZone, "tick events");
+        for (int i = 0; i < world->eventCount; i++) {
+            const SimEvent *event = &world->events[i];
+            switch (event->type) {
+                case SimEventGunshot:
+                    [[SoundManager shared] playGunSound];
+                    break;
+                case SimEventEnemyGunshot:
+                    [[SoundManager shared] playEnemyGunSoundWithVolume:event->volume];
+                    break;
+                case SimEventFootstep:
+                    [[SoundManager shared] playFootstepSound];
+                    break;
+                case SimEventDoor:
+                    [[SoundManager shared] playDoorSound];
+                    break;
+                case SimEventPickup:
+                    [[SoundManager shared] playPickupSound];
+
+                    // Set notification based on pickup type
+                    state.pickupNotificationTimer = 180;  // 3 seconds at 60fps
+                    switch ((PickupType)event->value) {
+                        case PickupTypeHealthPack:
+                            state.pickupNotificationText = @"+50 HEALTH";
+                            break;
+                        case PickupTypeAmmoSmall:
+                            state.pickupNotificationText = @"+30 AMMO";
+                            break;
+                        case PickupTypeAmmoHeavy:
+                            state.pickupNotificationText = @"+10 HEAVY AMMO";
+                            break;
+                        case PickupTypeShotgun:
+                            state.pickupNotificationText = @"SHOTGUN ACQUIRED";
+                            break;
+                        case PickupTypeAssaultRifle:
+                            state.pickupNotificationText = @"ASSAULT RIFLE ACQUIRED";
+                            break;
+                        case PickupTypeRocketLauncher:
+                            state.pickupNotificationText = @"ROCKET LAUNCHER ACQUIRED";
+                            break;
+                        case PickupTypeArmor:
+                            state.pickupNotificationText = @"+50 ARMOR";
+                            break;
+                    }
+                    break;
+                case SimEventPlayerHit:
+                    // In multiplayer, send hit notification - the remote player applies the damage
+                    if (!world->players[event->target].isRemote) break;
+                    NSLog(@"HIT DETECTED on remote player! Sending damage: %d", event->amount);
+                    [[MultiplayerController shared] sendHitOnRemotePlayer:event->amount];
+                    break;
+                case SimEventPlayerKill:
+                    // The other players here are all remote - their kills come from the network
+                    break;
             }
         }
 
+        SIM_PROFILE_END(eventsZone);
+
         // Update pickup notification timer
         if (state.pickupNotificationTimer > 0) {
             state.pickupNotificationTimer--;
         }
-
-        // Update timers
-        updateCombatTimers();
-        updateHealthRegeneration();
     }
 
+    simd_float3 camPos = {_metalView.posX, _metalView.posY, _metalView.posZ};
+
     // Build matrices
+    SIM_PROFILE_BEGIN(worldZone, "draw world");
     CameraBasis camBasis = computeCameraBasis(_metalView.camYaw, _metalView.camPitch);
     float camX = _metalView.posX, camY = _metalView.posY, camZ = _metalView.posZ;
     float fx = camBasis.forward.x, fy = camBasis.forward.y, fz = camBasis.forward.z;
@@ -629,8 +561,9 @@
     float *enemyX = state.enemyX;
     float *enemyY = state.enemyY;
     float *enemyZ = state.enemyZ;
+    int enemyCount = state.enemyCount;
 
-    for (int e = 0; e < NUM_ENEMIES; e++) {
+    for (int e = 0; e < enemyCount; e++) {
         if (!enemyAlive[e]) continue;
 
         float edx = camPos.x - enemyX[e];
@@ -666,12 +599,12 @@
         float cd = WALL_DEPTH / 2.0f;
         simd_float3 w1Min = {WALL1_X - cw, FLOOR_Y, WALL1_Z - cd};
         simd_float3 w1Max = {WALL1_X + cw, FLOOR_Y + WALL_HEIGHT, WALL1_Z + cd};
-        RayHitResult w1Hit = rayIntersectAABB(camPos, enemyDir, w1Min, w1Max);
+        RayHitResult w1Hit = rayIntersectAABBSimd(camPos, enemyDir, w1Min, w1Max);
         if (w1Hit.hit && w1Hit.t > 0 && w1Hit.t < enemyDist) enemyVisible = NO;
 
         simd_float3 w2Min = {WALL2_X - cw, FLOOR_Y, WALL2_Z - cd};
         simd_float3 w2Max = {WALL2_X + cw, FLOOR_Y + WALL_HEIGHT, WALL2_Z + cd};
-        RayHitResult w2Hit = rayIntersectAABB(camPos, enemyDir, w2Min, w2Max);
+        RayHitResult w2Hit = rayIntersectAABBSimd(camPos, enemyDir, w2Min, w2Max);
         if (w2Hit.hit && w2Hit.t > 0 && w2Hit.t < enemyDist) enemyVisible = NO;
 
         // Check against house walls
@@ -683,38 +616,38 @@
 
         simd_float3 backMin = {HOUSE_X - hw - wt, FLOOR_Y, HOUSE_Z - hd - wt};
         simd_float3 backMax = {HOUSE_X + hw + wt, FLOOR_Y + wh, HOUSE_Z - hd};
-        RayHitResult backHit = rayIntersectAABB(camPos, enemyDir, backMin, backMax);
+        RayHitResult backHit = rayIntersectAABBSimd(camPos, enemyDir, backMin, backMax);
         if (backHit.hit && backHit.t > 0 && backHit.t < enemyDist) enemyVisible = NO;
 
         simd_float3 leftMin = {HOUSE_X - hw - wt, FLOOR_Y, HOUSE_Z - hd};
         simd_float3 leftMax = {HOUSE_X - hw, FLOOR_Y + wh, HOUSE_Z + hd + wt};
-        RayHitResult leftHit = rayIntersectAABB(camPos, enemyDir, leftMin, leftMax);
+        RayHitResult leftHit = rayIntersectAABBSimd(camPos, enemyDir, leftMin, leftMax);
         if (leftHit.hit && leftHit.t > 0 && leftHit.t < enemyDist) enemyVisible = NO;
 
         simd_float3 rightMin = {HOUSE_X + hw, FLOOR_Y, HOUSE_Z - hd};
         simd_float3 rightMax = {HOUSE_X + hw + wt, FLOOR_Y + wh, HOUSE_Z + hd + wt};
-        RayHitResult rightHit = rayIntersectAABB(camPos, enemyDir, rightMin, rightMax);
+        RayHitResult rightHit = rayIntersectAABBSimd(camPos, enemyDir, rightMin, rightMax);
         if (rightHit.hit && rightHit.t > 0 && rightHit.t < enemyDist) enemyVisible = NO;
 
         simd_float3 frontLeftMin = {HOUSE_X - hw, FLOOR_Y, HOUSE_Z + hd};
         simd_float3 frontLeftMax = {HOUSE_X - dw, FLOOR_Y + wh, HOUSE_Z + hd + wt};
-        RayHitResult frontLeftHit = rayIntersectAABB(camPos, enemyDir, frontLeftMin, frontLeftMax);
+        RayHitResult frontLeftHit = rayIntersectAABBSimd(camPos, enemyDir, frontLeftMin, frontLeftMax);
         if (frontLeftHit.hit && frontLeftHit.t > 0 && frontLeftHit.t < enemyDist) enemyVisible = NO;
 
         simd_float3 frontRightMin = {HOUSE_X + dw, FLOOR_Y, HOUSE_Z + hd};
         simd_float3 frontRightMax = {HOUSE_X + hw, FLOOR_Y + wh, HOUSE_Z + hd + wt};
-        RayHitResult frontRightHit = rayIntersectAABB(camPos, enemyDir, frontRightMin, frontRightMax);
+        RayHitResult frontRightHit = rayIntersectAABBSimd(camPos, enemyDir, frontRightMin, frontRightMax);
         if (frontRightHit.hit && frontRightHit.t > 0 && frontRightHit.t < enemyDist) enemyVisible = NO;
 
         simd_float3 aboveDoorMin = {HOUSE_X - dw, FLOOR_Y + DOOR_HEIGHT, HOUSE_Z + hd};
         simd_float3 aboveDoorMax = {HOUSE_X + dw, FLOOR_Y + wh, HOUSE_Z + hd + wt};
-        RayHitResult aboveDoorHit = rayIntersectAABB(camPos, enemyDir, aboveDoorMin, aboveDoorMax);
+        RayHitResult aboveDoorHit = rayIntersectAABBSimd(camPos, enemyDir, aboveDoorMin, aboveDoorMax);
         if (aboveDoorHit.hit && aboveDoorHit.t > 0 && aboveDoorHit.t < enemyDist) enemyVisible = NO;
 
         // Check against door
         simd_float3 doorMin, doorMax;
         getDoorAABB(&doorMin, &doorMax);
-        RayHitResult doorHit = rayIntersectAABB(camPos, enemyDir, doorMin, doorMax);
+        RayHitResult doorHit = rayIntersectAABBSimd(camPos, enemyDir, doorMin, doorMax);
         if (doorHit.hit && doorHit.t > 0 && doorHit.t < enemyDist) enemyVisible = NO;
 
         // Only draw health bar if enemy is visible
@@ -789,12 +722,12 @@
         float cd = WALL_DEPTH / 2.0f;
         simd_float3 w1Min = {WALL1_X - cw, FLOOR_Y, WALL1_Z - cd};
         simd_float3 w1Max = {WALL1_X + cw, FLOOR_Y + WALL_HEIGHT, WALL1_Z + cd};
-        RayHitResult w1Hit = rayIntersectAABB(camPos, rpDir, w1Min, w1Max);
+        RayHitResult w1Hit = rayIntersectAABBSimd(camPos, rpDir, w1Min, w1Max);
         if (w1Hit.hit && w1Hit.t > 0 && w1Hit.t < rpDist) rpVisible = NO;
 
         simd_float3 w2Min = {WALL2_X - cw, FLOOR_Y, WALL2_Z - cd};
         simd_float3 w2Max = {WALL2_X + cw, FLOOR_Y + WALL_HEIGHT, WALL2_Z + cd};
-        RayHitResult w2Hit = rayIntersectAABB(camPos, rpDir, w2Min, w2Max);
+        RayHitResult w2Hit = rayIntersectAABBSimd(camPos, rpDir, w2Min, w2Max);
         if (w2Hit.hit && w2Hit.t > 0 && w2Hit.t < rpDist) rpVisible = NO;
 
         // Check against house walls
@@ -806,38 +739,38 @@
 
         simd_float3 backMin = {HOUSE_X - hw - wt, FLOOR_Y, HOUSE_Z - hd - wt};
         simd_float3 backMax = {HOUSE_X + hw + wt, FLOOR_Y + wh, HOUSE_Z - hd};
-        RayHitResult backHit = rayIntersectAABB(camPos, rpDir, backMin, backMax);
+        RayHitResult backHit = rayIntersectAABBSimd(camPos, rpDir, backMin, backMax);
         if (backHit.hit && backHit.t > 0 && backHit.t < rpDist) rpVisible = NO;
 
         simd_float3 leftMin = {HOUSE_X - hw - wt, FLOOR_Y, HOUSE_Z - hd};
         simd_float3 leftMax = {HOUSE_X - hw, FLOOR_Y + wh, HOUSE_Z + hd + wt};
-        RayHitResult leftHit = rayIntersectAABB(camPos, rpDir, leftMin, leftMax);
+        RayHitResult leftHit = rayIntersectAABBSimd(camPos, rpDir, leftMin, leftMax);
         if (leftHit.hit && leftHit.t > 0 && leftHit.t < rpDist) rpVisible = NO;
 
         simd_float3 rightMin = {HOUSE_X + hw, FLOOR_Y, HOUSE_Z - hd};
         simd_float3 rightMax = {HOUSE_X + hw + wt, FLOOR_Y + wh, HOUSE_Z + hd + wt};
-        RayHitResult rightHit = rayIntersectAABB(camPos, rpDir, rightMin, rightMax);
+        RayHitResult rightHit = rayIntersectAABBSimd(camPos, rpDir, rightMin, rightMax);
         if (rightHit.hit && rightHit.t > 0 && rightHit.t < rpDist) rpVisible = NO;
 
         simd_float3 frontLeftMin = {HOUSE_X - hw, FLOOR_Y, HOUSE_Z + hd};
         simd_float3 frontLeftMax = {HOUSE_X - dw, FLOOR_Y + wh, HOUSE_Z + hd + wt};
-        RayHitResult frontLeftHit = rayIntersectAABB(camPos, rpDir, frontLeftMin, frontLeftMax);
+        RayHitResult frontLeftHit = rayIntersectAABBSimd(camPos, rpDir, frontLeftMin, frontLeftMax);
         if (frontLeftHit.hit && frontLeftHit.t > 0 && frontLeftHit.t < rpDist) rpVisible = NO;
 
         simd_float3 frontRightMin = {HOUSE_X + dw, FLOOR_Y, HOUSE_Z + hd};
         simd_float3 frontRightMax = {HOUSE_X + hw, FLOOR_Y + wh, HOUSE_Z + hd + wt};
-        RayHitResult frontRightHit = rayIntersectAABB(camPos, rpDir, frontRightMin, frontRightMax);
+        RayHitResult frontRightHit = rayIntersectAABBSimd(camPos, rpDir, frontRightMin, frontRightMax);
         if (frontRightHit.hit && frontRightHit.t > 0 && frontRightHit.t < rpDist) rpVisible = NO;
 
         simd_float3 aboveDoorMin = {HOUSE_X - dw, FLOOR_Y + DOOR_HEIGHT, HOUSE_Z + hd};
         simd_float3 aboveDoorMax = {HOUSE_X + dw, FLOOR_Y + wh, HOUSE_Z + hd + wt};
-        RayHitResult aboveDoorHit = rayIntersectAABB(camPos, rpDir, aboveDoorMin, aboveDoorMax);
+        RayHitResult aboveDoorHit = rayIntersectAABBSimd(camPos, rpDir, aboveDoorMin, aboveDoorMax);
         if (aboveDoorHit.hit && aboveDoorHit.t > 0 && aboveDoorHit.t < rpDist) rpVisible = NO;
 
         // Check against door
         simd_float3 doorMin, doorMax;
         getDoorAABB(&doorMin, &doorMax);
-        RayHitResult doorHit = rayIntersectAABB(camPos, rpDir, doorMin, doorMax);
+        RayHitResult doorHit = rayIntersectAABBSimd(camPos, rpDir, doorMin, doorMax);
         if (doorHit.hit && doorHit.t > 0 && doorHit.t < rpDist) rpVisible = NO;
 
         // Only draw health bar if remote player is visible
@@ -875,7 +808,10 @@
     [encoder setVertexBytes:&mvp length:sizeof(mvp) atIndex:1];
     [encoder drawPrimitives:MTLPrimitiveTypeLine vertexStart:0 vertexCount:_boxLineVertexCount];
 
+    SIM_PROFILE_END(worldZone);
+
     // Draw pause menu when paused
+    SIM_PROFILE_BEGIN(hudZone, "draw HUD and menus");
     if (state.showPauseMenu && !state.gameOver) {
         [encoder setRenderPipelineState:_bgPipelineState];
         [encoder setDepthStencilState:_bgDepthState];
@@ -1745,7 +1681,8 @@
 
         // Draw enemies as dots (single player mode)
         if (!state.isMultiplayer) {
-            for (int i = 0; i < NUM_ENEMIES; i++) {
+            int enemyCount = state.enemyCount;
+            for (int i = 0; i < enemyCount; i++) {
                 if (state.enemyAlive[i]) {
                     float ex, ey;
                     WORLD_TO_MAP(state.enemyX[i], state.enemyZ[i], ex, ey);
@@ -2310,12 +2247,12 @@
 
             simd_float3 wall1Min = {WALL1_X - hw, w1y - hh, WALL1_Z - hd};
             simd_float3 wall1Max = {WALL1_X + hw, w1y + hh, WALL1_Z + hd};
-            RayHitResult wall1Hit = rayIntersectAABB(camPos, flashDir, wall1Min, wall1Max);
+            RayHitResult wall1Hit = rayIntersectAABBSimd(camPos, flashDir, wall1Min, wall1Max);
             if (wall1Hit.hit && wall1Hit.t < flashDist) flashVisible = NO;
 
             simd_float3 wall2Min = {WALL2_X - hw, w1y - hh, WALL2_Z - hd};
             simd_float3 wall2Max = {WALL2_X + hw, w1y + hh, WALL2_Z + hd};
-            RayHitResult wall2Hit = rayIntersectAABB(camPos, flashDir, wall2Min, wall2Max);
+            RayHitResult wall2Hit = rayIntersectAABBSimd(camPos, flashDir, wall2Min, wall2Max);
             if (wall2Hit.hit && wall2Hit.t < flashDist) flashVisible = NO;
         }
 
@@ -2857,9 +2794,12 @@
         [encoder drawPrimitives:MTLPrimitiveTypeTriangle vertexStart:0 vertexCount:lbv];
     }
 
+    SIM_PROFILE_END(hudZone);
+
     [encoder endEncoding];
     [commandBuffer presentDrawable:view.currentDrawable];
     [commandBuffer commit];
+    SIM_PROFILE_FRAME();
 }
 
 @end
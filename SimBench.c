@@ -0,0 +1,533 @@
+// SimBench.c - Microbenchmarks for the simulation's hot paths
+//
+// Usage: FPSBench [results.csv|-] [baseline.csv] [tolerance%]
+//        FPSBench --check
+// Times collision queries, the collision primitives, projectile hits and splash damage, the bot update and
+// packet framing, each on inputs generated from a fixed seed so every run does the same
+// work. Each benchmark runs BENCH_SAMPLES samples of a fixed number of operations and
+// reports ns per operation (mean and the 50th/90th/99th percentile of the samples) and
+// operations per second. Everything runs on the calling thread, so results don't depend
+// on the core count. Results go to results.csv (- for stdout); a results file saved
+// earlier can be given as a baseline, and the run fails (exit code 2) if any benchmark's
+// median got more than tolerance% (default BENCH_REGRESSION_PERCENT) slower than in the baseline.
+// --check runs the self-checks instead (the ground height field against the full ground
+// search) and fails with exit code 3 if any answer differs; build_sim.sh runs it.
+#include "SimWorld.h"
+#include "SimSnapshot.h"
+#include "Collision.h"
+#include "NetProtocol.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+enum {
+    BENCH_SAMPLES = 200,
+    BENCH_WARMUP_SAMPLES = 10,
+    BENCH_INPUT_COUNT = 1024,       // Inputs per benchmark, cycled through - a power of two
+    BENCH_MAX_BASELINE = 64,
+    BENCH_CHECK_GROUND_SAMPLES = 200000,
+    BENCH_SIGHT_BATCH = 16,         // Sight lines per line_of_sight_batch op - divides BENCH_INPUT_COUNT
+};
+
+// Default allowed slowdown of a benchmark's median against the baseline
+static const double BENCH_REGRESSION_PERCENT = 10.0;
+
+static const uint64_t BENCH_SEED = 0x5eed;
+
+static double nowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+// Results are folded in here so no benchmarked call can be optimized away
+static volatile float benchSink;
+
+// ============================================
+// INPUTS
+// ============================================
+
+typedef struct {
+    SimCollision *collision;
+
+    // Worlds mid-match, and their state to go back to before each sample
+    SimWorld *world;
+    SimWorld *saved;
+    SimWorld *crowd;                // BENCH_CROWD_BOTS bots
+    SimWorld *crowdSaved;
+
+    SimVec3 origins[BENCH_INPUT_COUNT];
+    SimVec3 directions[BENCH_INPUT_COUNT];
+    SimVec3 velocities[BENCH_INPUT_COUNT];
+    CollisionAABB boxes[BENCH_INPUT_COUNT];
+    CollisionAABB obstacles[BENCH_INPUT_COUNT];
+    SimVec3 shotDirections[BENCH_INPUT_COUNT];
+    SimVec3 crowdShotDirections[BENCH_INPUT_COUNT];
+    SimVec3 splashPoints[BENCH_INPUT_COUNT];
+    SimVec3 sightFrom[BENCH_INPUT_COUNT];
+    SimVec3 sightTo[BENCH_INPUT_COUNT];
+
+    GamePacket packets[BENCH_INPUT_COUNT];
+    uint8_t messages[BENCH_INPUT_COUNT][NET_MAX_PACKET_SIZE];
+    size_t messageLengths[BENCH_INPUT_COUNT];
+} BenchData;
+
+enum { BENCH_CROWD_BOTS = 256 };
+
+static float randomRange(SimRng *rng, float lo, float hi) {
+    return lo + simRngFloat(rng) * (hi - lo);
+}
+
+static SimVec3 randomDirection(SimRng *rng) {
+    for (;;) {
+        SimVec3 v = simVec3(randomRange(rng, -1, 1), randomRange(rng, -1, 1), randomRange(rng, -1, 1));
+        float length = simLength(v);
+        if (length > 0.1f && length <= 1.0f) return simScale(v, 1.0f / length);
+    }
+}
+
+// Somewhere a player could be - anywhere in the arena, up to the catwalks
+static SimVec3 randomArenaPoint(SimRng *rng) {
+    return simVec3(randomRange(rng, -ARENA_SIZE, ARENA_SIZE), randomRange(rng, FLOOR_Y + 0.5f, FLOOR_Y + 8.0f),
+                   randomRange(rng, -ARENA_SIZE, ARENA_SIZE));
+}
+
+static CollisionAABB randomBox(SimRng *rng, float maxHalfSize) {
+    SimVec3 center = randomArenaPoint(rng);
+    SimVec3 half = simVec3(randomRange(rng, 0.1f, maxHalfSize), randomRange(rng, 0.1f, maxHalfSize),
+                           randomRange(rng, 0.1f, maxHalfSize));
+    return (CollisionAABB){center.x - half.x, center.y - half.y, center.z - half.z,
+                           center.x + half.x, center.y + half.y, center.z + half.z};
+}
+
+// Stand still with controls active, so the bots come hunting - and never die, so they keep at it
+static void runIdleTicks(SimWorld *world, int ticks) {
+    SimInput input = {0};
+    input.active = YES;
+    input.weaponSlot = -1;
+    for (int t = 0; t < ticks; t++) {
+        simStep(world, &input);
+        world->players[0].health = PLAYER_MAX_HEALTH;
+    }
+}
+
+// A world a couple of seconds into a match with every bot active, and a copy of it
+static BOOL makeMatchWorld(SimCollision *collision, int botCapacity, SimWorld **outWorld, SimWorld **outSaved) {
+    SimWorld *world = simCreateWithBots(collision, botCapacity);
+    if (!world) return NO;
+    world->seed = BENCH_SEED;
+    simResetGame(world);
+
+    simSpawnBotRing(world);
+    simRespawnPlayer(world, 0, 0);
+
+    // Skip the staggered activation
+    SimBots bots = simBots(world);
+    for (int e = 0; e < bots.count; e++) {
+        bots.ai[e].isActive = YES;
+        bots.ai[e].activationTimer = 0;
+    }
+    runIdleTicks(world, 120);
+
+    SimWorld *saved = malloc(world->size);
+    if (!saved) return NO;
+    memcpy(saved, world, world->size);
+    *outWorld = world;
+    *outSaved = saved;
+    return YES;
+}
+
+static BOOL setupInputs(BenchData *data) {
+    data->collision = simCollisionCreate();
+    if (!data->collision) return NO;
+    char cachePath[1024];
+    simCollisionLoadOrBuildMilitaryBase(data->collision,
+                                        simCollisionDefaultCachePath(cachePath, (int)sizeof(cachePath)) ? cachePath : NULL);
+
+    if (!makeMatchWorld(data->collision, NUM_ENEMIES, &data->world, &data->saved) ||
+        !makeMatchWorld(data->collision, BENCH_CROWD_BOTS, &data->crowd, &data->crowdSaved)) {
+        return NO;
+    }
+
+    SimRng rng;
+    simRngSeed(&rng, BENCH_SEED, 0);
+
+    SimBots bots = simBots(data->world);
+    SimVec3 eye = data->world->players[0].position;
+    SimBots crowd = simBots(data->crowd);
+    SimVec3 crowdEye = data->crowd->players[0].position;
+    for (int i = 0; i < BENCH_INPUT_COUNT; i++) {
+        data->origins[i] = randomArenaPoint(&rng);
+        data->directions[i] = randomDirection(&rng);
+        data->velocities[i] = simScale(randomDirection(&rng), randomRange(&rng, 0.0f, 0.5f));
+        data->boxes[i] = randomBox(&rng, 1.0f);
+        data->obstacles[i] = randomBox(&rng, 4.0f);
+
+        // Shots at the bots with some spread - a mix of bot hits and misses into the walls
+        int e = i % bots.count;
+        SimVec3 aim = simVec3(bots.x[e] + randomRange(&rng, -1.5f, 1.5f), bots.y[e] + randomRange(&rng, -1.0f, 1.0f),
+                              bots.z[e] + randomRange(&rng, -1.5f, 1.5f));
+        data->shotDirections[i] = simNormalize(simSub(aim, eye));
+
+        // The same into the crowd, and rocket impacts among it
+        int c = i % crowd.count;
+        SimVec3 crowdAim = simVec3(crowd.x[c] + randomRange(&rng, -1.5f, 1.5f), crowd.y[c] + randomRange(&rng, -1.0f, 1.0f),
+                                   crowd.z[c] + randomRange(&rng, -1.5f, 1.5f));
+        data->crowdShotDirections[i] = simNormalize(simSub(crowdAim, crowdEye));
+        data->splashPoints[i] = simVec3(crowd.x[c] + randomRange(&rng, -2.0f, 2.0f), crowd.y[c],
+                                        crowd.z[c] + randomRange(&rng, -2.0f, 2.0f));
+
+        GamePacket *packet = &data->packets[i];
+        memset(packet, 0, sizeof(*packet));
+        packet->packetType = PacketTypeStateUpdate;
+        packet->sequence = (uint32_t)i + 1;
+        packet->player.playerId = (uint32_t)(i % NET_MAX_PLAYERS) + NET_HOST_PLAYER_ID;
+        packet->player.posX = data->origins[i].x;
+        packet->player.posY = data->origins[i].y;
+        packet->player.posZ = data->origins[i].z;
+        packet->player.camYaw = randomRange(&rng, 0.0f, 6.28f);
+        packet->player.camPitch = randomRange(&rng, -1.5f, 1.5f);
+        packet->player.isShooting = (uint8_t)(i % 2);
+        packet->player.health = PLAYER_MAX_HEALTH;
+        data->messageLengths[i] = netEncodeMessage(data->messages[i], NET_MAX_PACKET_SIZE, packet, sizeof(*packet));
+    }
+
+    // Bot-style sight lines, eye height to eye height within firing range - their own
+    // stream, so the inputs above stay what they were
+    SimRng sightRng;
+    simRngSeed(&sightRng, BENCH_SEED, 1);
+    for (int i = 0; i < BENCH_INPUT_COUNT; i++) {
+        SimVec3 from = simVec3(randomRange(&sightRng, -ARENA_SIZE, ARENA_SIZE), FLOOR_Y + randomRange(&sightRng, 0.5f, 1.7f),
+                               randomRange(&sightRng, -ARENA_SIZE, ARENA_SIZE));
+        float angle = randomRange(&sightRng, 0.0f, 6.2832f);
+        float dist = randomRange(&sightRng, 2.0f, 30.0f);
+        data->sightFrom[i] = from;
+        data->sightTo[i] = simVec3(from.x + cosf(angle) * dist, FLOOR_Y + randomRange(&sightRng, 0.5f, 1.7f),
+                                   from.z + sinf(angle) * dist);
+    }
+    return YES;
+}
+
+// ============================================
+// BENCHMARKS
+// ============================================
+
+static void benchRaycast(BenchData *data, int i) {
+    RaycastResult result = simCollisionRaycast(data->collision, data->origins[i], data->directions[i],
+                                               100.0f, CollisionLayerWorld);
+    benchSink += result.distance;
+}
+
+static void benchSightBatch(BenchData *data, int i) {
+    int start = (i * BENCH_SIGHT_BATCH) & (BENCH_INPUT_COUNT - 1);
+    BOOL visible[BENCH_SIGHT_BATCH];
+    simCollisionLineOfSightBatch(data->collision, &data->sightFrom[start], &data->sightTo[start],
+                                 BENCH_SIGHT_BATCH, visible);
+    benchSink += visible[0];
+}
+
+static void benchCheckGround(BenchData *data, int i) {
+    SimVec3 p = data->origins[i];
+    GroundResult result = simCollisionCheckGround(data->collision, p.x, p.y, p.z, PLAYER_RADIUS, PLAYER_HEIGHT);
+    benchSink += result.groundY;
+}
+
+static void benchMovePlayer(BenchData *data, int i) {
+    MoveResult result = simCollisionMovePlayer(data->collision, data->origins[i], data->velocities[i],
+                                               PLAYER_RADIUS, PLAYER_HEIGHT);
+    benchSink += result.pushOut.x;
+}
+
+static void benchSweepPlayer(BenchData *data, int i) {
+    SweepMoveResult result = simCollisionSweepPlayer(data->collision, data->origins[i], data->velocities[i],
+                                                     PLAYER_RADIUS, PLAYER_HEIGHT);
+    benchSink += result.position.x;
+}
+
+static void benchSweptAABB(BenchData *data, int i) {
+    SimVec3 v = simScale(data->directions[i], 4.0f);
+    SweepResult result = sweptAABB(data->boxes[i], v.x, v.y, v.z, data->obstacles[i]);
+    benchSink += result.tEntry;
+}
+
+static void benchRayIntersectAABB(BenchData *data, int i) {
+    const CollisionAABB *box = &data->obstacles[i];
+    RayHitResult result = rayIntersectAABB(data->origins[i], data->directions[i],
+                                           simVec3(box->minX, box->minY, box->minZ),
+                                           simVec3(box->maxX, box->maxY, box->maxZ));
+    benchSink += result.t;
+}
+
+static void resetWorld(BenchData *data) {
+    simSnapshotLoad(data->world, data->saved);
+}
+
+static void resetCrowd(BenchData *data) {
+    simSnapshotLoad(data->crowd, data->crowdSaved);
+}
+
+static void benchProjectileHit(BenchData *data, int i) {
+    SimVec3 muzzle = data->world->players[0].position;
+    CombatHitResult result = simProcessProjectileHit(data->world, 0, muzzle, data->shotDirections[i],
+                                                     PLAYER_DAMAGE, 100.0f);
+    benchSink += result.hitDistance;
+}
+
+static void benchProjectileHitCrowd(BenchData *data, int i) {
+    SimVec3 muzzle = data->crowd->players[0].position;
+    CombatHitResult result = simProcessProjectileHit(data->crowd, 0, muzzle, data->crowdShotDirections[i],
+                                                     PLAYER_DAMAGE, 100.0f);
+    benchSink += result.hitDistance;
+}
+
+static void benchSplashCrowd(BenchData *data, int i) {
+    WeaponStats rocket = weaponStats(WeaponTypeRocketLauncher);
+    simApplySplashDamage(data->crowd, 0, data->splashPoints[i], rocket.splashRadius, rocket.splashDamage);
+}
+
+static void benchUpdateBots(BenchData *data, int i) {
+    (void)i;
+    simUpdateBots(data->world);
+}
+
+static void benchUpdateCrowd(BenchData *data, int i) {
+    (void)i;
+    simUpdateBots(data->crowd);
+}
+
+static void benchEncodePacket(BenchData *data, int i) {
+    uint8_t buffer[NET_MAX_PACKET_SIZE];
+    benchSink += (float)netEncodeMessage(buffer, sizeof(buffer), &data->packets[i], sizeof(GamePacket));
+}
+
+static void benchDecodePacket(BenchData *data, int i) {
+    GamePacket packet;
+    if (netDecodeStateUpdate(data->messages[i], data->messageLengths[i], &packet)) {
+        benchSink += packet.player.posX;
+    }
+}
+
+typedef struct {
+    const char *name;
+    int opsPerSample;
+    void (*reset)(BenchData *data);     // Before each sample, untimed (NULL: nothing to reset)
+    void (*run)(BenchData *data, int input);
+} Benchmark;
+
+static const Benchmark BENCHMARKS[] = {
+    {"collision_raycast",       256, NULL, benchRaycast},
+    {"line_of_sight_batch",     64, NULL, benchSightBatch},
+    {"collision_check_ground",  256, NULL, benchCheckGround},
+    {"collision_move_player",   256, NULL, benchMovePlayer},
+    {"collision_sweep_player",  256, NULL, benchSweepPlayer},
+    {"swept_aabb",              4096, NULL, benchSweptAABB},
+    {"ray_intersect_aabb",      4096, NULL, benchRayIntersectAABB},
+    {"projectile_hit",          64, resetWorld, benchProjectileHit},
+    {"projectile_hit_256",      64, resetCrowd, benchProjectileHitCrowd},
+    {"splash_damage_256",       64, resetCrowd, benchSplashCrowd},
+    {"update_bots",             16, resetWorld, benchUpdateBots},
+    {"update_bots_256",         4, resetCrowd, benchUpdateCrowd},
+    {"packet_encode",           4096, NULL, benchEncodePacket},
+    {"packet_decode",           4096, NULL, benchDecodePacket},
+};
+enum { BENCHMARK_COUNT = sizeof(BENCHMARKS) / sizeof(BENCHMARKS[0]) };
+
+// ============================================
+// RESULTS
+// ============================================
+
+typedef struct {
+    char name[64];
+    long ops;
+    double nsPerOp;                 // Mean over all samples
+    double opsPerSecond;
+    double p50, p90, p99;           // Percentiles of the samples' ns per op
+} BenchResult;
+
+static int compareDoubles(const void *a, const void *b) {
+    double x = *(const double *)a;
+    double y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+static double percentile(const double *sorted, int count, double fraction) {
+    int index = (int)(fraction * (double)(count - 1) + 0.5);
+    return sorted[index];
+}
+
+static BenchResult runBenchmark(BenchData *data, const Benchmark *bench) {
+    double samples[BENCH_SAMPLES];
+    double total = 0.0;
+    int input = 0;
+
+    for (int s = -BENCH_WARMUP_SAMPLES; s < BENCH_SAMPLES; s++) {
+        if (bench->reset) bench->reset(data);
+
+        double start = nowSeconds();
+        for (int op = 0; op < bench->opsPerSample; op++) {
+            bench->run(data, input);
+            input = (input + 1) & (BENCH_INPUT_COUNT - 1);
+        }
+        double elapsed = nowSeconds() - start;
+
+        if (s >= 0) {
+            samples[s] = elapsed * 1e9 / (double)bench->opsPerSample;
+            total += elapsed;
+        }
+    }
+    qsort(samples, BENCH_SAMPLES, sizeof(double), compareDoubles);
+
+    BenchResult result;
+    memset(&result, 0, sizeof(result));
+    snprintf(result.name, sizeof(result.name), "%s", bench->name);
+    result.ops = (long)BENCH_SAMPLES * bench->opsPerSample;
+    result.nsPerOp = total * 1e9 / (double)result.ops;
+    result.opsPerSecond = (double)result.ops / total;
+    result.p50 = percentile(samples, BENCH_SAMPLES, 0.50);
+    result.p90 = percentile(samples, BENCH_SAMPLES, 0.90);
+    result.p99 = percentile(samples, BENCH_SAMPLES, 0.99);
+    return result;
+}
+
+static const char *CSV_HEADER = "name,ops,ns_per_op,ops_per_sec,p50_ns,p90_ns,p99_ns";
+
+static void writeCSV(FILE *file, const BenchResult *results, int count) {
+    fprintf(file, "%s\n", CSV_HEADER);
+    for (int i = 0; i < count; i++) {
+        const BenchResult *r = &results[i];
+        fprintf(file, "%s,%ld,%.2f,%.0f,%.2f,%.2f,%.2f\n",
+                r->name, r->ops, r->nsPerOp, r->opsPerSecond, r->p50, r->p90, r->p99);
+    }
+}
+
+// Results saved by an earlier run. Returns how many were read, or -1 if the file can't be read.
+static int readCSV(const char *path, BenchResult *results, int maxResults) {
+    FILE *file = fopen(path, "r");
+    if (!file) {
+        fprintf(stderr, "[BENCH] Can't open baseline %s\n", path);
+        return -1;
+    }
+
+    char line[256];
+    int count = 0;
+    while (count < maxResults && fgets(line, sizeof(line), file)) {
+        BenchResult *r = &results[count];
+        memset(r, 0, sizeof(*r));
+        if (sscanf(line, "%63[^,],%ld,%lf,%lf,%lf,%lf,%lf",
+                   r->name, &r->ops, &r->nsPerOp, &r->opsPerSecond, &r->p50, &r->p90, &r->p99) == 7) {
+            count++;
+        }
+    }
+    fclose(file);
+    return count;
+}
+
+// Medians against the baseline. Returns the number of benchmarks that regressed.
+static int compareWithBaseline(const BenchResult *results, int count, const BenchResult *baseline, int baselineCount,
+                               double tolerance) {
+    int regressions = 0;
+    printf("\n%-24s %12s %12s %9s\n", "benchmark", "base p50", "p50", "change");
+    for (int i = 0; i < count; i++) {
+        const BenchResult *before = NULL;
+        for (int b = 0; b < baselineCount; b++) {
+            if (strcmp(baseline[b].name, results[i].name) == 0) before = &baseline[b];
+        }
+        if (!before || before->p50 <= 0.0) {
+            printf("%-24s %12s %12.1f %9s\n", results[i].name, "-", results[i].p50, "new");
+            continue;
+        }
+
+        double change = (results[i].p50 / before->p50 - 1.0) * 100.0;
+        BOOL regressed = change > tolerance;
+        if (regressed) regressions++;
+        printf("%-24s %12.1f %12.1f %+8.1f%%%s\n", results[i].name, before->p50, results[i].p50, change,
+               regressed ? "  REGRESSED" : "");
+    }
+    return regressions;
+}
+
+// ============================================
+// SELF-CHECKS
+// ============================================
+
+static int runChecks(void) {
+    SimCollision *collision = simCollisionCreate();
+    if (!collision) {
+        fprintf(stderr, "[BENCH] Out of memory\n");
+        return 1;
+    }
+    char cachePath[1024];
+    simCollisionLoadOrBuildMilitaryBase(collision,
+                                        simCollisionDefaultCachePath(cachePath, (int)sizeof(cachePath)) ? cachePath : NULL);
+
+    int mismatches = simCollisionVerifyGroundField(collision, BENCH_CHECK_GROUND_SAMPLES, BENCH_SEED);
+    printf("[BENCH] Ground height field: %d of %d sampled queries differ from the full search\n",
+           mismatches, BENCH_CHECK_GROUND_SAMPLES);
+
+    simCollisionDestroy(collision);
+    return mismatches > 0 ? 3 : 0;
+}
+
+int main(int argc, char **argv) {
+    if (argc == 2 && strcmp(argv[1], "--check") == 0) {
+        return runChecks();
+    }
+
+    const char *outputPath = (argc > 1) ? argv[1] : NULL;
+    const char *baselinePath = (argc > 2) ? argv[2] : NULL;
+    double tolerance = (argc > 3) ? strtod(argv[3], NULL) : BENCH_REGRESSION_PERCENT;
+    if (argc > 4 || tolerance <= 0.0) {
+        fprintf(stderr, "usage: %s [results.csv|-] [baseline.csv] [tolerance%%] | --check\n", argv[0]);
+        return 1;
+    }
+
+    BenchResult baseline[BENCH_MAX_BASELINE];
+    int baselineCount = 0;
+    if (baselinePath) {
+        baselineCount = readCSV(baselinePath, baseline, BENCH_MAX_BASELINE);
+        if (baselineCount < 0) return 1;
+    }
+
+    BenchData *data = calloc(1, sizeof(BenchData));
+    if (!data || !setupInputs(data)) {
+        fprintf(stderr, "[BENCH] Out of memory\n");
+        return 1;
+    }
+
+    BenchResult results[BENCHMARK_COUNT];
+    printf("%-24s %10s %12s %10s %10s %10s\n", "benchmark", "ns/op", "ops/s", "p50", "p90", "p99");
+    for (int i = 0; i < BENCHMARK_COUNT; i++) {
+        results[i] = runBenchmark(data, &BENCHMARKS[i]);
+        const BenchResult *r = &results[i];
+        printf("%-24s %10.1f %12.0f %10.1f %10.1f %10.1f\n",
+               r->name, r->nsPerOp, r->opsPerSecond, r->p50, r->p90, r->p99);
+    }
+
+    if (outputPath) {
+        FILE *file = strcmp(outputPath, "-") == 0 ? stdout : fopen(outputPath, "w");
+        if (!file) {
+            fprintf(stderr, "[BENCH] Can't write %s\n", outputPath);
+            return 1;
+        }
+        if (file == stdout) printf("\n");
+        writeCSV(file, results, BENCHMARK_COUNT);
+        if (file != stdout) fclose(file);
+    }
+
+    int regressions = 0;
+    if (baselinePath) {
+        regressions = compareWithBaseline(results, BENCHMARK_COUNT, baseline, baselineCount, tolerance);
+        printf("[BENCH] %d of %d benchmarks more than %.0f%% slower than the baseline\n",
+               regressions, BENCHMARK_COUNT, tolerance);
+    }
+
+    simDestroy(data->world);
+    simDestroy(data->crowd);
+    free(data->saved);
+    free(data->crowdSaved);
+    simCollisionDestroy(data->collision);
+    free(data);
+    return regressions > 0 ? 2 : 0;
+}
@@ -0,0 +1,2804 @@
+// SimCollision.c - Portable collision world implementation
+#include "SimCollision.h"
+#include "Collision.h"
+#include "CollisionBVH.h"
+#include "NavGrid.h"
+#include "CoverMap.h"
+#include "HeightField.h"
+#include "CollisionCache.h"
+#include "SimJobs.h"
+#include "SimProfile.h"
+#include "SimRandom.h"
+#include <errno.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Broadphase flags - which queries a shape takes part in
+enum {
+    ShapeQueryRaycast = 1 << 0,     // Blocks projectiles
+    ShapeQueryGround  = 1 << 1,     // Walkable surface
+    ShapeQueryMove    = 1 << 2,     // Blocks horizontal movement (ramps excluded)
+};
+
+// Small padding on broadphase query boxes so float rounding never drops a candidate
+static const float BROADPHASE_PAD = 0.01f;
+
+// Ground height field - texel size and the largest radius it answers (player 0.3, bots 0.4)
+static const float GROUND_FIELD_TEXEL = 1.0f;
+static const float GROUND_FIELD_MAX_RADIUS = 0.5f;
+
+// Navigation grid - cell size, the body every path must fit (the wider bot, the taller
+// player), and the largest step up (a jump) and down a link may take
+static const float NAV_CELL_SIZE = 0.5f;
+static const float NAV_AGENT_RADIUS = 0.4f;
+static const float NAV_AGENT_HEIGHT = PLAYER_HEIGHT;
+static const float NAV_MAX_CLIMB = 1.0f;
+static const float NAV_MAX_DROP = 3.5f;
+
+// Path queries - nodes A* may expand before giving up, cells around a point searched for
+// the node to start or end on, and cached paths (direct-mapped)
+#define NAV_MAX_EXPANSIONS 8192
+#define NAV_NODE_SEARCH_CELLS 2
+#define NAV_PATH_CACHE_SIZE 256
+
+// Flow field steps a steering lookup looks ahead along a straight, level run
+#define NAV_FLOW_LOOKAHEAD 4
+
+// Cover points - spacing along a blocker's faces and the gap kept to them, the least a
+// blocker must rise over the feet to count, and candidates closer than the merge distance
+// (facing the same way) that count as one. Exposure is sampled from viewers standing at
+// each of the ranges in each of the directions; grid cells of the index.
+static const float COVER_SPACING = 1.5f;
+static const float COVER_WALL_GAP = 0.6f;
+static const float COVER_MIN_HEIGHT = 1.0f;
+static const float COVER_MERGE_DISTANCE = 1.0f;
+static const float COVER_EXPOSURE_RANGES[] = {5.0f, 10.0f, 20.0f};
+#define COVER_EXPOSURE_DIRECTIONS 16
+static const float COVER_CELL_SIZE = 4.0f;
+
+// Cover queries - body center above the feet (what a threat must not see), how squarely a
+// point's blocker must face the threat, the weight of exposure against distance in meters,
+// candidates scanned, and best ones checked for line of sight
+static const float COVER_BODY_HEIGHT = 0.6f;
+static const float COVER_MIN_FACING = 0.5f;
+static const float COVER_EXPOSURE_WEIGHT = 10.0f;
+#define COVER_QUERY_CANDIDATES 128
+#define COVER_QUERY_SIGHT_CHECKS 4
+
+// Swept movement - slide iterations per move, and the gap kept between the player and surfaces
+static const int SWEEP_MAX_ITERATIONS = 4;
+static const float SWEEP_SKIN = 0.001f;
+
+// Shapes per SIMD block in the SoA ray table
+#define SHAPE_BLOCK_WIDTH 4
+
+// Bodies per work item in batched kinematics - one chunk runs on one thread
+#define KINEMATIC_CHUNK_SIZE 16
+
+// Baked cache version - bump whenever simCollisionBuildMilitaryBase or a baked structure changes
+#define COLLISION_CACHE_VERSION 7
+
+// Version of the base addMilitaryBaseShapes lays out - bump it with any change there the
+// GameConfig dimensions don't show (a literal position, a shape added or removed), since
+// the baked cache is keyed on it rather than on the shapes themselves
+#define MILITARY_BASE_GEOMETRY_VERSION 1
+
+// Baked cache sections
+#define BAKED_TAG_INFO          CACHE_TAG('I', 'N', 'F', 'O')
+#define BAKED_TAG_SHAPES        CACHE_TAG('S', 'H', 'A', 'P')
+#define BAKED_TAG_RAY_BLOCKS    CACHE_TAG('R', 'A', 'Y', 'B')
+#define BAKED_TAG_GROUND_SHAPE  CACHE_TAG('G', 'S', 'H', 'P')
+#define BAKED_TAG_BVH_NODES     CACHE_TAG('B', 'V', 'H', 'N')
+#define BAKED_TAG_BVH_ITEMS     CACHE_TAG('B', 'V', 'H', 'I')
+#define BAKED_TAG_BVH_BOUNDS    CACHE_TAG('B', 'V', 'H', 'B')
+#define BAKED_TAG_HF_COUNTS     CACHE_TAG('H', 'F', 'L', 'C')
+#define BAKED_TAG_HF_LAYERS     CACHE_TAG('H', 'F', 'L', 'Y')
+#define BAKED_TAG_NAV_COUNTS    CACHE_TAG('N', 'A', 'V', 'C')
+#define BAKED_TAG_NAV_SURFACES  CACHE_TAG('N', 'A', 'V', 'Y')
+#define BAKED_TAG_NAV_LINKS     CACHE_TAG('N', 'A', 'V', 'L')
+#define BAKED_TAG_COVER_POINTS  CACHE_TAG('C', 'V', 'R', 'P')
+#define BAKED_TAG_COVER_CELLS   CACHE_TAG('C', 'V', 'R', 'C')
+
+// Handle layout: low bits are the slot index, the rest is the slot generation
+#define SHAPE_HANDLE_SLOT_MASK ((1 << SHAPE_HANDLE_INDEX_BITS) - 1)
+#define SHAPE_HANDLE_MAX_GENERATION ((1 << (31 - SHAPE_HANDLE_INDEX_BITS)) - 1)
+
+// 4-wide vectors for the batched raycast (GCC/Clang vector extensions, no simd.h)
+typedef float Float4 __attribute__((vector_size(16)));
+typedef int Int4 __attribute__((vector_size(16)));
+typedef unsigned int UInt4 __attribute__((vector_size(16)));
+
+// Handle slot - maps a stable handle to the shape's current position in the dense array
+typedef struct {
+    int denseIndex;             // Index into shapes (or dynShapes), -1 when free
+    int generation;             // Bumped on free so old handles stop resolving
+    int nextFree;               // Next free slot (free list), -1 = end
+    BOOL isDynamic;             // Shape lives in the dynamic set
+} ShapeSlot;
+
+// Scalars that go with the baked arrays
+typedef struct {
+    int32_t shapeCount;
+    int32_t rayBlockCount;
+    int32_t groundCount;
+    int32_t bvhNodeCount;
+    int32_t groundFieldValid;
+    float hfMinX, hfMinZ, hfTexelSize, hfMargin;
+    int32_t hfSizeX, hfSizeZ;
+    int32_t navGridValid;
+    float navMinX, navMinZ, navCellSize;
+    int32_t navSizeX, navSizeZ, navCellCount;
+    int32_t coverMapValid;
+    float coverMinX, coverMinZ, coverCellSize;
+    int32_t coverSizeX, coverSizeZ, coverCellCount, coverPointCount;
+} BakedWorldInfo;
+
+// Per-thread query scratch - candidate lists sized to the current shape counts
+typedef struct {
+    int *candidates;            // Static BVH hits
+    int *dynCandidates;         // Dynamic BVH hits
+    CollisionShape **shapes;    // Merged candidates, static first
+    int capacity;               // Static entries the arrays hold
+    int dynCapacity;            // Dynamic entries the arrays hold
+    NavSearch nav;              // A* open list and per-node costs
+} QueryScratch;
+
+// 4 shapes' bounds in SoA form for batched raycasts - lane i of block b is shape b*4+i
+typedef struct {
+    Float4 minX, minY, minZ;
+    Float4 maxX, maxY, maxZ;
+    UInt4 layer;                // Layer bits, 0 if the shape doesn't block projectiles
+} ShapeRayBlock;
+
+// One cached path. The key covers everything the search depended on besides the grid:
+// the end nodes, the dynamic shapes' bounds and the caller's keep-out circles.
+typedef struct {
+    BOOL used;
+    int start;
+    int goal;
+    uint64_t key;
+    int pointCount;             // -1: no path
+    SimVec3 points[SIM_NAV_MAX_PATH_POINTS];
+} NavPathEntry;
+
+// One flow field and what it was built for - the goal node and the dynamic shapes' bounds.
+// A paused field keeps its build but doesn't answer lookups.
+typedef struct {
+    NavFlowField field;
+    uint64_t key;
+    BOOL built;
+    BOOL paused;
+} NavFlowEntry;
+
+struct SimCollision {
+    // Dense shape array - removal swaps the last shape into the hole
+    CollisionShape *shapes;
+    int *shapeSlot;             // Slot owning each dense entry
+    int shapeCount;
+    int shapeCapacity;
+
+    // Handle slots, shared by static and dynamic shapes
+    ShapeSlot *slots;
+    int slotCount;
+    int slotCapacity;
+    int freeSlot;
+
+    // Bounding volume hierarchy over shapes, rebuilt lazily after shape changes
+    CollisionBVH bvh;
+    BOOL bvhDirty;
+    BVHItem *bvhItems;          // Build scratch
+
+    // SoA copy of shape bounds for batched raycasts
+    ShapeRayBlock *rayBlocks;
+    int rayBlockCount;
+
+    // Walkable surfaces baked per texel, rebuilt with the BVH
+    HeightField groundField;
+    HeightFieldItem *groundItems;      // Build scratch
+    int *groundShape;                  // Shape index for each baked item
+    int groundCount;
+    BOOL groundFieldValid;
+
+    // Walkable grid for path queries, invalidated whenever the BVH is rebuilt. Paths found are
+    // kept in navCache (allocated on first use), shared by every querying thread.
+    NavGrid navGrid;
+    BOOL navGridValid;
+    NavPathEntry *navCache;
+    pthread_mutex_t navCacheLock;
+    NavFlowEntry navFlow[SIM_NAV_FLOW_FIELDS];
+
+    // Cover points along the static blockers, invalidated with the nav grid they stand on
+    CoverMap coverMap;
+    BOOL coverMapValid;
+
+    // Dynamic shapes (doors, moving platforms) - kept out of the static BVH, ray table,
+    // and height field so moving them never triggers a rebuild
+    CollisionShape *dynShapes;
+    int *dynShapeSlot;
+    int dynCount;
+    int dynCapacity;
+    CollisionBVH dynBvh;
+    BVHItem *dynBvhItems;       // Current bounds, refit into dynBvh
+    BOOL dynTopologyDirty;      // Shapes added/removed - rebuild dynBvh
+    BOOL dynBoundsDirty;        // Shapes moved - refit dynBvh
+
+    // Static shapes are exactly what addMilitaryBaseShapes lays out (built or loaded) - the
+    // only set the baked cache's key describes
+    BOOL staticIsMilitaryBase;
+
+    // Mapped baked cache. While open, shapes, rayBlocks, groundShape and the static
+    // BVH, height field, nav grid and cover map arrays point into it.
+    CollisionCache bakedCache;
+
+    SimJobSystem *jobs;         // Not owned
+};
+
+static BOOL detachBakedCache(SimCollision *world);
+static void dropBakedCache(SimCollision *world);
+
+// Grow scratch to hold shapeCount static and dynCount dynamic candidates
+static BOOL reserveQueryScratch(QueryScratch *scratch, int shapeCount, int dynCount) {
+    if (shapeCount <= scratch->capacity && dynCount <= scratch->dynCapacity && scratch->shapes) {
+        return YES;
+    }
+
+    int capacity = scratch->capacity > 0 ? scratch->capacity : COLLISION_SHAPE_INITIAL_CAPACITY;
+    while (capacity < shapeCount) capacity *= 2;
+    int dynCapacity = scratch->dynCapacity > 0 ? scratch->dynCapacity : 16;
+    while (dynCapacity < dynCount) dynCapacity *= 2;
+
+    int *candidates = realloc(scratch->candidates, sizeof(int) * capacity);
+    if (!candidates) return NO;
+    scratch->candidates = candidates;
+
+    int *dynCandidates = realloc(scratch->dynCandidates, sizeof(int) * dynCapacity);
+    if (!dynCandidates) return NO;
+    scratch->dynCandidates = dynCandidates;
+
+    // shapes holds both lists together
+    CollisionShape **shapes = realloc(scratch->shapes, sizeof(CollisionShape *) * (capacity + dynCapacity));
+    if (!shapes) return NO;
+    scratch->shapes = shapes;
+
+    scratch->capacity = capacity;
+    scratch->dynCapacity = dynCapacity;
+    return YES;
+}
+
+static void freeQueryScratch(QueryScratch *scratch) {
+    free(scratch->candidates);
+    free(scratch->dynCandidates);
+    free(scratch->shapes);
+    navSearchFree(&scratch->nav);
+    memset(scratch, 0, sizeof(*scratch));
+}
+
+// Scratch belongs to the thread, not the world, so threads can query one world at once
+static pthread_key_t scratchKey;
+static pthread_once_t scratchKeyOnce = PTHREAD_ONCE_INIT;
+
+static void freeThreadScratch(void *scratch) {
+    freeQueryScratch(scratch);
+    free(scratch);
+}
+
+static void createScratchKey(void) {
+    pthread_key_create(&scratchKey, freeThreadScratch);
+}
+
+// The calling thread's query scratch, grown to world's shape counts
+static QueryScratch *threadScratch(const SimCollision *world) {
+    static _Thread_local QueryScratch emptyScratch;
+
+    pthread_once(&scratchKeyOnce, createScratchKey);
+    QueryScratch *scratch = pthread_getspecific(scratchKey);
+    if (!scratch) {
+        scratch = calloc(1, sizeof(QueryScratch));
+        if (!scratch || pthread_setspecific(scratchKey, scratch) != 0) {
+            free(scratch);
+            fprintf(stderr, "[COLLISION] Failed to allocate query scratch\n");
+            return &emptyScratch;
+        }
+    }
+
+    if (!reserveQueryScratch(scratch, world->shapeCount, world->dynCount)) {
+        fprintf(stderr, "[COLLISION] Failed to grow query scratch for %d shapes\n",
+                world->shapeCount + world->dynCount);
+    }
+    return scratch;
+}
+
+SimCollision *simCollisionCreate(void) {
+    SimCollision *world = calloc(1, sizeof(SimCollision));
+    if (!world) return NULL;
+    world->freeSlot = -1;
+    world->bvhDirty = YES;
+    if (pthread_mutex_init(&world->navCacheLock, NULL) != 0) {
+        free(world);
+        return NULL;
+    }
+    return world;
+}
+
+void simCollisionDestroy(SimCollision *world) {
+    if (!world) return;
+    dropBakedCache(world);
+    bvhFree(&world->bvh);
+    bvhFree(&world->dynBvh);
+    navGridFree(&world->navGrid);
+    coverMapFree(&world->coverMap);
+    free(world->navCache);
+    for (int i = 0; i < SIM_NAV_FLOW_FIELDS; i++) {
+        navFlowFieldFree(&world->navFlow[i].field);
+    }
+    pthread_mutex_destroy(&world->navCacheLock);
+    hfFree(&world->groundField);
+    free(world->groundItems);
+    free(world->groundShape);
+    free(world->shapes);
+    free(world->shapeSlot);
+    free(world->slots);
+    free(world->bvhItems);
+    free(world->rayBlocks);
+    free(world->dynShapes);
+    free(world->dynShapeSlot);
+    free(world->dynBvhItems);
+    free(world);
+}
+
+void simCollisionSetJobSystem(SimCollision *world, SimJobSystem *jobs) {
+    world->jobs = jobs;
+}
+
+// ============================================
+// SHAPE STORAGE
+// ============================================
+
+// Grow every per-shape array to hold at least minCapacity shapes
+static BOOL reserveShapeCapacity(SimCollision *world, int minCapacity) {
+    if (minCapacity <= world->shapeCapacity) return YES;
+    if (minCapacity > SHAPE_HANDLE_MAX_SLOTS) return NO;
+
+    int capacity = world->shapeCapacity > 0 ? world->shapeCapacity : COLLISION_SHAPE_INITIAL_CAPACITY;
+    while (capacity < minCapacity) capacity *= 2;
+    if (capacity > SHAPE_HANDLE_MAX_SLOTS) capacity = SHAPE_HANDLE_MAX_SLOTS;
+
+    int blockCapacity = (capacity + SHAPE_BLOCK_WIDTH - 1) / SHAPE_BLOCK_WIDTH;
+
+    CollisionShape *shapes = realloc(world->shapes, sizeof(CollisionShape) * capacity);
+    if (!shapes) return NO;
+    world->shapes = shapes;
+
+    int *shapeSlot = realloc(world->shapeSlot, sizeof(int) * capacity);
+    if (!shapeSlot) return NO;
+    world->shapeSlot = shapeSlot;
+
+    BVHItem *bvhItems = realloc(world->bvhItems, sizeof(BVHItem) * capacity);
+    if (!bvhItems) return NO;
+    world->bvhItems = bvhItems;
+
+    HeightFieldItem *groundItems = realloc(world->groundItems, sizeof(HeightFieldItem) * capacity);
+    if (!groundItems) return NO;
+    world->groundItems = groundItems;
+
+    int *groundShape = realloc(world->groundShape, sizeof(int) * capacity);
+    if (!groundShape) return NO;
+    world->groundShape = groundShape;
+
+    ShapeRayBlock *rayBlocks = realloc(world->rayBlocks, sizeof(ShapeRayBlock) * blockCapacity);
+    if (!rayBlocks) return NO;
+    world->rayBlocks = rayBlocks;
+
+    world->shapeCapacity = capacity;
+    return YES;
+}
+
+// Grow the dynamic shape arrays to hold at least minCapacity shapes
+static BOOL reserveDynamicCapacity(SimCollision *world, int minCapacity) {
+    if (minCapacity <= world->dynCapacity) return YES;
+
+    int capacity = world->dynCapacity > 0 ? world->dynCapacity : 16;
+    while (capacity < minCapacity) capacity *= 2;
+
+    CollisionShape *shapes = realloc(world->dynShapes, sizeof(CollisionShape) * capacity);
+    if (!shapes) return NO;
+    world->dynShapes = shapes;
+
+    int *shapeSlot = realloc(world->dynShapeSlot, sizeof(int) * capacity);
+    if (!shapeSlot) return NO;
+    world->dynShapeSlot = shapeSlot;
+
+    BVHItem *bvhItems = realloc(world->dynBvhItems, sizeof(BVHItem) * capacity);
+    if (!bvhItems) return NO;
+    world->dynBvhItems = bvhItems;
+
+    world->dynCapacity = capacity;
+    return YES;
+}
+
+// Take a slot from the free list (or append one). Returns -1 when out of slots or memory.
+static int allocateSlot(SimCollision *world) {
+    if (world->freeSlot >= 0) {
+        int slot = world->freeSlot;
+        world->freeSlot = world->slots[slot].nextFree;
+        return slot;
+    }
+
+    if (world->slotCount == world->slotCapacity) {
+        if (world->slotCapacity >= SHAPE_HANDLE_MAX_SLOTS) return -1;
+        int capacity = world->slotCapacity > 0 ? world->slotCapacity * 2 : COLLISION_SHAPE_INITIAL_CAPACITY;
+        if (capacity > SHAPE_HANDLE_MAX_SLOTS) capacity = SHAPE_HANDLE_MAX_SLOTS;
+        ShapeSlot *slots = realloc(world->slots, sizeof(ShapeSlot) * capacity);
+        if (!slots) return -1;
+        world->slots = slots;
+        world->slotCapacity = capacity;
+    }
+
+    int slot = world->slotCount++;
+    world->slots[slot].generation = 1;
+    return slot;
+}
+
+// Return a slot to the free list - the generation bump invalidates outstanding handles
+static void retireSlot(SimCollision *world, int slot) {
+    ShapeSlot *entry = &world->slots[slot];
+    entry->denseIndex = -1;
+    entry->generation = entry->generation < SHAPE_HANDLE_MAX_GENERATION ? entry->generation + 1 : 1;
+    entry->nextFree = world->freeSlot;
+    world->freeSlot = slot;
+}
+
+// Dense index for a handle, or -1 if the handle is stale or invalid.
+// outDynamic (optional) says which array the index refers to.
+static int denseIndexForHandle(const SimCollision *world, int shapeId, BOOL *outDynamic) {
+    if (shapeId <= 0) return -1;
+    int slot = shapeId & SHAPE_HANDLE_SLOT_MASK;
+    int generation = shapeId >> SHAPE_HANDLE_INDEX_BITS;
+    if (slot >= world->slotCount) return -1;
+    if (world->slots[slot].generation != generation) return -1;
+    if (outDynamic) *outDynamic = world->slots[slot].isDynamic;
+    return world->slots[slot].denseIndex;
+}
+
+// Store a shape, assign its handle and return it (-1 if out of memory)
+static int insertShape(SimCollision *world, CollisionShape shape, BOOL dynamic) {
+    if (!dynamic && !detachBakedCache(world)) return -1;
+
+    BOOL reserved = dynamic ? reserveDynamicCapacity(world, world->dynCount + 1)
+                            : reserveShapeCapacity(world, world->shapeCount + 1);
+    if (!reserved) return -1;
+
+    int slot = allocateSlot(world);
+    if (slot < 0) return -1;
+
+    int index = dynamic ? world->dynCount++ : world->shapeCount++;
+    world->slots[slot].denseIndex = index;
+    world->slots[slot].nextFree = -1;
+    world->slots[slot].isDynamic = dynamic;
+
+    shape.shapeId = (world->slots[slot].generation << SHAPE_HANDLE_INDEX_BITS) | slot;
+    if (dynamic) {
+        world->dynShapes[index] = shape;
+        world->dynShapeSlot[index] = slot;
+        world->dynTopologyDirty = YES;
+    } else {
+        world->shapes[index] = shape;
+        world->shapeSlot[index] = slot;
+        world->bvhDirty = YES;
+        world->staticIsMilitaryBase = NO;
+    }
+    return shape.shapeId;
+}
+
+// ============================================
+// SHAPE MANAGEMENT
+// ============================================
+
+static CollisionShape makeBoxShape(float minX, float minY, float minZ,
+                                   float maxX, float maxY, float maxZ,
+                                   CollisionShapeType type, BOOL walkable, const char *name) {
+    CollisionShape shape = {0};
+    shape.minX = minX;
+    shape.minY = minY;
+    shape.minZ = minZ;
+    shape.maxX = maxX;
+    shape.maxY = maxY;
+    shape.maxZ = maxZ;
+    shape.type = type;
+    shape.layer = CollisionLayerWorld;
+    shape.isWalkable = walkable;
+    // Only walls block horizontal movement - platforms are for standing on (handled by ground detection)
+    shape.blocksMovement = (type == CollisionShapeTypeWall);
+    shape.blocksProjectiles = (type == CollisionShapeTypeWall || type == CollisionShapeTypePlatform);
+    shape.isRamp = NO;
+    snprintf(shape.debugName, sizeof(shape.debugName), "%s", name ? name : "");
+    return shape;
+}
+
+int simCollisionAddBox(SimCollision *world,
+                       float minX, float minY, float minZ,
+                       float maxX, float maxY, float maxZ,
+                       CollisionShapeType type, BOOL walkable, const char *name) {
+    CollisionShape shape = makeBoxShape(minX, minY, minZ, maxX, maxY, maxZ, type, walkable, name);
+    return insertShape(world, shape, NO);
+}
+
+int simCollisionAddRamp(SimCollision *world,
+                        float minX, float minZ, float maxX, float maxZ,
+                        float startY, float endY, int axis, float direction,
+                        const char *name) {
+    float minY = fminf(startY, endY);
+    float maxY = fmaxf(startY, endY);
+
+    CollisionShape shape = {0};
+    shape.minX = minX;
+    shape.minY = minY;
+    shape.minZ = minZ;
+    shape.maxX = maxX;
+    shape.maxY = maxY;
+    shape.maxZ = maxZ;
+    shape.type = CollisionShapeTypeRamp;
+    shape.layer = CollisionLayerWorld;
+    shape.isWalkable = YES;
+    shape.blocksMovement = YES;
+    shape.blocksProjectiles = YES;
+    shape.isRamp = YES;
+    shape.rampStartY = startY;
+    shape.rampEndY = endY;
+    shape.rampAxis = axis;
+    shape.rampDirection = direction;
+    snprintf(shape.debugName, sizeof(shape.debugName), "%s", name ? name : "");
+
+    return insertShape(world, shape, NO);
+}
+
+int simCollisionAddPlatform(SimCollision *world,
+                            float minX, float minZ, float maxX, float maxZ,
+                            float topY, float thickness, const char *name) {
+    return simCollisionAddBox(world, minX, topY - thickness, minZ, maxX, topY, maxZ,
+                              CollisionShapeTypePlatform, YES, name);
+}
+
+int simCollisionAddDynamicBox(SimCollision *world,
+                              float minX, float minY, float minZ,
+                              float maxX, float maxY, float maxZ,
+                              CollisionShapeType type, BOOL walkable, const char *name) {
+    CollisionShape shape = makeBoxShape(minX, minY, minZ, maxX, maxY, maxZ, type, walkable, name);
+    return insertShape(world, shape, YES);
+}
+
+BOOL simCollisionMoveDynamicShape(SimCollision *world, int shapeId,
+                                  float minX, float minY, float minZ,
+                                  float maxX, float maxY, float maxZ) {
+    BOOL dynamic = NO;
+    int index = denseIndexForHandle(world, shapeId, &dynamic);
+    if (index < 0 || !dynamic) return NO;
+
+    CollisionShape *shape = &world->dynShapes[index];
+    if (shape->minX == minX && shape->minY == minY && shape->minZ == minZ &&
+        shape->maxX == maxX && shape->maxY == maxY && shape->maxZ == maxZ) {
+        return YES;
+    }
+
+    shape->minX = minX;
+    shape->minY = minY;
+    shape->minZ = minZ;
+    shape->maxX = maxX;
+    shape->maxY = maxY;
+    shape->maxZ = maxZ;
+
+    // Item order matches dynShapes, so the refit input is updated in place
+    BVHItem *item = &world->dynBvhItems[index];
+    item->minX = minX;
+    item->minY = minY;
+    item->minZ = minZ;
+    item->maxX = maxX;
+    item->maxY = maxY;
+    item->maxZ = maxZ;
+    world->dynBoundsDirty = YES;
+    return YES;
+}
+
+void simCollisionRemoveShape(SimCollision *world, int shapeId) {
+    BOOL dynamic = NO;
+    int index = denseIndexForHandle(world, shapeId, &dynamic);
+    if (index < 0) return;
+    if (!dynamic && !detachBakedCache(world)) return;
+
+    // Move the last shape into the hole and repoint its slot
+    CollisionShape *shapes = dynamic ? world->dynShapes : world->shapes;
+    int *shapeSlot = dynamic ? world->dynShapeSlot : world->shapeSlot;
+    int *count = dynamic ? &world->dynCount : &world->shapeCount;
+
+    int slot = shapeSlot[index];
+    int last = *count - 1;
+    if (index != last) {
+        shapes[index] = shapes[last];
+        shapeSlot[index] = shapeSlot[last];
+        world->slots[shapeSlot[index]].denseIndex = index;
+    }
+    (*count)--;
+
+    retireSlot(world, slot);
+    if (dynamic) {
+        world->dynTopologyDirty = YES;
+    } else {
+        world->bvhDirty = YES;
+        world->staticIsMilitaryBase = NO;
+    }
+}
+
+void simCollisionClearAllShapes(SimCollision *world) {
+    if (!detachBakedCache(world)) return;
+
+    // Retire every live slot so handles from before the clear stay invalid
+    for (int i = 0; i < world->shapeCount; i++) {
+        retireSlot(world, world->shapeSlot[i]);
+    }
+    for (int i = 0; i < world->dynCount; i++) {
+        retireSlot(world, world->dynShapeSlot[i]);
+    }
+    world->shapeCount = 0;
+    world->dynCount = 0;
+    world->bvhDirty = YES;
+    world->dynTopologyDirty = YES;
+    world->staticIsMilitaryBase = NO;
+}
+
+CollisionShape *simCollisionGetShape(SimCollision *world, int shapeId) {
+    BOOL dynamic = NO;
+    int index = denseIndexForHandle(world, shapeId, &dynamic);
+    if (index < 0) return NULL;
+    return dynamic ? &world->dynShapes[index] : &world->shapes[index];
+}
+
+int simCollisionShapeCount(const SimCollision *world) {
+    return world->shapeCount + world->dynCount;
+}
+
+int simCollisionDynamicShapeCount(const SimCollision *world) {
+    return world->dynCount;
+}
+
+// ============================================
+// BROADPHASE
+// ============================================
+
+// BVH item for a shape - its bounds plus the queries it takes part in
+static BVHItem shapeBVHItem(const CollisionShape *shape) {
+    BVHItem item = {shape->minX, shape->minY, shape->minZ,
+                    shape->maxX, shape->maxY, shape->maxZ, 0};
+    if (shape->blocksProjectiles) item.flags |= ShapeQueryRaycast;
+    if (shape->isWalkable) item.flags |= ShapeQueryGround;
+    if (shape->blocksMovement && !shape->isRamp) item.flags |= ShapeQueryMove;
+    return item;
+}
+
+// Full build of the dynamic BVH - only needed when dynamic shapes are added or removed
+static void rebuildDynamicBroadphase(SimCollision *world) {
+    for (int i = 0; i < world->dynCount; i++) {
+        world->dynBvhItems[i] = shapeBVHItem(&world->dynShapes[i]);
+    }
+
+    if (bvhBuild(&world->dynBvh, world->dynBvhItems, world->dynCount)) {
+        world->dynTopologyDirty = NO;
+        world->dynBoundsDirty = NO;
+    } else {
+        fprintf(stderr, "[COLLISION] Failed to build dynamic BVH for %d shapes\n", world->dynCount);
+    }
+}
+
+void simCollisionRebuildBroadphase(SimCollision *world) {
+    if (!detachBakedCache(world)) return;
+    world->navGridValid = NO;
+    world->coverMapValid = NO;
+
+    BVHItem *items = world->bvhItems;
+
+    for (int i = 0; i < world->shapeCount; i++) {
+        items[i] = shapeBVHItem(&world->shapes[i]);
+    }
+
+    // SoA ray table (padding lanes get layer 0 so they never hit)
+    world->rayBlockCount = (world->shapeCount + SHAPE_BLOCK_WIDTH - 1) / SHAPE_BLOCK_WIDTH;
+    for (int b = 0; b < world->rayBlockCount; b++) {
+        for (int lane = 0; lane < SHAPE_BLOCK_WIDTH; lane++) {
+            int i = b * SHAPE_BLOCK_WIDTH + lane;
+            ShapeRayBlock *block = &world->rayBlocks[b];
+            if (i >= world->shapeCount) {
+                block->minX[lane] = block->minY[lane] = block->minZ[lane] = 0;
+                block->maxX[lane] = block->maxY[lane] = block->maxZ[lane] = 0;
+                block->layer[lane] = 0;
+                continue;
+            }
+            CollisionShape *shape = &world->shapes[i];
+            block->minX[lane] = shape->minX;
+            block->minY[lane] = shape->minY;
+            block->minZ[lane] = shape->minZ;
+            block->maxX[lane] = shape->maxX;
+            block->maxY[lane] = shape->maxY;
+            block->maxZ[lane] = shape->maxZ;
+            block->layer[lane] = shape->blocksProjectiles ? (unsigned int)shape->layer : 0;
+        }
+    }
+
+    // Ground height field over the walkable shapes
+    int groundCount = 0;
+    for (int i = 0; i < world->shapeCount; i++) {
+        CollisionShape *shape = &world->shapes[i];
+        if (!shape->isWalkable) continue;
+        HeightFieldItem *item = &world->groundItems[groundCount];
+        item->minX = shape->minX;
+        item->minZ = shape->minZ;
+        item->maxX = shape->maxX;
+        item->maxZ = shape->maxZ;
+        item->surfaceMinY = shape->isRamp ? fminf(shape->rampStartY, shape->rampEndY) : shape->maxY;
+        item->surfaceMaxY = shape->isRamp ? fmaxf(shape->rampStartY, shape->rampEndY) : shape->maxY;
+        world->groundShape[groundCount++] = i;
+    }
+    world->groundCount = groundCount;
+    world->groundFieldValid = hfBuild(&world->groundField, -ARENA_SIZE, -ARENA_SIZE, ARENA_SIZE, ARENA_SIZE,
+                                      GROUND_FIELD_TEXEL, GROUND_FIELD_MAX_RADIUS + BROADPHASE_PAD,
+                                      world->groundItems, groundCount);
+
+    if (bvhBuild(&world->bvh, items, world->shapeCount)) {
+        world->bvhDirty = NO;
+    } else {
+        fprintf(stderr, "[COLLISION] Failed to build BVH for %d shapes\n", world->shapeCount);
+    }
+
+    rebuildDynamicBroadphase(world);
+}
+
+static void ensureBroadphase(SimCollision *world) {
+    if (world->bvhDirty) {
+        simCollisionRebuildBroadphase(world);
+    } else if (world->dynTopologyDirty) {
+        rebuildDynamicBroadphase(world);
+    } else if (world->dynBoundsDirty) {
+        // Moved shapes keep their place in the tree - just refit the bounds
+        bvhRefit(&world->dynBvh, world->dynBvhItems);
+        world->dynBoundsDirty = NO;
+    }
+}
+
+void simCollisionPrepareQueries(SimCollision *world) {
+    ensureBroadphase(world);
+}
+
+// Candidates come back in tree order - sort to shape order so results match a linear scan
+static void sortShapeIndices(int *indices, int count) {
+    for (int i = 1; i < count; i++) {
+        int value = indices[i];
+        int j = i - 1;
+        while (j >= 0 && indices[j] > value) {
+            indices[j + 1] = indices[j];
+            j--;
+        }
+        indices[j + 1] = value;
+    }
+}
+
+// Shapes overlapping a box that take part in a query - static shapes in shape order,
+// then dynamic shapes in shape order. Fills scratch->shapes and returns the count.
+// Reads shared state only, so it is safe to call from several threads with separate scratch.
+static int collectShapes(const SimCollision *world,
+                         float minX, float minY, float minZ,
+                         float maxX, float maxY, float maxZ,
+                         unsigned int flags, QueryScratch *scratch) {
+    int count = 0;
+
+    int staticCount = bvhQueryAABB(&world->bvh, minX, minY, minZ, maxX, maxY, maxZ,
+                                   flags, scratch->candidates, scratch->capacity);
+    if (staticCount > scratch->capacity) staticCount = scratch->capacity;
+    sortShapeIndices(scratch->candidates, staticCount);
+    for (int c = 0; c < staticCount; c++) {
+        scratch->shapes[count++] = &world->shapes[scratch->candidates[c]];
+    }
+
+    int dynamicCount = bvhQueryAABB(&world->dynBvh, minX, minY, minZ, maxX, maxY, maxZ,
+                                    flags, scratch->dynCandidates, scratch->dynCapacity);
+    if (dynamicCount > scratch->dynCapacity) dynamicCount = scratch->dynCapacity;
+    sortShapeIndices(scratch->dynCandidates, dynamicCount);
+    for (int c = 0; c < dynamicCount; c++) {
+        scratch->shapes[count++] = &world->dynShapes[scratch->dynCandidates[c]];
+    }
+
+    SIM_PROFILE_COUNT(SimCounterShapesTested, count);
+    return count;
+}
+
+// ============================================
+// RAYCASTING
+// ============================================
+
+// Ray-AABB intersection against one shape (slab method)
+// Returns YES with the hit distance when the ray enters (or starts inside) the shape
+static BOOL rayHitsShape(const CollisionShape *shape, SimVec3 origin, SimVec3 direction, float *outT) {
+    float tmin = -INFINITY, tmax = INFINITY;
+
+    // X axis
+    if (fabsf(direction.x) > 0.0001f) {
+        float t1 = (shape->minX - origin.x) / direction.x;
+        float t2 = (shape->maxX - origin.x) / direction.x;
+        if (t1 > t2) { float tmp = t1; t1 = t2; t2 = tmp; }
+        tmin = fmaxf(tmin, t1);
+        tmax = fminf(tmax, t2);
+    } else if (origin.x < shape->minX || origin.x > shape->maxX) {
+        return NO;
+    }
+
+    // Y axis
+    if (fabsf(direction.y) > 0.0001f) {
+        float t1 = (shape->minY - origin.y) / direction.y;
+        float t2 = (shape->maxY - origin.y) / direction.y;
+        if (t1 > t2) { float tmp = t1; t1 = t2; t2 = tmp; }
+        tmin = fmaxf(tmin, t1);
+        tmax = fminf(tmax, t2);
+    } else if (origin.y < shape->minY || origin.y > shape->maxY) {
+        return NO;
+    }
+
+    // Z axis
+    if (fabsf(direction.z) > 0.0001f) {
+        float t1 = (shape->minZ - origin.z) / direction.z;
+        float t2 = (shape->maxZ - origin.z) / direction.z;
+        if (t1 > t2) { float tmp = t1; t1 = t2; t2 = tmp; }
+        tmin = fmaxf(tmin, t1);
+        tmax = fminf(tmax, t2);
+    } else if (origin.z < shape->minZ || origin.z > shape->maxZ) {
+        return NO;
+    }
+
+    if (tmin <= tmax && tmax > 0) {
+        *outT = tmin > 0 ? tmin : tmax;
+        return YES;
+    }
+    return NO;
+}
+
+// Calculate hit normal (which face was hit)
+static SimVec3 shapeHitNormal(const CollisionShape *shape, SimVec3 hitPt) {
+    float eps = 0.01f;
+    if (fabsf(hitPt.x - shape->minX) < eps) return simVec3(-1, 0, 0);
+    if (fabsf(hitPt.x - shape->maxX) < eps) return simVec3(1, 0, 0);
+    if (fabsf(hitPt.y - shape->minY) < eps) return simVec3(0, -1, 0);
+    if (fabsf(hitPt.y - shape->maxY) < eps) return simVec3(0, 1, 0);
+    if (fabsf(hitPt.z - shape->minZ) < eps) return simVec3(0, 0, -1);
+    return simVec3(0, 0, 1);
+}
+
+static RaycastResult missResult(float maxDistance) {
+    RaycastResult result = {NO, maxDistance, {0, 0, 0}, {0, 0, 0}, -1, CollisionShapeTypeWall};
+    return result;
+}
+
+typedef struct {
+    const CollisionShape *shapes;
+    int indexBase;              // Added to item indices for tie-breaks (dynamic shapes order after static)
+    SimVec3 origin;
+    SimVec3 direction;
+    CollisionLayer layerMask;
+    RaycastResult *result;
+    int hitIndex;
+} RaycastContext;
+
+// BVH leaf callback - exact test against one shape, keeps the closest hit
+static float raycastShapeLeaf(void *context, int item, float closestT) {
+    RaycastContext *ctx = context;
+    const CollisionShape *shape = &ctx->shapes[item];
+    int index = ctx->indexBase + item;
+    SIM_PROFILE_COUNT(SimCounterShapesTested, 1);
+
+    // Check layer mask
+    if (!(shape->layer & ctx->layerMask)) return closestT;
+    if (!shape->blocksProjectiles) return closestT;
+
+    float hitT;
+    if (!rayHitsShape(shape, ctx->origin, ctx->direction, &hitT)) return closestT;
+
+    // Equal distances resolve to the lowest shape index, same as a linear scan
+    BOOL closer = hitT < closestT ||
+                  (hitT == closestT && ctx->result->hit && index < ctx->hitIndex);
+    if (!closer) return closestT;
+
+    RaycastResult *result = ctx->result;
+    result->hit = YES;
+    result->distance = hitT;
+    result->hitPoint = simMulAdd(ctx->origin, ctx->direction, hitT);
+    result->shapeId = shape->shapeId;
+    result->shapeType = shape->type;
+    result->hitNormal = shapeHitNormal(shape, result->hitPoint);
+    ctx->hitIndex = index;
+    return hitT;
+}
+
+RaycastResult simCollisionRaycast(SimCollision *world, SimVec3 origin, SimVec3 direction,
+                                  float maxDistance, CollisionLayer layerMask) {
+    SIM_PROFILE_COUNT(SimCounterRaysCast, 1);
+    RaycastResult result = missResult(maxDistance);
+
+    // Normalize direction
+    float len = simLength(direction);
+    if (len < 0.0001f) return result;
+    direction = simVec3(direction.x / len, direction.y / len, direction.z / len);
+
+    ensureBroadphase(world);
+
+    RaycastContext ctx = {world->shapes, 0, origin, direction, layerMask, &result, -1};
+    bvhRaycast(&world->bvh, origin.x, origin.y, origin.z,
+               direction.x, direction.y, direction.z,
+               maxDistance, ShapeQueryRaycast, raycastShapeLeaf, &ctx);
+
+    // Dynamic shapes, only closer than the static hit
+    ctx.shapes = world->dynShapes;
+    ctx.indexBase = world->shapeCount;
+    bvhRaycast(&world->dynBvh, origin.x, origin.y, origin.z,
+               direction.x, direction.y, direction.z,
+               result.distance, ShapeQueryRaycast, raycastShapeLeaf, &ctx);
+
+    return result;
+}
+
+static inline Float4 splat4(float value) {
+    Float4 v = {value, value, value, value};
+    return v;
+}
+
+// mask ? b : a, lane by lane (mask lanes are all ones or all zeros)
+static inline Float4 select4(Float4 a, Float4 b, Int4 mask) {
+    return (Float4)(((Int4)a & ~mask) | ((Int4)b & mask));
+}
+
+static inline BOOL any4(Int4 mask) {
+    return (mask[0] | mask[1] | mask[2] | mask[3]) != 0;
+}
+
+// One slab axis for 4 shapes at once - same math as rayHitsShape, lane by lane
+static inline void slabAxis4(Float4 minV, Float4 maxV, float o, float d,
+                             Float4 *tmin, Float4 *tmax, Int4 *valid) {
+    Float4 ov = splat4(o);
+    if (fabsf(d) > 0.0001f) {
+        Float4 dv = splat4(d);
+        Float4 t1 = (minV - ov) / dv;
+        Float4 t2 = (maxV - ov) / dv;
+        Float4 near = select4(t1, t2, t2 < t1);
+        Float4 far = select4(t2, t1, t2 < t1);
+        *tmin = select4(*tmin, near, near > *tmin);
+        *tmax = select4(*tmax, far, far < *tmax);
+    } else {
+        *valid &= (ov >= minV) & (ov <= maxV);
+    }
+}
+
+// Ray-table blocks holding the static shapes a normalized ray can hit within maxDistance:
+// the BVH finds the shapes overlapping the segment's bounds, and their blocks are listed
+// ascending, without repeats, over the same scratch list. Returns how many.
+static int rayCandidateBlocks(const SimCollision *world, SimVec3 origin, SimVec3 direction,
+                              float maxDistance, QueryScratch *scratch) {
+    SimVec3 end = simMulAdd(origin, direction, maxDistance);
+    int *list = scratch->candidates;
+    int count = bvhQueryAABB(&world->bvh,
+                             fminf(origin.x, end.x) - BROADPHASE_PAD, fminf(origin.y, end.y) - BROADPHASE_PAD,
+                             fminf(origin.z, end.z) - BROADPHASE_PAD,
+                             fmaxf(origin.x, end.x) + BROADPHASE_PAD, fmaxf(origin.y, end.y) + BROADPHASE_PAD,
+                             fmaxf(origin.z, end.z) + BROADPHASE_PAD,
+                             ShapeQueryRaycast, list, scratch->capacity);
+    if (count > scratch->capacity) count = scratch->capacity;
+
+    // In place - the block list never grows past the candidates read so far
+    int blockCount = 0;
+    for (int c = 0; c < count; c++) {
+        int block = list[c] / SHAPE_BLOCK_WIDTH;
+        int slot = blockCount;
+        while (slot > 0 && list[slot - 1] > block) slot--;
+        if (slot > 0 && list[slot - 1] == block) continue;
+        memmove(&list[slot + 1], &list[slot], sizeof(int) * (size_t)(blockCount - slot));
+        list[slot] = block;
+        blockCount++;
+    }
+    return blockCount;
+}
+
+// Closest static hit along a normalized ray among the given ray-table blocks, 4 shapes at
+// a time. Returns the shape index (lowest on ties, same as a linear scan) or -1, with its
+// distance in outT.
+static int raycastRayBlocks(const SimCollision *world, SimVec3 origin, SimVec3 direction,
+                            float maxDistance, CollisionLayer layerMask,
+                            const int *blocks, int blockCount, float *outT) {
+    SIM_PROFILE_COUNT(SimCounterShapesTested, blockCount * SHAPE_BLOCK_WIDTH);
+    const Int4 laneIndex = {0, 1, 2, 3};
+    const UInt4 maskV = {layerMask, layerMask, layerMask, layerMask};
+    const UInt4 zeroU = {0, 0, 0, 0};
+
+    // Per-lane closest hit - strict < keeps the lowest shape index on ties
+    Float4 bestT = splat4(maxDistance);
+    Int4 bestIndex = {-1, -1, -1, -1};
+
+    for (int i = 0; i < blockCount; i++) {
+        int b = blocks[i];
+        const ShapeRayBlock *block = &world->rayBlocks[b];
+        Int4 valid = (block->layer & maskV) != zeroU;
+        if (!any4(valid)) continue;
+
+        Float4 tmin = splat4(-INFINITY), tmax = splat4(INFINITY);
+        slabAxis4(block->minX, block->maxX, origin.x, direction.x, &tmin, &tmax, &valid);
+        slabAxis4(block->minY, block->maxY, origin.y, direction.y, &tmin, &tmax, &valid);
+        slabAxis4(block->minZ, block->maxZ, origin.z, direction.z, &tmin, &tmax, &valid);
+
+        Float4 zero = splat4(0.0f);
+        Float4 hitT = select4(tmax, tmin, tmin > zero);
+        Int4 closer = valid & (tmin <= tmax) & (tmax > zero) & (hitT < bestT);
+        bestT = select4(bestT, hitT, closer);
+        Int4 blockIndex = laneIndex + b * SHAPE_BLOCK_WIDTH;
+        bestIndex = (bestIndex & ~closer) | (blockIndex & closer);
+    }
+
+    // Reduce lanes - closest distance, lowest shape index on ties
+    int hitIndex = -1;
+    float hitT = maxDistance;
+    for (int lane = 0; lane < SHAPE_BLOCK_WIDTH; lane++) {
+        if (bestIndex[lane] < 0) continue;
+        if (hitIndex < 0 || bestT[lane] < hitT ||
+            (bestT[lane] == hitT && bestIndex[lane] < hitIndex)) {
+            hitT = bestT[lane];
+            hitIndex = bestIndex[lane];
+        }
+    }
+    *outT = hitT;
+    return hitIndex;
+}
+
+void simCollisionRaycastBatch(SimCollision *world, const SimVec3 *origins, const SimVec3 *directions,
+                              int count, float maxDistance, CollisionLayer layerMask,
+                              RaycastResult *results) {
+    ensureBroadphase(world);
+    SIM_PROFILE_COUNT(SimCounterRaysCast, count);
+    QueryScratch *scratch = threadScratch(world);
+
+    for (int r = 0; r < count; r++) {
+        RaycastResult result = missResult(maxDistance);
+
+        // Normalize direction
+        SimVec3 origin = origins[r];
+        SimVec3 direction = directions[r];
+        float len = simLength(direction);
+        if (len < 0.0001f) {
+            results[r] = result;
+            continue;
+        }
+        direction = simVec3(direction.x / len, direction.y / len, direction.z / len);
+
+        // The BVH picks the blocks along the ray, the SIMD kernel tests them
+        int blockCount = rayCandidateBlocks(world, origin, direction, maxDistance, scratch);
+        float hitT;
+        int hitIndex = raycastRayBlocks(world, origin, direction, maxDistance, layerMask,
+                                        scratch->candidates, blockCount, &hitT);
+
+        if (hitIndex >= 0) {
+            CollisionShape *shape = &world->shapes[hitIndex];
+            result.hit = YES;
+            result.distance = hitT;
+            result.hitPoint = simMulAdd(origin, direction, hitT);
+            result.shapeId = shape->shapeId;
+            result.shapeType = shape->type;
+            result.hitNormal = shapeHitNormal(shape, result.hitPoint);
+        }
+
+        // Dynamic shapes aren't in the ray table - few enough for a scalar BVH pass
+        if (world->dynCount > 0) {
+            RaycastContext ctx = {world->dynShapes, world->shapeCount, origin, direction, layerMask,
+                                  &result, hitIndex};
+            bvhRaycast(&world->dynBvh, origin.x, origin.y, origin.z,
+                       direction.x, direction.y, direction.z,
+                       result.distance, ShapeQueryRaycast, raycastShapeLeaf, &ctx);
+        }
+
+        results[r] = result;
+    }
+}
+
+// ============================================
+// SWEPT MOVEMENT
+// ============================================
+
+// Strict overlap - boxes that only touch don't count
+static BOOL aabbOverlapStrict(CollisionAABB a, CollisionAABB b) {
+    return (a.minX < b.maxX && a.maxX > b.minX &&
+            a.minY < b.maxY && a.maxY > b.minY &&
+            a.minZ < b.maxZ && a.maxZ > b.minZ);
+}
+
+static SweepMoveResult sweepFrom(const SimCollision *world, SimVec3 position, SimVec3 velocity,
+                                 float radius, float height, QueryScratch *scratch) {
+    SweepMoveResult result = {NO, 1.0f, position, velocity, {0, 0, 0}, -1};
+
+    SimVec3 move = velocity;
+    float moveLength = simLength(move);
+    float consumed = 0.0f;      // Fraction of the original move already travelled
+
+    for (int iter = 0; iter < SWEEP_MAX_ITERATIONS; iter++) {
+        float length = simLength(move);
+        if (length < 0.0001f) break;
+
+        // Player box - feet lifted by the skin so the surface we stand on isn't a hit
+        CollisionAABB box = {
+            position.x - radius, position.y - height + SWEEP_SKIN, position.z - radius,
+            position.x + radius, position.y + 0.1f, position.z + radius
+        };
+
+        // Broadphase over the whole swept volume
+        int candidateCount = collectShapes(world,
+                                           fminf(box.minX, box.minX + move.x) - BROADPHASE_PAD,
+                                           fminf(box.minY, box.minY + move.y) - BROADPHASE_PAD,
+                                           fminf(box.minZ, box.minZ + move.z) - BROADPHASE_PAD,
+                                           fmaxf(box.maxX, box.maxX + move.x) + BROADPHASE_PAD,
+                                           fmaxf(box.maxY, box.maxY + move.y) + BROADPHASE_PAD,
+                                           fmaxf(box.maxZ, box.maxZ + move.z) + BROADPHASE_PAD,
+                                           ShapeQueryMove, scratch);
+
+        float bestT = 2.0f;
+        const CollisionShape *bestShape = NULL;
+        SimVec3 bestNormal = {0, 0, 0};
+
+        for (int c = 0; c < candidateCount; c++) {
+            const CollisionShape *shape = scratch->shapes[c];
+            CollisionAABB obstacle = {shape->minX, shape->minY, shape->minZ,
+                                      shape->maxX, shape->maxY, shape->maxZ};
+
+            // Already inside - left to the overlap push-out
+            if (aabbOverlapStrict(box, obstacle)) continue;
+
+            SweepResult sweep = sweptAABB(box, move.x, move.y, move.z, obstacle);
+            if (!sweep.hit || sweep.tEntry >= bestT) continue;
+
+            // Only faces we are moving into
+            SimVec3 normal = simVec3(sweep.hitNormal[0], sweep.hitNormal[1], sweep.hitNormal[2]);
+            if (simDot(normal, move) >= 0) continue;
+
+            bestT = sweep.tEntry;
+            bestShape = shape;
+            bestNormal = normal;
+        }
+
+        if (!bestShape) {
+            position = simAdd(position, move);
+            break;
+        }
+
+        // Advance to the contact, then back off by the skin along the normal
+        position = simAdd(position, simAdd(simScale(move, bestT), simScale(bestNormal, SWEEP_SKIN)));
+
+        if (!result.hit) {
+            result.hit = YES;
+            result.timeOfImpact = moveLength > 0 ? consumed + bestT * length / moveLength : 0.0f;
+            result.hitNormal = bestNormal;
+            result.hitShapeId = bestShape->shapeId;
+        }
+        consumed += bestT * length / moveLength;
+
+        // Slide - drop the part of the remaining move and the velocity going into the surface
+        move = simScale(move, 1.0f - bestT);
+        move = simMulAdd(move, bestNormal, -simDot(move, bestNormal));
+        float into = simDot(result.slideVelocity, bestNormal);
+        if (into < 0) {
+            result.slideVelocity = simMulAdd(result.slideVelocity, bestNormal, -into);
+        }
+    }
+
+    result.position = position;
+    return result;
+}
+
+SweepMoveResult simCollisionSweepPlayer(SimCollision *world, SimVec3 position, SimVec3 velocity,
+                                        float radius, float height) {
+    ensureBroadphase(world);
+    return sweepFrom(world, position, velocity, radius, height, threadScratch(world));
+}
+
+// ============================================
+// LINE OF SIGHT
+// ============================================
+
+typedef struct {
+    const CollisionShape *shapes;
+    const CollisionBVH *bvh;
+} WorldSegmentContext;
+
+// Whether a segment hits a projectile blocker in one shape set - reads the BVH only, safe across threads
+static bool segmentBlockedByWorld(void *context, const float from[3], const float to[3]) {
+    const WorldSegmentContext *world = context;
+
+    SimVec3 origin = simVec3(from[0], from[1], from[2]);
+    SimVec3 delta = simSub(simVec3(to[0], to[1], to[2]), origin);
+    float dist = simLength(delta);
+    if (dist < 0.0001f) return false;
+    SimVec3 direction = simVec3(delta.x / dist, delta.y / dist, delta.z / dist);
+
+    RaycastResult result = missResult(dist);
+    RaycastContext ctx = {world->shapes, 0, origin, direction, CollisionLayerWorld, &result, -1};
+    bvhRaycast(world->bvh, origin.x, origin.y, origin.z,
+               direction.x, direction.y, direction.z,
+               dist, ShapeQueryRaycast, raycastShapeLeaf, &ctx);
+    return result.hit;
+}
+
+// Line of sight for one pair - the SIMD ray kernel over the static blocks the BVH finds
+// along the segment, then the dynamic shapes. The caller brings the broadphase up to date.
+static BOOL lineOfSight(SimCollision *world, SimVec3 from, SimVec3 to, QueryScratch *scratch) {
+    SimVec3 delta = simSub(to, from);
+    float dist = simLength(delta);
+    if (dist < 0.0001f) return YES;
+
+    SimVec3 direction = simVec3(delta.x / dist, delta.y / dist, delta.z / dist);
+    int blockCount = rayCandidateBlocks(world, from, direction, dist, scratch);
+    float hitT;
+    if (raycastRayBlocks(world, from, direction, dist, CollisionLayerWorld,
+                         scratch->candidates, blockCount, &hitT) >= 0) return NO;
+
+    // Dynamic shapes aren't in the ray blocks
+    if (world->dynCount == 0) return YES;
+    float fromArr[3] = {from.x, from.y, from.z};
+    float toArr[3] = {to.x, to.y, to.z};
+    WorldSegmentContext moving = {world->dynShapes, &world->dynBvh};
+    return !segmentBlockedByWorld(&moving, fromArr, toArr);
+}
+
+BOOL simCollisionLineOfSight(SimCollision *world, SimVec3 from, SimVec3 to) {
+    ensureBroadphase(world);
+    SIM_PROFILE_COUNT(SimCounterRaysCast, 1);
+    return lineOfSight(world, from, to, threadScratch(world));
+}
+
+void simCollisionLineOfSightBatch(SimCollision *world, const SimVec3 *from, const SimVec3 *to,
+                                  int count, BOOL *results) {
+    ensureBroadphase(world);
+    SIM_PROFILE_COUNT(SimCounterRaysCast, count);
+    QueryScratch *scratch = threadScratch(world);
+    for (int i = 0; i < count; i++) {
+        results[i] = lineOfSight(world, from[i], to[i], scratch);
+    }
+}
+
+// ============================================
+// GROUND DETECTION
+// ============================================
+
+// Ramp surface height at (x, z), clamped to the ramp ends
+static float rampSurfaceY(const CollisionShape *shape, float x, float z) {
+    if (!shape->isRamp) return shape->maxY;
+
+    float progress;
+    if (shape->rampAxis == 0) {
+        // Ramp along X axis
+        float rangeX = shape->maxX - shape->minX;
+        if (rangeX < 0.001f) return shape->rampStartY;
+        progress = (x - shape->minX) / rangeX;
+        if (shape->rampDirection < 0) progress = 1.0f - progress;
+    } else {
+        // Ramp along Z axis
+        float rangeZ = shape->maxZ - shape->minZ;
+        if (rangeZ < 0.001f) return shape->rampStartY;
+        progress = (z - shape->minZ) / rangeZ;
+        if (shape->rampDirection < 0) progress = 1.0f - progress;
+    }
+
+    progress = fmaxf(0.0f, fminf(1.0f, progress));
+    return shape->rampStartY + progress * (shape->rampEndY - shape->rampStartY);
+}
+
+// Ground tolerance values
+static const float GROUND_STANDING_TOLERANCE = 0.15f;  // How close feet must be to surface to stand
+static const float GROUND_LANDING_TOLERANCE = 0.1f;    // Extra tolerance when falling
+
+typedef struct {
+    float bestGroundY;
+    int bestShapeId;
+    BOOL onRamp;
+} GroundSearch;
+
+// Test one walkable shape and keep it if it is the highest standable surface so far
+static void considerGroundShape(const CollisionShape *shape, float x, float z, float radius,
+                                float feetY, GroundSearch *search) {
+    if (!shape->isWalkable) return;
+
+    // Check horizontal overlap (with player radius)
+    BOOL xOverlap = (x + radius > shape->minX) && (x - radius < shape->maxX);
+    BOOL zOverlap = (z + radius > shape->minZ) && (z - radius < shape->maxZ);
+
+    if (!xOverlap || !zOverlap) return;
+
+    float surfaceY = rampSurfaceY(shape, x, z);
+
+    // Check if player feet are at or just above the surface
+    float distAbove = feetY - surfaceY;
+
+    // Can stand if: feet are within tolerance of surface AND surface is higher than current best
+    if (distAbove >= -GROUND_LANDING_TOLERANCE && distAbove <= GROUND_STANDING_TOLERANCE) {
+        if (surfaceY > search->bestGroundY) {
+            search->bestGroundY = surfaceY;
+            search->bestShapeId = shape->shapeId;
+            search->onRamp = shape->isRamp;
+        }
+    }
+}
+
+// useField NO skips the height field and searches the BVH - only to check the field against
+static GroundResult groundAt(const SimCollision *world, float x, float y, float z,
+                             float radius, float height, BOOL useField, QueryScratch *scratch) {
+    GroundResult result = {NO, FLOOR_Y, NO, -1};
+
+    float feetY = y - height;
+    GroundSearch search = {-1000.0f, -1, NO};
+
+    float lowY = feetY - GROUND_STANDING_TOLERANCE - BROADPHASE_PAD;
+    float highY = feetY + GROUND_LANDING_TOLERANCE + BROADPHASE_PAD;
+
+    // Height field: the surfaces under this texel, already in shape order
+    const HeightFieldLayer *layers = NULL;
+    int layerCount = -1;
+    if (useField && world->groundFieldValid && radius <= GROUND_FIELD_MAX_RADIUS) {
+        layerCount = hfLayersAt(&world->groundField, x, z, &layers);
+    }
+
+    if (layerCount >= 0) {
+        for (int l = 0; l < layerCount; l++) {
+            if (layers[l].surfaceMaxY < lowY || layers[l].surfaceMinY > highY) continue;
+            considerGroundShape(&world->shapes[world->groundShape[layers[l].item]], x, z, radius, feetY, &search);
+        }
+
+        // Dynamic surfaces aren't baked
+        int candidateCount = bvhQueryAABB(&world->dynBvh,
+                                          x - radius - BROADPHASE_PAD, lowY, z - radius - BROADPHASE_PAD,
+                                          x + radius + BROADPHASE_PAD, highY, z + radius + BROADPHASE_PAD,
+                                          ShapeQueryGround, scratch->dynCandidates, scratch->dynCapacity);
+        if (candidateCount > scratch->dynCapacity) candidateCount = scratch->dynCapacity;
+        sortShapeIndices(scratch->dynCandidates, candidateCount);
+        for (int c = 0; c < candidateCount; c++) {
+            considerGroundShape(&world->dynShapes[scratch->dynCandidates[c]], x, z, radius, feetY, &search);
+        }
+    } else {
+        // Outside the field, overflowed texel or oversized radius - BVH search
+        int candidateCount = collectShapes(world,
+                                           x - radius - BROADPHASE_PAD, lowY, z - radius - BROADPHASE_PAD,
+                                           x + radius + BROADPHASE_PAD, highY, z + radius + BROADPHASE_PAD,
+                                           ShapeQueryGround, scratch);
+        for (int c = 0; c < candidateCount; c++) {
+            considerGroundShape(scratch->shapes[c], x, z, radius, feetY, &search);
+        }
+    }
+
+    // Also check base floor
+    if (feetY <= FLOOR_Y + GROUND_STANDING_TOLERANCE && FLOOR_Y > search.bestGroundY) {
+        search.bestGroundY = FLOOR_Y;
+        search.bestShapeId = -1;
+        search.onRamp = NO;
+    }
+
+    if (search.bestGroundY > -999.0f) {
+        result.onGround = YES;
+        result.groundY = search.bestGroundY;
+        result.onRamp = search.onRamp;
+        result.groundShapeId = search.bestShapeId;
+    }
+
+    return result;
+}
+
+GroundResult simCollisionCheckGround(SimCollision *world, float x, float y, float z,
+                                     float radius, float height) {
+    ensureBroadphase(world);
+    return groundAt(world, x, y, z, radius, height, YES, threadScratch(world));
+}
+
+int simCollisionVerifyGroundField(SimCollision *world, int samples, uint64_t seed) {
+    ensureBroadphase(world);
+    QueryScratch *scratch = threadScratch(world);
+    SimRng rng;
+    simRngSeed(&rng, seed, 0);
+
+    int walkable = 0;
+    for (int i = 0; i < world->shapeCount; i++) {
+        if (world->shapes[i].isWalkable) walkable++;
+    }
+
+    int mismatches = 0;
+    for (int n = 0; n < samples; n++) {
+        float radius = simRngFloat(&rng) * GROUND_FIELD_MAX_RADIUS;
+        float height = PLAYER_HEIGHT;
+        float x, z, feetY;
+
+        // Half the samples stand near a walkable top, around and past its edges; the rest
+        // land anywhere up to the tower tops
+        if ((n & 1) && walkable > 0) {
+            int pick = simRngRange(&rng, walkable);
+            const CollisionShape *shape = NULL;
+            for (int i = 0; i < world->shapeCount && !shape; i++) {
+                if (world->shapes[i].isWalkable && pick-- == 0) shape = &world->shapes[i];
+            }
+            float reach = radius + 2.0f * BROADPHASE_PAD;
+            x = shape->minX - reach + simRngFloat(&rng) * (shape->maxX - shape->minX + 2.0f * reach);
+            z = shape->minZ - reach + simRngFloat(&rng) * (shape->maxZ - shape->minZ + 2.0f * reach);
+            feetY = rampSurfaceY(shape, x, z) + (simRngFloat(&rng) - 0.5f) * 0.6f;
+        } else {
+            x = (simRngFloat(&rng) * 2.0f - 1.0f) * (ARENA_SIZE + 1.0f);
+            z = (simRngFloat(&rng) * 2.0f - 1.0f) * (ARENA_SIZE + 1.0f);
+            feetY = FLOOR_Y - 0.5f + simRngFloat(&rng) * 16.0f;
+        }
+
+        GroundResult field = groundAt(world, x, feetY + height, z, radius, height, YES, scratch);
+        GroundResult dense = groundAt(world, x, feetY + height, z, radius, height, NO, scratch);
+        if (field.onGround != dense.onGround || field.groundY != dense.groundY ||
+            field.onRamp != dense.onRamp || field.groundShapeId != dense.groundShapeId) {
+            if (mismatches < 8) {
+                fprintf(stderr, "[COLLISION] Ground field differs at (%.3f, %.3f, %.3f) r %.3f: "
+                        "field %d %.4f shape %d, search %d %.4f shape %d\n",
+                        x, feetY, z, radius, field.onGround, field.groundY, field.groundShapeId,
+                        dense.onGround, dense.groundY, dense.groundShapeId);
+            }
+            mismatches++;
+        }
+    }
+    return mismatches;
+}
+
+// ============================================
+// MOVEMENT COLLISION
+// ============================================
+
+static MoveResult pushOutFrom(const SimCollision *world, SimVec3 position, SimVec3 velocity,
+                              float radius, float height, QueryScratch *scratch) {
+    MoveResult result = {NO, {0, 0, 0}, velocity, -1};
+
+    // Player AABB
+    float playerMinX = position.x - radius;
+    float playerMaxX = position.x + radius;
+    float playerMinY = position.y - height;
+    float playerMaxY = position.y + 0.1f;  // Small margin above eyes
+    float playerMinZ = position.z - radius;
+    float playerMaxZ = position.z + radius;
+
+    SimVec3 pushOut = {0, 0, 0};
+
+    // Broadphase: blocking shapes overlapping the player box
+    int candidateCount = collectShapes(world,
+                                       playerMinX - BROADPHASE_PAD,
+                                       playerMinY - BROADPHASE_PAD,
+                                       playerMinZ - BROADPHASE_PAD,
+                                       playerMaxX + BROADPHASE_PAD,
+                                       playerMaxY + BROADPHASE_PAD,
+                                       playerMaxZ + BROADPHASE_PAD,
+                                       ShapeQueryMove, scratch);
+
+    for (int c = 0; c < candidateCount; c++) {
+        const CollisionShape *shape = scratch->shapes[c];
+        if (!shape->blocksMovement) continue;
+        // Skip ramps - they're handled by ground detection, not wall collision
+        if (shape->isRamp) continue;
+
+        // Expand shape by player radius for collision
+        float sMinX = shape->minX - radius;
+        float sMaxX = shape->maxX + radius;
+        float sMinY = shape->minY;
+        float sMaxY = shape->maxY;
+        float sMinZ = shape->minZ - radius;
+        float sMaxZ = shape->maxZ + radius;
+
+        // Check overlap
+        BOOL xOv = position.x > sMinX && position.x < sMaxX;
+        BOOL yOv = playerMinY < sMaxY && playerMaxY > sMinY;
+        BOOL zOv = position.z > sMinZ && position.z < sMaxZ;
+
+        if (xOv && yOv && zOv) {
+            // Calculate penetration on each axis
+            float penLeft = position.x - sMinX;
+            float penRight = sMaxX - position.x;
+            float penDown = playerMaxY - sMinY;
+            float penUp = sMaxY - playerMinY;
+            float penBack = position.z - sMinZ;
+            float penFront = sMaxZ - position.z;
+
+            float minPenX = fminf(penLeft, penRight);
+            float minPenZ = fminf(penBack, penFront);
+            float minPenY = fminf(penDown, penUp);
+
+            // Choose smallest penetration axis to resolve
+            if (minPenY < minPenX && minPenY < minPenZ) {
+                // Resolve on Y axis
+                if (penDown < penUp) {
+                    pushOut.y -= penDown;
+                    if (result.newVelocity.y > 0) result.newVelocity.y = 0;
+                } else {
+                    pushOut.y += penUp;
+                    if (result.newVelocity.y < 0) result.newVelocity.y = 0;
+                }
+            } else if (minPenX < minPenZ) {
+                // Resolve on X axis
+                if (penLeft < penRight) {
+                    pushOut.x -= penLeft;
+                } else {
+                    pushOut.x += penRight;
+                }
+                result.newVelocity.x = 0;
+            } else {
+                // Resolve on Z axis
+                if (penBack < penFront) {
+                    pushOut.z -= penBack;
+                } else {
+                    pushOut.z += penFront;
+                }
+                result.newVelocity.z = 0;
+            }
+
+            result.collided = YES;
+            result.hitShapeId = shape->shapeId;
+        }
+    }
+
+    result.pushOut = pushOut;
+    return result;
+}
+
+MoveResult simCollisionMovePlayer(SimCollision *world, SimVec3 position, SimVec3 velocity,
+                                  float radius, float height) {
+    ensureBroadphase(world);
+    return pushOutFrom(world, position, velocity, radius, height, threadScratch(world));
+}
+
+// ============================================
+// BATCHED KINEMATICS
+// ============================================
+
+// One body: swept move, ground snap, then overlap push-out - the same steps the
+// player and bots run one call at a time
+static KinematicResult resolveBody(const SimCollision *world, SimVec3 position, SimVec3 velocity,
+                                   float radius, float height, QueryScratch *scratch) {
+    KinematicResult result = {0};
+
+    result.sweep = sweepFrom(world, position, velocity, radius, height, scratch);
+    SimVec3 pos = result.sweep.position;
+    SimVec3 vel = result.sweep.hit ? result.sweep.slideVelocity : velocity;
+
+    result.ground = groundAt(world, pos.x, pos.y, pos.z, radius, height, YES, scratch);
+    if (result.ground.onGround) {
+        pos.y = result.ground.groundY + height;
+        vel.y = 0;
+        result.onGround = YES;
+    }
+
+    result.move = pushOutFrom(world, pos, vel, radius, height, scratch);
+    if (result.move.collided) {
+        pos = simAdd(pos, result.move.pushOut);
+        vel = result.move.newVelocity;
+
+        // Pushed up onto a surface
+        if (result.move.pushOut.y > 0 && vel.y == 0) {
+            result.onGround = YES;
+        }
+    }
+
+    result.position = pos;
+    result.velocity = vel;
+    return result;
+}
+
+typedef struct {
+    const SimCollision *world;
+    const SimVec3 *positions;
+    const SimVec3 *velocities;
+    const float *radii;
+    const float *heights;
+    int count;
+    KinematicResult *results;
+} KinematicJob;
+
+// Chunks write disjoint results and only read shared collision data
+static void resolveKinematicChunk(void *context, int chunk) {
+    const KinematicJob *job = context;
+    int begin = chunk * KINEMATIC_CHUNK_SIZE;
+    int end = begin + KINEMATIC_CHUNK_SIZE < job->count ? begin + KINEMATIC_CHUNK_SIZE : job->count;
+    QueryScratch *scratch = threadScratch(job->world);
+    for (int i = begin; i < end; i++) {
+        job->results[i] = resolveBody(job->world, job->positions[i], job->velocities[i],
+                                      job->radii[i], job->heights[i], scratch);
+    }
+}
+
+void simCollisionResolveKinematics(SimCollision *world, const SimVec3 *positions,
+                                   const SimVec3 *velocities, const float *radii,
+                                   const float *heights, int count, KinematicResult *results) {
+    if (count <= 0) return;
+    ensureBroadphase(world);
+
+    // Small batches aren't worth the hand-off; without worker threads this runs inline
+    int chunkCount = (count + KINEMATIC_CHUNK_SIZE - 1) / KINEMATIC_CHUNK_SIZE;
+    KinematicJob job = {world, positions, velocities, radii, heights, count, results};
+    if (chunkCount == 1) {
+        resolveKinematicChunk(&job, 0);
+        return;
+    }
+    simJobParallelFor(world->jobs, chunkCount, resolveKinematicChunk, &job);
+}
+
+// ============================================
+// NAVIGATION
+// ============================================
+
+// Surfaces at (x, z) the nav agent can stand on - on ground the physics accepts, with
+// nothing static overlapping its body
+static int navSurfacesAt(void *context, float x, float z, float *outY, int maxSurfaces) {
+    const SimCollision *world = context;
+    QueryScratch *scratch = threadScratch(world);
+    float reach = NAV_AGENT_RADIUS + BROADPHASE_PAD;
+
+    // Candidates: the floor and the top of every walkable shape under the body
+    float candidates[NAV_MAX_LAYERS * 4];
+    int candidateCount = 0;
+    candidates[candidateCount++] = FLOOR_Y;
+    int shapeCount = bvhQueryAABB(&world->bvh, x - reach, FLOOR_Y - BROADPHASE_PAD, z - reach,
+                                  x + reach, INFINITY, z + reach,
+                                  ShapeQueryGround, scratch->candidates, scratch->capacity);
+    if (shapeCount > scratch->capacity) shapeCount = scratch->capacity;
+    for (int c = 0; c < shapeCount && candidateCount < NAV_MAX_LAYERS * 4; c++) {
+        candidates[candidateCount++] = rampSurfaceY(&world->shapes[scratch->candidates[c]], x, z);
+    }
+
+    // Lowest first
+    for (int i = 1; i < candidateCount; i++) {
+        float y = candidates[i];
+        int j = i;
+        for (; j > 0 && candidates[j - 1] > y; j--) candidates[j] = candidates[j - 1];
+        candidates[j] = y;
+    }
+
+    int count = 0;
+    for (int i = 0; i < candidateCount && count < maxSurfaces; i++) {
+        float eyeY = candidates[i] + NAV_AGENT_HEIGHT;
+        GroundResult ground = groundAt(world, x, eyeY, z, NAV_AGENT_RADIUS, NAV_AGENT_HEIGHT, YES, scratch);
+        if (!ground.onGround) continue;
+
+        SimVec3 standing = simVec3(x, ground.groundY + NAV_AGENT_HEIGHT + SWEEP_SKIN, z);
+        MoveResult overlap = pushOutFrom(world, standing, simVec3(0, 0, 0), NAV_AGENT_RADIUS, NAV_AGENT_HEIGHT, scratch);
+        if (overlap.collided) continue;
+        if (count > 0 && ground.groundY <= outY[count - 1]) continue;
+        outY[count++] = ground.groundY;
+    }
+    return count;
+}
+
+// A link is good when the body, lifted to the higher of the two surfaces, sweeps from one
+// cell center to the other without touching anything - walking, a jump up onto a ledge,
+// or a drop off one
+static bool navCanStep(void *context, const float from[3], const float to[3]) {
+    const SimCollision *world = context;
+    float rise = to[1] - from[1];
+    if (rise > NAV_MAX_CLIMB || rise < -NAV_MAX_DROP) return false;
+
+    float eyeY = fmaxf(from[1], to[1]) + NAV_AGENT_HEIGHT + GROUND_STANDING_TOLERANCE;
+    SimVec3 start = simVec3(from[0], eyeY, from[2]);
+    SimVec3 move = simVec3(to[0] - from[0], 0, to[2] - from[2]);
+    SweepMoveResult sweep = sweepFrom(world, start, move, NAV_AGENT_RADIUS, NAV_AGENT_HEIGHT, threadScratch(world));
+    return !sweep.hit;
+}
+
+static void buildNavSurfaceRow(void *context, int row) {
+    SimCollision *world = context;
+    navGridBuildSurfaces(&world->navGrid, row, navSurfacesAt, world);
+}
+
+static void buildNavLinkRow(void *context, int row) {
+    SimCollision *world = context;
+    navGridBuildLinks(&world->navGrid, row, navCanStep, world);
+}
+
+// Forget the cached paths and flow fields - the grid they were found on is gone
+static void resetNavQueries(SimCollision *world) {
+    pthread_mutex_lock(&world->navCacheLock);
+    if (world->navCache) memset(world->navCache, 0, sizeof(NavPathEntry) * NAV_PATH_CACHE_SIZE);
+    pthread_mutex_unlock(&world->navCacheLock);
+    for (int i = 0; i < SIM_NAV_FLOW_FIELDS; i++) {
+        world->navFlow[i].built = NO;
+    }
+}
+
+void simCollisionBuildNavGrid(SimCollision *world) {
+    // A mapped grid can't be freed - copy the shapes out and rebuild from them
+    if (!detachBakedCache(world)) return;
+    ensureBroadphase(world);
+    world->navGridValid = NO;
+    navGridFree(&world->navGrid);
+    resetNavQueries(world);
+
+    if (!navGridInit(&world->navGrid, -ARENA_SIZE, -ARENA_SIZE, ARENA_SIZE, ARENA_SIZE, NAV_CELL_SIZE)) {
+        fprintf(stderr, "[COLLISION] Failed to allocate nav grid\n");
+        return;
+    }
+
+    // Rows are independent within each pass - links need every row's surfaces first
+    simJobParallelFor(world->jobs, world->navGrid.sizeZ, buildNavSurfaceRow, world);
+    simJobParallelFor(world->jobs, world->navGrid.sizeZ, buildNavLinkRow, world);
+
+    world->navGridValid = YES;
+}
+
+typedef struct {
+    const SimCollision *world;
+    const SimNavCircle *avoid;
+    int avoidCount;
+    BOOL avoidDynamic;
+} NavQueryContext;
+
+// Nodes inside a keep-out circle, or where a dynamic shape overlaps the body
+static bool navNodeBlocked(void *context, const float position[3]) {
+    const NavQueryContext *query = context;
+
+    for (int i = 0; i < query->avoidCount; i++) {
+        float dx = position[0] - query->avoid[i].x;
+        float dz = position[2] - query->avoid[i].z;
+        if (dx * dx + dz * dz < query->avoid[i].radius * query->avoid[i].radius) return true;
+    }
+
+    if (query->avoidDynamic) {
+        const SimCollision *world = query->world;
+        for (int i = 0; i < world->dynCount; i++) {
+            const CollisionShape *shape = &world->dynShapes[i];
+            if (!shape->blocksMovement || shape->isRamp) continue;
+            if (position[0] + NAV_AGENT_RADIUS > shape->minX && position[0] - NAV_AGENT_RADIUS < shape->maxX &&
+                position[2] + NAV_AGENT_RADIUS > shape->minZ && position[2] - NAV_AGENT_RADIUS < shape->maxZ &&
+                position[1] + NAV_AGENT_HEIGHT > shape->minY && position[1] < shape->maxY) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+// Bounds of the dynamic shapes navNodeBlocked tests, hashed onto key
+static uint64_t dynamicShapesKey(const SimCollision *world, uint64_t key) {
+    for (int i = 0; i < world->dynCount; i++) {
+        const CollisionShape *shape = &world->dynShapes[i];
+        if (!shape->blocksMovement || shape->isRamp) continue;
+        float bounds[6] = {shape->minX, shape->minY, shape->minZ, shape->maxX, shape->maxY, shape->maxZ};
+        key = cacheHash(bounds, sizeof(bounds), key);
+    }
+    return key;
+}
+
+// Everything besides the grid that a search's result depends on
+static uint64_t pathKey(const NavQueryContext *query, int start, int goal) {
+    int ends[3] = {start, goal, query->avoidDynamic ? 1 : 0};
+    uint64_t key = cacheHash(ends, sizeof(ends), CACHE_HASH_SEED);
+    key = cacheHash(query->avoid, sizeof(SimNavCircle) * (size_t)query->avoidCount, key);
+    return query->avoidDynamic ? dynamicShapesKey(query->world, key) : key;
+}
+
+static int copyPath(const NavPathEntry *entry, SimVec3 *points, int maxPoints) {
+    int count = entry->pointCount < maxPoints ? entry->pointCount : maxPoints;
+    for (int i = 0; i < count; i++) points[i] = entry->points[i];
+    return entry->pointCount < 0 ? -1 : count;
+}
+
+int simCollisionFindPath(SimCollision *world, SimVec3 from, SimVec3 to,
+                         const SimNavCircle *avoid, int avoidCount, BOOL avoidDynamic,
+                         SimVec3 *points, int maxPoints) {
+    ensureBroadphase(world);
+    if (!world->navGridValid) return -1;
+
+    int start = navGridNodeAt(&world->navGrid, from.x, from.y, from.z, NAV_NODE_SEARCH_CELLS);
+    int goal = navGridNodeAt(&world->navGrid, to.x, to.y, to.z, NAV_NODE_SEARCH_CELLS);
+    if (start < 0 || goal < 0) return -1;
+    if (start == goal) return 0;
+
+    // A blocked goal can't be reached - no need to search everything else first
+    NavQueryContext query = {world, avoid, avoidCount, avoidDynamic};
+    float goalPosition[3];
+    navGridNodePosition(&world->navGrid, goal, goalPosition);
+    if (navNodeBlocked(&query, goalPosition)) return -1;
+
+    uint64_t key = pathKey(&query, start, goal);
+    int slot = (int)(key % NAV_PATH_CACHE_SIZE);
+
+    // The same search always finds the same path, so a hit is exactly what searching would give
+    pthread_mutex_lock(&world->navCacheLock);
+    if (!world->navCache) world->navCache = calloc(NAV_PATH_CACHE_SIZE, sizeof(NavPathEntry));
+    const NavPathEntry *cached = world->navCache ? &world->navCache[slot] : NULL;
+    if (cached && cached->used && cached->key == key && cached->start == start && cached->goal == goal) {
+        int count = copyPath(cached, points, maxPoints);
+        pthread_mutex_unlock(&world->navCacheLock);
+        return count;
+    }
+    pthread_mutex_unlock(&world->navCacheLock);
+
+    SIM_PROFILE_COUNT(SimCounterPathsSearched, 1);
+    NavPathEntry entry = {0};
+    entry.used = YES;
+    entry.start = start;
+    entry.goal = goal;
+    entry.key = key;
+    int nodes[SIM_NAV_MAX_PATH_POINTS];
+    entry.pointCount = navGridFindPath(&world->navGrid, &threadScratch(world)->nav, start, goal,
+                                       navNodeBlocked, &query, NAV_MAX_EXPANSIONS,
+                                       nodes, SIM_NAV_MAX_PATH_POINTS);
+    for (int i = 0; i < entry.pointCount; i++) {
+        float position[3];
+        navGridNodePosition(&world->navGrid, nodes[i], position);
+        entry.points[i] = simVec3(position[0], position[1], position[2]);
+    }
+
+    pthread_mutex_lock(&world->navCacheLock);
+    if (world->navCache) world->navCache[slot] = entry;
+    pthread_mutex_unlock(&world->navCacheLock);
+    return copyPath(&entry, points, maxPoints);
+}
+
+void simCollisionUpdateFlowField(SimCollision *world, int field, SimVec3 goal) {
+    if (field < 0 || field >= SIM_NAV_FLOW_FIELDS || !world->navGridValid) return;
+    NavFlowEntry *entry = &world->navFlow[field];
+
+    // Built for this goal node and these door positions already - the field would come out the same
+    int goalNode = navGridNodeAt(&world->navGrid, goal.x, goal.y, goal.z, NAV_NODE_SEARCH_CELLS);
+    uint64_t key = dynamicShapesKey(world, cacheHash(&goalNode, sizeof(goalNode), CACHE_HASH_SEED));
+    entry->paused = NO;
+    if (entry->built && entry->key == key) return;
+
+    SIM_PROFILE_ZONE("flowField");
+    NavQueryContext query = {world, NULL, 0, YES};
+    entry->built = navFlowFieldBuild(&world->navGrid, &entry->field, &threadScratch(world)->nav, goalNode,
+                                     navNodeBlocked, &query);
+    entry->key = key;
+}
+
+void simCollisionPauseFlowField(SimCollision *world, int field) {
+    if (field < 0 || field >= SIM_NAV_FLOW_FIELDS) return;
+    world->navFlow[field].paused = YES;
+}
+
+BOOL simCollisionFlowTarget(SimCollision *world, int field, SimVec3 from, SimVec3 *outPoint) {
+    if (field < 0 || field >= SIM_NAV_FLOW_FIELDS || !world->navGridValid) return NO;
+    const NavFlowEntry *entry = &world->navFlow[field];
+    if (!entry->built || entry->paused) return NO;
+
+    int node = navGridNodeAt(&world->navGrid, from.x, from.y, from.z, NAV_NODE_SEARCH_CELLS);
+    int ahead = navFlowFieldAhead(&world->navGrid, &entry->field, node, NAV_FLOW_LOOKAHEAD);
+    if (ahead == node) return NO;
+
+    float position[3];
+    navGridNodePosition(&world->navGrid, ahead, position);
+    *outPoint = simVec3(position[0], position[1], position[2]);
+    return YES;
+}
+
+// ============================================
+// COVER
+// ============================================
+
+// Feet spot next to side face of a static blocker at (x, z), facing into it along
+// (normalX, normalZ): the nav node there, if it's on the ground the blocker stands on and
+// the blocker rises high enough over it
+static BOOL coverSpotAt(const SimCollision *world, const CollisionShape *shape, float x, float z,
+                        float normalX, float normalZ, CoverPoint *out) {
+    int node = navGridNodeAt(&world->navGrid, x, shape->minY, z, 1);
+    if (node < 0) return NO;
+
+    float feet[3];
+    navGridNodePosition(&world->navGrid, node, feet);
+    float dx = feet[0] - x;
+    float dz = feet[2] - z;
+    if (dx * dx + dz * dz > NAV_CELL_SIZE * NAV_CELL_SIZE) return NO;
+    if (feet[1] < shape->minY - GROUND_STANDING_TOLERANCE || feet[1] + COVER_MIN_HEIGHT > shape->maxY) return NO;
+
+    out->x = feet[0];
+    out->y = feet[1];
+    out->z = feet[2];
+    out->normalX = normalX;
+    out->normalZ = normalZ;
+    out->height = shape->maxY - feet[1];
+    out->exposure = 0.0f;
+    return YES;
+}
+
+// Close to a point already found, facing the same way
+static BOOL coverDuplicate(const CoverPoint *points, int count, const CoverPoint *candidate) {
+    for (int i = 0; i < count; i++) {
+        float dx = points[i].x - candidate->x;
+        float dy = points[i].y - candidate->y;
+        float dz = points[i].z - candidate->z;
+        float facing = points[i].normalX * candidate->normalX + points[i].normalZ * candidate->normalZ;
+        if (dx * dx + dy * dy + dz * dz < COVER_MERGE_DISTANCE * COVER_MERGE_DISTANCE && facing > 0.7f) return YES;
+    }
+    return NO;
+}
+
+// Candidates every COVER_SPACING along the four side faces of each static shape that
+// blocks shots, in shape order. Returns the count, or -1 if out of memory.
+static int generateCoverCandidates(const SimCollision *world, CoverPoint **outPoints) {
+    int capacity = 256;
+    int count = 0;
+    CoverPoint *points = malloc(sizeof(CoverPoint) * (size_t)capacity);
+    if (!points) return -1;
+
+    for (int i = 0; i < world->shapeCount; i++) {
+        const CollisionShape *shape = &world->shapes[i];
+        if (!shape->blocksProjectiles || !shape->blocksMovement || shape->isRamp) continue;
+        if (shape->maxY - shape->minY < COVER_MIN_HEIGHT) continue;
+
+        // -X, +X, -Z, +Z faces: the normal points from the spot into the shape
+        for (int face = 0; face < 4; face++) {
+            BOOL alongZ = face < 2;
+            float length = alongZ ? shape->maxZ - shape->minZ : shape->maxX - shape->minX;
+            int spots = (int)floorf(length / COVER_SPACING);
+            if (spots < 1) spots = 1;
+
+            float normalX = alongZ ? (face == 0 ? 1.0f : -1.0f) : 0.0f;
+            float normalZ = alongZ ? 0.0f : (face == 2 ? 1.0f : -1.0f);
+            float faceX = face == 0 ? shape->minX : shape->maxX;
+            float faceZ = face == 2 ? shape->minZ : shape->maxZ;
+
+            for (int k = 0; k < spots; k++) {
+                float t = ((float)k + 0.5f) / (float)spots;
+                float x = alongZ ? faceX - normalX * COVER_WALL_GAP : shape->minX + t * length;
+                float z = alongZ ? shape->minZ + t * length : faceZ - normalZ * COVER_WALL_GAP;
+
+                CoverPoint candidate;
+                if (!coverSpotAt(world, shape, x, z, normalX, normalZ, &candidate)) continue;
+                if (coverDuplicate(points, count, &candidate)) continue;
+
+                if (count == capacity) {
+                    CoverPoint *grown = realloc(points, sizeof(CoverPoint) * (size_t)capacity * 2);
+                    if (!grown) {
+                        free(points);
+                        return -1;
+                    }
+                    points = grown;
+                    capacity *= 2;
+                }
+                points[count++] = candidate;
+            }
+        }
+    }
+
+    *outPoints = points;
+    return count;
+}
+
+typedef struct {
+    const SimCollision *world;
+    CoverPoint *points;
+} CoverExposureJob;
+
+// Fraction of viewers standing around the point - each range in each direction, where the
+// grid has ground at about its height - that see its body center
+static void scoreCoverExposure(void *context, int index) {
+    const CoverExposureJob *job = context;
+    const SimCollision *world = job->world;
+    CoverPoint *point = &job->points[index];
+    WorldSegmentContext segmentWorld = {world->shapes, &world->bvh};
+    float body[3] = {point->x, point->y + COVER_BODY_HEIGHT, point->z};
+    int rangeCount = (int)(sizeof(COVER_EXPOSURE_RANGES) / sizeof(COVER_EXPOSURE_RANGES[0]));
+
+    int viewers = 0;
+    int seen = 0;
+    for (int d = 0; d < COVER_EXPOSURE_DIRECTIONS; d++) {
+        float angle = (float)d * 2.0f * (float)M_PI / (float)COVER_EXPOSURE_DIRECTIONS;
+        for (int r = 0; r < rangeCount; r++) {
+            float x = point->x + cosf(angle) * COVER_EXPOSURE_RANGES[r];
+            float z = point->z + sinf(angle) * COVER_EXPOSURE_RANGES[r];
+            int node = navGridNodeAt(&world->navGrid, x, point->y, z, 1);
+            if (node < 0) continue;
+
+            float feet[3];
+            navGridNodePosition(&world->navGrid, node, feet);
+            if (fabsf(feet[1] - point->y) > NAV_MAX_CLIMB) continue;
+
+            float eye[3] = {feet[0], feet[1] + PLAYER_HEIGHT, feet[2]};
+            viewers++;
+            if (!segmentBlockedByWorld(&segmentWorld, eye, body)) seen++;
+        }
+    }
+    point->exposure = viewers > 0 ? (float)seen / (float)viewers : 0.0f;
+}
+
+void simCollisionBuildCoverPoints(SimCollision *world) {
+    // A mapped map can't be freed - copy the shapes out (the nav grid it needs goes with them)
+    if (!detachBakedCache(world)) return;
+    ensureBroadphase(world);
+    world->coverMapValid = NO;
+    coverMapFree(&world->coverMap);
+    if (!world->navGridValid) {
+        fprintf(stderr, "[COLLISION] Cover points need the nav grid - build it first\n");
+        return;
+    }
+
+    CoverPoint *points = NULL;
+    int count = generateCoverCandidates(world, &points);
+    if (count < 0) {
+        fprintf(stderr, "[COLLISION] Failed to allocate cover points\n");
+        return;
+    }
+
+    // Points are scored independently - spread them across cores
+    CoverExposureJob job = {world, points};
+    simJobParallelFor(world->jobs, count, scoreCoverExposure, &job);
+
+    world->coverMapValid = coverMapBuild(&world->coverMap, -ARENA_SIZE, -ARENA_SIZE, ARENA_SIZE, ARENA_SIZE,
+                                         COVER_CELL_SIZE, points, count);
+    free(points);
+    if (!world->coverMapValid) {
+        fprintf(stderr, "[COLLISION] Failed to allocate cover map\n");
+    }
+}
+
+int simCollisionCoverCount(const SimCollision *world) {
+    return world->coverMapValid ? world->coverMap.pointCount : 0;
+}
+
+BOOL simCollisionCoverPoint(const SimCollision *world, int cover, SimVec3 *outFeet) {
+    if (!world->coverMapValid || cover < 0 || cover >= world->coverMap.pointCount) return NO;
+    const CoverPoint *point = &world->coverMap.points[cover];
+    *outFeet = simVec3(point->x, point->y, point->z);
+    return YES;
+}
+
+int simCollisionFindCover(SimCollision *world, SimVec3 from, SimVec3 threat, float maxDistance, int exclude) {
+    ensureBroadphase(world);
+    if (!world->coverMapValid) return -1;
+
+    int candidates[COVER_QUERY_CANDIDATES];
+    int found = coverMapQuery(&world->coverMap, from.x, from.z, maxDistance, candidates, COVER_QUERY_CANDIDATES);
+    if (found > COVER_QUERY_CANDIDATES) found = COVER_QUERY_CANDIDATES;
+
+    // Best scores first: close to from, far from the threat, seen from few places
+    int best[COVER_QUERY_SIGHT_CHECKS];
+    float bestScore[COVER_QUERY_SIGHT_CHECKS];
+    int bestCount = 0;
+    for (int c = 0; c < found; c++) {
+        int cover = candidates[c];
+        if (cover == exclude) continue;
+        const CoverPoint *point = &world->coverMap.points[cover];
+
+        // The blocker must stand between the point and the threat
+        float toThreatX = threat.x - point->x;
+        float toThreatZ = threat.z - point->z;
+        float threatDist = sqrtf(toThreatX * toThreatX + toThreatZ * toThreatZ);
+        if (threatDist < 0.1f) continue;
+        if ((point->normalX * toThreatX + point->normalZ * toThreatZ) / threatDist < COVER_MIN_FACING) continue;
+
+        float dx = point->x - from.x;
+        float dz = point->z - from.z;
+        float score = threatDist * 2.0f - sqrtf(dx * dx + dz * dz) - point->exposure * COVER_EXPOSURE_WEIGHT;
+
+        int slot = bestCount < COVER_QUERY_SIGHT_CHECKS ? bestCount++ : COVER_QUERY_SIGHT_CHECKS;
+        while (slot > 0 && bestScore[slot - 1] < score) {
+            if (slot < COVER_QUERY_SIGHT_CHECKS) {
+                best[slot] = best[slot - 1];
+                bestScore[slot] = bestScore[slot - 1];
+            }
+            slot--;
+        }
+        if (slot < COVER_QUERY_SIGHT_CHECKS) {
+            best[slot] = cover;
+            bestScore[slot] = score;
+        }
+    }
+
+    // The first the threat can't actually see, else the best facing the right way
+    for (int i = 0; i < bestCount; i++) {
+        const CoverPoint *point = &world->coverMap.points[best[i]];
+        SimVec3 body = simVec3(point->x, point->y + COVER_BODY_HEIGHT, point->z);
+        if (!simCollisionLineOfSight(world, threat, body)) return best[i];
+    }
+    return bestCount > 0 ? best[0] : -1;
+}
+
+// ============================================
+// BAKED CACHE
+// ============================================
+
+// Make dir (0700) unless it exists, then require it to be ours and closed to other users
+static BOOL ensurePrivateDirectory(const char *dir) {
+    if (mkdir(dir, 0700) != 0 && errno != EEXIST) return NO;
+
+    struct stat st;
+    return stat(dir, &st) == 0 && S_ISDIR(st.st_mode) && st.st_uid == geteuid() &&
+           (st.st_mode & (S_IWGRP | S_IWOTH)) == 0;
+}
+
+#ifndef __APPLE__
+// Create every missing directory above path, owner-only - a fresh account may not have
+// $XDG_CACHE_HOME yet
+static void makeParentDirectories(char *path) {
+    for (char *slash = strchr(path + 1, '/'); slash; slash = strchr(slash + 1, '/')) {
+        *slash = '\0';
+        mkdir(path, 0700);
+        *slash = '/';
+    }
+}
+#endif
+
+static BOOL findDefaultCachePath(char *path, int pathSize) {
+    const char *overridePath = getenv("FPS_COLLISION_CACHE");
+    if (overridePath && overridePath[0]) {
+        int n = snprintf(path, (size_t)pathSize, "%s", overridePath);
+        return n >= 0 && n < pathSize;
+    }
+
+    // Per-user cache directory - never a shared one like /tmp, where another user
+    // could plant a file for us to map
+    const char *home = getenv("HOME");
+    char dir[1024];
+    int n;
+#ifdef __APPLE__
+    if (!home || home[0] != '/') return NO;
+    n = snprintf(dir, sizeof(dir), "%s/Library/Caches/fpsarena", home);
+#else
+    const char *cacheHome = getenv("XDG_CACHE_HOME");
+    if (cacheHome && cacheHome[0] == '/') {
+        n = snprintf(dir, sizeof(dir), "%s/fpsarena", cacheHome);
+        if (n < 0 || n >= (int)sizeof(dir)) return NO;
+        makeParentDirectories(dir);
+    } else {
+        if (!home || home[0] != '/') return NO;
+        n = snprintf(dir, sizeof(dir), "%s/.cache", home);
+        if (n < 0 || n >= (int)sizeof(dir)) return NO;
+        mkdir(dir, 0700);
+        n = snprintf(dir, sizeof(dir), "%s/.cache/fpsarena", home);
+    }
+#endif
+    if (n < 0 || n >= (int)sizeof(dir) || !ensurePrivateDirectory(dir)) return NO;
+
+    n = snprintf(path, (size_t)pathSize, "%s/collision.cache", dir);
+    return n >= 0 && n < pathSize;
+}
+
+static pthread_once_t noCachePathOnce = PTHREAD_ONCE_INIT;
+
+static void logNoCachePath(void) {
+    fprintf(stderr, "[COLLISION] No per-user cache directory - collision data will be rebuilt on every "
+                    "launch (set FPS_COLLISION_CACHE to choose a path)\n");
+}
+
+BOOL simCollisionDefaultCachePath(char *path, int pathSize) {
+    if (findDefaultCachePath(path, pathSize)) return YES;
+    pthread_once(&noCachePathOnce, logNoCachePath);
+    return NO;
+}
+
+// Key of the cache simCollisionBuildMilitaryBase bakes: the build parameters, the
+// GameConfig dimensions the base is laid out from and the geometry version - all known at
+// compile time, so checking a cache never has to lay the base out
+static uint64_t militaryBaseContentKey(void) {
+    const float params[] = {
+        ARENA_SIZE, FLOOR_Y, BROADPHASE_PAD,
+        GROUND_FIELD_TEXEL, GROUND_FIELD_MAX_RADIUS,
+        NAV_CELL_SIZE, NAV_AGENT_RADIUS, NAV_AGENT_HEIGHT, NAV_MAX_CLIMB, NAV_MAX_DROP,
+        COVER_SPACING, COVER_WALL_GAP, COVER_MIN_HEIGHT, COVER_MERGE_DISTANCE,
+        COVER_EXPOSURE_RANGES[0], COVER_EXPOSURE_RANGES[1], COVER_EXPOSURE_RANGES[2],
+        (float)COVER_EXPOSURE_DIRECTIONS, COVER_CELL_SIZE,
+    };
+    const float geometry[] = {
+        CMD_BUILDING_X, CMD_BUILDING_Z, CMD_BUILDING_WIDTH, CMD_BUILDING_DEPTH, CMD_BUILDING_HEIGHT,
+        CMD_WALL_THICK, CMD_DOOR_WIDTH, CMD_DOOR_HEIGHT,
+        TOWER_OFFSET, TOWER_SIZE, PLATFORM_LEVEL, RAMP_WIDTH, RAMP_LENGTH,
+        CATWALK_WIDTH, CATWALK_THICK, CATWALK_RAIL_HEIGHT,
+        CONTAINER_LENGTH, CONTAINER_WIDTH, CONTAINER_HEIGHT,
+        SANDBAG_LENGTH, SANDBAG_HEIGHT, SANDBAG_THICK,
+        WALL_WIDTH, WALL_HEIGHT, WALL_DEPTH, WALL1_X, WALL1_Z, WALL2_X, WALL2_Z,
+    };
+    const uint32_t version = MILITARY_BASE_GEOMETRY_VERSION;
+
+    uint64_t key = cacheHash(params, sizeof(params), CACHE_HASH_SEED);
+    key = cacheHash(geometry, sizeof(geometry), key);
+    return cacheHash(&version, sizeof(version), key);
+}
+
+// Forget the mapped arrays without copying them and unmap the file
+static void dropBakedCache(SimCollision *world) {
+    if (!world->bakedCache.base) return;
+
+    world->shapes = NULL;
+    world->rayBlocks = NULL;
+    world->groundShape = NULL;
+    memset(&world->bvh, 0, sizeof(world->bvh));
+    memset(&world->groundField, 0, sizeof(world->groundField));
+    memset(&world->navGrid, 0, sizeof(world->navGrid));
+    memset(&world->coverMap, 0, sizeof(world->coverMap));
+    world->bvhDirty = YES;
+    world->groundFieldValid = NO;
+    world->navGridValid = NO;
+    world->coverMapValid = NO;
+
+    cacheClose(&world->bakedCache);
+}
+
+// Copy the mapped static shapes to the heap and unmap - required before the static set
+// changes. The baked BVH, height field, nav grid and cover map are
+// dropped and rebuilt on demand like after any other shape change.
+static BOOL detachBakedCache(SimCollision *world) {
+    if (!world->bakedCache.base) return YES;
+
+    int blockCapacity = (world->shapeCapacity + SHAPE_BLOCK_WIDTH - 1) / SHAPE_BLOCK_WIDTH;
+    CollisionShape *shapes = malloc(sizeof(CollisionShape) * world->shapeCapacity);
+    ShapeRayBlock *rayBlocks = malloc(sizeof(ShapeRayBlock) * blockCapacity);
+    int *groundShape = malloc(sizeof(int) * world->shapeCapacity);
+    if (!shapes || !rayBlocks || !groundShape) {
+        free(shapes);
+        free(rayBlocks);
+        free(groundShape);
+        return NO;
+    }
+
+    memcpy(shapes, world->shapes, sizeof(CollisionShape) * world->shapeCount);
+    dropBakedCache(world);
+    world->shapes = shapes;
+    world->rayBlocks = rayBlocks;
+    world->groundShape = groundShape;
+    return YES;
+}
+
+BOOL simCollisionWriteCache(SimCollision *world, const char *path) {
+    // The key only describes the base as built - anything else would load as it
+    if (!world->staticIsMilitaryBase) {
+        fprintf(stderr, "[COLLISION] Static shapes aren't the military base - not caching them\n");
+        return NO;
+    }
+    ensureBroadphase(world);
+
+    BakedWorldInfo info = {0};
+    info.shapeCount = world->shapeCount;
+    info.rayBlockCount = world->rayBlockCount;
+    info.groundCount = world->groundCount;
+    info.bvhNodeCount = world->bvh.nodeCount;
+    info.groundFieldValid = world->groundFieldValid;
+    info.hfMinX = world->groundField.minX;
+    info.hfMinZ = world->groundField.minZ;
+    info.hfTexelSize = world->groundField.texelSize;
+    info.hfMargin = world->groundField.margin;
+    info.hfSizeX = world->groundField.sizeX;
+    info.hfSizeZ = world->groundField.sizeZ;
+    info.navGridValid = world->navGridValid;
+    info.navMinX = world->navGrid.minX;
+    info.navMinZ = world->navGrid.minZ;
+    info.navCellSize = world->navGrid.cellSize;
+    info.navSizeX = world->navGrid.sizeX;
+    info.navSizeZ = world->navGrid.sizeZ;
+    info.navCellCount = world->navGrid.cellCount;
+    info.coverMapValid = world->coverMapValid;
+    info.coverMinX = world->coverMap.minX;
+    info.coverMinZ = world->coverMap.minZ;
+    info.coverCellSize = world->coverMap.cellSize;
+    info.coverSizeX = world->coverMap.sizeX;
+    info.coverSizeZ = world->coverMap.sizeZ;
+    info.coverCellCount = world->coverMap.cellCount;
+    info.coverPointCount = world->coverMap.pointCount;
+
+    uint64_t texels = world->groundFieldValid ? (uint64_t)world->groundField.sizeX * world->groundField.sizeZ : 0;
+    uint64_t navCells = world->navGridValid ? (uint64_t)world->navGrid.cellCount : 0;
+    uint64_t coverPoints = world->coverMapValid ? (uint64_t)world->coverMap.pointCount : 0;
+    uint64_t coverCells = world->coverMapValid ? (uint64_t)world->coverMap.cellCount + 1 : 0;
+
+    CacheSectionData sections[] = {
+        {BAKED_TAG_INFO, sizeof(BakedWorldInfo), &info, 1},
+        {BAKED_TAG_SHAPES, sizeof(CollisionShape), world->shapes, (uint64_t)world->shapeCount},
+        {BAKED_TAG_RAY_BLOCKS, sizeof(ShapeRayBlock), world->rayBlocks, (uint64_t)world->rayBlockCount},
+        {BAKED_TAG_GROUND_SHAPE, sizeof(int), world->groundShape, (uint64_t)world->groundCount},
+        {BAKED_TAG_BVH_NODES, sizeof(BVHNode), world->bvh.nodes, (uint64_t)world->bvh.nodeCount},
+        {BAKED_TAG_BVH_ITEMS, sizeof(int), world->bvh.items, (uint64_t)world->bvh.itemCount},
+        {BAKED_TAG_BVH_BOUNDS, sizeof(BVHItem), world->bvh.itemBounds, (uint64_t)world->bvh.itemCount},
+        {BAKED_TAG_HF_COUNTS, sizeof(unsigned char), world->groundField.layerCount, texels},
+        {BAKED_TAG_HF_LAYERS, sizeof(HeightFieldLayer), world->groundField.layers, texels * HF_MAX_LAYERS},
+        {BAKED_TAG_NAV_COUNTS, sizeof(unsigned char), world->navGrid.layerCount, navCells},
+        {BAKED_TAG_NAV_SURFACES, sizeof(float), world->navGrid.surfaceY, navCells * NAV_MAX_LAYERS},
+        {BAKED_TAG_NAV_LINKS, sizeof(unsigned char), world->navGrid.links, navCells * NAV_MAX_LAYERS * NAV_DIRECTIONS},
+        {BAKED_TAG_COVER_POINTS, sizeof(CoverPoint), world->coverMap.points, coverPoints},
+        {BAKED_TAG_COVER_CELLS, sizeof(int), world->coverMap.cellStart, coverCells},
+    };
+    int sectionCount = (int)(sizeof(sections) / sizeof(sections[0]));
+
+    return cacheWrite(path, COLLISION_CACHE_VERSION, militaryBaseContentKey(), sections, sectionCount);
+}
+
+// Section with exactly the expected element count, or NULL
+static void *bakedSection(const CollisionCache *cache, uint32_t tag, uint32_t elemSize, uint64_t expected) {
+    uint64_t count = 0;
+    void *data = cacheSection(cache, tag, elemSize, &count);
+    return (data && count == expected) ? data : NULL;
+}
+
+// Rebuild the handle table from the baked shapes' handles. Returns NO on a bad or repeated handle.
+static BOOL restoreSlotsForShapes(SimCollision *world, const CollisionShape *shapes, int count) {
+    world->slotCount = 0;
+    world->freeSlot = -1;
+
+    for (int i = 0; i < count; i++) {
+        int slot = shapes[i].shapeId & SHAPE_HANDLE_SLOT_MASK;
+        int generation = shapes[i].shapeId >> SHAPE_HANDLE_INDEX_BITS;
+        if (shapes[i].shapeId <= 0 || generation == 0) return NO;
+
+        while (world->slotCount <= slot) {
+            int added = allocateSlot(world);
+            if (added < 0) return NO;
+            world->slots[added].denseIndex = -1;
+        }
+        if (world->slots[slot].denseIndex >= 0) return NO;
+
+        world->slots[slot].denseIndex = i;
+        world->slots[slot].generation = generation;
+        world->slots[slot].nextFree = -1;
+        world->slots[slot].isDynamic = NO;
+        world->shapeSlot[i] = slot;
+    }
+
+    // Unused slots go on the free list
+    for (int slot = world->slotCount - 1; slot >= 0; slot--) {
+        if (world->slots[slot].denseIndex >= 0) continue;
+        world->slots[slot].nextFree = world->freeSlot;
+        world->freeSlot = slot;
+    }
+    return YES;
+}
+
+BOOL simCollisionLoadCache(SimCollision *world, const char *path) {
+    CollisionCache cache;
+    if (!cacheOpen(&cache, path, COLLISION_CACHE_VERSION, militaryBaseContentKey())) {
+        return NO;
+    }
+
+    // Every section must match the counts recorded at bake time
+    const BakedWorldInfo *info = bakedSection(&cache, BAKED_TAG_INFO, sizeof(BakedWorldInfo), 1);
+    BOOL ok = info != NULL && info->shapeCount >= 0 && info->shapeCount <= SHAPE_HANDLE_MAX_SLOTS;
+
+    uint64_t shapeCount = ok ? (uint64_t)info->shapeCount : 0;
+    uint64_t texels = ok && info->groundFieldValid ? (uint64_t)info->hfSizeX * (uint64_t)info->hfSizeZ : 0;
+    uint64_t navCells = ok && info->navGridValid ? (uint64_t)info->navCellCount : 0;
+    uint64_t coverPoints = ok && info->coverMapValid ? (uint64_t)info->coverPointCount : 0;
+    uint64_t coverCells = ok && info->coverMapValid ? (uint64_t)info->coverCellCount + 1 : 0;
+
+    CollisionShape *shapes = NULL;
+    ShapeRayBlock *rayBlocks = NULL;
+    int *groundShape = NULL;
+    BVHNode *nodes = NULL;
+    int *bvhItems = NULL;
+    BVHItem *bvhBounds = NULL;
+    unsigned char *layerCount = NULL;
+    HeightFieldLayer *layers = NULL;
+    unsigned char *navCounts = NULL;
+    float *navSurfaces = NULL;
+    unsigned char *navLinks = NULL;
+    CoverPoint *coverPointData = NULL;
+    int *coverCellStart = NULL;
+
+    if (ok) {
+        shapes = bakedSection(&cache, BAKED_TAG_SHAPES, sizeof(CollisionShape), shapeCount);
+        rayBlocks = bakedSection(&cache, BAKED_TAG_RAY_BLOCKS, sizeof(ShapeRayBlock),
+                                 (shapeCount + SHAPE_BLOCK_WIDTH - 1) / SHAPE_BLOCK_WIDTH);
+        groundShape = bakedSection(&cache, BAKED_TAG_GROUND_SHAPE, sizeof(int), (uint64_t)info->groundCount);
+        nodes = bakedSection(&cache, BAKED_TAG_BVH_NODES, sizeof(BVHNode), (uint64_t)info->bvhNodeCount);
+        bvhItems = bakedSection(&cache, BAKED_TAG_BVH_ITEMS, sizeof(int), shapeCount);
+        bvhBounds = bakedSection(&cache, BAKED_TAG_BVH_BOUNDS, sizeof(BVHItem), shapeCount);
+        layerCount = bakedSection(&cache, BAKED_TAG_HF_COUNTS, sizeof(unsigned char), texels);
+        layers = bakedSection(&cache, BAKED_TAG_HF_LAYERS, sizeof(HeightFieldLayer), texels * HF_MAX_LAYERS);
+        navCounts = bakedSection(&cache, BAKED_TAG_NAV_COUNTS, sizeof(unsigned char), navCells);
+        navSurfaces = bakedSection(&cache, BAKED_TAG_NAV_SURFACES, sizeof(float), navCells * NAV_MAX_LAYERS);
+        navLinks = bakedSection(&cache, BAKED_TAG_NAV_LINKS, sizeof(unsigned char),
+                                navCells * NAV_MAX_LAYERS * NAV_DIRECTIONS);
+        coverPointData = bakedSection(&cache, BAKED_TAG_COVER_POINTS, sizeof(CoverPoint), coverPoints);
+        coverCellStart = bakedSection(&cache, BAKED_TAG_COVER_CELLS, sizeof(int), coverCells);
+
+        // Empty sections map to a valid (unused) address, so only missing ones fail
+        ok = shapes && rayBlocks && groundShape && nodes && bvhItems && bvhBounds &&
+             layerCount && layers && navCounts && navSurfaces && navLinks &&
+             coverPointData && coverCellStart &&
+             info->rayBlockCount == (int32_t)((shapeCount + SHAPE_BLOCK_WIDTH - 1) / SHAPE_BLOCK_WIDTH) &&
+             info->groundCount >= 0 && info->groundCount <= info->shapeCount &&
+             info->bvhNodeCount >= 0;
+    }
+
+    // The arrays are used without bounds checks from here on, so every index stored in
+    // them must be checked now - a damaged or foreign file must read as a miss
+    CollisionBVH bvh = {0};
+    HeightField groundField = {0};
+    NavGrid navGrid = {0};
+    CoverMap coverMap = {0};
+
+    if (ok) {
+        for (int i = 0; ok && i < info->shapeCount; i++) {
+            ok = shapes[i].debugName[COLLISION_SHAPE_NAME_LENGTH - 1] == '\0';
+        }
+        for (int i = 0; ok && i < info->groundCount; i++) {
+            ok = groundShape[i] >= 0 && groundShape[i] < info->shapeCount;
+        }
+
+        bvh.nodes = nodes;
+        bvh.nodeCount = info->bvhNodeCount;
+        bvh.items = bvhItems;
+        bvh.itemBounds = bvhBounds;
+        bvh.itemCount = info->shapeCount;
+        bvh.capacity = info->shapeCount;
+        ok = ok && bvhValidate(&bvh);
+
+        if (ok && info->groundFieldValid) {
+            groundField.minX = info->hfMinX;
+            groundField.minZ = info->hfMinZ;
+            groundField.texelSize = info->hfTexelSize;
+            groundField.margin = info->hfMargin;
+            groundField.sizeX = info->hfSizeX;
+            groundField.sizeZ = info->hfSizeZ;
+            groundField.layerCount = layerCount;
+            groundField.layers = layers;
+            ok = hfValidate(&groundField, info->groundCount);
+        }
+
+        if (ok && info->navGridValid) {
+            navGrid.minX = info->navMinX;
+            navGrid.minZ = info->navMinZ;
+            navGrid.cellSize = info->navCellSize;
+            navGrid.sizeX = info->navSizeX;
+            navGrid.sizeZ = info->navSizeZ;
+            navGrid.cellCount = info->navCellCount;
+            navGrid.layerCount = navCounts;
+            navGrid.surfaceY = navSurfaces;
+            navGrid.links = navLinks;
+            ok = navGridValidate(&navGrid);
+        }
+
+        if (ok && info->coverMapValid) {
+            coverMap.minX = info->coverMinX;
+            coverMap.minZ = info->coverMinZ;
+            coverMap.cellSize = info->coverCellSize;
+            coverMap.sizeX = info->coverSizeX;
+            coverMap.sizeZ = info->coverSizeZ;
+            coverMap.cellCount = info->coverCellCount;
+            coverMap.pointCount = info->coverPointCount;
+            coverMap.points = coverPointData;
+            coverMap.cellStart = coverCellStart;
+            ok = coverMapValidate(&coverMap);
+        }
+    }
+
+    if (ok) {
+        simCollisionClearAllShapes(world);
+        ok = reserveShapeCapacity(world, info->shapeCount > 1 ? info->shapeCount : 1) &&
+             restoreSlotsForShapes(world, shapes, info->shapeCount);
+        if (!ok) {
+            world->slotCount = 0;
+            world->freeSlot = -1;
+        }
+    }
+
+    if (!ok) {
+        cacheClose(&cache);
+        return NO;
+    }
+
+    // Point the static arrays at the mapping - no copies, pages shared with other processes
+    free(world->shapes);
+    free(world->rayBlocks);
+    free(world->groundShape);
+    world->shapes = shapes;
+    world->rayBlocks = rayBlocks;
+    world->groundShape = groundShape;
+    world->shapeCount = info->shapeCount;
+    world->rayBlockCount = info->rayBlockCount;
+    world->groundCount = info->groundCount;
+
+    bvhFree(&world->bvh);
+    world->bvh = bvh;
+    world->bvhDirty = NO;
+
+    hfFree(&world->groundField);
+    world->groundField = groundField;
+    world->groundFieldValid = info->groundFieldValid != 0;
+
+    navGridFree(&world->navGrid);
+    resetNavQueries(world);
+    world->navGrid = navGrid;
+    world->navGridValid = info->navGridValid != 0;
+
+    coverMapFree(&world->coverMap);
+    world->coverMap = coverMap;
+    world->coverMapValid = info->coverMapValid != 0;
+
+    world->bakedCache = cache;
+    world->staticIsMilitaryBase = YES;
+    return YES;
+}
+
+void simCollisionLoadOrBuildMilitaryBase(SimCollision *world, const char *cachePath) {
+    if (cachePath && simCollisionLoadCache(world, cachePath)) {
+        fprintf(stderr, "[COLLISION] Loaded baked collision cache (%d shapes)\n", world->shapeCount);
+        return;
+    }
+
+    simCollisionBuildMilitaryBase(world);
+    if (cachePath && !simCollisionWriteCache(world, cachePath)) {
+        fprintf(stderr, "[COLLISION] Failed to write collision cache to %s\n", cachePath);
+    }
+}
+
+// ============================================
+// WORLD BUILDING
+// ============================================
+
+static void addMilitaryBaseShapes(SimCollision *world);
+
+void simCollisionBuildMilitaryBase(SimCollision *world) {
+    addMilitaryBaseShapes(world);
+    world->staticIsMilitaryBase = YES;
+    simCollisionRebuildBroadphase(world);
+    simCollisionBuildNavGrid(world);
+    simCollisionBuildCoverPoints(world);
+}
+
+// Every static shape of the base, in a fixed order
+static void addMilitaryBaseShapes(SimCollision *world) {
+    simCollisionClearAllShapes(world);
+
+    // ---- ARENA BOUNDARIES ----
+    float arenaWall = 0.5f;
+    simCollisionAddBox(world, -ARENA_SIZE - arenaWall, FLOOR_Y, -ARENA_SIZE - arenaWall,
+                       -ARENA_SIZE, FLOOR_Y + 10.0f, ARENA_SIZE + arenaWall,
+                       CollisionShapeTypeWall, NO, "arena_west");
+    simCollisionAddBox(world, ARENA_SIZE, FLOOR_Y, -ARENA_SIZE - arenaWall,
+                       ARENA_SIZE + arenaWall, FLOOR_Y + 10.0f, ARENA_SIZE + arenaWall,
+                       CollisionShapeTypeWall, NO, "arena_east");
+    simCollisionAddBox(world, -ARENA_SIZE - arenaWall, FLOOR_Y, -ARENA_SIZE - arenaWall,
+                       ARENA_SIZE + arenaWall, FLOOR_Y + 10.0f, -ARENA_SIZE,
+                       CollisionShapeTypeWall, NO, "arena_south");
+    simCollisionAddBox(world, -ARENA_SIZE - arenaWall, FLOOR_Y, ARENA_SIZE,
+                       ARENA_SIZE + arenaWall, FLOOR_Y + 10.0f, ARENA_SIZE + arenaWall,
+                       CollisionShapeTypeWall, NO, "arena_north");
+
+    // ---- COMMAND BUILDING ----
+    float hw = CMD_BUILDING_WIDTH / 2.0f;
+    float hd = CMD_BUILDING_DEPTH / 2.0f;
+    float wt = CMD_WALL_THICK;
+    float wh = CMD_BUILDING_HEIGHT;
+    float dw = CMD_DOOR_WIDTH / 2.0f;
+
+    // Command building walls
+    simCollisionAddBox(world, CMD_BUILDING_X - hw - wt, FLOOR_Y, CMD_BUILDING_Z - hd - wt,
+                       CMD_BUILDING_X + hw + wt, FLOOR_Y + wh, CMD_BUILDING_Z - hd,
+                       CollisionShapeTypeWall, NO, "cmd_wall_south");
+    simCollisionAddBox(world, CMD_BUILDING_X - hw - wt, FLOOR_Y, CMD_BUILDING_Z - hd,
+                       CMD_BUILDING_X - hw, FLOOR_Y + wh, CMD_BUILDING_Z + hd + wt,
+                       CollisionShapeTypeWall, NO, "cmd_wall_west");
+    simCollisionAddBox(world, CMD_BUILDING_X + hw, FLOOR_Y, CMD_BUILDING_Z - hd,
+                       CMD_BUILDING_X + hw + wt, FLOOR_Y + wh, CMD_BUILDING_Z + hd + wt,
+                       CollisionShapeTypeWall, NO, "cmd_wall_east");
+    // North wall with door opening
+    simCollisionAddBox(world, CMD_BUILDING_X - hw, FLOOR_Y, CMD_BUILDING_Z + hd,
+                       CMD_BUILDING_X - dw, FLOOR_Y + wh, CMD_BUILDING_Z + hd + wt,
+                       CollisionShapeTypeWall, NO, "cmd_wall_north_left");
+    simCollisionAddBox(world, CMD_BUILDING_X + dw, FLOOR_Y, CMD_BUILDING_Z + hd,
+                       CMD_BUILDING_X + hw, FLOOR_Y + wh, CMD_BUILDING_Z + hd + wt,
+                       CollisionShapeTypeWall, NO, "cmd_wall_north_right");
+    simCollisionAddBox(world, CMD_BUILDING_X - dw, FLOOR_Y + CMD_DOOR_HEIGHT, CMD_BUILDING_Z + hd,
+                       CMD_BUILDING_X + dw, FLOOR_Y + wh, CMD_BUILDING_Z + hd + wt,
+                       CollisionShapeTypeWall, NO, "cmd_wall_above_door");
+
+    // Command building second floor
+    float secondFloorY = FLOOR_Y + CMD_BUILDING_HEIGHT / 2.0f;
+    float innerWall = CMD_WALL_THICK;
+    float stairHoleW = 2.0f;  // Full width, but use half for hole
+    float stairHoleD = 2.0f;  // Full depth, but use half for hole
+    // Visual uses stairHoleD/2 for hole boundaries, so collision must match
+    float holeHalfW = stairHoleW / 2.0f;  // = 1.0
+    float holeHalfD = stairHoleD / 2.0f;  // = 1.0
+
+    // Second floor platform (with stair hole matching visual geometry)
+    // Left section
+    simCollisionAddPlatform(world, CMD_BUILDING_X - hw + innerWall, CMD_BUILDING_Z - hd + innerWall, CMD_BUILDING_X - holeHalfW, CMD_BUILDING_Z + hd - innerWall,
+                            secondFloorY, 0.2f, "cmd_floor2_left");
+    // Right section
+    simCollisionAddPlatform(world, CMD_BUILDING_X + holeHalfW, CMD_BUILDING_Z - hd + innerWall, CMD_BUILDING_X + hw - innerWall, CMD_BUILDING_Z + hd - innerWall,
+                            secondFloorY, 0.2f, "cmd_floor2_right");
+    // Back section
+    simCollisionAddPlatform(world, CMD_BUILDING_X - holeHalfW, CMD_BUILDING_Z - hd + innerWall, CMD_BUILDING_X + holeHalfW, CMD_BUILDING_Z - holeHalfD,
+                            secondFloorY, 0.2f, "cmd_floor2_back");
+    // Front section
+    simCollisionAddPlatform(world, CMD_BUILDING_X - holeHalfW, CMD_BUILDING_Z + holeHalfD, CMD_BUILDING_X + holeHalfW, CMD_BUILDING_Z + hd - innerWall,
+                            secondFloorY, 0.2f, "cmd_floor2_front");
+
+    // Command building stairs (6 steps) - match visual geometry
+    int cmdNumSteps = 6;
+    float cmdStepH = (secondFloorY - FLOOR_Y) / cmdNumSteps;
+    float cmdStepD = stairHoleD / cmdNumSteps;  // Match visual: stairHoleD / numSteps
+    float cmdStairX = CMD_BUILDING_X - holeHalfW + 0.1f;
+    float cmdStairW = stairHoleW - 0.2f;  // Match visual: stairHoleW - 0.2
+
+    for (int i = 0; i < cmdNumSteps; i++) {
+        float stepTop = FLOOR_Y + (i + 1) * cmdStepH;
+        float stepZStart = CMD_BUILDING_Z + holeHalfD - i * cmdStepD;  // Match visual
+        float stepZEnd = stepZStart - cmdStepD;
+
+        char stepName[32];
+        snprintf(stepName, sizeof(stepName), "cmd_stair_%d", i);
+        simCollisionAddPlatform(world, cmdStairX, stepZEnd, cmdStairX + cmdStairW, stepZStart,
+                                stepTop, cmdStepH, stepName);
+    }
+
+    // ---- GUARD TOWERS ----
+    float towerPositions[4][2] = {
+        {TOWER_OFFSET, TOWER_OFFSET},
+        {-TOWER_OFFSET, TOWER_OFFSET},
+        {-TOWER_OFFSET, -TOWER_OFFSET},
+        {TOWER_OFFSET, -TOWER_OFFSET}
+    };
+    float towerTs = TOWER_SIZE / 2.0f;
+    float legW = 0.3f;
+
+    for (int t = 0; t < 4; t++) {
+        float tx = towerPositions[t][0];
+        float tz = towerPositions[t][1];
+
+        // Tower platform
+        char platName[32];
+        snprintf(platName, sizeof(platName), "tower_plat_%d", t);
+        simCollisionAddPlatform(world, tx - towerTs, tz - towerTs, tx + towerTs, tz + towerTs,
+                                PLATFORM_LEVEL, CATWALK_THICK, platName);
+
+        // Tower legs (4 per tower)
+        char legName[32];
+        snprintf(legName, sizeof(legName), "tower_leg_%d_0", t);
+        simCollisionAddBox(world, tx - towerTs, FLOOR_Y, tz - towerTs,
+                           tx - towerTs + legW, PLATFORM_LEVEL, tz - towerTs + legW,
+                           CollisionShapeTypeWall, NO, legName);
+        snprintf(legName, sizeof(legName), "tower_leg_%d_1", t);
+        simCollisionAddBox(world, tx + towerTs - legW, FLOOR_Y, tz - towerTs,
+                           tx + towerTs, PLATFORM_LEVEL, tz - towerTs + legW,
+                           CollisionShapeTypeWall, NO, legName);
+        snprintf(legName, sizeof(legName), "tower_leg_%d_2", t);
+        simCollisionAddBox(world, tx - towerTs, FLOOR_Y, tz + towerTs - legW,
+                           tx - towerTs + legW, PLATFORM_LEVEL, tz + towerTs,
+                           CollisionShapeTypeWall, NO, legName);
+        snprintf(legName, sizeof(legName), "tower_leg_%d_3", t);
+        simCollisionAddBox(world, tx + towerTs - legW, FLOOR_Y, tz + towerTs - legW,
+                           tx + towerTs, PLATFORM_LEVEL, tz + towerTs,
+                           CollisionShapeTypeWall, NO, legName);
+
+        // Tower cross braces removed - they were blocking ramp access
+        // Visual braces in GeometryBuilder are decorative only
+
+        // Tower ramp - goes OUTWARD from arena center (away from catwalks)
+        float rampDz = (tz > 0) ? 1.0f : -1.0f;  // Away from center on Z axis
+        float rampStartZ = tz + rampDz * towerTs;  // Start at outer edge of tower
+        float rampEndZ = rampStartZ + rampDz * RAMP_LENGTH;
+
+        char rampName[32];
+        snprintf(rampName, sizeof(rampName), "tower_ramp_%d", t);
+
+        simCollisionAddRamp(world, tx - RAMP_WIDTH/2, fminf(rampStartZ, rampEndZ),
+                            tx + RAMP_WIDTH/2, fmaxf(rampStartZ, rampEndZ),
+                            PLATFORM_LEVEL, FLOOR_Y, 2, rampDz,
+                            rampName);
+    }
+
+    // ---- CATWALKS ----
+    float cwW = CATWALK_WIDTH / 2.0f;
+    float cwTs = TOWER_SIZE / 2.0f;
+    float railThick = 0.06f;
+
+    // North catwalk (runs E-W at +Z)
+    simCollisionAddPlatform(world, -TOWER_OFFSET + cwTs, TOWER_OFFSET - cwW, TOWER_OFFSET - cwTs, TOWER_OFFSET + cwW,
+                            PLATFORM_LEVEL, CATWALK_THICK, "catwalk_north");
+    // North catwalk railings
+    simCollisionAddBox(world, -TOWER_OFFSET + cwTs, PLATFORM_LEVEL, TOWER_OFFSET + cwW - railThick,
+                       TOWER_OFFSET - cwTs, PLATFORM_LEVEL + CATWALK_RAIL_HEIGHT, TOWER_OFFSET + cwW,
+                       CollisionShapeTypeWall, NO, "catwalk_north_rail_n");
+    simCollisionAddBox(world, -TOWER_OFFSET + cwTs, PLATFORM_LEVEL, TOWER_OFFSET - cwW,
+                       TOWER_OFFSET - cwTs, PLATFORM_LEVEL + CATWALK_RAIL_HEIGHT, TOWER_OFFSET - cwW + railThick,
+                       CollisionShapeTypeWall, NO, "catwalk_north_rail_s");
+
+    // South catwalk (runs E-W at -Z)
+    simCollisionAddPlatform(world, -TOWER_OFFSET + cwTs, -TOWER_OFFSET - cwW, TOWER_OFFSET - cwTs, -TOWER_OFFSET + cwW,
+                            PLATFORM_LEVEL, CATWALK_THICK, "catwalk_south");
+    // South catwalk railings
+    simCollisionAddBox(world, -TOWER_OFFSET + cwTs, PLATFORM_LEVEL, -TOWER_OFFSET + cwW - railThick,
+                       TOWER_OFFSET - cwTs, PLATFORM_LEVEL + CATWALK_RAIL_HEIGHT, -TOWER_OFFSET + cwW,
+                       CollisionShapeTypeWall, NO, "catwalk_south_rail_n");
+    simCollisionAddBox(world, -TOWER_OFFSET + cwTs, PLATFORM_LEVEL, -TOWER_OFFSET - cwW,
+                       TOWER_OFFSET - cwTs, PLATFORM_LEVEL + CATWALK_RAIL_HEIGHT, -TOWER_OFFSET - cwW + railThick,
+                       CollisionShapeTypeWall, NO, "catwalk_south_rail_s");
+
+    // East catwalk (runs N-S at +X)
+    simCollisionAddPlatform(world, TOWER_OFFSET - cwW, -TOWER_OFFSET + cwTs, TOWER_OFFSET + cwW, TOWER_OFFSET - cwTs,
+                            PLATFORM_LEVEL, CATWALK_THICK, "catwalk_east");
+    // East catwalk railings
+    simCollisionAddBox(world, TOWER_OFFSET + cwW - railThick, PLATFORM_LEVEL, -TOWER_OFFSET + cwTs,
+                       TOWER_OFFSET + cwW, PLATFORM_LEVEL + CATWALK_RAIL_HEIGHT, TOWER_OFFSET - cwTs,
+                       CollisionShapeTypeWall, NO, "catwalk_east_rail_e");
+    simCollisionAddBox(world, TOWER_OFFSET - cwW, PLATFORM_LEVEL, -TOWER_OFFSET + cwTs,
+                       TOWER_OFFSET - cwW + railThick, PLATFORM_LEVEL + CATWALK_RAIL_HEIGHT, TOWER_OFFSET - cwTs,
+                       CollisionShapeTypeWall, NO, "catwalk_east_rail_w");
+
+    // West catwalk (runs N-S at -X)
+    simCollisionAddPlatform(world, -TOWER_OFFSET - cwW, -TOWER_OFFSET + cwTs, -TOWER_OFFSET + cwW, TOWER_OFFSET - cwTs,
+                            PLATFORM_LEVEL, CATWALK_THICK, "catwalk_west");
+    // West catwalk railings
+    simCollisionAddBox(world, -TOWER_OFFSET + cwW - railThick, PLATFORM_LEVEL, -TOWER_OFFSET + cwTs,
+                       -TOWER_OFFSET + cwW, PLATFORM_LEVEL + CATWALK_RAIL_HEIGHT, TOWER_OFFSET - cwTs,
+                       CollisionShapeTypeWall, NO, "catwalk_west_rail_e");
+    simCollisionAddBox(world, -TOWER_OFFSET - cwW, PLATFORM_LEVEL, -TOWER_OFFSET + cwTs,
+                       -TOWER_OFFSET - cwW + railThick, PLATFORM_LEVEL + CATWALK_RAIL_HEIGHT, TOWER_OFFSET - cwTs,
+                       CollisionShapeTypeWall, NO, "catwalk_west_rail_w");
+
+    // ---- CARGO CONTAINERS ----
+    // Positioned to not block tower ramp approaches
+    struct { float x, z; int rotated; } containers[] = {
+        {8.0f, 4.0f, 0}, {6.0f, 7.0f, 1}, {-8.0f, 4.0f, 0}, {-6.0f, 7.0f, 1},
+        {6.0f, -8.0f, 1}, {-6.0f, -8.0f, 1}, {0.0f, -12.0f, 0}, {18.0f, 0.0f, 1}
+    };
+
+    for (int c = 0; c < 8; c++) {
+        float cx = containers[c].x;
+        float cz = containers[c].z;
+        float cxl = containers[c].rotated ? CONTAINER_WIDTH/2 : CONTAINER_LENGTH/2;
+        float czl = containers[c].rotated ? CONTAINER_LENGTH/2 : CONTAINER_WIDTH/2;
+
+        char contName[32];
+        snprintf(contName, sizeof(contName), "container_%d", c);
+
+        // Container as solid wall that's also walkable on top
+        simCollisionAddBox(world, cx - cxl, FLOOR_Y, cz - czl,
+                           cx + cxl, FLOOR_Y + CONTAINER_HEIGHT, cz + czl,
+                           CollisionShapeTypeWall, YES, contName);
+    }
+
+    // Stacked container
+    simCollisionAddBox(world, 8.0f - CONTAINER_LENGTH/2, FLOOR_Y + CONTAINER_HEIGHT, 4.0f - CONTAINER_WIDTH/2,
+                       8.0f + CONTAINER_LENGTH/2, FLOOR_Y + CONTAINER_HEIGHT * 2, 4.0f + CONTAINER_WIDTH/2,
+                       CollisionShapeTypeWall, YES, "container_stacked");
+
+    // ---- SANDBAG WALLS ----
+    float sbTopY = FLOOR_Y + SANDBAG_HEIGHT;
+
+    // Horizontal sandbags
+    simCollisionAddBox(world, 5.0f - SANDBAG_LENGTH/2, FLOOR_Y, 4.0f - SANDBAG_THICK/2,
+                       5.0f + SANDBAG_LENGTH/2, sbTopY, 4.0f + SANDBAG_THICK/2,
+                       CollisionShapeTypeWall, YES, "sandbag_0");
+    simCollisionAddBox(world, -5.0f - SANDBAG_LENGTH/2, FLOOR_Y, 4.0f - SANDBAG_THICK/2,
+                       -5.0f + SANDBAG_LENGTH/2, sbTopY, 4.0f + SANDBAG_THICK/2,
+                       CollisionShapeTypeWall, YES, "sandbag_1");
+    simCollisionAddBox(world, 5.0f - SANDBAG_LENGTH/2, FLOOR_Y, -4.0f - SANDBAG_THICK/2,
+                       5.0f + SANDBAG_LENGTH/2, sbTopY, -4.0f + SANDBAG_THICK/2,
+                       CollisionShapeTypeWall, YES, "sandbag_2");
+    simCollisionAddBox(world, -5.0f - SANDBAG_LENGTH/2, FLOOR_Y, -4.0f - SANDBAG_THICK/2,
+                       -5.0f + SANDBAG_LENGTH/2, sbTopY, -4.0f + SANDBAG_THICK/2,
+                       CollisionShapeTypeWall, YES, "sandbag_3");
+
+    // Vertical sandbags
+    simCollisionAddBox(world, 12.0f - SANDBAG_THICK/2, FLOOR_Y, 10.0f - SANDBAG_LENGTH/2,
+                       12.0f + SANDBAG_THICK/2, sbTopY, 10.0f + SANDBAG_LENGTH/2,
+                       CollisionShapeTypeWall, YES, "sandbag_4");
+    simCollisionAddBox(world, -12.0f - SANDBAG_THICK/2, FLOOR_Y, 10.0f - SANDBAG_LENGTH/2,
+                       -12.0f + SANDBAG_THICK/2, sbTopY, 10.0f + SANDBAG_LENGTH/2,
+                       CollisionShapeTypeWall, YES, "sandbag_5");
+    simCollisionAddBox(world, 12.0f - SANDBAG_THICK/2, FLOOR_Y, -10.0f - SANDBAG_LENGTH/2,
+                       12.0f + SANDBAG_THICK/2, sbTopY, -10.0f + SANDBAG_LENGTH/2,
+                       CollisionShapeTypeWall, YES, "sandbag_6");
+    simCollisionAddBox(world, -12.0f - SANDBAG_THICK/2, FLOOR_Y, -10.0f - SANDBAG_LENGTH/2,
+                       -12.0f + SANDBAG_THICK/2, sbTopY, -10.0f + SANDBAG_LENGTH/2,
+                       CollisionShapeTypeWall, YES, "sandbag_7");
+    simCollisionAddBox(world, 3.0f - SANDBAG_THICK/2, FLOOR_Y, 8.0f - SANDBAG_LENGTH/2,
+                       3.0f + SANDBAG_THICK/2, sbTopY, 8.0f + SANDBAG_LENGTH/2,
+                       CollisionShapeTypeWall, YES, "sandbag_8");
+    simCollisionAddBox(world, -3.0f - SANDBAG_THICK/2, FLOOR_Y, 8.0f - SANDBAG_LENGTH/2,
+                       -3.0f + SANDBAG_THICK/2, sbTopY, 8.0f + SANDBAG_LENGTH/2,
+                       CollisionShapeTypeWall, YES, "sandbag_9");
+
+    // ---- LEGACY COVER WALLS ----
+    float wallTopY = FLOOR_Y + WALL_HEIGHT;
+    simCollisionAddBox(world, WALL1_X - WALL_WIDTH/2, FLOOR_Y, WALL1_Z - WALL_DEPTH/2,
+                       WALL1_X + WALL_WIDTH/2, wallTopY, WALL1_Z + WALL_DEPTH/2,
+                       CollisionShapeTypeWall, YES, "cover_wall_1");
+    simCollisionAddBox(world, WALL2_X - WALL_WIDTH/2, FLOOR_Y, WALL2_Z - WALL_DEPTH/2,
+                       WALL2_X + WALL_WIDTH/2, wallTopY, WALL2_Z + WALL_DEPTH/2,
+                       CollisionShapeTypeWall, YES, "cover_wall_2");
+}
+
@@ -0,0 +1,322 @@
+// SimCollision.h - Portable collision world (shapes, broadphase, queries, baked cache)
+#ifndef SIMCOLLISION_H
+#define SIMCOLLISION_H
+
+#include "SimTypes.h"
+#include "GameConfig.h"
+#include <stdint.h>
+
+// ============================================
+// COLLISION SHAPE TYPES
+// ============================================
+
+typedef enum {
+    CollisionShapeTypeWall,         // Solid wall - blocks movement
+    CollisionShapeTypePlatform,     // Can stand on top, blocks from sides
+    CollisionShapeTypeRamp,         // Sloped surface
+    CollisionShapeTypeFloor,        // Ground level surface
+    CollisionShapeTypeTrigger,      // Non-solid, triggers events
+} CollisionShapeType;
+
+typedef enum {
+    CollisionLayerWorld     = 1 << 0,   // Static world geometry
+    CollisionLayerPlayer    = 1 << 1,   // Player collision
+    CollisionLayerEnemy     = 1 << 2,   // Enemy collision
+    CollisionLayerProjectile = 1 << 3,  // Bullets/rockets
+    CollisionLayerPickup    = 1 << 4,   // Pickups
+    CollisionLayerAll       = 0xFFFF
+} CollisionLayer;
+
+// ============================================
+// COLLISION SHAPE STRUCTURE
+// ============================================
+
+// Shapes carry their name inline so the shape array can be baked to a file
+#define COLLISION_SHAPE_NAME_LENGTH 32
+
+typedef struct {
+    // Bounds (axis-aligned bounding box)
+    float minX, minY, minZ;
+    float maxX, maxY, maxZ;
+
+    // Shape properties
+    CollisionShapeType type;
+    CollisionLayer layer;
+
+    // Surface properties
+    BOOL isWalkable;            // Can player stand on top
+    BOOL blocksMovement;        // Blocks horizontal movement
+    BOOL blocksProjectiles;     // Blocks raycast shots
+
+    // Ramp-specific properties
+    BOOL isRamp;
+    float rampStartY;           // Y at ramp start
+    float rampEndY;             // Y at ramp end
+    int rampAxis;               // 0=X, 2=Z - which axis the ramp slopes along
+    float rampDirection;        // 1.0 or -1.0 for slope direction
+
+    // Identification
+    int shapeId;                // Handle for this shape (stable until removed)
+    char debugName[COLLISION_SHAPE_NAME_LENGTH];   // For debugging (copied, truncated)
+} CollisionShape;
+
+// ============================================
+// COLLISION RESULTS
+// ============================================
+
+typedef struct {
+    BOOL hit;
+    float distance;             // Distance to hit point
+    SimVec3 hitPoint;           // World position of hit
+    SimVec3 hitNormal;          // Surface normal at hit
+    int shapeId;                // ID of shape that was hit
+    CollisionShapeType shapeType;
+} RaycastResult;
+
+typedef struct {
+    BOOL onGround;
+    float groundY;              // Y position of ground surface
+    BOOL onRamp;                // Standing on a ramp
+    int groundShapeId;          // ID of ground shape
+} GroundResult;
+
+typedef struct {
+    BOOL collided;
+    SimVec3 pushOut;            // Vector to push player out of collision
+    SimVec3 newVelocity;        // Adjusted velocity after collision
+    int hitShapeId;             // ID of shape collided with
+} MoveResult;
+
+typedef struct {
+    BOOL hit;                   // Touched a blocking shape during the move
+    float timeOfImpact;         // Fraction of the move done before the first hit (1 = unobstructed)
+    SimVec3 position;           // Final position after sliding
+    SimVec3 slideVelocity;      // Velocity with the blocked components removed
+    SimVec3 hitNormal;          // Normal of the first surface hit
+    int hitShapeId;             // ID of the first shape hit
+} SweepMoveResult;
+
+typedef struct {
+    SimVec3 position;           // Final position (eye level, like simCollisionMovePlayer)
+    SimVec3 velocity;           // Final velocity
+    BOOL onGround;              // Snapped to ground or pushed up onto a surface
+    SweepMoveResult sweep;      // Swept move from the input position
+    GroundResult ground;        // Ground at the swept position
+    MoveResult move;            // Overlap push-out after the ground snap
+} KinematicResult;
+
+// ============================================
+// COLLISION WORLD
+// ============================================
+
+// Shape storage grows on demand, starting at this many shapes
+#define COLLISION_SHAPE_INITIAL_CAPACITY 256
+
+// Shape handles (shapeId) pack a slot index and a generation counter,
+// so a handle to a removed shape never resolves to a shape added later
+#define SHAPE_HANDLE_INDEX_BITS 20
+#define SHAPE_HANDLE_MAX_SLOTS (1 << SHAPE_HANDLE_INDEX_BITS)
+
+// Opaque - see SimCollision.c
+typedef struct SimCollision SimCollision;
+
+SimCollision *simCollisionCreate(void);
+void simCollisionDestroy(SimCollision *world);
+
+// Job system the nav and cover builds and batched kinematics split their work over (not owned).
+// NULL (the default) runs everything on the calling thread.
+void simCollisionSetJobSystem(SimCollision *world, SimJobSystem *jobs);
+
+// Shape management - each returns the new shape's handle, or -1 when out of memory
+int simCollisionAddBox(SimCollision *world,
+                       float minX, float minY, float minZ,
+                       float maxX, float maxY, float maxZ,
+                       CollisionShapeType type, BOOL walkable, const char *name);
+
+int simCollisionAddRamp(SimCollision *world,
+                        float minX, float minZ, float maxX, float maxZ,
+                        float startY, float endY, int axis, float direction,
+                        const char *name);
+
+int simCollisionAddPlatform(SimCollision *world,
+                            float minX, float minZ, float maxX, float maxZ,
+                            float topY, float thickness, const char *name);
+
+// Dynamic shapes - moved every tick (doors, moving platforms). Kept apart from the
+// static set: moving one only refits its bounds, and they are seen by every query.
+// They are not baked into the ground height field.
+int simCollisionAddDynamicBox(SimCollision *world,
+                              float minX, float minY, float minZ,
+                              float maxX, float maxY, float maxZ,
+                              CollisionShapeType type, BOOL walkable, const char *name);
+
+// Set new bounds for a dynamic shape. Returns NO if shapeId isn't a live dynamic shape.
+BOOL simCollisionMoveDynamicShape(SimCollision *world, int shapeId,
+                                  float minX, float minY, float minZ,
+                                  float maxX, float maxY, float maxZ);
+
+void simCollisionRemoveShape(SimCollision *world, int shapeId);
+void simCollisionClearAllShapes(SimCollision *world);
+
+// Rebuild the query BVHs now (otherwise done lazily on the next query).
+// Call after editing a shape returned by simCollisionGetShape in place.
+void simCollisionRebuildBroadphase(SimCollision *world);
+
+// O(1) handle lookup - NULL if the shape was removed. The pointer is only
+// valid until the next add/remove, since storage may grow or compact.
+CollisionShape *simCollisionGetShape(SimCollision *world, int shapeId);
+int simCollisionShapeCount(const SimCollision *world);          // Static plus dynamic
+int simCollisionDynamicShapeCount(const SimCollision *world);
+
+// Bring the broadphase up to date after shape changes. Queries do this themselves, but
+// may only run concurrently on one world once it's done - call this before starting
+// queries on several threads, and don't change shapes while they run.
+void simCollisionPrepareQueries(SimCollision *world);
+
+// Queries. Each thread has its own query scratch, so after simCollisionPrepareQueries
+// they can be called from several threads at once.
+RaycastResult simCollisionRaycast(SimCollision *world, SimVec3 origin, SimVec3 direction,
+                                  float maxDistance, CollisionLayer layerMask);
+
+// Batched raycast - each ray's static candidates come from the BVH and are tested 4 shapes
+// at a time (SIMD), then the dynamic shapes. results[i] matches simCollisionRaycast for origins[i] / directions[i].
+void simCollisionRaycastBatch(SimCollision *world, const SimVec3 *origins, const SimVec3 *directions,
+                              int count, float maxDistance, CollisionLayer layerMask,
+                              RaycastResult *results);
+
+GroundResult simCollisionCheckGround(SimCollision *world, float x, float y, float z,
+                                     float radius, float height);
+
+// Self-check of the baked ground height field: samples ground queries (half of them at
+// walkable tops and their edges) and answers each with and without the field. Returns how
+// many answers differ (the first few are logged) - 0 unless the field is wrong.
+int simCollisionVerifyGroundField(SimCollision *world, int samples, uint64_t seed);
+
+// Overlap push-out for the player box at position (eye level)
+MoveResult simCollisionMovePlayer(SimCollision *world, SimVec3 position, SimVec3 velocity,
+                                  float radius, float height);
+
+// Swept move-and-slide: moves the player box by velocity (one tick of displacement),
+// stopping at the first blocking shape and sliding along it. Catches thin shapes
+// that a fast move would otherwise skip over. Uses the same box as simCollisionMovePlayer.
+SweepMoveResult simCollisionSweepPlayer(SimCollision *world, SimVec3 position, SimVec3 velocity,
+                                        float radius, float height);
+
+// Batched kinematics for many bodies (bots, players) in one call. Each body runs the
+// swept move, then a ground check and a snap onto the ground, then overlap push-out.
+// Large batches are split into chunks over the job system.
+void simCollisionResolveKinematics(SimCollision *world, const SimVec3 *positions,
+                                   const SimVec3 *velocities, const float *radii,
+                                   const float *heights, int count, KinematicResult *results);
+
+// Line of sight against world geometry (layer World, projectile blockers), dynamic shapes
+// included - traced with the same BVH-culled SIMD kernel as simCollisionRaycastBatch.
+BOOL simCollisionLineOfSight(SimCollision *world, SimVec3 from, SimVec3 to);
+
+// Line of sight for count pairs in one call (the broadphase is brought up to date once).
+// results[i] matches simCollisionLineOfSight for from[i] / to[i].
+void simCollisionLineOfSightBatch(SimCollision *world, const SimVec3 *from, const SimVec3 *to,
+                                  int count, BOOL *results);
+
+// ============================================
+// NAVIGATION
+// ============================================
+
+// Corners one path query returns at most - a longer path is cut short, query again from its end
+#define SIM_NAV_MAX_PATH_POINTS 32
+
+// Flow fields kept at once - one per player that bots pursue
+#define SIM_NAV_FLOW_FIELDS 8
+
+// Circle in XZ that paths keep out of (spawn protection zones)
+typedef struct {
+    float x, z;
+    float radius;
+} SimNavCircle;
+
+// Bake the walkable grid from the static shapes: every surface a bot or player fits on
+// (floor, ramps, stairs, platforms, catwalks, the second floor) and which neighbouring
+// surfaces can be walked to, jumped up to (1 m) or dropped down to. Shape changes
+// invalidate it (path queries fail) until this is called again.
+void simCollisionBuildNavGrid(SimCollision *world);
+
+// Shortest path from one feet position to another over the nav grid. Writes the corners
+// after from (feet level, the last at the goal) to points and returns how many - 0 when
+// from and to are in the same spot - or -1 when there is no path. Paths stay out of the
+// avoid circles; with avoidDynamic they also route around dynamic shapes (a closed door).
+// Results are cached, and a cached path is exactly the one a new search would find.
+// Safe from several threads after simCollisionPrepareQueries.
+int simCollisionFindPath(SimCollision *world, SimVec3 from, SimVec3 to,
+                         const SimNavCircle *avoid, int avoidCount, BOOL avoidDynamic,
+                         SimVec3 *points, int maxPoints);
+
+// Point flow field `field` (0 to SIM_NAV_FLOW_FIELDS - 1) at goal (feet): every node on
+// the grid gets its next step toward it, routing around dynamic shapes. Rebuilt only when
+// the goal's node or the dynamic shapes changed since the last update, so the field is
+// always the one its inputs give. Different fields may update at once on different threads
+// after simCollisionPrepareQueries; a field must not be read while it updates.
+void simCollisionUpdateFlowField(SimCollision *world, int field, SimVec3 goal);
+
+// Stop answering lookups from a field until it's next updated. Its last build is kept, so
+// updating it again for the same goal costs nothing.
+void simCollisionPauseFlowField(SimCollision *world, int field);
+
+// Where to head from feet position from to follow a flow field - a few cells along it, up
+// to the next turn, jump or drop. O(1); safe from any number of threads. Returns NO when
+// the field doesn't reach from there (or from is at its goal).
+BOOL simCollisionFlowTarget(SimCollision *world, int field, SimVec3 from, SimVec3 *outPoint);
+
+// ============================================
+// COVER
+// ============================================
+
+// Bake cover points from the static shapes and the nav grid: a spot every meter and a half
+// along each side of everything that stops shots and stands at least 1 m over the ground
+// next to it, scored by how much of the area around can see a body standing there, and
+// indexed by position. Shape changes invalidate them (queries find nothing) until this is
+// called again; needs the nav grid.
+void simCollisionBuildCoverPoints(SimCollision *world);
+
+// Cover points baked (0 when there are none)
+int simCollisionCoverCount(const SimCollision *world);
+
+// Feet position of cover point `cover`. Returns NO for a bad index or no cover points.
+BOOL simCollisionCoverPoint(const SimCollision *world, int cover, SimVec3 *outFeet);
+
+// Best cover point within maxDistance of from (XZ) against a threat at eye position threat,
+// other than exclude (-1 for none): its blocker faces the threat, and it scores best on
+// nearness to from, distance from the threat and low exposure - the first of the best few
+// the threat can't see. Returns -1 when nothing in range faces the threat. A few
+// microseconds; safe from several threads after simCollisionPrepareQueries.
+int simCollisionFindCover(SimCollision *world, SimVec3 from, SimVec3 threat, float maxDistance, int exclude);
+
+// World initialization - shapes, broadphase, nav grid and cover points
+void simCollisionBuildMilitaryBase(SimCollision *world);
+
+// ============================================
+// BAKED CACHE
+// ============================================
+
+// Static shapes plus their BVH, ground height field, nav grid and cover points in one
+// versioned file. Path comes from FPS_COLLISION_CACHE, or collision.cache in
+// the per-user cache directory ($XDG_CACHE_HOME or ~/.cache, ~/Library/Caches on macOS)
+// under fpsarena, created owner-only along with a missing $XDG_CACHE_HOME. Returns NO, and
+// says so once on stderr, if there is no such directory or the path doesn't fit.
+BOOL simCollisionDefaultCachePath(char *path, int pathSize);
+
+// Bake the world to path. The file is keyed on the military base's compile-time geometry,
+// so only a world whose static shapes are still the base as built (or loaded) is written -
+// returns NO for any other.
+BOOL simCollisionWriteCache(SimCollision *world, const char *path);
+
+// Replace every shape with the baked set, mapped in place (no copies). Only a cache baked
+// from the current military base geometry and build parameters loads; every stored index
+// is range-checked first. Returns NO if the file is missing, not ours, stale or malformed.
+// Handles from before the load must not be used. The mapping is copied out on the first
+// static change.
+BOOL simCollisionLoadCache(SimCollision *world, const char *path);
+
+// Map the cache at path when current, otherwise build the military base and write it
+void simCollisionLoadOrBuildMilitaryBase(SimCollision *world, const char *cachePath);
+
+#endif // SIMCOLLISION_H
@@ -0,0 +1,414 @@
+// SimCombat.c - Player shooting and damage implementation (with multiplayer PvP support)
+#include "SimWorld.h"
+#include "Collision.h"
+#include <math.h>
+
+// Closest environment hit given the collision result for this ray
+// (the door is a dynamic collision shape, so it is already included)
+static float environmentHitDistance(RaycastResult worldHit, float maxRange) {
+    return worldHit.hit ? worldHit.distance : maxRange;
+}
+
+// Check ray against environment (walls, doors, etc.) - returns the closest hit distance
+static float checkEnvironmentHit(SimWorld *world, SimVec3 muzzle, SimVec3 dir, float maxRange) {
+    RaycastResult result = simCollisionRaycast(world->collision, muzzle, dir, maxRange, CollisionLayerWorld);
+    return environmentHitDistance(result, maxRange);
+}
+
+// Bots looked at per shot or splash before falling back to checking every one
+enum { BOT_CANDIDATES_MAX = 256 };
+
+// Furthest a bot or player hitbox (both 0.6 half-width) reaches from its center in XZ -
+// the box corner, a little over
+static const float HITBOX_REACH = 0.85f;
+
+// Slot to check for the nth nearby bot - every slot in order when the query found more than fit
+static int nearbyBot(const int *nearby, int found, int n) {
+    return found <= BOT_CANDIDATES_MAX ? nearby[n] : n;
+}
+
+static int nearbyBotCount(const SimWorld *world, int found) {
+    return found <= BOT_CANDIDATES_MAX ? found : world->botPool.count;
+}
+
+// Other players that shots and splash can hit
+static BOOL isPlayerTarget(const SimWorld *world, int shooterIndex, int playerIndex) {
+    return world->isMultiplayer && playerIndex != shooterIndex && world->players[playerIndex].alive;
+}
+
+// Check if a ray hits a player hitbox at the given position
+// Uses standing height ~1.7, width ~0.6
+BOOL simCheckPlayerHit(SimVec3 rayOrigin, SimVec3 rayDir, SimVec3 targetPos, float *hitDistance) {
+    // Build AABB for player hitbox centered at targetPos
+    // targetPos is assumed to be at the player's feet/ground level
+    SimVec3 boxMin = simVec3(targetPos.x - PLAYER_HITBOX_HALF_WIDTH,
+                             targetPos.y,  // Bottom at feet
+                             targetPos.z - PLAYER_HITBOX_HALF_WIDTH);
+    SimVec3 boxMax = simVec3(targetPos.x + PLAYER_HITBOX_HALF_WIDTH,
+                             targetPos.y + PLAYER_HITBOX_HEIGHT,  // Top at head
+                             targetPos.z + PLAYER_HITBOX_HALF_WIDTH);
+
+    RayHitResult result = rayIntersectAABB(rayOrigin, rayDir, boxMin, boxMax);
+
+    if (result.hit && result.t > 0) {
+        if (hitDistance != NULL) {
+            *hitDistance = result.t;
+        }
+        return YES;
+    }
+
+    return NO;
+}
+
+// Damage a bot, crediting the shooter with the kill in single-player
+static void damageEnemy(SimWorld *world, int shooterIndex, int e, int damage) {
+    SimBots bots = simBots(world);
+    bots.health[e] -= damage;
+    if (bots.health[e] <= 0) {
+        bots.alive[e] = NO;
+        bots.respawnTimer[e] = ENEMY_RESPAWN_DELAY;
+        if (!world->isMultiplayer) {
+            world->players[shooterIndex].botKills++;
+        }
+    }
+}
+
+// Damage another player - remote players are reported to their owner, local ones take it here
+static void damagePlayer(SimWorld *world, int shooterIndex, int victimIndex, int damage) {
+    simPushEvent(world, SimEventPlayerHit, shooterIndex, victimIndex, 0, damage, 1.0f);
+    if (world->players[victimIndex].isRemote) return;
+
+    simApplyDamageFromPlayer(world, victimIndex, damage);
+    if (!world->players[victimIndex].alive) {
+        simHandlePlayerKill(world, shooterIndex, victimIndex);
+        simPushEvent(world, SimEventPlayerKill, shooterIndex, victimIndex, 0, 0, 1.0f);
+    }
+}
+
+// Resolve a projectile against entities, given the distance to the nearest environment hit
+static CombatHitResult resolveProjectileHit(SimWorld *world, int shooterIndex, SimVec3 muzzle, SimVec3 dir,
+                                            int damage, float range, float maxDist) {
+    CombatHitResult hitResult = {
+        .type = HitResultNone,
+        .hitEntityId = -1,
+        .hitDistance = range,
+        .hitPoint = simVec3(0, 0, 0)
+    };
+
+    // Check hit against enemies (AI) filed along the shot, up to the environment hit
+    SimBots bots = simBots(world);
+    SpatialHash botGrid = simEntityHash(world, SimEntityBots);
+    SimVec3 shotEnd = simMulAdd(muzzle, dir, maxDist);
+    int nearby[BOT_CANDIDATES_MAX];
+    int found = spatialHashQuerySegment(&botGrid, muzzle.x, muzzle.z, shotEnd.x, shotEnd.z, HITBOX_REACH,
+                                        nearby, BOT_CANDIDATES_MAX);
+    int count = nearbyBotCount(world, found);
+    for (int n = 0; n < count; n++) {
+        int e = nearbyBot(nearby, found, n);
+        if (bots.alive[e]) {
+            // Enemy hitbox dimensions to match rendered model
+            // The enemy model is scaled by 1.4x and rotates to face the player
+            // Model dimensions (scaled): X width ~0.98, Y height ~1.96 (-0.84 to +1.12), Z depth ~0.34
+            // Since enemy rotates to face player, we use a symmetric XZ hitbox that covers all rotations
+            // The gun extends to about 0.84 in the facing direction, so we use 0.6 radius to be generous
+            float hitboxHalfWidth = 0.6f;   // Covers rotated model width (gun + body)
+            float hitboxHalfDepth = 0.6f;   // Same as width since enemy rotates
+            float hitboxBottom = -0.84f;    // Model feet (scaled)
+            float hitboxTop = 1.12f;        // Model head (scaled)
+
+            SimVec3 eMin = simVec3(bots.x[e] - hitboxHalfWidth, bots.y[e] + hitboxBottom,
+                                   bots.z[e] - hitboxHalfDepth);
+            SimVec3 eMax = simVec3(bots.x[e] + hitboxHalfWidth, bots.y[e] + hitboxTop,
+                                   bots.z[e] + hitboxHalfDepth);
+            RayHitResult eHit = rayIntersectAABB(muzzle, dir, eMin, eMax);
+            if (eHit.hit && eHit.t < maxDist) {
+                damageEnemy(world, shooterIndex, e, damage);
+                maxDist = eHit.t;
+
+                hitResult.type = HitResultEnemyAI;
+                hitResult.hitEntityId = e;
+                hitResult.hitDistance = eHit.t;
+                hitResult.hitPoint = simMulAdd(muzzle, dir, eHit.t);
+            }
+        }
+    }
+
+    // Check hit against the other players in multiplayer mode
+    SpatialHash playerGrid = simEntityHash(world, SimEntityPlayers);
+    int players[SIM_MAX_PLAYERS];
+    int nearbyPlayers = spatialHashQuerySegment(&playerGrid, muzzle.x, muzzle.z, shotEnd.x, shotEnd.z,
+                                                HITBOX_REACH, players, SIM_MAX_PLAYERS);
+    for (int n = 0; n < nearbyPlayers; n++) {
+        int p = players[n];
+        if (!isPlayerTarget(world, shooterIndex, p)) continue;
+
+        // Player position is at eye level, convert to feet level for hitbox
+        SimVec3 eye = world->players[p].position;
+        SimVec3 feet = simVec3(eye.x, eye.y - PLAYER_HEIGHT, eye.z);
+
+        float playerHitDist = 0;
+        if (simCheckPlayerHit(muzzle, dir, feet, &playerHitDist)) {
+            if (playerHitDist < maxDist) {
+                maxDist = playerHitDist;
+                hitResult.type = HitResultRemotePlayer;
+                hitResult.hitEntityId = p;
+                hitResult.hitDistance = playerHitDist;
+                hitResult.hitPoint = simMulAdd(muzzle, dir, playerHitDist);
+            }
+        }
+    }
+
+    return hitResult;
+}
+
+// Process a single projectile hit with given damage and range
+CombatHitResult simProcessProjectileHit(SimWorld *world, int shooterIndex,
+                                        SimVec3 muzzle, SimVec3 dir, int damage, float range) {
+    float maxDist = checkEnvironmentHit(world, muzzle, dir, range);
+    return resolveProjectileHit(world, shooterIndex, muzzle, dir, damage, range, maxDist);
+}
+
+// Apply splash damage at a point (for rocket launcher)
+void simApplySplashDamage(SimWorld *world, int shooterIndex, SimVec3 hitPoint, float radius, int damage) {
+    // Check enemies in splash radius
+    SimBots bots = simBots(world);
+    SpatialHash botGrid = simEntityHash(world, SimEntityBots);
+    int nearby[BOT_CANDIDATES_MAX];
+    int found = spatialHashQueryRadius(&botGrid, hitPoint.x, hitPoint.z, radius, nearby, BOT_CANDIDATES_MAX);
+    int count = nearbyBotCount(world, found);
+    for (int n = 0; n < count; n++) {
+        int e = nearbyBot(nearby, found, n);
+        if (bots.alive[e]) {
+            // Use enemy center of mass for splash damage calculation
+            // The enemy model's vertical center is approximately 0.14 above enemyY (scaled model)
+            SimVec3 enemyPos = simVec3(bots.x[e], bots.y[e] + 0.14f, bots.z[e]);
+            float dist = simDistance(hitPoint, enemyPos);
+            if (dist < radius) {
+                // Damage falls off with distance
+                float falloff = 1.0f - (dist / radius);
+                int splashDmg = (int)(damage * falloff);
+                damageEnemy(world, shooterIndex, e, splashDmg);
+            }
+        }
+    }
+
+    // Check the other players in splash radius (multiplayer)
+    SpatialHash playerGrid = simEntityHash(world, SimEntityPlayers);
+    int players[SIM_MAX_PLAYERS];
+    int nearbyPlayers = spatialHashQueryRadius(&playerGrid, hitPoint.x, hitPoint.z, radius, players, SIM_MAX_PLAYERS);
+    for (int n = 0; n < nearbyPlayers; n++) {
+        int p = players[n];
+        if (!isPlayerTarget(world, shooterIndex, p)) continue;
+
+        // Use center of body for splash calculations (eye level - half height)
+        SimVec3 eye = world->players[p].position;
+        SimVec3 center = simVec3(eye.x, eye.y - PLAYER_HEIGHT * 0.5f, eye.z);
+        float dist = simDistance(hitPoint, center);
+        if (dist < radius) {
+            float falloff = 1.0f - (dist / radius);
+            int splashDmg = (int)(damage * falloff);
+            if (splashDmg > 0) {
+                damagePlayer(world, shooterIndex, p, splashDmg);
+            }
+        }
+    }
+}
+
+CombatHitResult simProcessPlayerShooting(SimWorld *world, int playerIndex) {
+    SimPlayer *player = &world->players[playerIndex];
+
+    // Initialize result
+    CombatHitResult hitResult = {
+        .type = HitResultNone,
+        .hitEntityId = -1,
+        .hitDistance = FAR_PLANE,
+        .hitPoint = simVec3(0, 0, 0)
+    };
+
+    // Calculate shooting direction using camera basis
+    SimCameraBasis shootBasis = simCameraBasis(player->yaw, player->pitch);
+    SimVec3 baseDir = shootBasis.forward;
+
+    // Calculate muzzle position
+    float gunOffsetX = 0.15f;
+    float gunOffsetY = -0.12f;
+    float gunOffsetZ = 0.3f + 0.25f;
+    SimVec3 muzzle = simMulAdd(simMulAdd(simMulAdd(player->position, shootBasis.right, gunOffsetX),
+                                         shootBasis.up, gunOffsetY),
+                               shootBasis.forward, gunOffsetZ);
+
+    // Try to fire the current weapon
+    SpreadDirections spread;
+    if (!weaponFire(&player->weapons, &player->rng, baseDir, &spread)) {
+        // Weapon couldn't fire (reloading, no ammo, etc.)
+        return hitResult;
+    }
+
+    // Show muzzle flash
+    player->muzzleFlashTimer = 2;
+    player->shooting = YES;
+    simPushEvent(world, SimEventGunshot, playerIndex, -1, player->weapons.currentWeapon, 0, 1.0f);
+
+    // Get current weapon stats
+    WeaponStats stats = weaponStats(player->weapons.currentWeapon);
+
+    // Trace all projectiles against the environment in one batch (shotgun pellets)
+    SimVec3 muzzles[MAX_SPREAD_DIRECTIONS];
+    RaycastResult worldHits[MAX_SPREAD_DIRECTIONS];
+    for (int i = 0; i < spread.count; i++) {
+        muzzles[i] = muzzle;
+    }
+    simCollisionRaycastBatch(world->collision, muzzles, spread.directions, spread.count,
+                             stats.range, CollisionLayerWorld, worldHits);
+
+    // Process each projectile
+    for (int i = 0; i < spread.count; i++) {
+        SimVec3 dir = spread.directions[i];
+
+        float envDist = environmentHitDistance(worldHits[i], stats.range);
+        CombatHitResult projHit = resolveProjectileHit(world, playerIndex, muzzle, dir,
+                                                       stats.damage, stats.range, envDist);
+
+        // Track the closest/most important hit
+        if (projHit.type != HitResultNone) {
+            // Prefer player hits, then enemy hits
+            if (hitResult.type == HitResultNone ||
+                (projHit.type == HitResultRemotePlayer && hitResult.type != HitResultRemotePlayer) ||
+                projHit.hitDistance < hitResult.hitDistance) {
+                hitResult = projHit;
+            }
+        }
+
+        // Handle splash damage for rocket launcher
+        if (stats.splashRadius > 0 && projHit.hitDistance < stats.range) {
+            SimVec3 splashPoint = simMulAdd(muzzle, dir, projHit.hitDistance);
+            simApplySplashDamage(world, playerIndex, splashPoint, stats.splashRadius, stats.splashDamage);
+        }
+    }
+
+    // A direct hit on a player does fixed PvP damage, once per shot
+    if (world->isMultiplayer && hitResult.type == HitResultRemotePlayer) {
+        damagePlayer(world, playerIndex, hitResult.hitEntityId, PVP_DAMAGE);
+    }
+
+    return hitResult;
+}
+
+void simUpdateHealthRegeneration(SimWorld *world, int playerIndex) {
+    SimPlayer *player = &world->players[playerIndex];
+
+    if (!player->alive || world->gameWon || player->health >= PLAYER_MAX_HEALTH) return;
+
+    player->damageCooldownTimer++;
+    if (player->damageCooldownTimer >= PLAYER_REGEN_DELAY) {
+        player->regenTickTimer++;
+        if (player->regenTickTimer >= PLAYER_REGEN_RATE) {
+            player->regenTickTimer = 0;
+            player->health++;
+            if (player->bloodLevel > 0) {
+                player->bloodLevel -= 0.02f;
+                if (player->bloodLevel < 0) player->bloodLevel = 0;
+            }
+        }
+    }
+}
+
+void simUpdateCombatTimers(SimWorld *world) {
+    if (world->enemyMuzzleFlashTimer > 0) world->enemyMuzzleFlashTimer--;
+
+    for (int p = 0; p < world->playerCount; p++) {
+        SimPlayer *player = &world->players[p];
+        if (player->isRemote) continue;
+
+        if (player->muzzleFlashTimer > 0) player->muzzleFlashTimer--;
+        if (player->bloodFlashTimer > 0) player->bloodFlashTimer--;
+        if (player->spawnProtectionTimer > 0) player->spawnProtectionTimer--;
+
+        // Weapon timers (fire rate, reload)
+        weaponUpdate(&player->weapons);
+    }
+}
+
+int simAbsorbDamageWithArmor(SimWorld *world, int playerIndex, int damage) {
+    SimPlayer *player = &world->players[playerIndex];
+    if (player->armor <= 0) {
+        return damage;
+    }
+
+    // Armor absorbs half the damage
+    int armorDamage = damage / 2;
+    int healthDamage = damage - armorDamage;
+
+    // Reduce armor
+    player->armor -= armorDamage;
+    if (player->armor < 0) {
+        // Overflow damage goes to health
+        healthDamage -= player->armor;  // armor is negative
+        player->armor = 0;
+    }
+    return healthDamage;
+}
+
+// Apply damage when hit by another player
+void simApplyDamageFromPlayer(SimWorld *world, int victimIndex, int damage) {
+    SimPlayer *player = &world->players[victimIndex];
+
+    if (!player->alive || world->gameWon) return;
+
+    // Check spawn protection - reduce damage by 90% if protected
+    if (player->spawnProtectionTimer > 0) {
+        damage = damage / 10;  // 90% damage reduction during spawn protection
+        if (damage < 1) return;  // No damage if reduced to 0
+    }
+
+    // Apply armor damage reduction (50% reduction when armor > 0), then damage health
+    player->health -= simAbsorbDamageWithArmor(world, victimIndex, damage);
+
+    // Reset regeneration timer
+    player->damageCooldownTimer = 0;
+    player->regenTickTimer = 0;
+
+    // Visual feedback
+    player->bloodFlashTimer = 10;
+    player->bloodLevel += 0.15f;
+    if (player->bloodLevel > 1.0f) player->bloodLevel = 1.0f;
+
+    // Check for death
+    if (player->health <= 0) {
+        player->health = 0;
+        player->alive = NO;
+    }
+}
+
+// Handle a player kill event (for stats tracking, UI updates, etc.)
+void simHandlePlayerKill(SimWorld *world, int killerIndex, int victimIndex) {
+    // Update kill stats for whoever got the kill
+    if (killerIndex >= 0 && killerIndex < world->playerCount) {
+        world->players[killerIndex].kills++;
+    }
+
+    // Victim waits out the respawn timer
+    if (victimIndex >= 0 && victimIndex < world->playerCount) {
+        world->players[victimIndex].alive = NO;
+        world->players[victimIndex].respawnTimer = RESPAWN_DELAY;
+    }
+
+    // Check win condition after kill
+    simCheckWinCondition(world);
+}
+
+// Respawn a player after death
+void simRevivePlayer(SimWorld *world, int playerIndex) {
+    SimPlayer *player = &world->players[playerIndex];
+
+    player->health = PLAYER_MAX_HEALTH;
+    player->alive = YES;
+    player->bloodLevel = 0;
+    player->bloodFlashTimer = 0;
+    player->damageCooldownTimer = 0;
+    player->regenTickTimer = 0;
+    player->respawnTimer = 0;
+    player->spawnProtectionTimer = SPAWN_PROTECTION_TIME;  // 3 seconds of spawn protection
+
+    // Position reset is handled by the caller via simRespawnPlayer
+}
@@ -0,0 +1,67 @@
+// SimCombat.h - Player shooting and damage (with multiplayer PvP support), portable C
+#ifndef SIMCOMBAT_H
+#define SIMCOMBAT_H
+
+#include "SimTypes.h"
+#include "GameConfig.h"
+
+// Hit result types for simProcessPlayerShooting
+typedef enum {
+    HitResultNone = 0,      // Hit nothing (or environment)
+    HitResultEnemyAI,       // Hit an enemy AI
+    HitResultRemotePlayer   // Hit another player (multiplayer)
+} HitResultType;
+
+// Extended hit result with details
+typedef struct {
+    HitResultType type;
+    int hitEntityId;        // Enemy index or player index
+    float hitDistance;
+    SimVec3 hitPoint;
+} CombatHitResult;
+
+// Player hitbox dimensions for PvP
+static const float PLAYER_HITBOX_HEIGHT = 2.2f;   // Standing height (extra for head)
+static const float PLAYER_HITBOX_WIDTH = 1.2f;    // Width/depth (wider for easier hits)
+static const float PLAYER_HITBOX_HALF_WIDTH = 0.6f;
+static const float PLAYER_HITBOX_HALF_HEIGHT = 0.85f;
+
+// PvP damage constants
+static const int PVP_DAMAGE = 25;  // 4 hits to kill from 100 HP
+
+// Fire the player's current weapon from their eye position and facing - returns the best hit.
+// In multiplayer, also checks for PvP hits: a direct hit does PVP_DAMAGE. Hits on remote
+// players are reported as SimEventPlayerHit rather than applied.
+CombatHitResult simProcessPlayerShooting(SimWorld *world, int playerIndex);
+
+// Process a single projectile hit (for weapons with spread)
+// Returns hit result for the projectile direction
+CombatHitResult simProcessProjectileHit(SimWorld *world, int shooterIndex,
+                                        SimVec3 muzzle, SimVec3 dir, int damage, float range);
+
+// Apply splash damage at a point (for rocket launcher)
+void simApplySplashDamage(SimWorld *world, int shooterIndex, SimVec3 hitPoint, float radius, int damage);
+
+// Check if a ray hits a player hitbox standing at targetPos (feet level)
+// Returns YES if shot hit the player, sets hitDistance
+BOOL simCheckPlayerHit(SimVec3 rayOrigin, SimVec3 rayDir, SimVec3 targetPos, float *hitDistance);
+
+// Armor absorbs half of the damage - returns what is left for the player's health
+int simAbsorbDamageWithArmor(SimWorld *world, int playerIndex, int damage);
+
+// Apply damage from another player's hit (spawn protection, armor, death)
+void simApplyDamageFromPlayer(SimWorld *world, int victimIndex, int damage);
+
+// Update player health regeneration
+void simUpdateHealthRegeneration(SimWorld *world, int playerIndex);
+
+// Update muzzle flash, blood, spawn protection and weapon timers
+void simUpdateCombatTimers(SimWorld *world);
+
+// Kill/death handling for multiplayer (player indices, -1 for none)
+void simHandlePlayerKill(SimWorld *world, int killerIndex, int victimIndex);
+
+// Bring a dead player back with full health (position is set by simRespawnPlayer)
+void simRevivePlayer(SimWorld *world, int playerIndex);
+
+#endif // SIMCOMBAT_H
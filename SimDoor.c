@@ -0,0 +1,59 @@
+// SimDoor.c - Door AABB and animation implementation
+#include "SimWorld.h"
+#include <math.h>
+
+void simGetDoorAABB(const SimWorld *world, SimVec3 *outMin, SimVec3 *outMax) {
+    float doorAngle = world->doorAngle;
+
+    float hingeX = HOUSE_X - DOOR_WIDTH / 2.0f;
+    float hingeZ = HOUSE_Z + HOUSE_DEPTH / 2.0f;
+    float fy = FLOOR_Y;
+
+    if (doorAngle < 45.0f) {
+        // Closed position - door in doorframe
+        *outMin = simVec3(hingeX, fy, hingeZ);
+        *outMax = simVec3(hingeX + DOOR_WIDTH, fy + DOOR_HEIGHT, hingeZ + DOOR_THICK);
+    } else {
+        // Open position - door swung out perpendicular
+        *outMin = simVec3(hingeX - DOOR_THICK, fy, hingeZ);
+        *outMax = simVec3(hingeX, fy + DOOR_HEIGHT, hingeZ + DOOR_WIDTH);
+    }
+}
+
+void simUpdateDoor(SimWorld *world) {
+    if (world->doorOpen && world->doorAngle < 90.0f) {
+        world->doorAngle += 4.0f;
+        if (world->doorAngle > 90.0f) world->doorAngle = 90.0f;
+    } else if (!world->doorOpen && world->doorAngle > 0.0f) {
+        world->doorAngle -= 4.0f;
+        if (world->doorAngle < 0.0f) world->doorAngle = 0.0f;
+    }
+
+    simSyncDoorCollision(world);
+}
+
+void simSyncDoorCollision(SimWorld *world) {
+    SimVec3 doorMin, doorMax;
+    simGetDoorAABB(world, &doorMin, &doorMax);
+
+    if (simCollisionGetShape(world->collision, world->doorShapeId) == NULL) {
+        world->doorShapeId = simCollisionAddDynamicBox(world->collision,
+                                                       doorMin.x, doorMin.y, doorMin.z,
+                                                       doorMax.x, doorMax.y, doorMax.z,
+                                                       CollisionShapeTypeWall, NO, "door");
+        return;
+    }
+
+    simCollisionMoveDynamicShape(world->collision, world->doorShapeId,
+                                 doorMin.x, doorMin.y, doorMin.z,
+                                 doorMax.x, doorMax.y, doorMax.z);
+}
+
+BOOL simPlayerNearDoor(SimVec3 position) {
+    float doorCenterX = HOUSE_X;
+    float doorCenterZ = HOUSE_Z + HOUSE_DEPTH / 2.0f;
+    float dx = position.x - doorCenterX;
+    float dz = position.z - doorCenterZ;
+    float distToDoor = sqrtf(dx * dx + dz * dz);
+    return (distToDoor < 2.5f);
+}
@@ -0,0 +1,20 @@
+// SimDoor.h - Door AABB and animation (portable C)
+#ifndef SIMDOOR_H
+#define SIMDOOR_H
+
+#include "SimTypes.h"
+#include "GameConfig.h"
+
+// Get door AABB based on the world's door angle
+void simGetDoorAABB(const SimWorld *world, SimVec3 *outMin, SimVec3 *outMax);
+
+// Swing the door toward open/closed (also moves the door's collision shape)
+void simUpdateDoor(SimWorld *world);
+
+// Match the door's collision shape to simGetDoorAABB, adding it if missing
+void simSyncDoorCollision(SimWorld *world);
+
+// Check if a position is near the door
+BOOL simPlayerNearDoor(SimVec3 position);
+
+#endif // SIMDOOR_H
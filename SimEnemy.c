@@ -0,0 +1,1473 @@
+// SimEnemy.c - Enemy AI and state implementation
+#include "SimWorld.h"
+#include "SimProfile.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Bot collision body - enemyY is the center, collision works at eye level (top)
+static const float BOT_COLLISION_RADIUS = 0.4f;
+static const float BOT_COLLISION_HEIGHT = 1.2f;
+static const float BOT_EYE_OFFSET = 1.2f / 2.0f;  // BOT_COLLISION_HEIGHT / 2
+
+// Path following: a corner counts as reached this close (horizontally, then vertically),
+// the path is searched again when the goal moves this far, and a corner this much higher
+// than the feet and this close is jumped up to
+static const float PATH_CORNER_REACH = 0.5f;
+static const float PATH_CORNER_HEIGHT = 0.6f;
+static const float PATH_REPLAN_DISTANCE = 1.5f;
+static const float PATH_JUMP_RISE = 0.3f;
+static const float PATH_JUMP_REACH = 1.0f;
+
+// A player's flow field is pointed at them again once they get this far from its goal
+static const float PURSUIT_GOAL_SLACK = 2.0f;
+
+// Level of detail: a bot that isn't after anyone thinks every tick this close to its target,
+// every BOT_LOD_MID_INTERVAL ticks within engagement distance and every BOT_LOD_FAR_INTERVAL
+// beyond it (a patrolling bot covers well under a path corner's reach in that time)
+static const float BOT_LOD_NEAR_DISTANCE = 10.0f;
+enum { BOT_LOD_MID_INTERVAL = 2, BOT_LOD_FAR_INTERVAL = 4 };
+
+// Cover is looked for this far from the bot
+static const float COVER_SEARCH_RADIUS = 20.0f;
+
+// Line-of-sight checks traced per batch, and bot slots per chunk of the look job
+enum { SIGHT_BATCH = 32 };
+
+enum {
+    PATH_REPLAN_FRAMES = 15,    // Frames between searches for a moving goal
+    PATH_RETRY_FRAMES = 60,     // Frames before searching again after finding no path
+    PATH_PROGRESS_FRAMES = 180, // Frames without reaching a corner before searching again
+};
+
+// Forward declarations for internal functions
+static void updateBotBehavior(SimWorld *world, int e, SimVec3 camPos, float distToPlayer, int frames);
+static void executeBotMovement(SimWorld *world, int e, int target, SimVec3 camPos, int frames);
+static SimVec3 getWaypointPosition(int index);
+static SimVec3 getCoverPosition(SimWorld *world, int index, SimVec3 fallback);
+static void prepareBotPhysics(SimWorld *world, int e);
+static void applyBotKinematics(SimWorld *world, int e, const KinematicResult *body, SimVec3 threat);
+static BOOL canSeePlayer(SimWorld *world, int e, SimVec3 camPos);
+
+// Check if a position is inside any spawn protection zone
+static BOOL isInSpawnZone(const SimWorld *world, float x, float z) {
+    for (int i = 0; i < NUM_SPAWN_POINTS; i++) {
+        float dx = x - world->spawnPoints[i].x;
+        float dz = z - world->spawnPoints[i].z;
+        float dist = sqrtf(dx * dx + dz * dz);
+        if (dist < SPAWN_PROTECTION_RADIUS) {
+            return YES;
+        }
+    }
+    return NO;
+}
+
+// Get direction to move away from nearest spawn zone
+static SimVec3 getSpawnZoneAvoidanceDirection(const SimWorld *world, float x, float z) {
+    float nearestDist = 999999.0f;
+    int nearestSpawn = 0;
+
+    for (int i = 0; i < NUM_SPAWN_POINTS; i++) {
+        float dx = x - world->spawnPoints[i].x;
+        float dz = z - world->spawnPoints[i].z;
+        float dist = sqrtf(dx * dx + dz * dz);
+        if (dist < nearestDist) {
+            nearestDist = dist;
+            nearestSpawn = i;
+        }
+    }
+
+    // Direction away from nearest spawn point
+    float dx = x - world->spawnPoints[nearestSpawn].x;
+    float dz = z - world->spawnPoints[nearestSpawn].z;
+    float len = sqrtf(dx * dx + dz * dz);
+    if (len > 0.1f) {
+        return simVec3(dx / len, 0, dz / len);
+    }
+    return simVec3(1, 0, 0);  // Default direction
+}
+
+// Move enemy away from spawn zone if too close
+void simEnforceSpawnZoneExclusion(SimWorld *world, int e) {
+    SimBots bots = simBots(world);
+    if (isInSpawnZone(world, bots.x[e], bots.z[e])) {
+        SimVec3 avoidDir = getSpawnZoneAvoidanceDirection(world, bots.x[e], bots.z[e]);
+        // Push enemy out of spawn zone
+        bots.x[e] += avoidDir.x * 0.15f;
+        bots.z[e] += avoidDir.z * 0.15f;
+    }
+}
+
+// ============================================
+// BOT STORAGE
+// ============================================
+
+// Arrays start 16-byte aligned, one after another, in the order of SimBots
+static size_t alignArray(size_t offset) {
+    return (offset + 15) & ~(size_t)15;
+}
+
+// Grid cell size for each kind of entity, about the distance it is searched over
+static const float ENTITY_CELL_SIZE[SimEntityKindCount] = {
+    4.0f,   // Players
+    2.5f,   // Bots - shots and splash
+    4.0f,   // Pickups - collection radius
+};
+
+// Copies of a grid go into the world's bytes, so padding would be whatever was on the stack
+_Static_assert(sizeof(SimEntityGrid) == sizeof(size_t) + sizeof(float) + 3 * sizeof(int),
+               "SimEntityGrid must have no padding bytes");
+
+// A kind's grid over the arena, before it is placed in the block
+
+static SimEntityGrid entityGridShape(SimEntityKind kind, int capacity) {
+    SimEntityGrid grid = {0};
+    grid.cellSize = ENTITY_CELL_SIZE[kind];
+    grid.size = (int)ceilf(2.0f * ARENA_SIZE / grid.cellSize);
+    switch (kind) {
+        case SimEntityPlayers:      grid.entryCount = SIM_MAX_PLAYERS; break;
+        case SimEntityBots:         grid.entryCount = capacity; break;
+        default:                    grid.entryCount = MAX_PICKUPS; break;
+    }
+    return grid;
+}
+
+// Lay out the bot arrays after the SimWorld struct. Returns the offset after them; with a
+// world, also points bots at its arrays.
+static size_t layoutBots(SimWorld *world, int capacity, SimBots *bots) {
+    unsigned char *base = (unsigned char *)world;
+    size_t n = (size_t)capacity;
+    size_t offset = sizeof(SimWorld);
+
+#define BOT_ARRAY(field, type) \
+    offset = alignArray(offset); \
+    if (bots) bots->field = (type *)(base + offset); \
+    offset += sizeof(type) * n;
+
+    BOT_ARRAY(spawned, BOOL)
+    BOT_ARRAY(alive, BOOL)
+    BOT_ARRAY(health, int)
+    BOT_ARRAY(x, float)
+    BOT_ARRAY(y, float)
+    BOT_ARRAY(z, float)
+    BOT_ARRAY(velocityX, float)
+    BOT_ARRAY(velocityY, float)
+    BOT_ARRAY(velocityZ, float)
+    BOT_ARRAY(fireTimer, int)
+    BOT_ARRAY(respawnTimer, int)
+    BOT_ARRAY(target, int)
+    BOT_ARRAY(targetDist, float)
+    BOT_ARRAY(nextFree, int)
+    BOT_ARRAY(ai, BotAIState)
+
+#undef BOT_ARRAY
+
+    return alignArray(offset);
+}
+
+// Lay out one grid's arrays from grid->offset. Returns the offset after them; with a world,
+// also points hash at its arrays.
+static size_t layoutEntityHash(SimWorld *world, const SimEntityGrid *grid, SpatialHash *hash) {
+    unsigned char *base = (unsigned char *)world;
+    size_t offset = grid->offset;
+    size_t cells = (size_t)grid->size * (size_t)grid->size;
+    size_t entries = (size_t)grid->entryCount;
+
+#define HASH_ARRAY(field, type, count) \
+    offset = alignArray(offset); \
+    if (world) hash->field = (type *)(base + offset); \
+    offset += sizeof(type) * (count);
+
+    HASH_ARRAY(cellHead, int, cells)
+    HASH_ARRAY(entryCell, int, entries)
+    HASH_ARRAY(entryNext, int, entries)
+    HASH_ARRAY(entryPrev, int, entries)
+    HASH_ARRAY(entryX, float, entries)
+    HASH_ARRAY(entryZ, float, entries)
+
+#undef HASH_ARRAY
+
+    return alignArray(offset);
+}
+
+// The grids follow the bot arrays, one kind after another. Returns the bytes for the whole
+// world; with a world, also records each grid in it.
+static size_t layoutEntityHashes(SimWorld *world, int capacity) {
+    size_t offset = layoutBots(NULL, capacity, NULL);
+    for (int kind = 0; kind < SimEntityKindCount; kind++) {
+        SimEntityGrid grid = entityGridShape((SimEntityKind)kind, capacity);
+        grid.offset = offset;
+        if (world) world->entityGrids[kind] = grid;
+        offset = layoutEntityHash(NULL, &grid, NULL);
+    }
+    return offset;
+}
+
+size_t simWorldSizeForBots(int capacity) {
+    return layoutEntityHashes(NULL, capacity);
+}
+
+SimBots simBots(SimWorld *world) {
+    SimBots bots;
+    bots.capacity = world->botPool.capacity;
+    bots.count = world->botPool.count;
+    layoutBots(world, bots.capacity, &bots);
+    return bots;
+}
+
+void simInitEntityHashes(SimWorld *world) {
+    layoutEntityHashes(world, world->botPool.capacity);
+    for (int kind = 0; kind < SimEntityKindCount; kind++) {
+        SpatialHash hash = simEntityHash(world, (SimEntityKind)kind);
+        spatialHashClear(&hash);
+    }
+}
+
+SpatialHash simEntityHash(SimWorld *world, SimEntityKind kind) {
+    const SimEntityGrid *grid = &world->entityGrids[kind];
+    SpatialHash hash;
+    hash.minX = -ARENA_SIZE;
+    hash.minZ = -ARENA_SIZE;
+    hash.cellSize = grid->cellSize;
+    hash.sizeX = grid->size;
+    hash.sizeZ = grid->size;
+    hash.cellCount = grid->size * grid->size;
+    hash.entryCount = grid->entryCount;
+    layoutEntityHash(world, grid, &hash);
+    return hash;
+}
+
+// Back to life - no path, no steering, and the first think staggered over the longest interval
+static void resetBotMotion(BotAIState *ai, int e) {
+    memset(&ai->path, 0, sizeof(ai->path));
+    ai->steer = simVec3(0, 0, 0);
+    ai->thinkTimer = e % BOT_LOD_FAR_INTERVAL;
+    ai->sinceThink = 0;
+    ai->look.valid = NO;
+}
+
+// Stats from difficulty, patrolling, nothing spotted, standing still
+static void initBotAI(SimBots *bots, int e) {
+    BotAIState *ai = &bots->ai[e];
+    int difficulty = ai->difficulty;
+
+    // Set stats based on difficulty
+    ai->stats.moveSpeed = BOT_MOVE_SPEED[difficulty];
+    ai->stats.accuracy = BOT_ACCURACY[difficulty];
+    ai->stats.reactionTime = BOT_REACTION_TIME[difficulty];
+    ai->stats.aggression = BOT_AGGRESSION[difficulty];
+
+    // Initialize state
+    ai->behavior = BotBehaviorPatrol;
+    ai->currentWaypoint = e % NUM_WAYPOINTS;  // Start at different waypoints
+    ai->reactionTimer = 0;
+    ai->playerSpotted = NO;
+    bots->velocityX[e] = 0.0f;
+    bots->velocityY[e] = 0.0f;
+    bots->velocityZ[e] = 0.0f;
+    ai->jumpCooldown = 0;
+    ai->strafeAngle = ((float)(e % NUM_ENEMIES) / NUM_ENEMIES) * 2.0f * M_PI;
+    ai->strafeDirection = (e % 2 == 0) ? 1 : -1;
+    ai->coverTarget = -1;
+    ai->onGround = YES;
+
+    // Initialize new rebalanced AI fields
+    ai->spottingTimer = 0;
+    ai->canShoot = NO;
+    ai->loseSightTimer = 0;
+
+    // Wall collision avoidance
+    ai->wallHitCount = 0;
+    ai->wallHitCooldown = 0;
+
+    // Level of detail - first thinks staggered over the longest interval
+    ai->thinkInterval = 1;
+    ai->thinking = NO;
+    resetBotMotion(ai, e);
+}
+
+// Staggered activation: only the first few bots are active at the start, each one after
+// that activates BOT_ACTIVATION_INTERVAL after the previous
+static int rosterActivationDelay(int e) {
+    if (e < BOT_INITIAL_ACTIVE_COUNT) return 0;
+    return (e - BOT_INITIAL_ACTIVE_COUNT + 1) * BOT_ACTIVATION_INTERVAL;
+}
+
+static void setActivationDelay(BotAIState *ai, int activationDelay) {
+    ai->isActive = activationDelay <= 0;
+    ai->activationTimer = activationDelay > 0 ? activationDelay : 0;
+}
+
+int simSpawnBot(SimWorld *world, SimVec3 position, int difficulty, int activationDelay) {
+    SimBotPool *pool = &world->botPool;
+    SimBots bots = simBots(world);
+
+    // Reuse a freed slot before growing into new ones
+    int e;
+    if (pool->freeHead >= 0) {
+        e = pool->freeHead;
+        pool->freeHead = bots.nextFree[e];
+    } else if (pool->count < pool->capacity) {
+        e = pool->count++;
+    } else {
+        return -1;
+    }
+    pool->spawnedCount++;
+
+    if (difficulty < 0) difficulty = 0;
+    if (difficulty > 2) difficulty = 2;
+
+    bots.spawned[e] = YES;
+    bots.alive[e] = YES;
+    bots.health[e] = ENEMY_MAX_HEALTH;
+    bots.x[e] = position.x;
+    bots.y[e] = position.y;
+    bots.z[e] = position.z;
+    bots.fireTimer[e] = 0;
+    bots.respawnTimer[e] = 0;
+    bots.target[e] = -1;
+    bots.targetDist[e] = 0.0f;
+    bots.nextFree[e] = -1;
+
+    SpatialHash grid = simEntityHash(world, SimEntityBots);
+    spatialHashMove(&grid, e, position.x, position.z);
+
+    BotAIState *ai = &bots.ai[e];
+    memset(ai, 0, sizeof(*ai));
+    ai->difficulty = difficulty;
+    ai->home = position;
+    simRngSeed(&ai->rng, world->seed, simRngStreamId(SimRngStreamBot, (uint32_t)e));
+    initBotAI(&bots, e);
+    setActivationDelay(ai, activationDelay);
+    return e;
+}
+
+void simDespawnBot(SimWorld *world, int e) {
+    SimBotPool *pool = &world->botPool;
+    SimBots bots = simBots(world);
+    if (e < 0 || e >= bots.count || !bots.spawned[e]) return;
+
+    bots.spawned[e] = NO;
+    bots.alive[e] = NO;
+    bots.health[e] = 0;
+    bots.respawnTimer[e] = 0;
+    bots.nextFree[e] = pool->freeHead;
+    pool->freeHead = e;
+    pool->spawnedCount--;
+
+    SpatialHash grid = simEntityHash(world, SimEntityBots);
+    spatialHashRemove(&grid, e);
+
+    if (world->lastFiringEnemy == e) {
+        world->lastFiringEnemy = -1;
+    }
+}
+
+void simClearBots(SimWorld *world) {
+    SimBots bots = simBots(world);
+    for (int e = 0; e < bots.count; e++) {
+        bots.spawned[e] = NO;
+        bots.alive[e] = NO;
+    }
+    world->botPool.count = 0;
+    world->botPool.spawnedCount = 0;
+    world->botPool.freeHead = -1;
+    world->lastFiringEnemy = -1;
+
+    SpatialHash grid = simEntityHash(world, SimEntityBots);
+    spatialHashClear(&grid);
+}
+
+void simSpawnBotRoster(SimWorld *world) {
+    simClearBots(world);
+    for (int e = 0; e < NUM_ENEMIES; e++) {
+        SimVec3 start = simVec3(ENEMY_START_X[e], ENEMY_START_Y[e], ENEMY_START_Z[e]);
+        if (simSpawnBot(world, start, ENEMY_DIFFICULTY[e], rosterActivationDelay(e)) < 0) break;
+    }
+}
+
+void simSpawnBotRing(SimWorld *world) {
+    for (int i = 0; ; i++) {
+        int waypoint = i % NUM_WAYPOINTS;
+        float angle = (float)(i / NUM_WAYPOINTS) * 2.4f;
+        float radius = 0.5f + (float)((i / NUM_WAYPOINTS) % 4);
+        SimVec3 position = simVec3(WAYPOINT_X[waypoint] + cosf(angle) * radius, FLOOR_Y + 0.6f,
+                                   WAYPOINT_Z[waypoint] + sinf(angle) * radius);
+        if (simSpawnBot(world, position, i % 3, 0) < 0) break;
+    }
+}
+
+void simRespawnBots(SimWorld *world) {
+    SimBots bots = simBots(world);
+    SpatialHash grid = simEntityHash(world, SimEntityBots);
+    for (int e = 0; e < bots.count; e++) {
+        if (!bots.spawned[e]) continue;
+        bots.alive[e] = YES;
+        bots.health[e] = ENEMY_MAX_HEALTH;
+        bots.x[e] = bots.ai[e].home.x;
+        bots.y[e] = bots.ai[e].home.y;
+        bots.z[e] = bots.ai[e].home.z;
+        bots.fireTimer[e] = 0;
+        resetBotMotion(&bots.ai[e], e);
+        spatialHashMove(&grid, e, bots.x[e], bots.z[e]);
+    }
+}
+
+// Initialize bot AI for all enemies
+void simInitBotAI(SimWorld *world) {
+    SimBots bots = simBots(world);
+
+    for (int e = 0; e < bots.count; e++) {
+        if (!bots.spawned[e]) continue;
+        initBotAI(&bots, e);
+        setActivationDelay(&bots.ai[e], rosterActivationDelay(e));
+    }
+}
+
+BOOL simEnemyLineOfSight(SimWorld *world, SimVec3 eMuzzle, SimVec3 eDir, float maxEnemyDist) {
+    SimVec3 target = simMulAdd(eMuzzle, eDir, maxEnemyDist);
+    return simCollisionLineOfSight(world->collision, eMuzzle, target);
+}
+
+// Check if path is clear for movement
+BOOL simPathClear(SimWorld *world, SimVec3 start, SimVec3 end) {
+    SimVec3 delta = simSub(end, start);
+    float dist = simLength(delta);
+    if (dist < 0.1f) return YES;
+
+    SimVec3 dir = simVec3(delta.x / dist, delta.y / dist, delta.z / dist);
+    return simEnemyLineOfSight(world, start, dir, dist);
+}
+
+// Get distance to nearest obstacle
+float simObstacleDistance(SimWorld *world, SimVec3 pos, SimVec3 dir) {
+    float maxDist = 100.0f;
+
+    // Arena walls, buildings, towers, containers, sandbags, catwalks
+    RaycastResult hit = simCollisionRaycast(world->collision, pos, dir, maxDist, CollisionLayerWorld);
+    return hit.hit ? hit.distance : maxDist;
+}
+
+// Get waypoint position by index
+static SimVec3 getWaypointPosition(int index) {
+    return simVec3(WAYPOINT_X[index], WAYPOINT_Y[index] + 0.6f, WAYPOINT_Z[index]);
+}
+
+// Cover point by index (body center standing there), or fallback when there's no such point
+static SimVec3 getCoverPosition(SimWorld *world, int index, SimVec3 fallback) {
+    SimVec3 feet;
+    if (!simCollisionCoverPoint(world->collision, index, &feet)) return fallback;
+    return simVec3(feet.x, feet.y + BOT_EYE_OFFSET, feet.z);
+}
+
+int simFindNearestCover(SimWorld *world, SimVec3 pos, SimVec3 threatPos, int exclude) {
+    return simCollisionFindCover(world->collision, pos, threatPos, COVER_SEARCH_RADIUS, exclude);
+}
+
+static float horizontalDistance(SimVec3 a, SimVec3 b) {
+    float dx = a.x - b.x;
+    float dz = a.z - b.z;
+    return sqrtf(dx * dx + dz * dz);
+}
+
+// Unit XZ direction from feet to point, and whether point is a climb close enough to jump up to
+static void steerToward(SimVec3 feet, SimVec3 point, SimVec3 *outDir, BOOL *outJump) {
+    SimVec3 dir = simVec3(point.x - feet.x, 0, point.z - feet.z);
+    float len = simLength(dir);
+    *outDir = len > 0.01f ? simVec3(dir.x / len, 0, dir.z / len) : simVec3(0, 0, 0);
+    *outJump = point.y - feet.y > PATH_JUMP_RISE && len < PATH_JUMP_REACH;
+}
+
+BOOL simFollowPath(SimCollision *collision, SimPathFollower *path, SimVec3 feet, SimVec3 goal,
+                   const SimNavCircle *avoid, int avoidCount, BOOL avoidDynamic,
+                   SimVec3 *outDir, BOOL *outJump) {
+    *outJump = NO;
+    if (path->replanTimer > 0) path->replanTimer--;
+
+    BOOL stale = path->next >= path->count ||
+                 simDistance(goal, path->goal) > PATH_REPLAN_DISTANCE ||
+                 path->progressTimer >= PATH_PROGRESS_FRAMES;
+    if (stale && path->replanTimer == 0) {
+        int count = simCollisionFindPath(collision, feet, goal, avoid, avoidCount, avoidDynamic,
+                                         path->points, SIM_NAV_MAX_PATH_POINTS);
+        path->count = count > 0 ? count : 0;
+        path->next = 0;
+        path->goal = goal;
+        path->progressTimer = 0;
+        path->replanTimer = count < 0 ? PATH_RETRY_FRAMES : PATH_REPLAN_FRAMES;
+    }
+
+    // Skip the corners already reached
+    while (path->next < path->count) {
+        SimVec3 corner = path->points[path->next];
+        if (horizontalDistance(feet, corner) > PATH_CORNER_REACH ||
+            fabsf(feet.y - corner.y) > PATH_CORNER_HEIGHT) {
+            break;
+        }
+        path->next++;
+        path->progressTimer = 0;
+    }
+    if (path->next >= path->count) return NO;
+    path->progressTimer++;
+
+    steerToward(feet, path->points[path->next], outDir, outJump);
+    return YES;
+}
+
+// Direction along the flow field toward players[target] (simCollisionFlowTarget)
+static BOOL flowDirection(SimWorld *world, int target, SimVec3 feet, SimVec3 *outDir, BOOL *outJump) {
+    SimVec3 point;
+    if (!simCollisionFlowTarget(world->collision, target, feet, &point)) return NO;
+    steerToward(feet, point, outDir, outJump);
+    return YES;
+}
+
+// Leave a line-of-sight check for traceSights to trace this tick
+static void queueSight(SimWorld *world, SimSightCache *sight, SimVec3 from, SimVec3 to) {
+    sight->asked = YES;
+    sight->from = from;
+    sight->to = to;
+    sight->doorAngle = world->doorAngle;
+    sight->tracedTick = world->tick;
+    sight->pending = YES;
+}
+
+// Ask for line of sight between two points this tick. Answered now from the cache when its
+// last trace still stands for them (see SimBotPerception), otherwise left for traceSights.
+static void askSight(SimWorld *world, SimSightCache *sight, SimVec3 from, SimVec3 to) {
+    SimBotPerception *perception = &world->botPerception;
+    perception->checks++;
+    SIM_PROFILE_COUNT(SimCounterSightChecks, 1);
+    sight->asked = YES;
+    sight->pending = NO;
+
+    // Ends are measured from where it was traced, so small moves can't add up
+    if (sight->valid && sight->doorAngle == world->doorAngle &&
+        world->tick - sight->tracedTick < (unsigned int)perception->maxAge &&
+        simDistance(from, sight->from) <= perception->tolerance &&
+        simDistance(to, sight->to) <= perception->tolerance) {
+        perception->reused++;
+        SIM_PROFILE_COUNT(SimCounterSightReused, 1);
+        return;
+    }
+    queueSight(world, sight, from, to);
+}
+
+// Trace count pending checks in one batch
+static void traceSightBatch(SimWorld *world, SimSightCache **batch, int count) {
+    SimVec3 from[SIGHT_BATCH];
+    SimVec3 to[SIGHT_BATCH];
+    BOOL visible[SIGHT_BATCH];
+    for (int i = 0; i < count; i++) {
+        from[i] = batch[i]->from;
+        to[i] = batch[i]->to;
+    }
+
+    simCollisionLineOfSightBatch(world->collision, from, to, count, visible);
+    for (int i = 0; i < count; i++) {
+        batch[i]->visible = visible[i];
+        batch[i]->valid = YES;
+        batch[i]->pending = NO;
+    }
+}
+
+// Trace the pending looks (or aims) of bot slots [begin, end), SIGHT_BATCH at a time
+static void traceSights(SimWorld *world, BOOL aim, int begin, int end) {
+    SimBots bots = simBots(world);
+    SimSightCache *batch[SIGHT_BATCH];
+    int count = 0;
+
+    for (int e = begin; e < end; e++) {
+        SimSightCache *sight = aim ? &bots.ai[e].aim : &bots.ai[e].look;
+        if (!sight->pending) continue;
+        batch[count++] = sight;
+        if (count == SIGHT_BATCH) {
+            traceSightBatch(world, batch, count);
+            count = 0;
+        }
+    }
+    if (count > 0) traceSightBatch(world, batch, count);
+}
+
+// Check if bot can see the player - the look its think asked for before the bots moved.
+// A bot that only got in range since (pushed out of a spawn zone) checks on its own.
+static BOOL canSeePlayer(SimWorld *world, int e, SimVec3 camPos) {
+    SimBots bots = simBots(world);
+    if (bots.ai[e].look.asked) return bots.ai[e].look.visible;
+
+    SimVec3 botPos = simVec3(bots.x[e], bots.y[e] + 0.5f, bots.z[e]);
+    SimVec3 delta = simSub(camPos, botPos);
+    float dist = simLength(delta);
+
+    if (dist < 0.1f || dist > BOT_DETECTION_RANGE) return NO;
+
+    SimVec3 dir = simVec3(delta.x / dist, delta.y / dist, delta.z / dist);
+    return simEnemyLineOfSight(world, botPos, dir, dist);
+}
+
+void simBotUpdateBehavior(SimWorld *world, BotAIState *ai, float healthFraction, float targetDist,
+                          BOOL canSee, int frames, SimVec3 position, SimVec3 threat) {
+    // Update player spotted state with reaction time
+    if (canSee && !ai->playerSpotted) {
+        ai->reactionTimer += frames;
+        ai->loseSightTimer = 0;  // Reset lose sight timer when we can see player
+        if (ai->reactionTimer >= ai->stats.reactionTime) {
+            ai->playerSpotted = YES;
+        }
+    } else if (!canSee) {
+        // Lose track of player after losing sight for 3 seconds
+        if (ai->playerSpotted) {
+            ai->loseSightTimer += frames;
+            if (ai->loseSightTimer >= BOT_LOSE_SIGHT_TIMEOUT) {
+                // Break off pursuit after 3 seconds of no sight
+                ai->playerSpotted = NO;
+                ai->reactionTimer = 0;
+                ai->spottingTimer = 0;
+                ai->canShoot = NO;
+            }
+        } else {
+            // Not spotted yet, decay reaction timer
+            if (ai->reactionTimer > 0) {
+                ai->reactionTimer -= 2 * frames;  // Forget faster than notice
+            }
+        }
+    }
+
+    // Update spotting timer for shoot delay (bot must see player for 30+ frames before shooting)
+    if (canSee && ai->playerSpotted) {
+        ai->spottingTimer += frames;
+        if (ai->spottingTimer >= BOT_SPOTTING_DELAY) {
+            ai->canShoot = YES;
+        }
+    } else if (!canSee) {
+        // Reset spotting timer when losing sight
+        ai->spottingTimer = 0;
+        ai->canShoot = NO;
+    }
+
+    // Health-based behavior changes (override combat behaviors) - retreat to cover from the
+    // player if there's any around
+    if (healthFraction <= BOT_RETREAT_HEALTH_THRESHOLD) {
+        ai->behavior = BotBehaviorRetreat;
+        if (ai->coverTarget < 0) {
+            ai->coverTarget = simFindNearestCover(world, position, threat, -1);
+        }
+        return;
+    }
+
+    if (healthFraction <= BOT_COVER_HEALTH_THRESHOLD && ai->playerSpotted) {
+        // Low aggression bots take cover (when there's any around), high aggression bots keep fighting
+        if (simRngFloat(&ai->rng) > ai->stats.aggression) {
+            if (ai->coverTarget < 0) {
+                ai->coverTarget = simFindNearestCover(world, position, threat, -1);
+            }
+            if (ai->coverTarget >= 0) {
+                ai->behavior = BotBehaviorTakeCover;
+                return;
+            }
+        }
+    }
+
+    // Combat behavior based on player visibility and distance
+    if (ai->playerSpotted) {
+        // Chase-first behavior: bot must get close before shooting
+        // When first spotting player, chase toward them before engaging in combat
+        if (!ai->canShoot) {
+            // Haven't spotted long enough - chase toward player
+            ai->behavior = BotBehaviorChase;
+        } else if (targetDist < BOT_STRAFE_RANGE) {
+            ai->behavior = BotBehaviorStrafe;
+        } else if (targetDist < BOT_CHASE_RANGE) {
+            ai->behavior = BotBehaviorChase;
+        } else {
+            // Too far, patrol to get closer
+            ai->behavior = BotBehaviorPatrol;
+        }
+    } else {
+        // No player spotted, patrol
+        // Prefer patrol behavior longer before switching to chase
+        ai->behavior = BotBehaviorPatrol;
+        ai->coverTarget = -1;  // Reset cover target
+    }
+}
+
+// Update bot behavior state machine - frames have passed since the last update
+static void updateBotBehavior(SimWorld *world, int e, SimVec3 camPos, float distToPlayer, int frames) {
+    SimBots bots = simBots(world);
+
+    float healthFraction = (float)bots.health[e] / (float)ENEMY_MAX_HEALTH;
+
+    // Check if player is within engagement distance AND visible
+    BOOL withinEngagementRange = (distToPlayer <= BOT_ENGAGEMENT_DISTANCE);
+    BOOL canSee = withinEngagementRange && canSeePlayer(world, e, camPos);
+
+    simBotUpdateBehavior(world, &bots.ai[e], healthFraction, distToPlayer, canSee, frames,
+                         simVec3(bots.x[e], bots.y[e], bots.z[e]), camPos);
+}
+
+// Pick the bot's steering (BotAIState steer) based on current behavior - frames have passed
+// since the last pick
+static void executeBotMovement(SimWorld *world, int e, int target, SimVec3 camPos, int frames) {
+    SimBots bots = simBots(world);
+    BotAIState *botAI = bots.ai;
+
+    SimVec3 botPos = simVec3(bots.x[e], bots.y[e], bots.z[e]);
+    SimVec3 targetPos = botPos;
+    float moveSpeed = botAI[e].stats.moveSpeed;
+    BOOL navigate = NO;       // Walk a nav path to targetPos rather than straight at it
+    BOOL pursue = NO;         // Follow the target player's flow field
+
+    switch (botAI[e].behavior) {
+        case BotBehaviorPatrol: {
+            // Move toward current waypoint
+            targetPos = getWaypointPosition(botAI[e].currentWaypoint);
+            float distToWaypoint = simDistance(botPos, targetPos);
+
+            // Reached waypoint, pick next one
+            if (distToWaypoint < BOT_WAYPOINT_REACH_DIST) {
+                botAI[e].currentWaypoint = (botAI[e].currentWaypoint + 1) % NUM_WAYPOINTS;
+                targetPos = getWaypointPosition(botAI[e].currentWaypoint);
+            }
+            navigate = YES;
+            break;
+        }
+
+        case BotBehaviorChase: {
+            // Move toward the player's feet (targetPos is a body center like botPos)
+            targetPos = camPos;
+            targetPos.y = camPos.y - PLAYER_HEIGHT + 0.6f;
+            moveSpeed *= 1.2f;  // Slightly faster when chasing
+            pursue = YES;
+            break;
+        }
+
+        case BotBehaviorStrafe: {
+            // Circle-strafe around player
+            botAI[e].strafeAngle += botAI[e].strafeDirection * 0.05f * (float)frames;
+            float strafeRadius = 5.0f;
+            targetPos.x = camPos.x + cosf(botAI[e].strafeAngle) * strafeRadius;
+            targetPos.z = camPos.z + sinf(botAI[e].strafeAngle) * strafeRadius;
+            targetPos.y = FLOOR_Y + 0.6f;
+
+            // Occasionally change strafe direction
+            if (simRngRange(&botAI[e].rng, 120) == 0) {
+                botAI[e].strafeDirection *= -1;
+            }
+            break;
+        }
+
+        case BotBehaviorTakeCover: {
+            // Move toward cover position
+            if (botAI[e].coverTarget >= 0) {
+                targetPos = getCoverPosition(world, botAI[e].coverTarget, botPos);
+                navigate = YES;
+            }
+            moveSpeed *= 1.3f;  // Move faster to cover
+            break;
+        }
+
+        case BotBehaviorRetreat: {
+            // Run for cover, or else away from the player
+            SimVec3 awayDir = simSub(botPos, camPos);
+            awayDir.y = 0;
+            float len = simLength(awayDir);
+            if (botAI[e].coverTarget >= 0) {
+                targetPos = getCoverPosition(world, botAI[e].coverTarget, botPos);
+                navigate = YES;
+            } else if (len > 0.1f) {
+                awayDir = simVec3(awayDir.x / len, awayDir.y / len, awayDir.z / len);
+                targetPos = simMulAdd(botPos, awayDir, 5.0f);
+            }
+            moveSpeed *= 1.4f;  // Run fast when retreating
+            break;
+        }
+    }
+
+    // Calculate desired movement direction
+    SimVec3 moveDir = simSub(targetPos, botPos);
+    moveDir.y = 0;  // Only move horizontally
+    float moveDist = simLength(moveDir);
+
+    // Follow the nav grid around walls, up stairs and ramps - a path of our own keeping out of
+    // the spawn zones, or in pursuit the flow field every bot after that player shares
+    SimVec3 feet = simVec3(botPos.x, botPos.y - BOT_EYE_OFFSET, botPos.z);
+    BOOL onPath = NO;
+    BOOL jump = NO;
+    if (navigate) {
+        SimNavCircle avoid[NUM_SPAWN_POINTS];
+        for (int i = 0; i < NUM_SPAWN_POINTS; i++) {
+            avoid[i].x = world->spawnPoints[i].x;
+            avoid[i].z = world->spawnPoints[i].z;
+            avoid[i].radius = SPAWN_PROTECTION_RADIUS;
+        }
+        SimVec3 goal = simVec3(targetPos.x, targetPos.y - BOT_EYE_OFFSET, targetPos.z);
+        onPath = simFollowPath(world->collision, &botAI[e].path, feet, goal, avoid, NUM_SPAWN_POINTS, YES,
+                               &moveDir, &jump);
+    } else if (pursue) {
+        onPath = flowDirection(world, target, feet, &moveDir, &jump);
+    }
+    if (onPath) {
+        moveDist = simLength(moveDir);
+        if (jump && botAI[e].onGround) {
+            bots.velocityY[e] = JUMP_VELOCITY * 0.8f;
+            botAI[e].onGround = NO;
+        }
+    }
+
+    botAI[e].steer = simVec3(0, 0, 0);
+    botAI[e].steerSpeed = moveSpeed;
+    if (moveDist > 0.1f) {
+        moveDir = simVec3(moveDir.x / moveDist, moveDir.y / moveDist, moveDir.z / moveDist);
+
+        // Check for obstacles ahead (a path already goes around them)
+        float obstacleDist = onPath ? INFINITY : simObstacleDistance(world, botPos, moveDir);
+
+        // A strafing bot blocked from its spot on the circle heads along the flow field instead
+        SimVec3 flowDir;
+        BOOL flowJump;
+        if (obstacleDist < 1.5f && botAI[e].behavior == BotBehaviorStrafe &&
+            flowDirection(world, target, feet, &flowDir, &flowJump) && simLength(flowDir) > 0.0f) {
+            moveDir = flowDir;
+        } else if (obstacleDist < 1.5f) {
+            // Obstacle ahead, try to go around
+            // Try turning left
+            SimVec3 leftDir = simVec3(-moveDir.z, 0, moveDir.x);
+            float leftDist = simObstacleDistance(world, botPos, leftDir);
+
+            // Try turning right
+            SimVec3 rightDir = simVec3(moveDir.z, 0, -moveDir.x);
+            float rightDist = simObstacleDistance(world, botPos, rightDir);
+
+            if (leftDist > rightDist && leftDist > 1.5f) {
+                moveDir = leftDir;
+            } else if (rightDist > 1.5f) {
+                moveDir = rightDir;
+            } else {
+                // Stuck, try jumping
+                if (botAI[e].onGround && botAI[e].jumpCooldown <= 0) {
+                    bots.velocityY[e] = JUMP_VELOCITY * 0.8f;
+                    botAI[e].onGround = NO;
+                    botAI[e].jumpCooldown = BOT_JUMP_COOLDOWN;
+                }
+            }
+        }
+
+        botAI[e].steer = moveDir;
+    }
+}
+
+// Accelerate along the steering picked at the last think - every tick, thinking or not
+static void accelerateBot(SimWorld *world, int e) {
+    SimBots bots = simBots(world);
+    const BotAIState *bot = &bots.ai[e];
+    if (bot->steer.x == 0.0f && bot->steer.z == 0.0f) return;
+
+    // Apply acceleration toward target direction
+    bots.velocityX[e] += bot->steer.x * BOT_ACCELERATION;
+    bots.velocityZ[e] += bot->steer.z * BOT_ACCELERATION;
+
+    // Clamp to max speed
+    float currentSpeed = sqrtf(bots.velocityX[e] * bots.velocityX[e] +
+                               bots.velocityZ[e] * bots.velocityZ[e]);
+    if (currentSpeed > bot->steerSpeed) {
+        float scale = bot->steerSpeed / currentSpeed;
+        bots.velocityX[e] *= scale;
+        bots.velocityZ[e] *= scale;
+    }
+}
+
+// Apply gravity and friction before the collision pass
+static void prepareBotPhysics(SimWorld *world, int e) {
+    SimBots bots = simBots(world);
+    BotAIState *bot = &bots.ai[e];
+
+    // Apply friction
+    bots.velocityX[e] *= BOT_FRICTION;
+    bots.velocityZ[e] *= BOT_FRICTION;
+
+    // Assume not on ground until collision detected
+    bot->onGround = NO;
+
+    // Apply gravity (always apply, ground collision will stop it)
+    bots.velocityY[e] -= GRAVITY;
+
+    // Clamp terminal velocity
+    if (bots.velocityY[e] < -0.5f) bots.velocityY[e] = -0.5f;
+
+    // Update jump cooldown
+    if (bot->jumpCooldown > 0) {
+        bot->jumpCooldown--;
+    }
+}
+
+// Take the bot's resolved body from the collision pass (swept move, ground snap, wall push-out).
+// threat is the target's eye position, for picking other cover.
+static void applyBotKinematics(SimWorld *world, int e, const KinematicResult *body, SimVec3 threat) {
+    SimBots bots = simBots(world);
+    BotAIState *bot = &bots.ai[e];
+
+    // Collision works at eye level - convert back to center
+    float newX = body->position.x;
+    float newY = body->position.y - BOT_EYE_OFFSET;
+    float newZ = body->position.z;
+    bots.velocityX[e] = body->velocity.x;
+    bots.velocityY[e] = body->velocity.y;
+    bots.velocityZ[e] = body->velocity.z;
+    if (body->onGround) {
+        bot->onGround = YES;
+    }
+
+    // Track horizontal wall collisions (not Y axis) - swept stops or overlap push-outs
+    BOOL sweptIntoWall = body->sweep.hit && fabsf(body->sweep.hitNormal.y) < 0.5f;
+    BOOL pushedOutOfWall = body->move.collided &&
+                           (fabsf(body->move.pushOut.x) > 0.01f || fabsf(body->move.pushOut.z) > 0.01f);
+    if (sweptIntoWall || pushedOutOfWall) {
+        bot->wallHitCount++;
+        bot->wallHitCooldown = 60;  // Longer cooldown before reset
+
+        // If hitting walls repeatedly, take action quickly
+        if (bot->wallHitCount >= 3) {
+            bot->wallHitCount = 0;
+
+            // On a path, just search it again - the path already routes around walls
+            if (bot->path.next < bot->path.count) {
+                bot->path.count = 0;
+                bot->path.replanTimer = 0;
+            } else {
+                // No path - change behavior based on current state
+                if (bot->behavior == BotBehaviorPatrol) {
+                    // Pick a completely different waypoint
+                    bot->currentWaypoint = (bot->currentWaypoint + 5 + simRngRange(&bot->rng, 5)) % NUM_WAYPOINTS;
+                } else if (bot->behavior == BotBehaviorChase || bot->behavior == BotBehaviorStrafe) {
+                    // Can't reach player - temporarily go to patrol mode
+                    bot->behavior = BotBehaviorPatrol;
+                    bot->currentWaypoint = simRngRange(&bot->rng, NUM_WAYPOINTS);
+                    bot->playerSpotted = NO;  // Reset spotted state
+                    bot->canShoot = NO;
+                    bot->spottingTimer = 0;
+                } else if (bot->behavior == BotBehaviorTakeCover || bot->behavior == BotBehaviorRetreat) {
+                    // Pick a different cover point
+                    SimVec3 botPos = simVec3(bots.x[e], bots.y[e], bots.z[e]);
+                    bot->coverTarget = simFindNearestCover(world, botPos, threat, bot->coverTarget);
+                }
+
+                // Add random velocity push to break out of stuck state
+                float pushAngle = simRngFloat(&bot->rng) * 2.0f * M_PI;
+                bots.velocityX[e] += cosf(pushAngle) * 0.05f;
+                bots.velocityZ[e] += sinf(pushAngle) * 0.05f;
+            }
+        }
+    }
+
+    // Decay wall hit count over time if not hitting walls
+    if (bot->wallHitCooldown > 0) {
+        bot->wallHitCooldown--;
+    } else if (bot->wallHitCount > 0) {
+        bot->wallHitCount = 0;  // Reset fully when cooldown expires
+    }
+
+    bots.x[e] = newX;
+    bots.y[e] = newY;
+    bots.z[e] = newZ;
+}
+
+// Enemy gun muzzle position, and the target player's center mass it aims at
+static void botAim(SimWorld *world, int e, int target, SimVec3 *outMuzzle, SimVec3 *outAimPoint) {
+    SimBots bots = simBots(world);
+    SimVec3 camPos = world->players[target].position;
+    *outMuzzle = simVec3(bots.x[e] + 0.5f, bots.y[e] + 0.28f, bots.z[e]);
+    *outAimPoint = simVec3(camPos.x, camPos.y - 0.5f, camPos.z);
+}
+
+// Count down the bot's fire timer, and when it fires at the target player, queue its aim's
+// line of sight - traced afresh with the rest of the tick's shots before fireBotShot
+static void readyBotShot(SimWorld *world, int e, int target, float distToPlayer) {
+    SimBots bots = simBots(world);
+    BotAIState *botAI = bots.ai;
+
+    // Only shoot if player is spotted and bot has completed spotting delay
+    if (!botAI[e].playerSpotted) return;
+    if (!botAI[e].canShoot) return;  // Must have spotted player for 30+ frames
+    if (botAI[e].behavior == BotBehaviorPatrol) return;
+    if (botAI[e].behavior == BotBehaviorRetreat) return;
+    if (botAI[e].behavior == BotBehaviorChase) return;  // Chase first, then shoot
+
+    // Don't engage beyond engagement distance
+    if (distToPlayer > BOT_ENGAGEMENT_DISTANCE) return;
+
+    bots.fireTimer[e]--;
+    if (bots.fireTimer[e] <= 0) {
+        // Reset fire timer with some randomness
+        int baseRate = ENEMY_FIRE_RATE_MIN;
+        // Harder bots shoot faster
+        baseRate = (int)(baseRate * (2.0f - botAI[e].stats.aggression));
+        bots.fireTimer[e] = baseRate + simRngRange(&botAI[e].rng, ENEMY_FIRE_RATE_VAR);
+
+        SimVec3 eMuzzle, aimPoint;
+        botAim(world, e, target, &eMuzzle, &aimPoint);
+        float dist = simDistance(eMuzzle, aimPoint);
+        if (dist > 0.1f && dist < 30.0f) {
+            // Whether a shot lands is never answered from an earlier tick
+            world->botPerception.checks++;
+            SIM_PROFILE_COUNT(SimCounterSightChecks, 1);
+            queueSight(world, &botAI[e].aim, eMuzzle, aimPoint);
+        }
+    }
+}
+
+// Fire a readied shot at the target player if its aim has line of sight
+static void fireBotShot(SimWorld *world, int e, int target) {
+    SimBots bots = simBots(world);
+    BotAIState *botAI = bots.ai;
+    SimPlayer *player = &world->players[target];
+
+    // Line of sight, traced this tick with the rest of the tick's shots
+    if (!botAI[e].aim.visible) return;
+
+    // Calculate direction from muzzle to target
+    SimVec3 eMuzzle, aimPoint;
+    botAim(world, e, target, &eMuzzle, &aimPoint);
+    SimVec3 delta = simSub(aimPoint, eMuzzle);
+    float dist = simLength(delta);
+    SimVec3 eDir = simVec3(delta.x / dist, delta.y / dist, delta.z / dist);
+
+    // Apply accuracy - add random spread based on bot accuracy
+    float spread = (1.0f - botAI[e].stats.accuracy) * 0.3f;
+    eDir.x += (simRngFloat(&botAI[e].rng) - 0.5f) * spread;
+    eDir.y += (simRngFloat(&botAI[e].rng) - 0.5f) * spread;
+    eDir.z += (simRngFloat(&botAI[e].rng) - 0.5f) * spread;
+    eDir = simNormalize(eDir);
+
+    // Check if shot would still hit player (accounting for accuracy)
+    float hitChance = botAI[e].stats.accuracy;
+    // Harder to hit at distance
+    hitChance *= fmaxf(0.3f, 1.0f - (dist / 30.0f) * 0.5f);
+
+    BOOL shotHits = simRngFloat(&botAI[e].rng) < hitChance;
+
+    world->enemyMuzzlePos = eMuzzle;
+    world->enemyMuzzleFlashTimer = 4;
+    world->lastFiringEnemy = e;
+
+    // Enemy gunshot with distance-based volume
+    float volume = 1.0f - (dist / 30.0f);
+    volume = fmaxf(0.1f, volume);
+    volume = volume * volume;
+    simPushEvent(world, SimEventEnemyGunshot, target, -1, e, 0, volume);
+
+    // Only damage player if shot hits
+    if (shotHits) {
+        int damage = ENEMY_DAMAGE;
+
+        // Check spawn protection - reduce damage by 90% if protected
+        if (player->spawnProtectionTimer > 0) {
+            damage = damage / 10;  // 90% damage reduction during spawn protection
+        }
+
+        // Skip if no damage after spawn protection
+        if (damage > 0) {
+            // Apply armor damage reduction (50% reduction when armor > 0)
+            damage = simAbsorbDamageWithArmor(world, target, damage);
+
+            player->health -= damage;
+            player->damageCooldownTimer = 0;
+            player->bloodLevel += 0.25f;
+            if (player->bloodLevel > 1.0f) player->bloodLevel = 1.0f;
+            player->bloodFlashTimer = 8;
+
+            if (player->health <= 0) {
+                player->health = 0;
+                player->alive = NO;
+            }
+        }
+    }
+}
+
+// Nearest living player with controls active, or -1
+static int findBotTarget(const SimWorld *world, SimVec3 botPos, float *outDist) {
+    int best = -1;
+    float bestDist = 0.0f;
+
+    for (int p = 0; p < world->playerCount; p++) {
+        const SimPlayer *player = &world->players[p];
+        if (player->isRemote || !player->alive || !player->inputActive) continue;
+
+        float dist = simDistance(botPos, player->position);
+        if (best < 0 || dist < bestDist) {
+            best = p;
+            bestDist = dist;
+        }
+    }
+
+    *outDist = bestDist;
+    return best;
+}
+
+// Bots per chunk of the move job - a few bots' line-of-sight and collision queries are
+// about what it takes to be worth handing to another thread. A chunk's bodies go through
+// the kinematics in one batch.
+enum { BOT_MOVE_GRAIN = 8 };
+
+// What a bot went after this tick, carried from its think to the end of its move
+typedef struct {
+    int target;
+    float targetDist;
+    SimVec3 camPos;
+} BotMove;
+
+// Nothing to go after - bots hold still (game won, or the single-player game over / menu case)
+static BOOL botsHoldStill(const SimWorld *world) {
+    if (world->gameWon) return YES;
+    float unused;
+    return findBotTarget(world, simVec3(0, 0, 0), &unused) < 0;
+}
+
+// Respawn, activation, AI and acceleration for one bot, up to its collision step. Reads the
+// players, the spawn points and the collision world, and writes only this bot's slot, so
+// every bot can move at once. Returns YES when the bot moves this tick, with its body in
+// outPosition / outVelocity for the kinematics.
+static BOOL startBotMove(SimWorld *world, int e, BotMove *move, SimVec3 *outPosition, SimVec3 *outVelocity) {
+    SimBots bots = simBots(world);
+    BotAIState *botAI = bots.ai;
+
+    bots.target[e] = -1;
+    if (!bots.spawned[e]) return NO;
+
+    // Handle enemy respawning
+    if (!bots.alive[e]) {
+        if (bots.respawnTimer[e] > 0) {
+            bots.respawnTimer[e]--;
+            if (bots.respawnTimer[e] == 0) {
+                // Respawn the enemy at their starting position
+                bots.alive[e] = YES;
+                bots.health[e] = ENEMY_MAX_HEALTH;
+                bots.x[e] = botAI[e].home.x;
+                bots.y[e] = botAI[e].home.y;
+                bots.z[e] = botAI[e].home.z;
+                bots.velocityX[e] = 0;
+                bots.velocityY[e] = 0;
+                bots.velocityZ[e] = 0;
+                botAI[e].playerSpotted = NO;
+                botAI[e].reactionTimer = 0;
+                botAI[e].spottingTimer = 0;
+                botAI[e].canShoot = NO;
+                botAI[e].onGround = YES;
+                botAI[e].isActive = YES;
+                resetBotMotion(&botAI[e], e);
+            }
+        }
+        return NO;
+    }
+
+    // Handle staggered activation - decrement timer and activate when ready
+    if (!botAI[e].isActive) {
+        if (botAI[e].activationTimer > 0) {
+            botAI[e].activationTimer--;
+        } else {
+            botAI[e].isActive = YES;
+        }
+        return NO;  // Skip AI update for inactive enemies
+    }
+
+    // Enforce spawn zone exclusion - enemies cannot enter spawn areas
+    simEnforceSpawnZoneExclusion(world, e);
+
+    // Pick the player to go after and the distance to them
+    SimVec3 botPos = simVec3(bots.x[e], bots.y[e], bots.z[e]);
+    move->target = findBotTarget(world, botPos, &move->targetDist);
+    move->camPos = world->players[move->target].position;
+
+    // Update behavior state and pick where to go - when scheduled to, catching up on the
+    // frames since the last time
+    botAI[e].sinceThink++;
+    if (botAI[e].thinking) {
+        updateBotBehavior(world, e, move->camPos, move->targetDist, botAI[e].sinceThink);
+        executeBotMovement(world, e, move->target, move->camPos, botAI[e].sinceThink);
+        botAI[e].sinceThink = 0;
+    }
+    accelerateBot(world, e);
+
+    // Apply gravity and friction - the swept move, ground snap and wall push-out follow
+    prepareBotPhysics(world, e);
+    *outPosition = simVec3(bots.x[e], bots.y[e] + BOT_EYE_OFFSET, bots.z[e]);
+    *outVelocity = simVec3(bots.velocityX[e], bots.velocityY[e], bots.velocityZ[e]);
+    return YES;
+}
+
+// Take on the bot's resolved body and record its target for the shooting pass
+static void finishBotMove(SimWorld *world, int e, const BotMove *move, const KinematicResult *body) {
+    SimBots bots = simBots(world);
+    applyBotKinematics(world, e, body, move->camPos);
+
+    // Enforce spawn zone exclusion again after movement
+    simEnforceSpawnZoneExclusion(world, e);
+
+    bots.target[e] = move->target;
+    bots.targetDist[e] = move->targetDist;
+    SIM_PROFILE_COUNT(SimCounterBotsMoved, 1);
+}
+
+// One chunk of the move job: BOT_MOVE_GRAIN bot slots from chunk * BOT_MOVE_GRAIN. Each
+// bot's think only reads the others' state from before the job, so the chunk's moving
+// bodies can be resolved together in one kinematics batch and then taken on in slot order.
+static void moveBots(void *context, int chunk) {
+    SimWorld *world = context;
+    int begin = chunk * BOT_MOVE_GRAIN;
+    int end = begin + BOT_MOVE_GRAIN;
+    if (end > world->botPool.count) end = world->botPool.count;
+
+    BotMove moves[BOT_MOVE_GRAIN];
+    int slots[BOT_MOVE_GRAIN];
+    SimVec3 positions[BOT_MOVE_GRAIN];
+    SimVec3 velocities[BOT_MOVE_GRAIN];
+    float radii[BOT_MOVE_GRAIN];
+    float heights[BOT_MOVE_GRAIN];
+    KinematicResult bodies[BOT_MOVE_GRAIN];
+    int count = 0;
+
+    for (int e = begin; e < end; e++) {
+        if (!startBotMove(world, e, &moves[count], &positions[count], &velocities[count])) continue;
+        slots[count] = e;
+        radii[count] = BOT_COLLISION_RADIUS;
+        heights[count] = BOT_COLLISION_HEIGHT;
+        count++;
+    }
+    if (count == 0) return;
+
+    simCollisionResolveKinematics(world->collision, positions, velocities, radii, heights, count, bodies);
+    for (int i = 0; i < count; i++) {
+        finishBotMove(world, slots[i], &moves[i], &bodies[i]);
+    }
+}
+
+// Ticks between thinks for a bot distToPlayer from its target - every tick once it's noticed
+// or gone after someone, then by distance
+static int botThinkInterval(const BotAIState *bot, float distToPlayer) {
+    if (bot->playerSpotted || bot->reactionTimer > 0 || bot->behavior != BotBehaviorPatrol) return 1;
+    if (distToPlayer <= BOT_LOD_NEAR_DISTANCE) return 1;
+    if (distToPlayer <= BOT_ENGAGEMENT_DISTANCE) return BOT_LOD_MID_INTERVAL;
+    return BOT_LOD_FAR_INTERVAL;
+}
+
+// Can the bot think this tick (alive and its AI started)?
+static BOOL botAwake(SimBots bots, int e) {
+    return bots.spawned[e] && bots.alive[e] && bots.ai[e].isActive;
+}
+
+// Ask for a thinking bot's look at its target, as canSeePlayer will want it - only within
+// engagement distance, where the bot looks at all
+static void askLook(SimWorld *world, int e) {
+    SimBots bots = simBots(world);
+    SimVec3 botPos = simVec3(bots.x[e], bots.y[e], bots.z[e]);
+    float distToPlayer;
+    int target = findBotTarget(world, botPos, &distToPlayer);
+    if (target < 0 || distToPlayer > BOT_ENGAGEMENT_DISTANCE) return;
+
+    SimVec3 eye = simVec3(botPos.x, botPos.y + 0.5f, botPos.z);
+    SimVec3 camPos = world->players[target].position;
+    float dist = simDistance(eye, camPos);
+    if (dist < 0.1f || dist > BOT_DETECTION_RANGE) return;
+
+    askSight(world, &bots.ai[e].look, eye, camPos);
+}
+
+// Pick the bots that think this tick - one job, in slot order, before any bot moves. Every
+// awake bot's timer counts down (cut short if it's got closer); the due ones think within
+// the budget, bots thinking every tick first, each pass handing thinks out from the cursor.
+// When the budget runs out the cursor moves to the first bot left over, so it goes first
+// next tick. Then the thinking bots ask for their looks (SimBotPerception).
+static void scheduleBots(void *context, int unused) {
+    (void)unused;
+    SIM_PROFILE_ZONE("scheduleBots");
+    SimWorld *world = context;
+    SimBots bots = simBots(world);
+    SimBotSchedule *schedule = &world->botSchedule;
+
+    schedule->thinks = 0;
+    schedule->skipped = 0;
+    schedule->deferred = 0;
+    world->botPerception.checks = 0;
+    world->botPerception.reused = 0;
+    if (schedule->cursor >= bots.count) schedule->cursor = 0;
+
+    for (int e = 0; e < bots.count; e++) {
+        BotAIState *bot = &bots.ai[e];
+        bot->thinking = NO;
+        bot->look.asked = NO;
+        if (!botAwake(bots, e)) continue;
+
+        float distToPlayer;
+        findBotTarget(world, simVec3(bots.x[e], bots.y[e], bots.z[e]), &distToPlayer);
+        bot->thinkInterval = botThinkInterval(bot, distToPlayer);
+        bot->thinkTimer--;
+        if (bot->thinkTimer > bot->thinkInterval) bot->thinkTimer = bot->thinkInterval;
+        if (bot->thinkTimer > 0) schedule->skipped++;
+    }
+
+    int budget = schedule->thinkBudget > 0 ? schedule->thinkBudget : bots.count;
+    int leftOver = -1;
+    for (int pass = 0; pass < 2; pass++) {
+        for (int i = 0; i < bots.count; i++) {
+            int e = (schedule->cursor + i) % bots.count;
+            BotAIState *bot = &bots.ai[e];
+            if (!botAwake(bots, e) || bot->thinkTimer > 0) continue;
+            if ((bot->thinkInterval == 1) != (pass == 0)) continue;
+
+            if (schedule->thinks < budget) {
+                bot->thinking = YES;
+                bot->thinkTimer = bot->thinkInterval;
+                schedule->thinks++;
+            } else {
+                schedule->deferred++;
+                if (leftOver < 0) leftOver = e;
+            }
+        }
+    }
+    if (leftOver >= 0) schedule->cursor = leftOver;
+
+    for (int e = 0; e < bots.count; e++) {
+        if (bots.ai[e].thinking) askLook(world, e);
+    }
+
+    SIM_PROFILE_COUNT(SimCounterBotThinks, schedule->thinks);
+    SIM_PROFILE_COUNT(SimCounterBotThinksDeferred, schedule->deferred);
+}
+
+// Trace the looks the schedule left pending - a job of SIGHT_BATCH bot slots per chunk,
+// before any bot moves
+static void traceLooks(void *context, int chunk) {
+    SimWorld *world = context;
+    int begin = chunk * SIGHT_BATCH;
+    int end = begin + SIGHT_BATCH;
+    if (end > world->botPool.count) end = world->botPool.count;
+    traceSights(world, NO, begin, end);
+}
+
+// Was any bot chasing or strafing players[p] last tick (bots.target is last tick's until
+// the bots move)?
+static BOOL playerPursued(SimWorld *world, int p) {
+    SimBots bots = simBots(world);
+    for (int e = 0; e < bots.count; e++) {
+        if (bots.target[e] != p) continue;
+        BotBehavior behavior = bots.ai[e].behavior;
+        if (behavior == BotBehaviorChase || behavior == BotBehaviorStrafe) return YES;
+    }
+    return NO;
+}
+
+// Point the flow field of each player being pursued at them - a job per player, before any
+// bot moves. The goal only follows the player once they get PURSUIT_GOAL_SLACK from it, so
+// a player on the move costs a build every couple of meters rather than every cell; it's
+// kept in the world, so the field is always the same at the same tick. Fields nobody
+// follows are paused rather than kept up to date; a bot that takes up the chase steers
+// straight for its first tick.
+static void updatePursuitField(void *context, int p) {
+    SimWorld *world = context;
+    const SimPlayer *player = &world->players[p];
+    if (player->isRemote || !player->alive || !player->inputActive || !playerPursued(world, p)) {
+        simCollisionPauseFlowField(world->collision, p);
+        return;
+    }
+
+    SimVec3 feet = simVec3(player->position.x, player->position.y - PLAYER_HEIGHT, player->position.z);
+    if (!world->pursuitGoalSet[p] || simDistance(feet, world->pursuitGoal[p]) > PURSUIT_GOAL_SLACK) {
+        world->pursuitGoal[p] = feet;
+        world->pursuitGoalSet[p] = YES;
+    }
+    simCollisionUpdateFlowField(world->collision, p, world->pursuitGoal[p]);
+}
+
+// Shooting changes the players and pushes events - one job, bots in slot order. The bots
+// that fire this tick are gathered first and their aims traced in one batch.
+static void shootBots(void *context, int unused) {
+    (void)unused;
+    SIM_PROFILE_ZONE("shootBots");
+    SimWorld *world = context;
+    SimBots bots = simBots(world);
+
+    for (int e = 0; e < bots.count; e++) {
+        bots.ai[e].aim.asked = NO;
+        if (bots.target[e] >= 0) {
+            readyBotShot(world, e, bots.target[e], bots.targetDist[e]);
+        }
+    }
+    traceSights(world, YES, 0, bots.count);
+    for (int e = 0; e < bots.count; e++) {
+        if (bots.ai[e].aim.asked) {
+            fireBotShot(world, e, bots.target[e]);
+        }
+    }
+}
+
+// Refile the bots that moved - on one thread after the move job, since moves in different
+// chunks can relink the same cell
+static void fileBots(void *context, int unused) {
+    (void)unused;
+    SIM_PROFILE_ZONE("fileBots");
+    SimWorld *world = context;
+    SimBots bots = simBots(world);
+    SpatialHash grid = simEntityHash(world, SimEntityBots);
+
+    for (int e = 0; e < bots.count; e++) {
+        if (bots.spawned[e]) {
+            spatialHashMove(&grid, e, bots.x[e], bots.z[e]);
+        }
+    }
+}
+
+static BOOL addBotJobs(SimWorld *world, SimJobGraph *graph) {
+    int fields = simJobGraphAdd(graph, updatePursuitField, world, world->playerCount, 1);
+    if (fields < 0) return NO;
+    int schedule = simJobGraphAdd(graph, scheduleBots, world, 1, 1);
+    if (schedule < 0) return NO;
+    int looks = simJobGraphAdd(graph, traceLooks, world, (world->botPool.count + SIGHT_BATCH - 1) / SIGHT_BATCH, 1);
+    if (looks < 0 || !simJobGraphDepend(graph, looks, schedule)) return NO;
+    int move = simJobGraphAdd(graph, moveBots, world, (world->botPool.count + BOT_MOVE_GRAIN - 1) / BOT_MOVE_GRAIN, 1);
+    if (move < 0 || !simJobGraphDepend(graph, move, fields) || !simJobGraphDepend(graph, move, looks)) return NO;
+    int file = simJobGraphAdd(graph, fileBots, world, 1, 1);
+    if (file < 0 || !simJobGraphDepend(graph, file, move)) return NO;
+    int shoot = simJobGraphAdd(graph, shootBots, world, 1, 1);
+    if (shoot < 0) return NO;
+    return simJobGraphDepend(graph, shoot, move);
+}
+
+BOOL simAddBotJobs(SimWorld *world, SimJobGraph *graph) {
+    if (botsHoldStill(world) || world->botPool.spawnedCount == 0) return YES;
+
+    // The jobs only depend on each other, so dropping the ones that fit undoes the add
+    int jobCount = graph->jobCount;
+    if (addBotJobs(world, graph)) return YES;
+    graph->jobCount = jobCount;
+    return NO;
+}
+
+void simUpdateBotsSerial(SimWorld *world) {
+    if (botsHoldStill(world) || world->botPool.spawnedCount == 0) return;
+
+    // The stages of addBotJobs, in dependency order
+    simCollisionPrepareQueries(world->collision);
+    for (int p = 0; p < world->playerCount; p++) {
+        updatePursuitField(world, p);
+    }
+    scheduleBots(world, 0);
+    for (int chunk = 0; chunk < (world->botPool.count + SIGHT_BATCH - 1) / SIGHT_BATCH; chunk++) {
+        traceLooks(world, chunk);
+    }
+    for (int chunk = 0; chunk < (world->botPool.count + BOT_MOVE_GRAIN - 1) / BOT_MOVE_GRAIN; chunk++) {
+        moveBots(world, chunk);
+    }
+    fileBots(world, 0);
+    shootBots(world, 0);
+}
+
+void simUpdateBots(SimWorld *world) {
+    SimJobGraph graph;
+    simJobGraphInit(&graph);
+    if (!simAddBotJobs(world, &graph)) {
+        simUpdateBotsSerial(world);
+        return;
+    }
+
+    simCollisionPrepareQueries(world->collision);
+    simJobGraphRun(world->jobs, &graph);
+}
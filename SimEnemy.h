@@ -0,0 +1,240 @@
+// SimEnemy.h - Enemy AI and state (portable C)
+#ifndef SIMENEMY_H
+#define SIMENEMY_H
+
+#include "SimTypes.h"
+#include "SimRandom.h"
+#include "GameConfig.h"
+#include "SimJobs.h"
+#include "SimCollision.h"
+
+// Bot behavior states
+typedef enum {
+    BotBehaviorPatrol = 0,    // Following waypoints around the map
+    BotBehaviorChase,         // Actively pursuing player
+    BotBehaviorStrafe,        // Circle-strafing while shooting
+    BotBehaviorTakeCover,     // Moving to cover when low health
+    BotBehaviorRetreat        // Running away when very low health
+} BotBehavior;
+
+// A nav path (simCollisionFindPath) being walked
+typedef struct {
+    SimVec3 points[SIM_NAV_MAX_PATH_POINTS];  // Corners (feet), goal last
+    int count;                // Corners in points, 0 for no path
+    int next;                 // Corner being walked to
+    SimVec3 goal;             // Feet position the path was searched to
+    int replanTimer;          // Frames before the path may be searched again
+    int progressTimer;        // Frames since the last corner was reached
+} SimPathFollower;
+
+// One of a bot's line-of-sight checks, kept to answer the next one (see SimBotPerception)
+typedef struct {
+    SimVec3 from;             // Ends it was last traced between
+    SimVec3 to;
+    float doorAngle;          // Door angle then - a moved door means tracing again
+    unsigned int tracedTick;  // World tick it was traced on
+    BOOL valid;               // Traced at least once since the bot was reset
+    BOOL visible;             // Result, for this tick when asked
+    BOOL asked;               // Asked for this tick
+    BOOL pending;             // Asked, waiting to be traced in this tick's batch
+} SimSightCache;
+
+// Bot stats structure
+typedef struct {
+    float moveSpeed;          // Movement speed (varies per difficulty)
+    float accuracy;           // Accuracy (0.5 to 0.95)
+    int reactionTime;         // Frames before reacting to player
+    float aggression;         // How likely to chase vs take cover
+} BotStats;
+
+// Bot AI state structure (position, velocity, health and timers are in SimBots)
+typedef struct {
+    BotBehavior behavior;     // Current behavior state
+    BotStats stats;           // Bot stats based on difficulty
+    int difficulty;           // 0=Easy, 1=Medium, 2=Hard
+    SimVec3 home;             // Respawn position (body center)
+    int currentWaypoint;      // Index of current patrol waypoint
+    int reactionTimer;        // Countdown timer for reaction
+    BOOL playerSpotted;       // Has the player been spotted
+    int jumpCooldown;         // Cooldown between jumps
+    float strafeAngle;        // Current strafe angle around player
+    int strafeDirection;      // 1 = clockwise, -1 = counter-clockwise
+    int coverTarget;          // Index of target cover position
+    BOOL onGround;            // Is the bot on the ground
+    // New fields for rebalanced AI
+    int spottingTimer;        // Frames player has been continuously visible
+    BOOL canShoot;            // Has spotted player long enough to shoot
+    int loseSightTimer;       // Frames since player was last seen
+    BOOL isActive;            // Whether this enemy is currently active in the game
+    int activationTimer;      // Timer until this enemy becomes active
+    int wallHitCount;         // Counter for consecutive wall hits
+    int wallHitCooldown;      // Cooldown before resetting wall hit count
+    SimPathFollower path;     // Path to the patrol waypoint, player or cover being walked
+    int thinkInterval;        // Frames between thinks at the bot's level of detail (see SimBotSchedule)
+    int thinkTimer;           // Frames until the next think - at or below 0 it's due (overdue if deferred)
+    int sinceThink;           // Frames since the last think, caught up on at the next one
+    BOOL thinking;            // Scheduled to think this tick
+    SimVec3 steer;            // Unit XZ direction picked at the last think (zero to stand still)
+    float steerSpeed;         // Top speed along it
+    SimSightCache look;       // Eyes to the target's eyes, asked for when it thinks
+    SimSightCache aim;        // Muzzle to the target's center mass, traced on every tick it fires
+    SimRng rng;               // This bot's random stream
+} BotAIState;
+
+// ============================================
+// BOT STORAGE
+// ============================================
+//
+// Bots live in slots, one dense array per field (structure of arrays), placed in the
+// world's own allocation right after the SimWorld struct. The world stays one block that
+// a snapshot copies with one memcpy, and the arrays are found from the capacity rather
+// than stored as pointers, so a copy needs no fixing up. Freed slots go on a free list
+// and are reused by the next spawn.
+
+// Bookkeeping kept in SimWorld
+typedef struct {
+    int capacity;             // Slots, fixed when the world is created
+    int count;                // Slots ever handed out - every bot is below this
+    int spawnedCount;         // Slots holding a bot
+    int freeHead;             // Freed slot to reuse next, or -1
+} SimBotPool;
+
+// Level of detail for the bot AI. A bot "thinks" - looks for its target, runs the behaviour
+// state machine and picks where to steer (paths, obstacle probes) - every tick close to a
+// player or once it's after one, less often the further it is;
+// in between it keeps accelerating along its last steering, and its physics runs every tick.
+// Thinks are staggered over the ticks and capped at thinkBudget per tick, near bots first;
+// bots over the cap think first next tick. All of it lives in the world, so a tick plays the
+// same after a rollback and with any number of workers.
+typedef struct {
+    int thinkBudget;          // Most thinks per tick, 0 for no limit (SIM_BOT_THINK_BUDGET by default)
+    int cursor;               // Slot the next tick's thinks are handed out from
+    // This tick
+    int thinks;               // Bots that thought
+    int skipped;              // Bots that weren't due - moved on their last steering only
+    int deferred;             // Bots that were due, but over the budget
+} SimBotSchedule;
+
+#define SIM_BOT_THINK_BUDGET 256
+
+// Bot perception. The line-of-sight checks of a tick are gathered - the look of every bot
+// that thinks, before any bot moves, and the aim of every bot that fires - and the ones that
+// need tracing resolved as a batch. A look is answered from the bot's last one instead while
+// both ends are within tolerance of where that one was traced, it's under maxAge ticks old and
+// the door hasn't moved, so a standoff doesn't trace the same sight line again every tick.
+// Aims decide whether shots land, so they are always traced on the tick the bot fires.
+// The caches live in the bots' AI state, so results don't depend on the number of workers.
+typedef struct {
+    float tolerance;          // Meters either end may move and still reuse a result (SIM_SIGHT_TOLERANCE)
+    int maxAge;               // Ticks a result is reused for at most, 0 to always trace (SIM_SIGHT_MAX_AGE)
+    // This tick
+    int checks;               // Line-of-sight checks asked for
+    int reused;               // Answered from the caches - the rest were traced
+} SimBotPerception;
+
+#define SIM_SIGHT_TOLERANCE 0.25f
+#define SIM_SIGHT_MAX_AGE 30
+
+// The world's bot arrays, indexed by slot. Loop to count and skip slots that aren't
+// spawned; a slot that isn't spawned is never alive.
+typedef struct {
+    int capacity;
+    int count;
+    BOOL *spawned;            // Slot holds a bot (NO: on the free list)
+    BOOL *alive;              // Spawned and not waiting to respawn
+    int *health;
+    float *x;                 // Body center
+    float *y;
+    float *z;
+    float *velocityX;
+    float *velocityY;         // For jumping and falling
+    float *velocityZ;
+    int *fireTimer;
+    int *respawnTimer;        // Counts down in frames while dead
+    int *target;              // Player the bot went after this tick, or -1 (it didn't move)
+    float *targetDist;        // Distance to that player before moving
+    int *nextFree;            // Free list link (free slots only)
+    BotAIState *ai;
+} SimBots;
+
+// Bytes for a world with capacity bot slots - the SimWorld struct, its bot arrays and entity grids
+size_t simWorldSizeForBots(int capacity);
+
+// The world's bot arrays
+SimBots simBots(SimWorld *world);
+
+// Put a bot in a free slot at position (body center). activationDelay frames pass before
+// its AI starts. Returns the slot, or -1 when every slot is taken.
+int simSpawnBot(SimWorld *world, SimVec3 position, int difficulty, int activationDelay);
+
+// Free a bot's slot for reuse
+void simDespawnBot(SimWorld *world, int slot);
+
+// Free every slot
+void simClearBots(SimWorld *world);
+
+// Clear the bots and spawn the single-player roster (ENEMY_START_*, ENEMY_DIFFICULTY),
+// with staggered activation - as many of them as fit
+void simSpawnBotRoster(SimWorld *world);
+
+// Fill the free slots with a ring of bots around each patrol waypoint in turn, active at once -
+// sizes a world past the single-player roster for stress tests and benchmarks
+void simSpawnBotRing(SimWorld *world);
+
+// Every spawned bot alive again at its home position with full health (AI state is kept)
+void simRespawnBots(SimWorld *world);
+
+// Restart every bot's AI - stats from its difficulty, patrolling, staggered activation
+void simInitBotAI(SimWorld *world);
+
+// Update enemy AI - handles movement, shooting, and behavior changes.
+// Each bot goes after the nearest living player with controls active; with none, bots hold still.
+// Runs on the world's job system; the same as simAddBotJobs in a graph of its own.
+void simUpdateBots(SimWorld *world);
+
+// Add the bot update to a graph: the flow fields toward the players are brought up to date
+// (one job each) while one job picks which bots think this tick (SimBotSchedule) and gathers
+// their looks, the looks that need it are traced in batches (SimBotPerception), then every
+// bot thinks and moves in parallel (each touches only its own slot), then one job refiles
+// the moved bots in the entity grid while another shoots in slot order. Queries run from
+// worker threads, so run the graph after simCollisionPrepareQueries.
+// Returns NO, with the graph as it was, if the jobs don't fit - use simUpdateBotsSerial then.
+BOOL simAddBotJobs(SimWorld *world, SimJobGraph *graph);
+
+// The same update with every stage run on the calling thread, in order
+void simUpdateBotsSerial(SimWorld *world);
+
+// Check line of sight from enemy muzzle to target
+BOOL simEnemyLineOfSight(SimWorld *world, SimVec3 eMuzzle, SimVec3 eDir, float maxDist);
+
+// Check if there's a clear path between two points (for movement)
+BOOL simPathClear(SimWorld *world, SimVec3 start, SimVec3 end);
+
+// Get distance to nearest obstacle in given direction
+float simObstacleDistance(SimWorld *world, SimVec3 pos, SimVec3 dir);
+
+// One think of the bot state machine, shared by the bots and the AI-controlled match
+// players: spotting (after the reaction time, lost after a while out of sight), the shoot
+// delay, and the behaviour from health (fraction of max), distance to the target and
+// whether it is in engagement range and in sight. frames have passed since the last think.
+// Cover is looked for around position (feet) against threat (the target's eye).
+void simBotUpdateBehavior(SimWorld *world, BotAIState *ai, float healthFraction, float targetDist,
+                          BOOL canSee, int frames, SimVec3 position, SimVec3 threat);
+
+// Cover point (simCollisionCoverPoint index) near pos that hides from the threat (eye
+// position), preferring close to pos, far from the threat and little exposed; never
+// exclude (-1 for none). Returns -1 when there's none around.
+int simFindNearestCover(SimWorld *world, SimVec3 pos, SimVec3 threatPos, int exclude);
+
+// Steer along a nav path from feet to goal (feet positions), searching again - at most
+// every few frames - when the goal has moved, the path is used up or no corner has been
+// reached for a while. Writes the unit XZ direction to walk, and whether to jump up to the
+// next corner. Returns NO when there's no path to walk, to steer straight at the goal instead.
+BOOL simFollowPath(SimCollision *collision, SimPathFollower *path, SimVec3 feet, SimVec3 goal,
+                   const SimNavCircle *avoid, int avoidCount, BOOL avoidDynamic,
+                   SimVec3 *outDir, BOOL *outJump);
+
+// Enforce spawn zone exclusion - pushes enemy out of spawn protection zones
+void simEnforceSpawnZoneExclusion(SimWorld *world, int enemyIndex);
+
+#endif // SIMENEMY_H
@@ -0,0 +1,202 @@
+// SimHeadless.c - Runs the simulation with no window, GPU or audio, to time ticks on any machine
+//
+// Usage: FPSSim [ticks] [seed] [replay|-] [bots]
+// One scripted player runs, turns and shoots against the bots; the player is reset
+// when killed. bots (default NUM_ENEMIES) sizes the world for a stress test - slots past
+// the single-player roster are filled with bots spread over the patrol waypoints. Prints
+// ticks per second at the end, and a hash of the final state that is the same on every
+// run with the same seed. With a replay path the run is also recorded, for FPSReplay to
+// play back. The last seconds are kept as snapshots, and the run ends by rolling back to
+// the oldest and re-simulating to the same state. Also reports how many bots thought each
+// tick, and how many the AI level of detail and think budget put off. Built with
+// -DFPS_PROFILE and FPS_TRACE set, the last ticks are written there as a Chrome trace.
+#include "SimWorld.h"
+#include "SimProfile.h"
+#include "SimReplay.h"
+#include "SimSnapshot.h"
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static double nowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+// Walk forward while sweeping the view, strafe in bursts, hold jump now and then
+// and fire at the player's trigger rate
+static SimInput scriptedInput(unsigned int tick) {
+    SimInput input = {0};
+    input.active = YES;
+    input.weaponSlot = -1;
+    input.yaw = (float)tick * 0.01f;
+    input.pitch = 0.0f;
+
+    input.buttons = SimButtonForward;
+    if ((tick / 90) % 2 == 0) input.buttons |= SimButtonLeft;
+    if ((tick / 240) % 4 == 0) input.buttons |= SimButtonJump;
+    if (tick % PLAYER_FIRE_RATE == 0) input.buttons |= SimButtonFire;
+    return input;
+}
+
+// One tick of the scripted player
+static void runTick(SimWorld *world, SimReplayWriter *replay, int *deaths) {
+    SimInput input = scriptedInput(world->tick);
+    if (replay) {
+        simReplayWriterStep(replay, world, &input);
+    } else {
+        simStep(world, &input);
+    }
+
+    // Same as pressing R on the game over screen
+    if (!world->players[0].alive) {
+        (*deaths)++;
+        int botKills = world->players[0].botKills;
+        world->seed++;  // Each life gets its own streams, as a new game would
+        simResetGame(world);
+        simSpawnBotRing(world);
+        world->players[0].botKills = botKills;
+        simRespawnPlayer(world, 0, simChooseSpawnPoint(world, 0));
+    }
+}
+
+// Roll back to the oldest snapshot and re-simulate to the present - the state must come
+// out the same. Returns NO if it doesn't.
+static BOOL checkRollback(SimWorld *world, const SimSnapshotRing *snapshots) {
+    unsigned int oldestTick;
+    unsigned int newestTick;
+    if (!simSnapshotOldestTick(snapshots, &oldestTick) || !simSnapshotNewestTick(snapshots, &newestTick)) {
+        return YES;
+    }
+
+    uint64_t expected = simReplayWorldHash(world);
+    unsigned int presentTick = world->tick;
+
+    // The tick count restarts with each life - only roll back within the current one
+    if (presentTick <= newestTick) {
+        printf("[SIM] Rollback skipped - the run ended on a death\n");
+        return YES;
+    }
+
+    double restoreStart = nowSeconds();
+    simSnapshotRestore(snapshots, world, oldestTick);
+    double restoreTime = nowSeconds() - restoreStart;
+
+    int deaths = 0;
+    while (world->tick < presentTick && deaths == 0) {
+        runTick(world, NULL, &deaths);
+    }
+
+    uint64_t actual = simReplayWorldHash(world);
+    printf("[SIM] Rolled back %u ticks (restore %.2f us) and re-simulated: %s\n",
+           presentTick - oldestTick, restoreTime * 1e6, actual == expected ? "state matches" : "STATE DIFFERS");
+    return actual == expected;
+}
+
+int main(int argc, char **argv) {
+    long ticks = (argc > 1) ? strtol(argv[1], NULL, 10) : 36000;
+    long botCapacity = (argc > 4) ? strtol(argv[4], NULL, 10) : NUM_ENEMIES;
+    if (ticks <= 0 || botCapacity < 0 || botCapacity > INT_MAX) {
+        fprintf(stderr, "usage: %s [ticks] [seed] [replay|-] [bots]\n", argv[0]);
+        return 1;
+    }
+
+    SimCollision *collision = simCollisionCreate();
+    if (!collision) {
+        fprintf(stderr, "[SIM] Out of memory\n");
+        return 1;
+    }
+
+    char cachePath[1024];
+    double loadStart = nowSeconds();
+    simCollisionLoadOrBuildMilitaryBase(collision,
+                                        simCollisionDefaultCachePath(cachePath, (int)sizeof(cachePath)) ? cachePath : NULL);
+    double loadTime = nowSeconds() - loadStart;
+
+    SimWorld *world = simCreateWithBots(collision, (int)botCapacity);
+    SimJobSystem *jobs = simJobSystemCreate(-1);
+    if (!world || !jobs) {
+        fprintf(stderr, "[SIM] Out of memory\n");
+        return 1;
+    }
+    simCollisionSetJobSystem(collision, jobs);
+    simSetJobSystem(world, jobs);
+    if (argc > 2) {
+        world->seed = strtoull(argv[2], NULL, 0);
+        simResetGame(world);
+    }
+    simSpawnBotRing(world);
+    uint64_t seed = world->seed;
+    simRespawnPlayer(world, 0, simChooseSpawnPoint(world, 0));
+
+    SimReplayWriter *replay = NULL;
+    if (argc > 3 && strcmp(argv[3], "-") != 0) {
+        replay = simReplayWriterOpen(argv[3], world, REPLAY_DEFAULT_KEYFRAME_INTERVAL);
+        if (!replay) return 1;
+    }
+
+    SimSnapshotRing *snapshots = simSnapshotRingCreate(SIM_SNAPSHOT_DEFAULT_CAPACITY, world);
+    if (!snapshots) {
+        fprintf(stderr, "[SIM] Out of memory\n");
+        return 1;
+    }
+
+    SIM_PROFILE_THREAD_NAME("main");
+    int deaths = 0;
+    long thinks = 0;
+    long skipped = 0;
+    long deferred = 0;
+    long sightChecks = 0;
+    long sightReused = 0;
+    double saveTime = 0.0;
+    double start = nowSeconds();
+    for (long t = 0; t < ticks; t++) {
+        double saveStart = nowSeconds();
+        simSnapshotSave(snapshots, world);
+        saveTime += nowSeconds() - saveStart;
+
+        runTick(world, replay, &deaths);
+        thinks += world->botSchedule.thinks;
+        skipped += world->botSchedule.skipped;
+        deferred += world->botSchedule.deferred;
+        sightChecks += world->botPerception.checks;
+        sightReused += world->botPerception.reused;
+        SIM_PROFILE_FRAME();
+    }
+    double elapsed = nowSeconds() - start;
+
+    if (replay && !simReplayWriterClose(replay)) return 1;
+
+    uint64_t finalHash = simReplayWorldHash(world);
+    const char *tracePath = getenv("FPS_TRACE");
+    if (tracePath) simProfileWriteChromeTrace(tracePath);
+
+    printf("[SIM] Collision world ready in %.1f ms (%d shapes)\n",
+           loadTime * 1000.0, simCollisionShapeCount(collision));
+    printf("[SIM] %ld ticks in %.3f s - %.0f ticks/s, %.2f us/tick (%d worker threads)\n",
+           ticks, elapsed, (double)ticks / elapsed, elapsed * 1e6 / (double)ticks,
+           simJobSystemWorkerCount(jobs));
+    printf("[SIM] Bots: %d, killed: %d, player deaths: %d\n",
+           world->botPool.spawnedCount, world->players[0].botKills, deaths);
+    printf("[SIM] Bot thinks per tick: %.1f, skipped %.1f, deferred %.1f (budget %d)\n",
+           (double)thinks / (double)ticks, (double)skipped / (double)ticks, (double)deferred / (double)ticks,
+           world->botSchedule.thinkBudget);
+    printf("[SIM] Bot sight checks per tick: %.1f, %.1f%% answered from cache (tolerance %.2f m)\n",
+           (double)sightChecks / (double)ticks,
+           sightChecks > 0 ? 100.0 * (double)sightReused / (double)sightChecks : 0.0,
+           (double)world->botPerception.tolerance);
+    printf("[SIM] Seed %llu, final state hash %016llx\n",
+           (unsigned long long)seed, (unsigned long long)finalHash);
+    printf("[SIM] Snapshots: %d x %zu bytes, %.2f us per save\n",
+           simSnapshotRingCapacity(snapshots), world->size, saveTime * 1e6 / (double)ticks);
+    BOOL rollbackOK = checkRollback(world, snapshots);
+
+    simSnapshotRingDestroy(snapshots);
+    simDestroy(world);
+    simCollisionDestroy(collision);
+    simJobSystemDestroy(jobs);
+    return rollbackOK ? 0 : 2;
+}
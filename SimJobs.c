@@ -0,0 +1,396 @@
+// SimJobs.c - Work-stealing thread pool and job graph implementation
+#include "SimJobs.h"
+#include "SimProfile.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+// Chunks per thread a job is split into when it doesn't choose a grain - enough that a
+// thread finishing early has something to steal
+enum { CHUNKS_PER_THREAD = 4 };
+enum { MAX_WORKERS = 63 };
+enum { DEQUE_INITIAL_CAPACITY = 64 };
+
+// ============================================
+// JOB GRAPHS
+// ============================================
+
+void simJobGraphInit(SimJobGraph *graph) {
+    graph->jobCount = 0;
+    graph->remainingJobs = 0;
+}
+
+int simJobGraphAdd(SimJobGraph *graph, SimParallelFn fn, void *context, int count, int grain) {
+    if (graph->jobCount >= SIM_JOB_GRAPH_MAX_JOBS) return -1;
+
+    int job = graph->jobCount++;
+    SimJobNode *node = &graph->jobs[job];
+    memset(node, 0, sizeof(*node));
+    node->fn = fn;
+    node->context = context;
+    node->count = count > 0 ? count : 0;
+    node->grain = grain;
+    return job;
+}
+
+BOOL simJobGraphDepend(SimJobGraph *graph, int job, int dependency) {
+    // Dependencies point back to jobs added earlier, so a graph can't have cycles
+    if (job < 0 || job >= graph->jobCount || dependency < 0 || dependency >= job) return NO;
+
+    SimJobNode *before = &graph->jobs[dependency];
+    if (before->dependentCount >= SIM_JOB_MAX_DEPENDENTS) return NO;
+    before->dependents[before->dependentCount++] = job;
+    graph->jobs[job].dependencyCount++;
+    return YES;
+}
+
+// Every dependency comes before its dependents, so index order is a valid order
+static void runGraphInline(SimJobGraph *graph) {
+    for (int j = 0; j < graph->jobCount; j++) {
+        const SimJobNode *node = &graph->jobs[j];
+        for (int i = 0; i < node->count; i++) {
+            node->fn(node->context, i);
+        }
+    }
+}
+
+// ============================================
+// THREAD POOL
+// ============================================
+
+// A chunk of one job's iterations
+typedef struct {
+    SimJobGraph *graph;
+    int job;
+    int begin;
+    int end;
+} JobTask;
+
+// The owner pushes and pops at the back (newest first, still warm in cache);
+// thieves take from the front (oldest, usually the biggest remaining piece of work)
+typedef struct {
+    pthread_mutex_t lock;
+    JobTask *tasks;             // Ring buffer
+    int capacity;
+    int front;
+    int count;
+} TaskDeque;
+
+struct SimJobSystem {
+    int workerCount;
+    pthread_t *threads;
+
+    // One per worker, then one shared by every thread outside the pool
+    TaskDeque *deques;
+    int dequeCount;
+    int dequesAllocated;
+
+    int queued;                 // Tasks in all deques (atomic)
+    int quit;
+
+    pthread_mutex_t sleepLock;
+    pthread_cond_t wake;
+    int sleepers;
+};
+
+// The pool the current thread works for and its deque there
+static _Thread_local SimJobSystem *threadPool;
+static _Thread_local int threadDeque;
+
+static int ownDeque(const SimJobSystem *jobs) {
+    return threadPool == jobs ? threadDeque : jobs->workerCount;
+}
+
+static BOOL pushTask(TaskDeque *deque, JobTask task) {
+    pthread_mutex_lock(&deque->lock);
+    if (deque->count == deque->capacity) {
+        int capacity = deque->capacity > 0 ? deque->capacity * 2 : DEQUE_INITIAL_CAPACITY;
+        JobTask *tasks = malloc(sizeof(JobTask) * (size_t)capacity);
+        if (!tasks) {
+            pthread_mutex_unlock(&deque->lock);
+            return NO;
+        }
+        for (int i = 0; i < deque->count; i++) {
+            tasks[i] = deque->tasks[(deque->front + i) % deque->capacity];
+        }
+        free(deque->tasks);
+        deque->tasks = tasks;
+        deque->capacity = capacity;
+        deque->front = 0;
+    }
+    deque->tasks[(deque->front + deque->count) % deque->capacity] = task;
+    deque->count++;
+    pthread_mutex_unlock(&deque->lock);
+    return YES;
+}
+
+static BOOL popBack(TaskDeque *deque, JobTask *outTask) {
+    pthread_mutex_lock(&deque->lock);
+    BOOL found = deque->count > 0;
+    if (found) {
+        deque->count--;
+        *outTask = deque->tasks[(deque->front + deque->count) % deque->capacity];
+    }
+    pthread_mutex_unlock(&deque->lock);
+    return found;
+}
+
+static BOOL stealFront(TaskDeque *deque, JobTask *outTask) {
+    pthread_mutex_lock(&deque->lock);
+    BOOL found = deque->count > 0;
+    if (found) {
+        *outTask = deque->tasks[deque->front];
+        deque->front = (deque->front + 1) % deque->capacity;
+        deque->count--;
+    }
+    pthread_mutex_unlock(&deque->lock);
+    return found;
+}
+
+// Own work first, then steal from the others in turn
+static BOOL findTask(SimJobSystem *jobs, int self, JobTask *outTask) {
+    if (__atomic_load_n(&jobs->queued, __ATOMIC_ACQUIRE) == 0) return NO;
+
+    BOOL found = popBack(&jobs->deques[self], outTask);
+    for (int i = 1; !found && i < jobs->dequeCount; i++) {
+        found = stealFront(&jobs->deques[(self + i) % jobs->dequeCount], outTask);
+    }
+    if (found) {
+        __atomic_sub_fetch(&jobs->queued, 1, __ATOMIC_ACQ_REL);
+    }
+    return found;
+}
+
+static void wakeWorkers(SimJobSystem *jobs) {
+    pthread_mutex_lock(&jobs->sleepLock);
+    if (jobs->sleepers > 0) {
+        pthread_cond_broadcast(&jobs->wake);
+    }
+    pthread_mutex_unlock(&jobs->sleepLock);
+}
+
+static void finishJob(SimJobSystem *jobs, SimJobGraph *graph, int job);
+static void runTask(SimJobSystem *jobs, const JobTask *task);
+
+// Queue a job whose dependencies are done, split into chunks
+static void scheduleJob(SimJobSystem *jobs, SimJobGraph *graph, int job) {
+    SimJobNode *node = &graph->jobs[job];
+    if (node->count == 0) {
+        finishJob(jobs, graph, job);
+        return;
+    }
+
+    int chunkCount = (node->count + node->grain - 1) / node->grain;
+    __atomic_store_n(&node->remainingChunks, chunkCount, __ATOMIC_RELEASE);
+
+    TaskDeque *deque = &jobs->deques[ownDeque(jobs)];
+    for (int c = 0; c < chunkCount; c++) {
+        int begin = c * node->grain;
+        int end = begin + node->grain < node->count ? begin + node->grain : node->count;
+        JobTask task = {graph, job, begin, end};
+        if (pushTask(deque, task)) {
+            __atomic_add_fetch(&jobs->queued, 1, __ATOMIC_ACQ_REL);
+        } else {
+            // Out of memory for the queue - do the chunk here instead. It may be the
+            // last one, so it completes like any other task and releases the dependents.
+            runTask(jobs, &task);
+        }
+    }
+
+    // This thread goes looking for work next, so a lone task needs nobody woken for it
+    if (__atomic_load_n(&jobs->queued, __ATOMIC_ACQUIRE) > 1) {
+        wakeWorkers(jobs);
+    }
+}
+
+static void finishJob(SimJobSystem *jobs, SimJobGraph *graph, int job) {
+    SimJobNode *node = &graph->jobs[job];
+    for (int d = 0; d < node->dependentCount; d++) {
+        int dependent = node->dependents[d];
+        if (__atomic_sub_fetch(&graph->jobs[dependent].unmetDependencies, 1, __ATOMIC_ACQ_REL) == 0) {
+            scheduleJob(jobs, graph, dependent);
+        }
+    }
+    __atomic_sub_fetch(&graph->remainingJobs, 1, __ATOMIC_ACQ_REL);
+}
+
+static void runTask(SimJobSystem *jobs, const JobTask *task) {
+    SIM_PROFILE_BEGIN(chunkZone, "job chunk");
+    SimJobNode *node = &task->graph->jobs[task->job];
+    for (int i = task->begin; i < task->end; i++) {
+        node->fn(node->context, i);
+    }
+    SIM_PROFILE_END(chunkZone);
+    if (__atomic_sub_fetch(&node->remainingChunks, 1, __ATOMIC_ACQ_REL) == 0) {
+        finishJob(jobs, task->graph, task->job);
+    }
+}
+
+typedef struct {
+    SimJobSystem *jobs;
+    int index;
+} WorkerStart;
+
+static void *workerMain(void *arg) {
+    WorkerStart start = *(WorkerStart *)arg;
+    free(arg);
+
+    SimJobSystem *jobs = start.jobs;
+    threadPool = jobs;
+    threadDeque = start.index;
+
+#ifdef FPS_PROFILE
+    char threadName[32];
+    snprintf(threadName, sizeof(threadName), "worker %d", start.index + 1);
+    SIM_PROFILE_THREAD_NAME(threadName);
+#endif
+
+    for (;;) {
+        JobTask task;
+        if (findTask(jobs, start.index, &task)) {
+            runTask(jobs, &task);
+            continue;
+        }
+
+        pthread_mutex_lock(&jobs->sleepLock);
+        jobs->sleepers++;
+        while (!jobs->quit && __atomic_load_n(&jobs->queued, __ATOMIC_ACQUIRE) == 0) {
+            pthread_cond_wait(&jobs->wake, &jobs->sleepLock);
+        }
+        jobs->sleepers--;
+        BOOL quit = jobs->quit;
+        pthread_mutex_unlock(&jobs->sleepLock);
+        if (quit) break;
+    }
+    return NULL;
+}
+
+SimJobSystem *simJobSystemCreate(int workerCount) {
+    if (workerCount < 0) {
+        const char *workers = getenv("FPS_WORKERS");
+        if (workers && workers[0]) {
+            workerCount = (int)strtol(workers, NULL, 10);
+            if (workerCount < 0) workerCount = 0;
+        } else {
+            long cores = sysconf(_SC_NPROCESSORS_ONLN);
+            workerCount = cores > 1 ? (int)cores - 1 : 0;
+        }
+    }
+    if (workerCount > MAX_WORKERS) workerCount = MAX_WORKERS;
+
+    SimJobSystem *jobs = calloc(1, sizeof(SimJobSystem));
+    if (!jobs) return NULL;
+
+    jobs->dequesAllocated = workerCount + 1;
+    jobs->deques = calloc((size_t)jobs->dequesAllocated, sizeof(TaskDeque));
+    jobs->threads = calloc((size_t)(workerCount > 0 ? workerCount : 1), sizeof(pthread_t));
+    if (!jobs->deques || !jobs->threads) {
+        free(jobs->deques);
+        free(jobs->threads);
+        free(jobs);
+        return NULL;
+    }
+    for (int d = 0; d < jobs->dequesAllocated; d++) {
+        TaskDeque *deque = &jobs->deques[d];
+        pthread_mutex_init(&deque->lock, NULL);
+        deque->tasks = malloc(sizeof(JobTask) * DEQUE_INITIAL_CAPACITY);
+        deque->capacity = deque->tasks ? DEQUE_INITIAL_CAPACITY : 0;
+    }
+    pthread_mutex_init(&jobs->sleepLock, NULL);
+    pthread_cond_init(&jobs->wake, NULL);
+
+    for (int w = 0; w < workerCount; w++) {
+        WorkerStart *start = malloc(sizeof(WorkerStart));
+        if (!start) {
+            free(start);
+            break;
+        }
+        start->jobs = jobs;
+        start->index = w;
+        if (pthread_create(&jobs->threads[w], NULL, workerMain, start) != 0) {
+            free(start);
+            break;
+        }
+        jobs->workerCount++;
+    }
+    if (jobs->workerCount < workerCount) {
+        fprintf(stderr, "[JOBS] Started %d of %d worker threads\n", jobs->workerCount, workerCount);
+    }
+
+    // Threads outside the pool share the deque after the last worker that started
+    jobs->dequeCount = jobs->workerCount + 1;
+    return jobs;
+}
+
+void simJobSystemDestroy(SimJobSystem *jobs) {
+    if (!jobs) return;
+
+    pthread_mutex_lock(&jobs->sleepLock);
+    jobs->quit = 1;
+    pthread_cond_broadcast(&jobs->wake);
+    pthread_mutex_unlock(&jobs->sleepLock);
+    for (int w = 0; w < jobs->workerCount; w++) {
+        pthread_join(jobs->threads[w], NULL);
+    }
+
+    for (int d = 0; d < jobs->dequesAllocated; d++) {
+        pthread_mutex_destroy(&jobs->deques[d].lock);
+        free(jobs->deques[d].tasks);
+    }
+    free(jobs->deques);
+    free(jobs->threads);
+    pthread_mutex_destroy(&jobs->sleepLock);
+    pthread_cond_destroy(&jobs->wake);
+    free(jobs);
+}
+
+int simJobSystemWorkerCount(const SimJobSystem *jobs) {
+    return jobs ? jobs->workerCount : 0;
+}
+
+void simJobGraphRun(SimJobSystem *jobs, SimJobGraph *graph) {
+    if (graph->jobCount == 0) return;
+    if (!jobs || jobs->workerCount == 0) {
+        runGraphInline(graph);
+        return;
+    }
+
+    int threadCount = jobs->workerCount + 1;
+    for (int j = 0; j < graph->jobCount; j++) {
+        SimJobNode *node = &graph->jobs[j];
+        if (node->grain <= 0) {
+            node->grain = node->count / (threadCount * CHUNKS_PER_THREAD);
+            if (node->grain < 1) node->grain = 1;
+        }
+        node->unmetDependencies = node->dependencyCount;
+        node->remainingChunks = 0;
+    }
+    __atomic_store_n(&graph->remainingJobs, graph->jobCount, __ATOMIC_RELEASE);
+
+    for (int j = 0; j < graph->jobCount; j++) {
+        if (graph->jobs[j].dependencyCount == 0) {
+            scheduleJob(jobs, graph, j);
+        }
+    }
+
+    // Work on anything queued (this graph's or not) until the graph is done
+    int self = ownDeque(jobs);
+    while (__atomic_load_n(&graph->remainingJobs, __ATOMIC_ACQUIRE) > 0) {
+        JobTask task;
+        if (findTask(jobs, self, &task)) {
+            runTask(jobs, &task);
+        } else {
+            sched_yield();
+        }
+    }
+}
+
+void simJobParallelFor(SimJobSystem *jobs, int count, SimParallelFn fn, void *context) {
+    SimJobGraph graph;
+    simJobGraphInit(&graph);
+    simJobGraphAdd(&graph, fn, context, count, 0);
+    simJobGraphRun(jobs, &graph);
+}
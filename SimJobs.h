@@ -0,0 +1,74 @@
+// SimJobs.h - Work-stealing thread pool running per-tick job graphs (portable C, pthreads)
+#ifndef SIMJOBS_H
+#define SIMJOBS_H
+
+#include "SimTypes.h"
+
+// A job runs fn(context, i) for every i in [0, count). Its iterations are split into
+// chunks that idle workers steal from each other, so a job may run on any thread and
+// iterations must write disjoint data. A job starts once every job it depends on is done.
+//
+// The thread that runs a graph works on it too and returns when all of it is done. Jobs
+// may run graphs of their own (a parallel-for inside a job) - the waiting thread keeps
+// working meanwhile, so nesting never deadlocks.
+
+// ============================================
+// JOB GRAPHS
+// ============================================
+
+enum {
+    SIM_JOB_GRAPH_MAX_JOBS = 16,
+    SIM_JOB_MAX_DEPENDENTS = 8,
+};
+
+typedef struct {
+    SimParallelFn fn;
+    void *context;
+    int count;                  // Iterations
+    int grain;                  // Iterations per chunk
+    int dependencyCount;
+    int dependents[SIM_JOB_MAX_DEPENDENTS];
+    int dependentCount;
+
+    // Run state
+    int unmetDependencies;
+    int remainingChunks;
+} SimJobNode;
+
+// Built on the stack each tick - no allocation
+typedef struct {
+    SimJobNode jobs[SIM_JOB_GRAPH_MAX_JOBS];
+    int jobCount;
+    int remainingJobs;
+} SimJobGraph;
+
+void simJobGraphInit(SimJobGraph *graph);
+
+// Add a job of count iterations, grain at a time (0 picks a grain from the worker count).
+// Returns its index, or -1 when the graph is full.
+int simJobGraphAdd(SimJobGraph *graph, SimParallelFn fn, void *context, int count, int grain);
+
+// job starts after dependency is done. Returns NO when dependency already has
+// SIM_JOB_MAX_DEPENDENTS dependents or the indices are invalid.
+BOOL simJobGraphDepend(SimJobGraph *graph, int job, int dependency);
+
+// ============================================
+// THREAD POOL
+// ============================================
+
+// Start workerCount threads (0: none - everything runs on the calling thread). Negative
+// takes FPS_WORKERS from the environment if set, otherwise one per core less the calling
+// thread. Returns NULL if out of memory.
+SimJobSystem *simJobSystemCreate(int workerCount);
+void simJobSystemDestroy(SimJobSystem *jobs);
+
+int simJobSystemWorkerCount(const SimJobSystem *jobs);
+
+// Run every job in the graph and return when all are done. jobs may be NULL - the graph
+// then runs on the calling thread, in dependency order.
+void simJobGraphRun(SimJobSystem *jobs, SimJobGraph *graph);
+
+// A graph of one job
+void simJobParallelFor(SimJobSystem *jobs, int count, SimParallelFn fn, void *context);
+
+#endif // SIMJOBS_H
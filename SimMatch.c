@@ -0,0 +1,491 @@
+// SimMatch.c - AI-controlled players and the headless match runner
+#include "SimMatch.h"
+#include "SimReplay.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Aim at the middle of the hitbox rather than the eyes
+static const float AIM_DROP = 0.6f;
+
+// Strafe back out when an opponent gets closer than this
+static const float STRAFE_MIN_RANGE = 4.0f;
+
+// Horizontal movement per frame under which a combatant pushing a key counts as stuck
+static const float STUCK_DISTANCE = 0.005f;
+
+// sin(22.5 degrees) - a travel direction this far off an axis presses that axis's key
+static const float KEY_THRESHOLD = 0.38f;
+
+enum {
+    STRAFE_FLIP_MIN = 45,       // Frames before the strafe direction may flip
+    STRAFE_FLIP_VAR = 60,
+    STUCK_FRAMES = 30,          // Stuck this long - jump, and skip the waypoint when patrolling
+    DOOR_USE_CHANCE = 10,       // One in this many frames at a closed door, press use
+};
+
+// ============================================
+// COMBATANTS
+// ============================================
+
+void simCombatantInit(SimCombatant *combatant, const SimWorld *world, int playerIndex, int difficulty) {
+    memset(combatant, 0, sizeof(*combatant));
+    if (difficulty < 0) difficulty = 0;
+    if (difficulty > 2) difficulty = 2;
+
+    // Stats from difficulty, as initBotAI does for bots
+    BotAIState *ai = &combatant->ai;
+    ai->difficulty = difficulty;
+    ai->stats.moveSpeed = BOT_MOVE_SPEED[difficulty];
+    ai->stats.accuracy = BOT_ACCURACY[difficulty];
+    ai->stats.reactionTime = BOT_REACTION_TIME[difficulty];
+    ai->stats.aggression = BOT_AGGRESSION[difficulty];
+
+    ai->behavior = BotBehaviorPatrol;
+    ai->currentWaypoint = (playerIndex * 5) % NUM_WAYPOINTS;  // Spread out over the map
+    ai->strafeDirection = (playerIndex % 2 == 0) ? 1 : -1;
+    ai->coverTarget = -1;
+    ai->onGround = YES;
+    ai->isActive = YES;
+    simRngSeed(&ai->rng, world->seed, simRngStreamId(SimRngStreamCombatant, (uint32_t)playerIndex));
+
+    combatant->target = -1;
+    combatant->lastPosition = world->players[playerIndex].position;
+}
+
+// Forget whoever was spotted
+static void loseTarget(BotAIState *ai) {
+    ai->playerSpotted = NO;
+    ai->reactionTimer = 0;
+    ai->spottingTimer = 0;
+    ai->canShoot = NO;
+    ai->loseSightTimer = 0;
+    ai->coverTarget = -1;
+}
+
+// Nearest living opponent - the one to watch for, seen or not. -1 when everyone else is dead.
+static int nearestOpponent(const SimWorld *world, int playerIndex, float *outDist) {
+    SimVec3 position = world->players[playerIndex].position;
+    int best = -1;
+    float bestDist = INFINITY;
+
+    for (int p = 0; p < world->playerCount; p++) {
+        if (p == playerIndex || !world->players[p].alive) continue;
+        float dist = simDistance(position, world->players[p].position);
+        if (dist < bestDist) {
+            bestDist = dist;
+            best = p;
+        }
+    }
+
+    *outDist = bestDist;
+    return best;
+}
+
+static BOOL canSeeOpponent(SimWorld *world, SimVec3 eye, SimVec3 targetEye, float dist) {
+    if (dist < 0.1f || dist > BOT_DETECTION_RANGE) return NO;
+
+    SimVec3 delta = simSub(targetEye, eye);
+    SimVec3 dir = simVec3(delta.x / dist, delta.y / dist, delta.z / dist);
+    return simEnemyLineOfSight(world, eye, dir, dist);
+}
+
+// Feet of a player plus the height bots measure their waypoints and cover at
+static SimVec3 groundPosition(const SimPlayer *player) {
+    return simVec3(player->position.x, player->position.y - PLAYER_HEIGHT + 0.6f, player->position.z);
+}
+
+// A patrol waypoint at the same height as groundPosition
+static SimVec3 waypointPosition(int index) {
+    return simVec3(WAYPOINT_X[index], WAYPOINT_Y[index] + 0.6f, WAYPOINT_Z[index]);
+}
+
+static float horizontalDistance(SimVec3 a, SimVec3 b) {
+    float dx = a.x - b.x;
+    float dz = a.z - b.z;
+    return sqrtf(dx * dx + dz * dz);
+}
+
+// The bot behaviour state machine, with the player's health - thinks every tick
+static void updateBehavior(SimCombatant *combatant, SimWorld *world, const SimPlayer *player,
+                           SimVec3 targetEye, float targetDist) {
+    float healthFraction = (float)player->health / (float)PLAYER_MAX_HEALTH;
+
+    BOOL withinEngagementRange = combatant->target >= 0 && targetDist <= BOT_ENGAGEMENT_DISTANCE;
+    BOOL canSee = withinEngagementRange && canSeeOpponent(world, player->position, targetEye, targetDist);
+
+    simBotUpdateBehavior(world, &combatant->ai, healthFraction, targetDist, canSee, 1,
+                         groundPosition(player), targetEye);
+}
+
+// PvP hits do fixed damage, so the owned weapon that fires fastest wins - among those with
+// ammo that reach the target
+static int chooseWeapon(const SimPlayer *player, float targetDist) {
+    const WeaponState *weapons = &player->weapons;
+    int best = WeaponTypePistol;
+    WeaponStats bestStats = weaponStats(WeaponTypePistol);
+
+    for (int w = 0; w < WeaponTypeCount; w++) {
+        if (!player->hasWeapon[w]) continue;
+        WeaponStats stats = weaponStats((WeaponType)w);
+        BOOL hasAmmo = stats.magSize == 0 || weapons->currentAmmo[w] + weapons->reserveAmmo[w] > 0;
+        if (!hasAmmo || stats.splashRadius > 0 || stats.range < targetDist) continue;
+
+        if (stats.fireRate < bestStats.fireRate ||
+            (stats.fireRate == bestStats.fireRate && stats.spread < bestStats.spread)) {
+            best = w;
+            bestStats = stats;
+        }
+    }
+    return best;
+}
+
+// Sidestep obstacles the way bots do - turn to the more open side
+static SimVec3 avoidObstacles(SimWorld *world, SimVec3 position, SimVec3 moveDir) {
+    if (simObstacleDistance(world, position, moveDir) >= 1.5f) return moveDir;
+
+    SimVec3 leftDir = simVec3(-moveDir.z, 0, moveDir.x);
+    SimVec3 rightDir = simVec3(moveDir.z, 0, -moveDir.x);
+    float leftDist = simObstacleDistance(world, position, leftDir);
+    float rightDist = simObstacleDistance(world, position, rightDir);
+
+    if (leftDist > rightDist && leftDist > 1.5f) return leftDir;
+    if (rightDist > 1.5f) return rightDir;
+    return moveDir;
+}
+
+SimInput simCombatantThink(SimCombatant *combatant, SimWorld *world, int playerIndex) {
+    SimPlayer *player = &world->players[playerIndex];
+    BotAIState *ai = &combatant->ai;
+
+    SimInput input = {0};
+    input.active = YES;
+    input.weaponSlot = -1;
+    input.yaw = player->yaw;
+    input.pitch = 0.0f;
+
+    if (combatant->triggerTimer > 0) combatant->triggerTimer--;
+    if (!player->alive) {
+        combatant->target = -1;
+        loseTarget(ai);
+        ai->behavior = BotBehaviorPatrol;
+        combatant->stuckTimer = 0;
+        memset(&ai->path, 0, sizeof(ai->path));
+        return input;
+    }
+
+    float targetDist = INFINITY;
+    int target = nearestOpponent(world, playerIndex, &targetDist);
+    if (target != combatant->target) {
+        loseTarget(ai);
+        combatant->target = target;
+    }
+    SimVec3 targetEye = target >= 0 ? world->players[target].position : player->position;
+    updateBehavior(combatant, world, player, targetEye, targetDist);
+
+    // Where to go, and whether to keep the sights on the target meanwhile
+    SimVec3 position = groundPosition(player);
+    SimVec3 goal = position;
+    BOOL navigate = NO;         // Walk a nav path to goal rather than straight at it
+    BOOL faceTarget = NO;
+    float speedScale = 1.0f;
+    SimVec3 coverFeet;          // Cover point to go to (TakeCover, Retreat)
+
+    switch (ai->behavior) {
+        case BotBehaviorPatrol: {
+            goal = waypointPosition(ai->currentWaypoint);
+            if (simDistance(position, goal) < BOT_WAYPOINT_REACH_DIST) {
+                ai->currentWaypoint = (ai->currentWaypoint + 1) % NUM_WAYPOINTS;
+                goal = waypointPosition(ai->currentWaypoint);
+            }
+            navigate = YES;
+            break;
+        }
+
+        case BotBehaviorChase:
+            goal = target >= 0 ? groundPosition(&world->players[target]) : position;
+            navigate = YES;
+            faceTarget = YES;
+            speedScale = 1.2f;
+            break;
+
+        case BotBehaviorStrafe: {
+            // Circle the target, backing off when it gets close
+            SimVec3 toTarget = simSub(targetEye, position);
+            toTarget.y = 0;
+            float len = simLength(toTarget);
+            if (len > 0.1f) {
+                toTarget = simVec3(toTarget.x / len, 0, toTarget.z / len);
+                SimVec3 side = simVec3(-toTarget.z * ai->strafeDirection, 0, toTarget.x * ai->strafeDirection);
+                goal = simMulAdd(position, side, 2.0f);
+                if (len < STRAFE_MIN_RANGE) goal = simMulAdd(goal, toTarget, -2.0f);
+            }
+            faceTarget = YES;
+
+            if (--combatant->strafeTimer <= 0) {
+                combatant->strafeTimer = STRAFE_FLIP_MIN + simRngRange(&ai->rng, STRAFE_FLIP_VAR);
+                if (simRngRange(&ai->rng, 2) == 0) ai->strafeDirection *= -1;
+            }
+            break;
+        }
+
+        case BotBehaviorTakeCover:
+            if (simCollisionCoverPoint(world->collision, ai->coverTarget, &coverFeet)) {
+                goal = simVec3(coverFeet.x, coverFeet.y + 0.6f, coverFeet.z);
+                navigate = YES;
+            }
+            // In cover, hold still and fight from there
+            if (horizontalDistance(position, goal) < BOT_WAYPOINT_REACH_DIST) {
+                goal = position;
+                faceTarget = YES;
+            }
+            speedScale = 1.3f;
+            break;
+
+        case BotBehaviorRetreat: {
+            // To cover, or else away from the target
+            SimVec3 away = simSub(position, targetEye);
+            away.y = 0;
+            float len = simLength(away);
+            if (simCollisionCoverPoint(world->collision, ai->coverTarget, &coverFeet)) {
+                goal = simVec3(coverFeet.x, coverFeet.y + 0.6f, coverFeet.z);
+                navigate = YES;
+            } else if (len > 0.1f) {
+                goal = simMulAdd(position, simVec3(away.x / len, 0, away.z / len), 5.0f);
+            }
+            speedScale = 1.4f;
+            break;
+        }
+    }
+
+    SimVec3 moveDir = simSub(goal, position);
+    moveDir.y = 0;
+    float moveDist = simLength(moveDir);
+
+    // Walk the nav grid to the goal - up stairs and ramps, and through the door (opened
+    // below when it's shut), so no keep-out circles and dynamic shapes don't block
+    BOOL onPath = NO;
+    BOOL pathJump = NO;
+    if (navigate && moveDist > 0.1f) {
+        SimVec3 feet = simVec3(position.x, position.y - 0.6f, position.z);
+        SimVec3 goalFeet = simVec3(goal.x, goal.y - 0.6f, goal.z);
+        onPath = simFollowPath(world->collision, &ai->path, feet, goalFeet, NULL, 0, NO, &moveDir, &pathJump);
+        if (onPath) moveDist = simLength(moveDir);
+    }
+
+    BOOL moving = moveDist > 0.1f;
+    if (moving && !onPath) {
+        moveDir = avoidObstacles(world, position, simVec3(moveDir.x / moveDist, 0, moveDir.z / moveDist));
+    }
+    if (pathJump) input.buttons |= SimButtonJump;
+
+    // Look at the target (with aim error by accuracy) or where we're going
+    if (faceTarget && target >= 0) {
+        SimVec3 aimPoint = simVec3(targetEye.x, targetEye.y - AIM_DROP, targetEye.z);
+        SimVec3 delta = simSub(aimPoint, player->position);
+        float spread = (1.0f - ai->stats.accuracy) * 0.3f;
+        input.yaw = atan2f(delta.x, -delta.z) + (simRngFloat(&ai->rng) - 0.5f) * spread;
+        input.pitch = atan2f(delta.y, sqrtf(delta.x * delta.x + delta.z * delta.z)) +
+                      (simRngFloat(&ai->rng) - 0.5f) * spread;
+    } else if (moving) {
+        input.yaw = atan2f(moveDir.x, -moveDir.z);
+    }
+
+    // Slower difficulties hold the movement keys for fewer frames (BOT_MOVE_SPEED)
+    if (moving) {
+        combatant->stride += fminf(1.0f, ai->stats.moveSpeed * speedScale / BOT_MOVE_SPEED[2]);
+        if (combatant->stride >= 1.0f) {
+            combatant->stride -= 1.0f;
+
+            // Travel direction in terms of the view
+            float forward = moveDir.x * sinf(input.yaw) - moveDir.z * cosf(input.yaw);
+            float right = moveDir.x * cosf(input.yaw) + moveDir.z * sinf(input.yaw);
+            if (forward > KEY_THRESHOLD) input.buttons |= SimButtonForward;
+            if (forward < -KEY_THRESHOLD) input.buttons |= SimButtonBack;
+            if (right > KEY_THRESHOLD) input.buttons |= SimButtonRight;
+            if (right < -KEY_THRESHOLD) input.buttons |= SimButtonLeft;
+        }
+    }
+
+    // Jump when pushing against something, and search the path again - or without one,
+    // give up on that waypoint
+    if (moving && horizontalDistance(player->position, combatant->lastPosition) < STUCK_DISTANCE) {
+        if (++combatant->stuckTimer >= STUCK_FRAMES) {
+            combatant->stuckTimer = 0;
+            input.buttons |= SimButtonJump;
+            if (onPath) {
+                ai->path.count = 0;
+                ai->path.replanTimer = 0;
+            } else if (ai->behavior == BotBehaviorPatrol) {
+                ai->currentWaypoint = (ai->currentWaypoint + 1) % NUM_WAYPOINTS;
+            }
+        }
+    } else {
+        combatant->stuckTimer = 0;
+    }
+    combatant->lastPosition = player->position;
+
+    // Open the door when it's in the way - now and then, so two players at it don't
+    // toggle it straight back shut
+    if (player->nearDoor && !world->doorOpen && moving && simRngRange(&ai->rng, DOOR_USE_CHANCE) == 0) {
+        input.buttons |= SimButtonUse;
+    }
+
+    // Weapon for the range, then the trigger at the player's fire rate
+    int weapon = chooseWeapon(player, target >= 0 ? targetDist : 0.0f);
+    if (weapon != (int)player->weapons.currentWeapon && !player->weapons.isReloading) {
+        input.weaponSlot = weapon;
+    }
+
+    BOOL inRange = targetDist <= fminf(BOT_ENGAGEMENT_DISTANCE, weaponStats(player->weapons.currentWeapon).range);
+    if (faceTarget && target >= 0 && ai->canShoot && inRange && combatant->triggerTimer == 0) {
+        input.buttons |= SimButtonFire;
+        combatant->triggerTimer = PLAYER_FIRE_RATE;
+    }
+
+    return input;
+}
+
+// ============================================
+// MATCHES
+// ============================================
+
+SimMatchConfig simMatchDefaultConfig(int playerCount) {
+    SimMatchConfig config;
+    memset(&config, 0, sizeof(config));
+    if (playerCount < 2) playerCount = 2;
+    if (playerCount > SIM_MAX_PLAYERS) playerCount = SIM_MAX_PLAYERS;
+
+    config.playerCount = playerCount;
+    for (int p = 0; p < playerCount; p++) {
+        config.difficulty[p] = p % 3;
+    }
+    config.killLimit = DEFAULT_KILL_LIMIT;
+    config.maxTicks = 5 * 60 * 60;
+    return config;
+}
+
+// Players come back after RESPAWN_DELAY at the spawn furthest from the others, as the host does
+static void updateRespawn(SimWorld *world, int playerIndex) {
+    SimPlayer *player = &world->players[playerIndex];
+    if (player->alive || player->respawnTimer <= 0) return;
+
+    if (--player->respawnTimer == 0) {
+        simRevivePlayer(world, playerIndex);
+        simRespawnPlayer(world, playerIndex, simChooseSpawnPoint(world, playerIndex));
+    }
+}
+
+BOOL simRunMatch(SimCollision *collision, const SimMatchConfig *config, uint64_t seed, SimMatchResult *result) {
+    memset(result, 0, sizeof(*result));
+    result->seed = seed;
+    result->winner = -1;
+
+    int playerCount = config->playerCount;
+    if (playerCount < 2 || playerCount > SIM_MAX_PLAYERS) return NO;
+
+    // A multiplayer match with every player local - hits are applied here, as the host does
+    SimWorld *world = simCreateWithBots(collision, 0);
+    if (!world) return NO;
+    world->seed = seed;
+    while (world->playerCount < playerCount) {
+        simAddPlayer(world, world->playerCount + 1, NO);
+    }
+    world->players[0].playerId = 1;
+    world->killLimit = config->killLimit;
+    simResetForMultiplayer(world, YES);
+
+    SimCombatant combatants[SIM_MAX_PLAYERS];
+    for (int p = 0; p < playerCount; p++) {
+        int spawn = p < 2 ? world->players[p].spawnIndex : simChooseSpawnPoint(world, p);
+        simRespawnPlayer(world, p, spawn);
+        simCombatantInit(&combatants[p], world, p, config->difficulty[p]);
+    }
+    simSyncDoorCollision(world);
+
+    SimInput inputs[SIM_MAX_PLAYERS];
+    while (!world->gameWon && world->tick < config->maxTicks) {
+        for (int p = 0; p < playerCount; p++) {
+            inputs[p] = simCombatantThink(&combatants[p], world, p);
+        }
+
+        BOOL wasAlive[SIM_MAX_PLAYERS];
+        for (int p = 0; p < playerCount; p++) {
+            wasAlive[p] = world->players[p].alive;
+        }
+
+        simStep(world, inputs);
+
+        for (int i = 0; i < world->eventCount; i++) {
+            const SimEvent *event = &world->events[i];
+            if (event->type == SimEventGunshot) result->shots[event->player]++;
+            if (event->type == SimEventPickup) result->pickups[event->player]++;
+        }
+        for (int p = 0; p < playerCount; p++) {
+            if (wasAlive[p] && !world->players[p].alive) result->deaths[p]++;
+            updateRespawn(world, p);
+        }
+    }
+
+    result->ticks = world->tick;
+    result->winner = world->gameWon ? world->winnerId - 1 : -1;
+    for (int p = 0; p < playerCount; p++) {
+        result->kills[p] = world->players[p].kills;
+    }
+    result->finalHash = simReplayWorldHash(world);
+
+    // Leave the collision world as it was for the next match
+    if (world->doorShapeId >= 0) simCollisionRemoveShape(collision, world->doorShapeId);
+    simDestroy(world);
+    return YES;
+}
+
+typedef struct {
+    const char *cachePath;
+    const SimMatchConfig *config;
+    uint64_t firstSeed;
+    int matchCount;
+    SimMatchResult *results;
+    int nextMatch;              // Next match to hand out (atomic)
+    int played;                 // Matches finished (atomic)
+} MatchQueue;
+
+// One lane per thread: a collision world of its own, then matches until none are left
+static void runMatchLane(void *context, int lane) {
+    (void)lane;
+    MatchQueue *queue = context;
+
+    SimCollision *collision = simCollisionCreate();
+    if (!collision) {
+        fprintf(stderr, "[MATCH] Out of memory\n");
+        return;
+    }
+    simCollisionLoadOrBuildMilitaryBase(collision, queue->cachePath);
+
+    for (;;) {
+        int match = __atomic_fetch_add(&queue->nextMatch, 1, __ATOMIC_RELAXED);
+        if (match >= queue->matchCount) break;
+
+        if (simRunMatch(collision, queue->config, queue->firstSeed + (uint64_t)match, &queue->results[match])) {
+            __atomic_add_fetch(&queue->played, 1, __ATOMIC_RELAXED);
+        } else {
+            fprintf(stderr, "[MATCH] Match %d failed\n", match);
+        }
+    }
+
+    simCollisionDestroy(collision);
+}
+
+BOOL simRunMatches(SimJobSystem *jobs, const char *cachePath, const SimMatchConfig *config,
+                   uint64_t firstSeed, int matchCount, SimMatchResult *results) {
+    if (matchCount <= 0) return YES;
+    memset(results, 0, sizeof(SimMatchResult) * (size_t)matchCount);
+
+    MatchQueue queue = {cachePath, config, firstSeed, matchCount, results, 0, 0};
+    int lanes = simJobSystemWorkerCount(jobs) + 1;
+    if (lanes > matchCount) lanes = matchCount;
+    simJobParallelFor(jobs, lanes, runMatchLane, &queue);
+
+    return queue.played == matchCount;
+}
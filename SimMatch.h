@@ -0,0 +1,69 @@
+// SimMatch.h - AI-controlled players and headless bot-vs-bot deathmatches (portable C)
+#ifndef SIMMATCH_H
+#define SIMMATCH_H
+
+#include "SimWorld.h"
+
+// A combatant plays a multiplayer slot through SimInput, the way a person at the keyboard
+// would, with the single-player bot brain: the BotAIState behaviours, thresholds and
+// BOT_* difficulty tables decide what it does, and the player's own weapons decide
+// what a shot does. Matches are free-for-all to the kill limit, every player a combatant.
+
+// ============================================
+// COMBATANTS
+// ============================================
+
+typedef struct {
+    BotAIState ai;              // Behaviour, stats by difficulty, spotting timers, random stream
+    int target;                 // Player index being engaged, -1 for none
+    int strafeTimer;            // Frames until the strafe direction may flip
+    int triggerTimer;           // Frames until the trigger is pulled again
+    float stride;               // Movement owed - slower difficulties hold the keys less often
+    int stuckTimer;             // Frames spent pushing without getting anywhere
+    SimVec3 lastPosition;
+} SimCombatant;
+
+// Fresh brain for players[playerIndex] - patrolling, nothing spotted
+void simCombatantInit(SimCombatant *combatant, const SimWorld *world, int playerIndex, int difficulty);
+
+// Decide this tick's input for players[playerIndex]
+SimInput simCombatantThink(SimCombatant *combatant, SimWorld *world, int playerIndex);
+
+// ============================================
+// MATCHES
+// ============================================
+
+typedef struct {
+    int playerCount;                        // 2 to SIM_MAX_PLAYERS
+    int difficulty[SIM_MAX_PLAYERS];        // Per player, 0=Easy to 2=Hard
+    int killLimit;
+    unsigned int maxTicks;                  // The match is a draw when it runs this long
+} SimMatchConfig;
+
+typedef struct {
+    uint64_t seed;
+    unsigned int ticks;
+    int winner;                             // Player index, -1 when time ran out
+    int kills[SIM_MAX_PLAYERS];
+    int deaths[SIM_MAX_PLAYERS];
+    int shots[SIM_MAX_PLAYERS];
+    int pickups[SIM_MAX_PLAYERS];
+    uint64_t finalHash;                     // simReplayWorldHash at the end
+} SimMatchResult;
+
+// playerCount players, difficulties cycling Easy/Medium/Hard, DEFAULT_KILL_LIMIT, 5 minutes
+SimMatchConfig simMatchDefaultConfig(int playerCount);
+
+// Play one match to the end on the calling thread. The collision world must be the
+// military base and not in use by another thread - the door's shape is added and removed
+// again. The result depends only on the config and seed. Returns NO if out of memory.
+BOOL simRunMatch(SimCollision *collision, const SimMatchConfig *config, uint64_t seed, SimMatchResult *result);
+
+// Play matchCount matches, seeds firstSeed, firstSeed + 1, ..., spread over the job system's
+// threads (jobs may be NULL). Each thread plays on a collision world of its own, loaded from
+// cachePath (built if that fails). results[i] is match i, the same for any number of threads.
+// Returns NO if any match failed.
+BOOL simRunMatches(SimJobSystem *jobs, const char *cachePath, const SimMatchConfig *config,
+                   uint64_t firstSeed, int matchCount, SimMatchResult *results);
+
+#endif // SIMMATCH_H
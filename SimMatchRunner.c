@@ -0,0 +1,115 @@
+// SimMatchRunner.c - Plays bot-vs-bot deathmatches headless, as many at once as there are cores
+//
+// Usage: FPSMatches [matches] [seed] [players] [results.csv]
+// Every player is an AI combatant (SimMatch.h), difficulties cycling Easy/Medium/Hard by
+// player slot. Matches run to the kill limit or 5 minutes of game time, at full speed on
+// every core (FPS_WORKERS picks the worker count). Prints matches and ticks per second,
+// win rates and kills per death by difficulty, and a hash of every match's final state
+// that is the same for any number of workers. With a CSV path, writes one row per player
+// per match.
+#include "SimMatch.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+static const char *DIFFICULTY_NAMES[3] = {"easy", "medium", "hard"};
+
+static double nowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static BOOL writeResults(const char *path, const SimMatchConfig *config,
+                         const SimMatchResult *results, int matchCount) {
+    FILE *file = fopen(path, "w");
+    if (!file) {
+        fprintf(stderr, "[MATCH] Can't write %s\n", path);
+        return NO;
+    }
+
+    fprintf(file, "match,seed,ticks,player,difficulty,kills,deaths,shots,pickups,won\n");
+    for (int m = 0; m < matchCount; m++) {
+        const SimMatchResult *result = &results[m];
+        for (int p = 0; p < config->playerCount; p++) {
+            fprintf(file, "%d,%llu,%u,%d,%s,%d,%d,%d,%d,%d\n",
+                    m, (unsigned long long)result->seed, result->ticks, p,
+                    DIFFICULTY_NAMES[config->difficulty[p]], result->kills[p], result->deaths[p],
+                    result->shots[p], result->pickups[p], result->winner == p);
+        }
+    }
+
+    return fclose(file) == 0;
+}
+
+int main(int argc, char **argv) {
+    int matchCount = (argc > 1) ? (int)strtol(argv[1], NULL, 10) : 64;
+    uint64_t seed = (argc > 2) ? strtoull(argv[2], NULL, 0) : SIM_DEFAULT_SEED;
+    int playerCount = (argc > 3) ? (int)strtol(argv[3], NULL, 10) : 4;
+    if (matchCount <= 0 || playerCount < 2 || playerCount > SIM_MAX_PLAYERS) {
+        fprintf(stderr, "usage: %s [matches] [seed] [players 2-%d] [results.csv]\n", argv[0], SIM_MAX_PLAYERS);
+        return 1;
+    }
+    SimMatchConfig config = simMatchDefaultConfig(playerCount);
+
+    // Bake the collision cache once up front, so the threads only load it
+    char cachePath[1024];
+    const char *cache = simCollisionDefaultCachePath(cachePath, (int)sizeof(cachePath)) ? cachePath : NULL;
+    SimCollision *collision = simCollisionCreate();
+    SimJobSystem *jobs = simJobSystemCreate(-1);
+    SimMatchResult *results = malloc(sizeof(SimMatchResult) * (size_t)matchCount);
+    if (!collision || !jobs || !results) {
+        fprintf(stderr, "[MATCH] Out of memory\n");
+        return 1;
+    }
+    simCollisionLoadOrBuildMilitaryBase(collision, cache);
+    simCollisionDestroy(collision);
+
+    double start = nowSeconds();
+    BOOL ok = simRunMatches(jobs, cache, &config, seed, matchCount, results);
+    double elapsed = nowSeconds() - start;
+
+    // Totals by difficulty
+    long ticks = 0;
+    int timeouts = 0;
+    long kills = 0;
+    int wins[3] = {0};
+    int players[3] = {0};
+    long difficultyKills[3] = {0};
+    long difficultyDeaths[3] = {0};
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for (int m = 0; m < matchCount; m++) {
+        const SimMatchResult *result = &results[m];
+        ticks += result->ticks;
+        if (result->winner < 0) timeouts++;
+        else wins[config.difficulty[result->winner]]++;
+
+        for (int p = 0; p < playerCount; p++) {
+            int difficulty = config.difficulty[p];
+            players[difficulty]++;
+            kills += result->kills[p];
+            difficultyKills[difficulty] += result->kills[p];
+            difficultyDeaths[difficulty] += result->deaths[p];
+        }
+        hash = (hash ^ result->finalHash) * 0x100000001b3ull;
+    }
+
+    printf("[MATCH] %d matches of %d players in %.3f s - %.1f matches/s, %.0f ticks/s (%d worker threads)\n",
+           matchCount, playerCount, elapsed, (double)matchCount / elapsed, (double)ticks / elapsed,
+           simJobSystemWorkerCount(jobs));
+    printf("[MATCH] Average match %.1f s of game time, %.1f kills, %d of %d timed out\n",
+           (double)ticks / matchCount / 60.0, (double)kills / matchCount, timeouts, matchCount);
+    for (int d = 0; d < 3; d++) {
+        if (players[d] == 0) continue;
+        printf("[MATCH] %-6s x%d per match: %5.1f%% of wins, %.2f kills per death\n",
+               DIFFICULTY_NAMES[d], players[d] / matchCount, 100.0 * wins[d] / matchCount,
+               difficultyDeaths[d] ? (double)difficultyKills[d] / (double)difficultyDeaths[d] : (double)difficultyKills[d]);
+    }
+    printf("[MATCH] Seed %llu, results hash %016llx\n", (unsigned long long)seed, (unsigned long long)hash);
+
+    if (argc > 4 && !writeResults(argv[4], &config, results, matchCount)) ok = NO;
+
+    free(results);
+    simJobSystemDestroy(jobs);
+    return ok ? 0 : 1;
+}
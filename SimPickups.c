@@ -0,0 +1,249 @@
+// SimPickups.c - Pickup placement, respawn and collection
+#include "SimWorld.h"
+#include <math.h>
+
+static void addPickup(SimWorld *world, PickupType type, float x, float y, float z) {
+    if (world->pickupCount >= MAX_PICKUPS) return;
+
+    Pickup *pickup = &world->pickups[world->pickupCount];
+    pickup->type = type;
+    pickup->x = x;
+    pickup->y = y;
+    pickup->z = z;
+    pickup->isActive = YES;
+    pickup->respawnTimer = 0;
+    pickup->bobOffset = 0;
+    pickup->rotationAngle = (float)world->pickupCount * 0.7f;  // Stagger initial rotations
+
+    SpatialHash grid = simEntityHash(world, SimEntityPickups);
+    spatialHashMove(&grid, world->pickupCount, x, z);
+    world->pickupCount++;
+}
+
+void simInitPickups(SimWorld *world) {
+    world->pickupCount = 0;
+    world->pickupTime = 0;
+
+    SpatialHash grid = simEntityHash(world, SimEntityPickups);
+    spatialHashClear(&grid);
+
+    // Spawn locations strategically placed around the map
+    // Format: type, x, y (base), z
+
+    // === HEALTH PICKUPS ===
+    // Health in central building (inside house)
+    addPickup(world, PickupTypeHealthPack, HOUSE_X, FLOOR_Y + 0.3f, HOUSE_Z);
+
+    // Health near cover walls
+    addPickup(world, PickupTypeHealthPack, WALL1_X + 1.5f, FLOOR_Y + 0.3f, WALL1_Z);
+
+    // === AMMO PICKUPS ===
+    // Small ammo scattered around
+    addPickup(world, PickupTypeAmmoSmall, 3.0f, FLOOR_Y + 0.3f, 2.0f);
+    addPickup(world, PickupTypeAmmoSmall, -3.0f, FLOOR_Y + 0.3f, 4.0f);
+    addPickup(world, PickupTypeAmmoSmall, 0.0f, FLOOR_Y + 0.3f, 6.0f);
+
+    // Heavy ammo in more contested areas
+    addPickup(world, PickupTypeAmmoHeavy, -ARENA_SIZE + 3.0f, FLOOR_Y + 0.3f, -ARENA_SIZE + 3.0f);
+    addPickup(world, PickupTypeAmmoHeavy, ARENA_SIZE - 3.0f, FLOOR_Y + 0.3f, ARENA_SIZE - 3.0f);
+
+    // === WEAPON PICKUPS ===
+    // Shotgun - in risky location near edge of arena
+    addPickup(world, PickupTypeShotgun, ARENA_SIZE - 2.0f, FLOOR_Y + 0.5f, 0.0f);
+
+    // Assault Rifle - near wall 2
+    addPickup(world, PickupTypeAssaultRifle, WALL2_X - 2.0f, FLOOR_Y + 0.5f, WALL2_Z + 2.0f);
+
+    // Rocket Launcher - most dangerous location (far corner)
+    addPickup(world, PickupTypeRocketLauncher, -ARENA_SIZE + 2.0f, FLOOR_Y + 0.5f, ARENA_SIZE - 2.0f);
+
+    // === ARMOR PICKUPS ===
+    // Armor in exposed positions
+    addPickup(world, PickupTypeArmor, WALL1_X - 2.0f, FLOOR_Y + 0.3f, WALL1_Z + 2.0f);
+    addPickup(world, PickupTypeArmor, 5.0f, FLOOR_Y + 0.3f, -5.0f);
+
+    // Additional pickups for variety
+    addPickup(world, PickupTypeHealthPack, -5.0f, FLOOR_Y + 0.3f, -3.0f);
+    addPickup(world, PickupTypeAmmoSmall, 6.0f, FLOOR_Y + 0.3f, 5.0f);
+}
+
+void simResetPickups(SimWorld *world) {
+    // Reactivate all pickups
+    for (int i = 0; i < world->pickupCount; i++) {
+        world->pickups[i].isActive = YES;
+        world->pickups[i].respawnTimer = 0;
+    }
+    world->pickupTime = 0;
+}
+
+void simUpdatePickups(SimWorld *world, float deltaTime) {
+    world->pickupTime += deltaTime;
+
+    for (int i = 0; i < world->pickupCount; i++) {
+        Pickup *pickup = &world->pickups[i];
+
+        // Update respawn timer for inactive pickups
+        if (!pickup->isActive) {
+            pickup->respawnTimer -= deltaTime;
+            if (pickup->respawnTimer <= 0) {
+                pickup->isActive = YES;
+                pickup->respawnTimer = 0;
+            }
+        }
+
+        // Update bob animation (sinusoidal)
+        pickup->bobOffset = sinf(world->pickupTime * PICKUP_BOB_SPEED + i * 0.5f) * PICKUP_BOB_HEIGHT;
+
+        // Update rotation
+        pickup->rotationAngle += PICKUP_ROTATE_SPEED;
+        if (pickup->rotationAngle > M_PI * 2.0f) {
+            pickup->rotationAngle -= M_PI * 2.0f;
+        }
+    }
+}
+
+static BOOL canCollectPickup(const SimPlayer *player, const Pickup *pickup) {
+    switch (pickup->type) {
+        case PickupTypeHealthPack:
+            return player->health < PLAYER_MAX_HEALTH;
+
+        case PickupTypeArmor:
+            return player->armor < MAX_ARMOR;
+
+        case PickupTypeAmmoSmall:
+        case PickupTypeAmmoHeavy:
+            return YES;  // Always can collect ammo
+
+        case PickupTypeShotgun:
+            return !player->hasWeapon[WeaponTypeShotgun];
+
+        case PickupTypeAssaultRifle:
+            return !player->hasWeapon[WeaponTypeAssaultRifle];
+
+        case PickupTypeRocketLauncher:
+            return !player->hasWeapon[WeaponTypeRocketLauncher];
+
+        default:
+            return YES;
+    }
+}
+
+static PickupResult applyPickup(SimPlayer *player, const Pickup *pickup) {
+    PickupResult result = {NO, pickup->type, 0};
+
+    switch (pickup->type) {
+        case PickupTypeHealthPack: {
+            int oldHealth = player->health;
+            player->health += HEALTH_PACK_AMOUNT;
+            if (player->health > PLAYER_MAX_HEALTH) {
+                player->health = PLAYER_MAX_HEALTH;
+            }
+            result.collected = YES;
+            result.amount = player->health - oldHealth;
+
+            // Also reduce blood overlay when healing
+            if (player->bloodLevel > 0) {
+                player->bloodLevel -= 0.3f;
+                if (player->bloodLevel < 0) player->bloodLevel = 0;
+            }
+            break;
+        }
+
+        case PickupTypeArmor: {
+            int oldArmor = player->armor;
+            player->armor += ARMOR_PACK_AMOUNT;
+            if (player->armor > MAX_ARMOR) {
+                player->armor = MAX_ARMOR;
+            }
+            result.collected = YES;
+            result.amount = player->armor - oldArmor;
+            break;
+        }
+
+        case PickupTypeAmmoSmall:
+            // Add ammo to both pistol and assault rifle
+            weaponAddAmmo(&player->weapons, WeaponTypePistol, AMMO_SMALL_AMOUNT);
+            weaponAddAmmo(&player->weapons, WeaponTypeAssaultRifle, AMMO_SMALL_AMOUNT);
+            player->ammoSmall += AMMO_SMALL_AMOUNT;
+            result.collected = YES;
+            result.amount = AMMO_SMALL_AMOUNT;
+            break;
+
+        case PickupTypeAmmoHeavy:
+            // Add ammo to both shotgun and rocket launcher
+            weaponAddAmmo(&player->weapons, WeaponTypeShotgun, AMMO_HEAVY_AMOUNT);
+            weaponAddAmmo(&player->weapons, WeaponTypeRocketLauncher, AMMO_HEAVY_AMOUNT);
+            player->ammoHeavy += AMMO_HEAVY_AMOUNT;
+            result.collected = YES;
+            result.amount = AMMO_HEAVY_AMOUNT;
+            break;
+
+        case PickupTypeShotgun:
+            player->hasWeapon[WeaponTypeShotgun] = YES;
+            // Give some ammo with weapon
+            weaponAddAmmo(&player->weapons, WeaponTypeShotgun, 8);
+            player->ammoHeavy += 8;
+            result.collected = YES;
+            result.amount = 1;
+            break;
+
+        case PickupTypeAssaultRifle:
+            player->hasWeapon[WeaponTypeAssaultRifle] = YES;
+            // Give some ammo with weapon
+            weaponAddAmmo(&player->weapons, WeaponTypeAssaultRifle, 50);
+            player->ammoSmall += 50;
+            result.collected = YES;
+            result.amount = 1;
+            break;
+
+        case PickupTypeRocketLauncher:
+            player->hasWeapon[WeaponTypeRocketLauncher] = YES;
+            // Give some rockets with weapon
+            weaponAddAmmo(&player->weapons, WeaponTypeRocketLauncher, 5);
+            player->ammoHeavy += 5;
+            result.collected = YES;
+            result.amount = 1;
+            break;
+    }
+
+    return result;
+}
+
+PickupResult simCheckPlayerPickup(SimWorld *world, int playerIndex) {
+    PickupResult result = {NO, PickupTypeHealthPack, 0};
+    SimPlayer *player = &world->players[playerIndex];
+
+    // Only the pickups in reach, in index order
+    int nearby[MAX_PICKUPS];
+    SpatialHash grid = simEntityHash(world, SimEntityPickups);
+    int count = spatialHashQueryRadius(&grid, player->position.x, player->position.z, PICKUP_COLLECT_RADIUS,
+                                       nearby, MAX_PICKUPS);
+
+    for (int n = 0; n < count; n++) {
+        Pickup *pickup = &world->pickups[nearby[n]];
+        if (!pickup->isActive) continue;
+
+        // Calculate distance to pickup (2D XZ distance - ignore Y since player eye level
+        // is much higher than floor-level pickups)
+        float dx = player->position.x - pickup->x;
+        float dz = player->position.z - pickup->z;
+        float distSq = dx * dx + dz * dz;
+
+        if (distSq < PICKUP_COLLECT_RADIUS * PICKUP_COLLECT_RADIUS && canCollectPickup(player, pickup)) {
+            // Apply pickup effect
+            result = applyPickup(player, pickup);
+
+            if (result.collected) {
+                // Deactivate and start respawn timer
+                pickup->isActive = NO;
+                pickup->respawnTimer = PICKUP_RESPAWN_TIME;
+
+                simPushEvent(world, SimEventPickup, playerIndex, -1, result.type, result.amount, 1.0f);
+
+                return result;  // Only collect one pickup per frame
+            }
+        }
+    }
+
+    return result;
+}
@@ -0,0 +1,65 @@
+// SimPickups.h - Ammo, weapon, health, and armor pickups (portable C)
+#ifndef SIMPICKUPS_H
+#define SIMPICKUPS_H
+
+#include "SimTypes.h"
+#include "GameConfig.h"
+
+// Pickup types
+typedef enum {
+    PickupTypeHealthPack = 0,    // Restores 50 health
+    PickupTypeAmmoSmall,         // Pistol/rifle ammo
+    PickupTypeAmmoHeavy,         // Shotgun/rocket ammo
+    PickupTypeShotgun,           // Gives shotgun if don't have
+    PickupTypeAssaultRifle,      // Gives assault rifle
+    PickupTypeRocketLauncher,    // Gives rocket launcher
+    PickupTypeArmor              // Adds 50 armor (reduces damage by 50%)
+} PickupType;
+
+// Pickup constants
+enum { MAX_PICKUPS = 15 };
+static const float PICKUP_RESPAWN_TIME = 30.0f * 60.0f;  // 30 seconds at 60fps = 1800 frames
+static const float PICKUP_COLLECT_RADIUS = 1.0f;
+static const float PICKUP_BOB_SPEED = 0.05f;
+static const float PICKUP_BOB_HEIGHT = 0.15f;
+static const float PICKUP_ROTATE_SPEED = 0.02f;
+
+// Health/armor values
+static const int HEALTH_PACK_AMOUNT = 50;
+static const int ARMOR_PACK_AMOUNT = 50;
+static const int MAX_ARMOR = 100;
+
+// Ammo amounts
+static const int AMMO_SMALL_AMOUNT = 30;
+static const int AMMO_HEAVY_AMOUNT = 10;
+
+// Pickup structure
+typedef struct {
+    PickupType type;
+    float x, y, z;              // Base position
+    BOOL isActive;              // Whether pickup can be collected
+    float respawnTimer;         // Countdown until respawn
+    float bobOffset;            // Current bob animation offset
+    float rotationAngle;        // Current rotation angle
+} Pickup;
+
+// Pickup result structure (returned when collecting a pickup)
+typedef struct {
+    BOOL collected;
+    PickupType type;
+    int amount;                 // Amount of health/armor/ammo restored/given
+} PickupResult;
+
+// Place the map's pickups
+void simInitPickups(SimWorld *world);
+
+// Reactivate every pickup for a new game
+void simResetPickups(SimWorld *world);
+
+// Respawn timers and bob/rotate animation
+void simUpdatePickups(SimWorld *world, float deltaTime);
+
+// Collect at most one pickup in reach of the player (pushes a SimEventPickup)
+PickupResult simCheckPlayerPickup(SimWorld *world, int playerIndex);
+
+#endif // SIMPICKUPS_H
@@ -0,0 +1,228 @@
+// SimProfile.c - Per-thread profiling rings and Chrome trace export
+#include "SimProfile.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#ifdef FPS_PROFILE
+
+typedef enum {
+    ProfileEventZone = 0,
+    ProfileEventCounter,
+} ProfileEventType;
+
+typedef struct {
+    const char *name;
+    uint64_t start;                 // Nanoseconds
+    uint64_t value;                 // Zone: duration in nanoseconds; counter: its value
+    int type;
+} ProfileEvent;
+
+// One per thread that ever recorded - kept for the life of the process, so a dump still
+// shows threads that have exited
+typedef struct ProfileThread {
+    struct ProfileThread *next;
+    ProfileEvent *events;           // Ring of SIM_PROFILE_RING_EVENTS
+    uint64_t written;               // Events ever written (atomic, owner writes)
+    uint64_t counters[SIM_COUNTER_COUNT];   // Running totals (atomic, owner writes)
+    int tid;
+    char name[32];
+} ProfileThread;
+
+static const char *COUNTER_NAMES[SIM_COUNTER_COUNT] = {
+    "rays cast",
+    "shapes tested",
+    "packets sent",
+    "packets received",
+    "bots moved",
+    "paths searched",
+    "bot thinks",
+    "bot thinks deferred",
+    "sight checks",
+    "sight checks reused",
+};
+
+static ProfileThread *profileThreads;       // Newest first (atomic)
+static int profileThreadCount;              // (atomic)
+static _Thread_local ProfileThread *currentThread;
+
+// Counter totals at the last frame mark - only the frame-marking thread touches these
+static uint64_t frameTotals[SIM_COUNTER_COUNT];
+
+static uint64_t nowNanoseconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+// The calling thread's ring, set up on first use. NULL if out of memory - nothing is recorded.
+static ProfileThread *thisThread(void) {
+    if (currentThread) return currentThread;
+
+    ProfileThread *thread = calloc(1, sizeof(ProfileThread));
+    if (!thread) return NULL;
+    thread->events = malloc(sizeof(ProfileEvent) * SIM_PROFILE_RING_EVENTS);
+    if (!thread->events) {
+        free(thread);
+        return NULL;
+    }
+    thread->tid = __atomic_add_fetch(&profileThreadCount, 1, __ATOMIC_RELAXED);
+    snprintf(thread->name, sizeof(thread->name), "thread %d", thread->tid);
+
+    thread->next = __atomic_load_n(&profileThreads, __ATOMIC_ACQUIRE);
+    while (!__atomic_compare_exchange_n(&profileThreads, &thread->next, thread, YES,
+                                        __ATOMIC_RELEASE, __ATOMIC_ACQUIRE)) {
+    }
+    currentThread = thread;
+    return thread;
+}
+
+static void recordEvent(ProfileThread *thread, ProfileEventType type, const char *name,
+                        uint64_t start, uint64_t value) {
+    uint64_t index = thread->written;
+    ProfileEvent *event = &thread->events[index & (SIM_PROFILE_RING_EVENTS - 1)];
+    event->name = name;
+    event->start = start;
+    event->value = value;
+    event->type = type;
+    __atomic_store_n(&thread->written, index + 1, __ATOMIC_RELEASE);
+}
+
+SimProfileZone simProfileZoneBegin(const char *name) {
+    SimProfileZone zone = {name, nowNanoseconds()};
+    return zone;
+}
+
+void simProfileZoneEnd(SimProfileZone *zone) {
+    ProfileThread *thread = thisThread();
+    if (!thread) return;
+    recordEvent(thread, ProfileEventZone, zone->name, zone->start, nowNanoseconds() - zone->start);
+}
+
+void simProfileCount(SimCounter counter, int amount) {
+    ProfileThread *thread = thisThread();
+    if (!thread) return;
+    __atomic_store_n(&thread->counters[counter], thread->counters[counter] + (uint64_t)amount, __ATOMIC_RELAXED);
+}
+
+void simProfileSetThreadName(const char *name) {
+    ProfileThread *thread = thisThread();
+    if (!thread) return;
+    snprintf(thread->name, sizeof(thread->name), "%s", name);
+}
+
+void simProfileFrameMark(void) {
+    ProfileThread *self = thisThread();
+    if (!self) return;
+
+    uint64_t totals[SIM_COUNTER_COUNT] = {0};
+    for (ProfileThread *thread = __atomic_load_n(&profileThreads, __ATOMIC_ACQUIRE); thread; thread = thread->next) {
+        for (int c = 0; c < SIM_COUNTER_COUNT; c++) {
+            totals[c] += __atomic_load_n(&thread->counters[c], __ATOMIC_RELAXED);
+        }
+    }
+
+    uint64_t now = nowNanoseconds();
+    for (int c = 0; c < SIM_COUNTER_COUNT; c++) {
+        recordEvent(self, ProfileEventCounter, COUNTER_NAMES[c], now, totals[c] - frameTotals[c]);
+        frameTotals[c] = totals[c];
+    }
+}
+
+static void writeJSONString(FILE *file, const char *text) {
+    fputc('"', file);
+    for (const char *c = text; *c; c++) {
+        if (*c == '"' || *c == '\\') fputc('\\', file);
+        if ((unsigned char)*c >= 0x20) fputc(*c, file);
+    }
+    fputc('"', file);
+}
+
+BOOL simProfileWriteChromeTrace(const char *path) {
+    FILE *file = fopen(path, "w");
+    if (!file) {
+        fprintf(stderr, "[PROFILE] Can't write %s\n", path);
+        return NO;
+    }
+
+    ProfileEvent *copy = malloc(sizeof(ProfileEvent) * SIM_PROFILE_RING_EVENTS);
+    if (!copy) {
+        fclose(file);
+        return NO;
+    }
+
+    long eventCount = 0;
+    BOOL first = YES;
+    fprintf(file, "{\"traceEvents\":[\n");
+    for (ProfileThread *thread = __atomic_load_n(&profileThreads, __ATOMIC_ACQUIRE); thread; thread = thread->next) {
+        fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":",
+                first ? "" : ",\n", thread->tid);
+        writeJSONString(file, thread->name);
+        fprintf(file, "}}");
+        first = NO;
+
+        // Copy the ring, then drop whatever the owner may have overwritten meanwhile
+        uint64_t end = __atomic_load_n(&thread->written, __ATOMIC_ACQUIRE);
+        uint64_t begin = end > SIM_PROFILE_RING_EVENTS ? end - SIM_PROFILE_RING_EVENTS : 0;
+        for (uint64_t i = begin; i < end; i++) {
+            copy[i - begin] = thread->events[i & (SIM_PROFILE_RING_EVENTS - 1)];
+        }
+        uint64_t after = __atomic_load_n(&thread->written, __ATOMIC_ACQUIRE);
+        uint64_t firstValid = after >= SIM_PROFILE_RING_EVENTS ? after - SIM_PROFILE_RING_EVENTS + 1 : 0;
+        if (firstValid < begin) firstValid = begin;
+
+        for (uint64_t i = firstValid; i < end; i++) {
+            const ProfileEvent *event = &copy[i - begin];
+            fprintf(file, ",\n{\"name\":");
+            writeJSONString(file, event->name);
+            if (event->type == ProfileEventZone) {
+                fprintf(file, ",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%d}",
+                        (double)event->start / 1000.0, (double)event->value / 1000.0, thread->tid);
+            } else {
+                fprintf(file, ",\"ph\":\"C\",\"ts\":%.3f,\"pid\":1,\"tid\":%d,\"args\":{\"value\":%llu}}",
+                        (double)event->start / 1000.0, thread->tid, (unsigned long long)event->value);
+            }
+            eventCount++;
+        }
+    }
+    fprintf(file, "\n],\"displayTimeUnit\":\"ns\"}\n");
+    free(copy);
+
+    BOOL ok = !ferror(file);
+    ok = fclose(file) == 0 && ok;
+    if (ok) {
+        fprintf(stderr, "[PROFILE] Wrote %ld events to %s\n", eventCount, path);
+    }
+    return ok;
+}
+
+#else
+
+SimProfileZone simProfileZoneBegin(const char *name) {
+    SimProfileZone zone = {name, 0};
+    return zone;
+}
+
+void simProfileZoneEnd(SimProfileZone *zone) {
+    (void)zone;
+}
+
+void simProfileCount(SimCounter counter, int amount) {
+    (void)counter;
+    (void)amount;
+}
+
+void simProfileSetThreadName(const char *name) {
+    (void)name;
+}
+
+void simProfileFrameMark(void) {
+}
+
+BOOL simProfileWriteChromeTrace(const char *path) {
+    fprintf(stderr, "[PROFILE] Not writing %s - built without FPS_PROFILE\n", path);
+    return NO;
+}
+
+#endif // FPS_PROFILE
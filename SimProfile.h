@@ -0,0 +1,83 @@
+// SimProfile.h - Scoped timing zones and counters, exported as a Chrome trace (portable C)
+#ifndef SIMPROFILE_H
+#define SIMPROFILE_H
+
+#include "SimTypes.h"
+#include <stdint.h>
+
+// Built with -DFPS_PROFILE, zones and counters are recorded into a ring buffer per thread -
+// no locks, the owning thread is the only writer - that keeps the last
+// SIM_PROFILE_RING_EVENTS events of each thread, so a long-running server can be dumped
+// at any time. Without FPS_PROFILE every macro compiles to nothing and
+// simProfileWriteChromeTrace only reports that profiling is off.
+//
+// Zone and counter names must be string literals (or otherwise outlive the process).
+// Open the written file in chrome://tracing or https://ui.perfetto.dev.
+
+enum { SIM_PROFILE_RING_EVENTS = 1 << 16 };
+
+typedef enum {
+    SimCounterRaysCast = 0,         // Raycasts and line-of-sight queries
+    SimCounterShapesTested,         // Shapes a collision query tested against
+    SimCounterPacketsSent,
+    SimCounterPacketsReceived,
+    SimCounterBotsMoved,
+    SimCounterPathsSearched,        // A* searches run (path cache misses)
+    SimCounterBotThinks,            // Bot perception and behaviour updates (SimBotSchedule)
+    SimCounterBotThinksDeferred,    // Bots due to think, put off by the think budget
+    SimCounterSightChecks,          // Bot line-of-sight checks asked for (SimBotPerception)
+    SimCounterSightReused,          // Of those, answered from the bot's last trace
+    SIM_COUNTER_COUNT
+} SimCounter;
+
+typedef struct {
+    const char *name;
+    uint64_t start;                 // Nanoseconds
+} SimProfileZone;
+
+SimProfileZone simProfileZoneBegin(const char *name);
+void simProfileZoneEnd(SimProfileZone *zone);
+void simProfileCount(SimCounter counter, int amount);
+
+// Name the calling thread in the trace
+void simProfileSetThreadName(const char *name);
+
+// Close a frame (a tick): record every counter's total over all threads since the last mark.
+// Call from one thread only - the one running the ticks.
+void simProfileFrameMark(void);
+
+// Write every thread's ring as Chrome trace JSON. Safe while other threads keep recording;
+// events they overwrite during the dump are left out. Returns NO if the file can't be
+// written or profiling isn't compiled in.
+BOOL simProfileWriteChromeTrace(const char *path);
+
+#ifdef FPS_PROFILE
+
+#define SIM_PROFILE_CONCAT_(a, b) a##b
+#define SIM_PROFILE_CONCAT(a, b) SIM_PROFILE_CONCAT_(a, b)
+
+// Time from here to the end of the enclosing block
+#define SIM_PROFILE_ZONE(name) \
+    SimProfileZone SIM_PROFILE_CONCAT(simProfileZone_, __LINE__) \
+        __attribute__((cleanup(simProfileZoneEnd), unused)) = simProfileZoneBegin(name)
+
+// Time a span that isn't a block of its own
+#define SIM_PROFILE_BEGIN(zone, name) SimProfileZone zone = simProfileZoneBegin(name)
+#define SIM_PROFILE_END(zone) simProfileZoneEnd(&(zone))
+
+#define SIM_PROFILE_COUNT(counter, amount) simProfileCount((counter), (amount))
+#define SIM_PROFILE_THREAD_NAME(name) simProfileSetThreadName(name)
+#define SIM_PROFILE_FRAME() simProfileFrameMark()
+
+#else
+
+#define SIM_PROFILE_ZONE(name) do {} while (0)
+#define SIM_PROFILE_BEGIN(zone, name) do {} while (0)
+#define SIM_PROFILE_END(zone) do {} while (0)
+#define SIM_PROFILE_COUNT(counter, amount) do {} while (0)
+#define SIM_PROFILE_THREAD_NAME(name) do {} while (0)
+#define SIM_PROFILE_FRAME() do {} while (0)
+
+#endif // FPS_PROFILE
+
+#endif // SIMPROFILE_H
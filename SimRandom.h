@@ -0,0 +1,77 @@
+// SimRandom.h - Seeded random number streams for the simulation (xoshiro128**)
+#ifndef SIMRANDOM_H
+#define SIMRANDOM_H
+
+#include <stdint.h>
+
+// Every source of gameplay randomness owns its own stream, derived from the match seed
+// and a stream id, so a tick depends only on the seed and the inputs - never on how many
+// numbers some other system drew, or on which thread asked first.
+typedef struct {
+    uint32_t s[4];
+} SimRng;
+
+// Stream kinds - a stream id is the kind in the top 8 bits and the player or bot index in
+// the low 24, so no count of bots or players can run one kind into the next
+typedef enum {
+    SimRngStreamWorld = 0,          // Spawn picking
+    SimRngStreamPlayer,             // Per player: weapon spread
+    SimRngStreamBot,                // Per bot: decisions, fire timing, aim
+    SimRngStreamCombatant,          // Per player: AI-controlled player decisions and aim
+} SimRngStream;
+
+static const uint32_t SIM_RNG_STREAM_INDEX_MASK = 0xFFFFFFu;
+
+static inline uint32_t simRngStreamId(SimRngStream kind, uint32_t index) {
+    return ((uint32_t)kind << 24) | (index & SIM_RNG_STREAM_INDEX_MASK);
+}
+
+static const uint64_t SIM_DEFAULT_SEED = 0x46505341u;  // "FPSA"
+
+static inline uint64_t simSplitMix64(uint64_t *x) {
+    uint64_t z = (*x += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+// Independent stream for (seed, stream id) - the state is never all zero
+static inline void simRngSeed(SimRng *rng, uint64_t seed, uint32_t stream) {
+    uint64_t x = seed ^ ((uint64_t)stream * 0xD1B54A32D192ED03ull);
+    uint64_t a = simSplitMix64(&x);
+    uint64_t b = simSplitMix64(&x);
+    rng->s[0] = (uint32_t)a;
+    rng->s[1] = (uint32_t)(a >> 32);
+    rng->s[2] = (uint32_t)b;
+    rng->s[3] = (uint32_t)(b >> 32) | 1u;
+}
+
+static inline uint32_t simRotl32(uint32_t x, int k) {
+    return (x << k) | (x >> (32 - k));
+}
+
+static inline uint32_t simRngNext(SimRng *rng) {
+    uint32_t *s = rng->s;
+    uint32_t result = simRotl32(s[1] * 5, 7) * 9;
+    uint32_t t = s[1] << 9;
+
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = simRotl32(s[3], 11);
+    return result;
+}
+
+// Uniform in [0, 1)
+static inline float simRngFloat(SimRng *rng) {
+    return (float)(simRngNext(rng) >> 8) * (1.0f / 16777216.0f);
+}
+
+// Uniform in [0, n) for n > 0
+static inline int simRngRange(SimRng *rng, int n) {
+    return (int)(((uint64_t)simRngNext(rng) * (uint32_t)n) >> 32);
+}
+
+#endif // SIMRANDOM_H
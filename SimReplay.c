@@ -0,0 +1,609 @@
+// SimReplay.c - Match recording and headless re-simulation
+#include "SimReplay.h"
+#include "SimSnapshot.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+
+// Keyframe record: tag, frame, forced flag, then the world's bytes
+enum { KEYFRAME_RECORD_HEADER_SIZE = 1 + 4 + 1 };
+enum { PLAYER_RECORD_SIZE = 1 + 1 + sizeof(SimPlayer) };
+
+// Copy of the world without its handles into the collision world and job system, which
+// belong to whichever process is running it rather than to the simulation
+static void normalizedCopy(SimWorld *out, const SimWorld *world) {
+    memcpy(out, world, world->size);
+    out->collision = NULL;
+    out->jobs = NULL;
+    out->doorShapeId = -1;
+}
+
+static uint64_t hashBytes(uint64_t hash, const void *data, size_t size) {
+    const unsigned char *bytes = data;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+uint64_t simReplayWorldHash(const SimWorld *world) {
+    // The struct without its handles, then the bot arrays after it
+    SimWorld head;
+    memcpy(&head, world, sizeof(head));
+    head.collision = NULL;
+    head.jobs = NULL;
+    head.doorShapeId = -1;
+
+    uint64_t hash = hashBytes(0xcbf29ce484222325ull, &head, sizeof(head));
+    return hashBytes(hash, (const unsigned char *)world + sizeof(head), world->size - sizeof(head));
+}
+
+static void resetInputs(SimInput *inputs) {
+    memset(inputs, 0, sizeof(SimInput) * SIM_MAX_PLAYERS);
+    for (int p = 0; p < SIM_MAX_PLAYERS; p++) {
+        inputs[p].weaponSlot = -1;
+    }
+}
+
+// ============================================
+// RECORDING
+// ============================================
+
+struct SimReplayWriter {
+    FILE *file;
+    uint64_t offset;
+    BOOL ok;
+    int keyframeInterval;
+    uint32_t frame;
+
+    // World after the last recorded step - anything different next frame was changed outside simStep
+    size_t worldSize;
+    SimWorld *snapshot;
+    SimWorld *scratch;
+    BOOL haveSnapshot;
+
+    SimInput lastInputs[SIM_MAX_PLAYERS];   // Decoding state, restarted at every keyframe
+
+    ReplayIndexEntry *index;
+    int indexCount;
+    int indexCapacity;
+};
+
+static void writeBytes(SimReplayWriter *writer, const void *data, size_t size) {
+    if (writer->ok && fwrite(data, 1, size, writer->file) != size) {
+        writer->ok = NO;
+    }
+    writer->offset += size;
+}
+
+static void writeU8(SimReplayWriter *writer, uint8_t value) {
+    writeBytes(writer, &value, sizeof(value));
+}
+
+static void writeKeyframe(SimReplayWriter *writer, const SimWorld *world, BOOL forced) {
+    if (writer->indexCount == writer->indexCapacity) {
+        int capacity = writer->indexCapacity ? writer->indexCapacity * 2 : 64;
+        ReplayIndexEntry *index = realloc(writer->index, sizeof(ReplayIndexEntry) * (size_t)capacity);
+        if (!index) {
+            writer->ok = NO;
+            return;
+        }
+        writer->index = index;
+        writer->indexCapacity = capacity;
+    }
+    ReplayIndexEntry *entry = &writer->index[writer->indexCount++];
+    entry->frame = writer->frame;
+    entry->reserved = 0;
+    entry->offset = writer->offset;
+
+    writeU8(writer, ReplayRecordKeyframe);
+    writeBytes(writer, &writer->frame, sizeof(writer->frame));
+    writeU8(writer, forced ? 1 : 0);
+    writeBytes(writer, world, world->size);
+
+    resetInputs(writer->lastInputs);
+}
+
+static void writeTick(SimReplayWriter *writer, const SimWorld *world, const SimInput *inputs) {
+    uint8_t count = 0;
+    if (inputs) {
+        for (int p = 0; p < world->playerCount; p++) {
+            if (!world->players[p].isRemote) count++;
+        }
+    }
+
+    writeU8(writer, ReplayRecordTick);
+    writeU8(writer, count);
+    if (count == 0) return;
+
+    for (int p = 0; p < world->playerCount; p++) {
+        if (world->players[p].isRemote) continue;
+
+        const SimInput *input = &inputs[p];
+        SimInput *last = &writer->lastInputs[p];
+        uint8_t flags = input->active ? ReplayInputActive : 0;
+        if (input->buttons != last->buttons) flags |= ReplayInputButtons;
+        if (input->weaponSlot >= 0) flags |= ReplayInputWeapon;
+        if (memcmp(&input->yaw, &last->yaw, sizeof(float)) != 0 ||
+            memcmp(&input->pitch, &last->pitch, sizeof(float)) != 0) {
+            flags |= ReplayInputLook;
+        }
+
+        writeU8(writer, (uint8_t)p);
+        writeU8(writer, flags);
+        if (flags & ReplayInputButtons) {
+            uint16_t buttons = (uint16_t)input->buttons;
+            writeBytes(writer, &buttons, sizeof(buttons));
+        }
+        if (flags & ReplayInputWeapon) {
+            int8_t slot = (int8_t)input->weaponSlot;
+            writeBytes(writer, &slot, sizeof(slot));
+        }
+        if (flags & ReplayInputLook) {
+            writeBytes(writer, &input->yaw, sizeof(float));
+            writeBytes(writer, &input->pitch, sizeof(float));
+        }
+
+        last->buttons = input->buttons;
+        last->yaw = input->yaw;
+        last->pitch = input->pitch;
+    }
+}
+
+static void freeWriter(SimReplayWriter *writer) {
+    free(writer->index);
+    free(writer->snapshot);
+    free(writer->scratch);
+    free(writer);
+}
+
+SimReplayWriter *simReplayWriterOpen(const char *path, const SimWorld *world, int keyframeInterval) {
+    SimReplayWriter *writer = calloc(1, sizeof(SimReplayWriter));
+    if (!writer) return NULL;
+
+    writer->worldSize = world->size;
+    writer->snapshot = malloc(world->size);
+    writer->scratch = malloc(world->size);
+    if (!writer->snapshot || !writer->scratch) {
+        freeWriter(writer);
+        return NULL;
+    }
+
+    writer->file = fopen(path, "wb");
+    if (!writer->file) {
+        fprintf(stderr, "[REPLAY] Failed to create %s\n", path);
+        freeWriter(writer);
+        return NULL;
+    }
+    writer->ok = YES;
+    writer->keyframeInterval = keyframeInterval > 0 ? keyframeInterval : REPLAY_DEFAULT_KEYFRAME_INTERVAL;
+
+    ReplayHeader header;
+    memset(&header, 0, sizeof(header));
+    header.magic = REPLAY_MAGIC;
+    header.version = REPLAY_VERSION;
+    header.endianTag = REPLAY_ENDIAN_TAG;
+    header.worldSize = (uint32_t)world->size;
+    header.playerSize = sizeof(SimPlayer);
+    header.botCapacity = (uint32_t)world->botPool.capacity;
+    header.keyframeInterval = (uint32_t)writer->keyframeInterval;
+    header.seed = world->seed;
+    writeBytes(writer, &header, sizeof(header));
+
+    resetInputs(writer->lastInputs);
+    return writer;
+}
+
+BOOL simReplayWriterStep(SimReplayWriter *writer, SimWorld *world, const SimInput *inputs) {
+    if (world->size != writer->worldSize) {
+        writer->ok = NO;
+        return NO;
+    }
+
+    SimWorld *current = writer->scratch;
+    normalizedCopy(current, world);
+
+    BOOL keyframe = !writer->haveSnapshot || writer->frame % (uint32_t)writer->keyframeInterval == 0;
+    BOOL forced = NO;
+    BOOL playerChanged[SIM_MAX_PLAYERS] = {NO};
+
+    if (writer->haveSnapshot) {
+        // Players changed from outside become player records; any other change needs a keyframe
+        if (current->playerCount == writer->snapshot->playerCount) {
+            for (int p = 0; p < current->playerCount; p++) {
+                if (memcmp(&current->players[p], &writer->snapshot->players[p], sizeof(SimPlayer)) != 0) {
+                    playerChanged[p] = YES;
+                    memcpy(&writer->snapshot->players[p], &current->players[p], sizeof(SimPlayer));
+                }
+            }
+        }
+        if (memcmp(current, writer->snapshot, writer->worldSize) != 0) {
+            forced = YES;
+            keyframe = YES;
+        }
+    }
+
+    if (keyframe) {
+        writeKeyframe(writer, current, forced);
+    } else {
+        for (int p = 0; p < current->playerCount; p++) {
+            if (!playerChanged[p]) continue;
+            writeU8(writer, ReplayRecordPlayer);
+            writeU8(writer, (uint8_t)p);
+            writeBytes(writer, &current->players[p], sizeof(SimPlayer));
+        }
+    }
+    writeTick(writer, current, inputs);
+
+    simStep(world, inputs);
+
+    normalizedCopy(writer->snapshot, world);
+    writer->haveSnapshot = YES;
+    writer->frame++;
+    return writer->ok;
+}
+
+BOOL simReplayWriterClose(SimReplayWriter *writer) {
+    if (!writer) return NO;
+
+    ReplayTrailer trailer;
+    memset(&trailer, 0, sizeof(trailer));
+    trailer.indexOffset = writer->offset;
+    trailer.keyframeCount = (uint32_t)writer->indexCount;
+    trailer.frameCount = writer->frame;
+    trailer.magic = REPLAY_MAGIC;
+
+    if (writer->indexCount > 0) {
+        writeBytes(writer, writer->index, sizeof(ReplayIndexEntry) * (size_t)writer->indexCount);
+    }
+    writeBytes(writer, &trailer, sizeof(trailer));
+
+    BOOL ok = writer->ok;
+    if (fclose(writer->file) != 0) ok = NO;
+    if (!ok) fprintf(stderr, "[REPLAY] Failed to write replay\n");
+
+    freeWriter(writer);
+    return ok;
+}
+
+// ============================================
+// PLAYBACK
+// ============================================
+
+struct SimReplayReader {
+    uint8_t *data;
+    size_t size;
+    ReplayHeader header;
+    size_t recordsEnd;          // Index offset, or the end of the last whole record
+    SimWorld *scratch;          // A keyframe's world, copied out of the file aligned
+
+    ReplayIndexEntry *index;
+    int keyframeCount;
+    int frameCount;
+
+    size_t cursor;
+    int frame;
+    BOOL started;               // The world holds re-simulated state that keyframes can be checked against
+    int desyncFrame;
+    SimInput lastInputs[SIM_MAX_PLAYERS];
+};
+
+// Size of the record at pos, or 0 if it is unknown or runs past end
+static size_t recordSize(const SimReplayReader *reader, size_t pos, size_t end) {
+    const uint8_t *data = reader->data;
+    if (pos >= end) return 0;
+
+    size_t size = 0;
+    switch (data[pos]) {
+        case ReplayRecordKeyframe:
+            size = KEYFRAME_RECORD_HEADER_SIZE + reader->header.worldSize;
+            break;
+
+        case ReplayRecordPlayer:
+            size = PLAYER_RECORD_SIZE;
+            break;
+
+        case ReplayRecordTick: {
+            if (pos + 2 > end) return 0;
+            size = 2;
+            int count = data[pos + 1];
+            for (int i = 0; i < count; i++) {
+                if (pos + size + 2 > end) return 0;
+                uint8_t flags = data[pos + size + 1];
+                size += 2;
+                if (flags & ReplayInputButtons) size += sizeof(uint16_t);
+                if (flags & ReplayInputWeapon) size += sizeof(int8_t);
+                if (flags & ReplayInputLook) size += 2 * sizeof(float);
+            }
+            break;
+        }
+
+        default:
+            return 0;
+    }
+    return pos + size <= end ? size : 0;
+}
+
+// Index a recording that has no trailer - everything up to the first partial record
+static BOOL scanRecords(SimReplayReader *reader) {
+    size_t pos = sizeof(ReplayHeader);
+    int capacity = 0;
+
+    for (;;) {
+        size_t size = recordSize(reader, pos, reader->size);
+        if (size == 0) break;
+
+        uint8_t type = reader->data[pos];
+        if (type == ReplayRecordKeyframe) {
+            if (reader->keyframeCount == capacity) {
+                capacity = capacity ? capacity * 2 : 64;
+                ReplayIndexEntry *index = realloc(reader->index, sizeof(ReplayIndexEntry) * (size_t)capacity);
+                if (!index) return NO;
+                reader->index = index;
+            }
+            ReplayIndexEntry *entry = &reader->index[reader->keyframeCount++];
+            memcpy(&entry->frame, reader->data + pos + 1, sizeof(entry->frame));
+            entry->reserved = 0;
+            entry->offset = pos;
+        } else if (type == ReplayRecordTick) {
+            reader->frameCount++;
+        }
+        pos += size;
+    }
+
+    reader->recordsEnd = pos;
+    return YES;
+}
+
+// Use the index from a cleanly closed recording, if there is one that fits the file
+static BOOL readTrailer(SimReplayReader *reader) {
+    if (reader->size < sizeof(ReplayHeader) + sizeof(ReplayTrailer)) return NO;
+
+    ReplayTrailer trailer;
+    memcpy(&trailer, reader->data + reader->size - sizeof(trailer), sizeof(trailer));
+    if (trailer.magic != REPLAY_MAGIC) return NO;
+
+    uint64_t indexBytes = (uint64_t)trailer.keyframeCount * sizeof(ReplayIndexEntry);
+    if (trailer.indexOffset < sizeof(ReplayHeader) ||
+        trailer.indexOffset + indexBytes + sizeof(trailer) != reader->size) {
+        return NO;
+    }
+
+    reader->index = malloc(indexBytes > 0 ? (size_t)indexBytes : 1);
+    if (!reader->index) return NO;
+    memcpy(reader->index, reader->data + trailer.indexOffset, (size_t)indexBytes);
+    reader->keyframeCount = (int)trailer.keyframeCount;
+    reader->frameCount = (int)trailer.frameCount;
+    reader->recordsEnd = (size_t)trailer.indexOffset;
+
+    // Every keyframe must be a keyframe record inside the records
+    for (int i = 0; i < reader->keyframeCount; i++) {
+        uint64_t offset = reader->index[i].offset;
+        if (offset + KEYFRAME_RECORD_HEADER_SIZE + reader->header.worldSize > reader->recordsEnd ||
+            reader->data[offset] != ReplayRecordKeyframe) {
+            free(reader->index);
+            reader->index = NULL;
+            reader->keyframeCount = 0;
+            reader->frameCount = 0;
+            return NO;
+        }
+    }
+    return YES;
+}
+
+SimReplayReader *simReplayReaderOpen(const char *path) {
+    FILE *file = fopen(path, "rb");
+    if (!file) {
+        fprintf(stderr, "[REPLAY] Can't open %s\n", path);
+        return NULL;
+    }
+
+    SimReplayReader *reader = calloc(1, sizeof(SimReplayReader));
+    long size = -1;
+    if (reader && fseek(file, 0, SEEK_END) == 0) size = ftell(file);
+    if (size >= (long)sizeof(ReplayHeader) && fseek(file, 0, SEEK_SET) == 0) {
+        reader->data = malloc((size_t)size);
+        reader->size = (size_t)size;
+    }
+    BOOL ok = reader && reader->data && fread(reader->data, 1, reader->size, file) == reader->size;
+    fclose(file);
+
+    if (ok) {
+        memcpy(&reader->header, reader->data, sizeof(reader->header));
+        ok = reader->header.magic == REPLAY_MAGIC &&
+             reader->header.version == REPLAY_VERSION &&
+             reader->header.endianTag == REPLAY_ENDIAN_TAG &&
+             reader->header.botCapacity <= INT_MAX &&
+             reader->header.worldSize == simWorldSizeForBots((int)reader->header.botCapacity) &&
+             reader->header.playerSize == sizeof(SimPlayer);
+        if (!ok) fprintf(stderr, "[REPLAY] %s is not a replay of this simulation build\n", path);
+    }
+    if (ok) {
+        reader->scratch = malloc(reader->header.worldSize);
+        ok = reader->scratch != NULL;
+    }
+    if (ok && !readTrailer(reader)) {
+        ok = scanRecords(reader);
+        if (ok) fprintf(stderr, "[REPLAY] %s was not closed - recovered %d frames\n", path, reader->frameCount);
+    }
+    if (ok && reader->keyframeCount == 0) {
+        fprintf(stderr, "[REPLAY] %s has no keyframes\n", path);
+        ok = NO;
+    }
+    if (!ok) {
+        simReplayReaderClose(reader);
+        return NULL;
+    }
+
+    reader->cursor = (size_t)reader->index[0].offset;
+    reader->frame = (int)reader->index[0].frame;
+    reader->desyncFrame = -1;
+    resetInputs(reader->lastInputs);
+    return reader;
+}
+
+void simReplayReaderClose(SimReplayReader *reader) {
+    if (!reader) return;
+    free(reader->index);
+    free(reader->data);
+    free(reader->scratch);
+    free(reader);
+}
+
+int simReplayFrameCount(const SimReplayReader *reader) {
+    return reader->frameCount;
+}
+
+int simReplayKeyframeCount(const SimReplayReader *reader) {
+    return reader->keyframeCount;
+}
+
+uint64_t simReplaySeed(const SimReplayReader *reader) {
+    return reader->header.seed;
+}
+
+int simReplayBotCapacity(const SimReplayReader *reader) {
+    return (int)reader->header.botCapacity;
+}
+
+int simReplayFrame(const SimReplayReader *reader) {
+    return reader->frame;
+}
+
+int simReplayDesyncFrame(const SimReplayReader *reader) {
+    return reader->desyncFrame;
+}
+
+// Load a keyframe into world, keeping world's own collision handles
+static void applyKeyframe(SimReplayReader *reader, SimWorld *world, const uint8_t *record) {
+    uint32_t frame;
+    memcpy(&frame, record + 1, sizeof(frame));
+    BOOL forced = record[5] != 0;
+    const uint8_t *worldBytes = record + KEYFRAME_RECORD_HEADER_SIZE;
+
+    // A periodic keyframe is exactly what the recording's simulation reached - compare ours
+    if (reader->started && !forced && reader->desyncFrame < 0) {
+        normalizedCopy(reader->scratch, world);
+        if (memcmp(reader->scratch, worldBytes, world->size) != 0) {
+            reader->desyncFrame = (int)frame;
+        }
+    }
+
+    memcpy(reader->scratch, worldBytes, reader->header.worldSize);
+    simSnapshotLoad(world, reader->scratch);
+
+    reader->frame = (int)frame;
+    reader->started = YES;
+    resetInputs(reader->lastInputs);
+}
+
+// Decode a tick record into inputs. Returns NO when the record carries no inputs.
+static BOOL decodeTick(SimReplayReader *reader, const uint8_t *record, SimInput *inputs) {
+    int count = record[1];
+    const uint8_t *p = record + 2;
+
+    for (int i = 0; i < count; i++) {
+        int player = p[0];
+        uint8_t flags = p[1];
+        p += 2;
+        if (player >= SIM_MAX_PLAYERS) continue;
+
+        SimInput *last = &reader->lastInputs[player];
+        SimInput *input = &inputs[player];
+        input->active = (flags & ReplayInputActive) != 0;
+        input->buttons = last->buttons;
+        input->weaponSlot = -1;
+        input->yaw = last->yaw;
+        input->pitch = last->pitch;
+
+        if (flags & ReplayInputButtons) {
+            uint16_t buttons;
+            memcpy(&buttons, p, sizeof(buttons));
+            input->buttons = buttons;
+            p += sizeof(buttons);
+        }
+        if (flags & ReplayInputWeapon) {
+            input->weaponSlot = (int8_t)p[0];
+            p += sizeof(int8_t);
+        }
+        if (flags & ReplayInputLook) {
+            memcpy(&input->yaw, p, sizeof(float));
+            memcpy(&input->pitch, p + sizeof(float), sizeof(float));
+            p += 2 * sizeof(float);
+        }
+
+        last->buttons = input->buttons;
+        last->yaw = input->yaw;
+        last->pitch = input->pitch;
+    }
+    return count > 0;
+}
+
+BOOL simReplayStep(SimReplayReader *reader, SimWorld *world) {
+    if (world->size != reader->header.worldSize) return NO;
+
+    for (;;) {
+        size_t size = recordSize(reader, reader->cursor, reader->recordsEnd);
+        if (size == 0) return NO;
+
+        const uint8_t *record = reader->data + reader->cursor;
+        reader->cursor += size;
+
+        switch (record[0]) {
+            case ReplayRecordKeyframe:
+                applyKeyframe(reader, world, record);
+                break;
+
+            case ReplayRecordPlayer:
+                if (reader->started && record[1] < SIM_MAX_PLAYERS) {
+                    memcpy(&world->players[record[1]], record + 2, sizeof(SimPlayer));
+                }
+                break;
+
+            case ReplayRecordTick: {
+                SimInput inputs[SIM_MAX_PLAYERS];
+                resetInputs(inputs);
+                BOOL hasInputs = decodeTick(reader, record, inputs);
+                simStep(world, hasInputs ? inputs : NULL);
+                reader->frame++;
+                return YES;
+            }
+        }
+    }
+}
+
+BOOL simReplaySeek(SimReplayReader *reader, SimWorld *world, int frame) {
+    if (frame < 0 || frame > reader->frameCount) return NO;
+    if (world->size != reader->header.worldSize) return NO;
+
+    // Last keyframe at or before frame
+    int lo = 0;
+    int hi = reader->keyframeCount - 1;
+    if ((int)reader->index[0].frame > frame) return NO;
+    while (lo < hi) {
+        int mid = (lo + hi + 1) / 2;
+        if ((int)reader->index[mid].frame <= frame) {
+            lo = mid;
+        } else {
+            hi = mid - 1;
+        }
+    }
+
+    // Playing forward from here is cheaper than going back to a keyframe
+    BOOL ahead = reader->started && reader->frame <= frame && reader->frame >= (int)reader->index[lo].frame;
+    if (!ahead) {
+        reader->cursor = (size_t)reader->index[lo].offset;
+        reader->started = NO;
+        size_t size = recordSize(reader, reader->cursor, reader->recordsEnd);
+        if (size == 0) return NO;
+        applyKeyframe(reader, world, reader->data + reader->cursor);
+        reader->cursor += size;
+    }
+
+    while (reader->frame < frame) {
+        if (!simReplayStep(reader, world)) return NO;
+    }
+    return YES;
+}
@@ -0,0 +1,123 @@
+// SimReplay.h - Match recording (seed, per-tick inputs, keyframes) and headless re-simulation
+#ifndef SIMREPLAY_H
+#define SIMREPLAY_H
+
+#include "SimWorld.h"
+#include <stdint.h>
+
+// 'FPRP' - first four bytes of every replay file
+#define REPLAY_MAGIC 0x50525046u
+#define REPLAY_VERSION 3
+
+// Written as-is; a replay only plays back on a machine with the same byte order
+#define REPLAY_ENDIAN_TAG 0x01020304u
+
+// Periodic keyframe spacing - 10 seconds at 60 ticks/s
+#define REPLAY_DEFAULT_KEYFRAME_INTERVAL 600
+
+// ============================================
+// FILE LAYOUT
+// ============================================
+//
+// ReplayHeader, then one block per recorded frame:
+//   [keyframe | player records]  tick record
+// and, when the recording was closed cleanly, the keyframe index and a trailer.
+//
+// A keyframe is the whole world (the world's raw bytes, bots included) and starts every keyframe interval,
+// or any frame where something outside simStep changed more than the players
+// (a game reset, bots reinitialised). Changes confined to players - network proxies,
+// respawn teleports, damage from the network - are player records instead. A tick record
+// holds the inputs of every player simStep moves, each only as far as it changed.
+
+typedef enum {
+    ReplayRecordKeyframe = 'K',     // uint32 frame, uint8 forced, world (worldSize bytes)
+    ReplayRecordPlayer = 'P',       // uint8 player index, SimPlayer
+    ReplayRecordTick = 'T',         // uint8 count, count x (uint8 player, uint8 ReplayInputFlags, fields)
+} ReplayRecordType;
+
+typedef enum {
+    ReplayInputActive = 1 << 0,
+    ReplayInputButtons = 1 << 1,    // uint16 buttons follow, else as last tick
+    ReplayInputWeapon = 1 << 2,     // int8 weapon slot follows, else none
+    ReplayInputLook = 1 << 3,       // float yaw, float pitch follow, else as last tick
+} ReplayInputFlags;
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t endianTag;
+    uint32_t worldSize;             // World bytes and sizeof(SimPlayer) - a layout change
+    uint32_t playerSize;            // makes old replays unreadable rather than wrong
+    uint32_t keyframeInterval;
+    uint32_t botCapacity;           // Bot slots of the recorded world
+    uint32_t reserved;
+    uint64_t seed;                  // Match seed when recording started
+} ReplayHeader;
+
+typedef struct {
+    uint32_t frame;
+    uint32_t reserved;
+    uint64_t offset;                // Of the keyframe record, from the start of the file
+} ReplayIndexEntry;
+
+// Last bytes of a cleanly closed replay
+typedef struct {
+    uint64_t indexOffset;
+    uint32_t keyframeCount;
+    uint32_t frameCount;
+    uint32_t magic;                 // REPLAY_MAGIC again
+    uint32_t reserved;
+} ReplayTrailer;
+
+// ============================================
+// RECORDING
+// ============================================
+
+typedef struct SimReplayWriter SimReplayWriter;
+
+// Start recording world to path. Returns NULL if the file can't be created.
+SimReplayWriter *simReplayWriterOpen(const char *path, const SimWorld *world, int keyframeInterval);
+
+// Record this frame's inputs and any changes made since the last frame, then simStep
+BOOL simReplayWriterStep(SimReplayWriter *writer, SimWorld *world, const SimInput *inputs);
+
+// Write the keyframe index and close. Returns NO if any write failed.
+BOOL simReplayWriterClose(SimReplayWriter *writer);
+
+// ============================================
+// PLAYBACK
+// ============================================
+
+typedef struct SimReplayReader SimReplayReader;
+
+// Load a replay. A recording that was never closed (crash) is indexed by scanning it.
+// Returns NULL if the file is missing, from another world layout or malformed.
+SimReplayReader *simReplayReaderOpen(const char *path);
+void simReplayReaderClose(SimReplayReader *reader);
+
+int simReplayFrameCount(const SimReplayReader *reader);
+int simReplayKeyframeCount(const SimReplayReader *reader);
+uint64_t simReplaySeed(const SimReplayReader *reader);
+
+// Bot slots the recording was made with - play it into a world created with as many
+int simReplayBotCapacity(const SimReplayReader *reader);
+
+// Next frame to play
+int simReplayFrame(const SimReplayReader *reader);
+
+// Jump to a frame - loads the nearest keyframe at or before it and re-simulates the rest.
+// world must be over the same map as the recording, with the same bot capacity;
+// its own collision handles are kept.
+BOOL simReplaySeek(SimReplayReader *reader, SimWorld *world, int frame);
+
+// Play one frame. Returns NO at the end of the recording.
+BOOL simReplayStep(SimReplayReader *reader, SimWorld *world);
+
+// First frame whose periodic keyframe differed from the re-simulated world, or -1.
+// A difference means the simulation no longer matches the one that recorded the match.
+int simReplayDesyncFrame(const SimReplayReader *reader);
+
+// FNV-1a over all simulation state (not the collision handles) - equal worlds hash equal
+uint64_t simReplayWorldHash(const SimWorld *world);
+
+#endif // SIMREPLAY_H
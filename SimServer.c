@@ -0,0 +1,839 @@
+// SimServer.c - Dedicated server: simulates the match at a fixed tick from its clients' inputs,
+// with no window, GPU or audio
+//
+// Usage: FPSServer [port] [name]
+// Speaks the same protocol as a hosting game client (NetworkManager), so players join it from the
+// lobby like any other host. The server is player 1 but has no avatar; up to NET_MAX_PLAYERS clients
+// get ids from 2, and each occupies the SimWorld player slot of the same index.
+//
+// Authoritative: ConnectAccept says so, and clients send their controls (PacketTypeInput) instead
+// of their position. Inputs queue per client and every tick runs each player's next one - one
+// tick per input, as on the client - so a client whose input hasn't arrived stays put. Movement,
+// shots (traced with simCollisionRaycast), damage, kills, respawns and the win check all happen
+// here. Every player's state then goes to all clients with the sequence of the input its tick ran
+// - the owner corrects its predicted position from it - and hits, kills and respawns go out over
+// TCP. Clients' own hit and kill reports are ignored.
+//
+// Built with -DFPS_PROFILE, SIGUSR1 writes a Chrome trace of the recent ticks to FPS_TRACE
+// (default fps_server_trace.json), and so does shutting down when FPS_TRACE is set.
+#include "SimWorld.h"
+#include "SimProfile.h"
+#include "NetProtocol.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <errno.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+
+_Static_assert(NET_MAX_PLAYERS <= SIM_MAX_PLAYERS, "every client needs a SimWorld player slot");
+
+enum {
+    MATCH_RESTART_DELAY = 300,  // 5 seconds at 60 ticks/s between a win and the next match
+    MAX_TICKS_BEHIND = 5,       // Drop missed ticks instead of running them back to back
+    ONE_SHOT_BUTTONS = SimButtonFire | SimButtonReload | SimButtonUse,  // Kept when an input is dropped
+    INPUT_QUEUE_LENGTH = 16,    // Inputs a client may run ahead of the server - about a quarter second
+};
+static const double CLIENT_TIMEOUT = 10.0;  // Seconds without a packet before a client is dropped
+static const double STATUS_INTERVAL = 60.0;
+
+// ============================================
+// STATE
+// ============================================
+
+typedef struct {
+    BOOL active;                // Slot holds a TCP connection
+    BOOL joined;                // Sent its Connect packet
+    int tcpSocket;
+    struct sockaddr_in address;
+    uint16_t udpPort;           // Discovered from first UDP packet
+    uint32_t playerId;
+    char name[32];
+    uint32_t lastSequence;      // Newest input received
+    uint32_t inputSequence;     // Input the player's last tick ran, 0 before the first
+    double lastPacketTime;
+    SimInput input;             // Controls the player's last tick ran
+
+    // Inputs waiting for a tick, oldest first
+    SimInput queuedInputs[INPUT_QUEUE_LENGTH];
+    uint32_t queuedSequences[INPUT_QUEUE_LENGTH];
+    int queueHead;
+    int queueCount;
+
+    // TCP is a stream - messages may arrive split or several to a read
+    uint8_t recvBuffer[NET_MAX_PACKET_SIZE];
+    int recvLength;
+} ServerClient;
+
+typedef struct {
+    SimCollision *collision;
+    SimJobSystem *jobs;
+    SimWorld *world;
+    char name[32];
+
+    int udpSocket;
+    int tcpListenSocket;
+    int discoverySocket;
+    uint16_t port;
+
+    ServerClient clients[NET_MAX_PLAYERS];  // Index matches the SimWorld player slot
+    uint32_t sendSequence;
+    int matchRestartTimer;      // Counts down after a win, next match starts at 0
+    long droppedInputs;         // Oldest inputs dropped from full queues, since the last status line
+
+    uint8_t sendBuffer[NET_MAX_PACKET_SIZE];
+} Server;
+
+static volatile sig_atomic_t running = 1;
+static volatile sig_atomic_t traceRequested = 0;
+
+static void handleSignal(int sig) {
+    (void)sig;
+    running = 0;
+}
+
+static void handleTraceSignal(int sig) {
+    (void)sig;
+    traceRequested = 1;
+}
+
+static double nowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+// ============================================
+// SOCKETS
+// ============================================
+
+static void setSocketOptions(int sock, BOOL tcp) {
+    int opt = 1;
+    int flags = fcntl(sock, F_GETFL, 0);
+    if (flags >= 0) {
+        fcntl(sock, F_SETFL, flags | O_NONBLOCK);
+    }
+    setsockopt(sock, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
+    if (tcp) {
+        setsockopt(sock, IPPROTO_TCP, TCP_NODELAY, &opt, sizeof(opt));
+    }
+}
+
+static int createBoundSocket(int type, uint16_t port) {
+    int sock = socket(AF_INET, type, type == SOCK_STREAM ? IPPROTO_TCP : IPPROTO_UDP);
+    if (sock < 0) {
+        fprintf(stderr, "[SERVER] Failed to create socket: %s\n", strerror(errno));
+        return -1;
+    }
+    setSocketOptions(sock, type == SOCK_STREAM);
+
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = INADDR_ANY;
+    addr.sin_port = htons(port);
+
+    if (bind(sock, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+        fprintf(stderr, "[SERVER] Failed to bind port %d: %s\n", port, strerror(errno));
+        close(sock);
+        return -1;
+    }
+    return sock;
+}
+
+// Header + payload into the send buffer, returns the total length
+static size_t buildMessage(Server *server, const void *payload, size_t length) {
+    return netEncodeMessage(server->sendBuffer, sizeof(server->sendBuffer), payload, length);
+}
+
+static void sendTCP(Server *server, ServerClient *client, const void *payload, size_t length) {
+    if (!client->active) return;
+    size_t total = buildMessage(server, payload, length);
+    send(client->tcpSocket, server->sendBuffer, total, 0);
+    SIM_PROFILE_COUNT(SimCounterPacketsSent, 1);
+}
+
+// Reliable message to every joined client except one player id (0 for none)
+static void relayReliable(Server *server, const void *payload, size_t length, uint32_t excludeId) {
+    size_t total = buildMessage(server, payload, length);
+    for (int i = 0; i < NET_MAX_PLAYERS; i++) {
+        ServerClient *client = &server->clients[i];
+        if (client->joined && client->playerId != excludeId) {
+            send(client->tcpSocket, server->sendBuffer, total, 0);
+            SIM_PROFILE_COUNT(SimCounterPacketsSent, 1);
+        }
+    }
+}
+
+static GamePacket makeGamePacket(Server *server, PacketType type, uint32_t playerId) {
+    GamePacket packet;
+    memset(&packet, 0, sizeof(packet));
+    packet.packetType = (uint8_t)type;
+    packet.sequence = ++server->sendSequence;
+    packet.player.playerId = playerId;
+    return packet;
+}
+
+// ============================================
+// MATCH
+// ============================================
+
+static ServerClient *clientWithId(Server *server, uint32_t playerId) {
+    for (int i = 0; i < NET_MAX_PLAYERS; i++) {
+        if (server->clients[i].joined && server->clients[i].playerId == playerId) {
+            return &server->clients[i];
+        }
+    }
+    return NULL;
+}
+
+static int joinedCount(const Server *server) {
+    int count = 0;
+    for (int i = 0; i < NET_MAX_PLAYERS; i++) {
+        if (server->clients[i].joined) count++;
+    }
+    return count;
+}
+
+// Sync a player slot with its client - empty slots are dead players with no id that never respawn
+static void syncSlot(Server *server, int slot) {
+    ServerClient *client = &server->clients[slot];
+    SimPlayer *player = &server->world->players[slot];
+    player->playerId = client->joined ? (int)client->playerId : 0;
+    if (client->joined) {
+        simRevivePlayer(server->world, slot);
+    } else {
+        player->alive = NO;
+        player->health = 0;
+        player->respawnTimer = 0;
+    }
+}
+
+static void netStateFromPlayer(PlayerNetState *state, const SimPlayer *player) {
+    state->posX = player->position.x;
+    state->posY = player->position.y;
+    state->posZ = player->position.z;
+    state->camYaw = player->yaw;
+    state->camPitch = player->pitch;
+    state->isShooting = player->shooting ? 1 : 0;
+    state->health = player->alive ? player->health : 0;
+}
+
+static void startMatch(Server *server) {
+    SimWorld *world = server->world;
+    simResetForMultiplayer(world, NO);
+    for (int i = 0; i < NET_MAX_PLAYERS; i++) {
+        syncSlot(server, i);
+        if (server->clients[i].joined) {
+            simRespawnPlayer(world, i, simChooseSpawnPoint(world, i));
+        }
+    }
+    server->matchRestartTimer = 0;
+
+    // Clients reset scores and respawn on game start
+    GamePacket packet = makeGamePacket(server, PacketTypeGameStart, NET_HOST_PLAYER_ID);
+    relayReliable(server, &packet, sizeof(packet), 0);
+    fprintf(stderr, "[SERVER] Match started with %d players\n", joinedCount(server));
+}
+
+// ============================================
+// CONNECTIONS
+// ============================================
+
+static void disconnectClient(Server *server, ServerClient *client, const char *reason) {
+    if (!client->active) return;
+
+    uint32_t playerId = client->playerId;
+    BOOL wasJoined = client->joined;
+    fprintf(stderr, "[SERVER] Player %u (%s) %s\n", playerId, client->name[0] ? client->name : "?", reason);
+
+    close(client->tcpSocket);
+    memset(client, 0, sizeof(*client));
+    client->tcpSocket = -1;
+    syncSlot(server, (int)(client - server->clients));
+
+    // Notify other players so they drop the proxy
+    if (wasJoined) {
+        GamePacket packet = makeGamePacket(server, PacketTypeDisconnect, playerId);
+        relayReliable(server, &packet, sizeof(packet), playerId);
+    }
+}
+
+// Lowest free id from 2, so ids are reused after disconnects instead of growing
+static uint32_t freePlayerId(const Server *server) {
+    for (uint32_t id = NET_HOST_PLAYER_ID + 1; ; id++) {
+        BOOL used = NO;
+        for (int i = 0; i < NET_MAX_PLAYERS; i++) {
+            if (server->clients[i].active && server->clients[i].playerId == id) used = YES;
+        }
+        if (!used) return id;
+    }
+}
+
+static void acceptNewConnections(Server *server) {
+    struct sockaddr_in addr;
+    socklen_t addrLen = sizeof(addr);
+    int sock;
+
+    while ((sock = accept(server->tcpListenSocket, (struct sockaddr *)&addr, &addrLen)) >= 0) {
+        char addrStr[INET_ADDRSTRLEN];
+        inet_ntop(AF_INET, &addr.sin_addr, addrStr, sizeof(addrStr));
+
+        ServerClient *client = NULL;
+        for (int i = 0; i < NET_MAX_PLAYERS && !client; i++) {
+            if (!server->clients[i].active) client = &server->clients[i];
+        }
+        if (!client) {
+            fprintf(stderr, "[SERVER] Server full, refusing %s\n", addrStr);
+            close(sock);
+            addrLen = sizeof(addr);
+            continue;
+        }
+
+        setSocketOptions(sock, YES);
+        memset(client, 0, sizeof(*client));
+        client->active = YES;
+        client->tcpSocket = sock;
+        client->address = addr;
+        client->playerId = freePlayerId(server);
+        client->lastPacketTime = nowSeconds();
+        client->input.weaponSlot = -1;
+
+        ConnectionPacket response;
+        memset(&response, 0, sizeof(response));
+        response.packetType = PacketTypeConnectAccept;
+        response.playerId = client->playerId;
+        memcpy(response.playerName, server->name, sizeof(response.playerName));
+        response.hostFlags = NET_HOST_AUTHORITATIVE;
+        sendTCP(server, client, &response, sizeof(response));
+
+        fprintf(stderr, "[SERVER] New connection from %s, assigned player ID %u\n", addrStr, client->playerId);
+        addrLen = sizeof(addr);
+    }
+}
+
+static void removeStaleClients(Server *server) {
+    double now = nowSeconds();
+    for (int i = 0; i < NET_MAX_PLAYERS; i++) {
+        ServerClient *client = &server->clients[i];
+        if (client->active && now - client->lastPacketTime > CLIENT_TIMEOUT) {
+            disconnectClient(server, client, "timed out");
+        }
+    }
+}
+
+// ============================================
+// PACKET HANDLING
+// ============================================
+
+static void handleTCPMessage(Server *server, ServerClient *client, uint8_t *data, uint16_t length) {
+    if (length < 1) return;
+
+    switch (data[0]) {
+        case PacketTypeConnect:
+            if (length >= sizeof(ConnectionPacket) && !client->joined) {
+                ConnectionPacket *packet = (ConnectionPacket *)data;
+                memcpy(client->name, packet->playerName, sizeof(client->name) - 1);
+                client->name[sizeof(client->name) - 1] = '\0';
+                client->joined = YES;
+
+                int slot = (int)(client - server->clients);
+                syncSlot(server, slot);
+                server->world->players[slot].kills = 0;
+                simRespawnPlayer(server->world, slot, simChooseSpawnPoint(server->world, slot));
+                fprintf(stderr, "[SERVER] Player '%s' joined with ID %u (%d/%d)\n",
+                        client->name, client->playerId, joinedCount(server), NET_MAX_PLAYERS);
+
+                // There is no lobby host to press start - drop the player straight into the match
+                GamePacket start = makeGamePacket(server, PacketTypeGameStart, NET_HOST_PLAYER_ID);
+                sendTCP(server, client, &start, sizeof(start));
+            }
+            break;
+
+        case PacketTypeDisconnect:
+            disconnectClient(server, client, "disconnected");
+            break;
+
+        case PacketTypePing: {
+            uint8_t pong[1 + sizeof(uint32_t)];
+            uint32_t hostId = NET_HOST_PLAYER_ID;
+            pong[0] = PacketTypePong;
+            memcpy(pong + 1, &hostId, sizeof(hostId));
+            sendTCP(server, client, pong, sizeof(pong));
+            break;
+        }
+
+        default:
+            // Shots, hits, kills and respawns are decided here - clients' reports of them are ignored
+            break;
+    }
+}
+
+static void pollClient(Server *server, ServerClient *client) {
+    for (;;) {
+        ssize_t received = recv(client->tcpSocket, client->recvBuffer + client->recvLength,
+                                sizeof(client->recvBuffer) - (size_t)client->recvLength, 0);
+        if (received == 0 || (received < 0 && errno != EAGAIN && errno != EWOULDBLOCK)) {
+            disconnectClient(server, client, received == 0 ? "disconnected" : "dropped");
+            return;
+        }
+        if (received < 0) return;
+
+        client->recvLength += (int)received;
+        client->lastPacketTime = nowSeconds();
+
+        // Handle every complete message in the buffer
+        int offset = 0;
+        while (client->active && client->recvLength - offset >= (int)sizeof(PacketHeader)) {
+            int length = netDecodeHeader(client->recvBuffer + offset, (size_t)(client->recvLength - offset));
+            if (length < 0 || sizeof(PacketHeader) + (size_t)length > sizeof(client->recvBuffer)) {
+                disconnectClient(server, client, "sent a bad packet");
+                return;
+            }
+            if (client->recvLength - offset < (int)sizeof(PacketHeader) + length) break;
+
+            SIM_PROFILE_COUNT(SimCounterPacketsReceived, 1);
+            handleTCPMessage(server, client, client->recvBuffer + offset + sizeof(PacketHeader), (uint16_t)length);
+            offset += (int)sizeof(PacketHeader) + length;
+        }
+        if (!client->active) return;
+
+        memmove(client->recvBuffer, client->recvBuffer + offset, (size_t)(client->recvLength - offset));
+        client->recvLength -= offset;
+    }
+}
+
+// Queue an input for its own tick. A client a whole queue ahead loses its oldest input; the next
+// one takes over its one-shot buttons and weapon switch so presses aren't lost with it.
+static void queueInput(Server *server, ServerClient *client, const SimInput *input, uint32_t sequence) {
+    if (client->queueCount == INPUT_QUEUE_LENGTH) {
+        SimInput dropped = client->queuedInputs[client->queueHead];
+        client->queueHead = (client->queueHead + 1) % INPUT_QUEUE_LENGTH;
+        client->queueCount--;
+        server->droppedInputs++;
+
+        SimInput *next = &client->queuedInputs[client->queueHead];
+        next->buttons |= dropped.buttons & ONE_SHOT_BUTTONS;
+        if (next->weaponSlot < 0) next->weaponSlot = dropped.weaponSlot;
+    }
+
+    int tail = (client->queueHead + client->queueCount) % INPUT_QUEUE_LENGTH;
+    client->queuedInputs[tail] = *input;
+    client->queuedSequences[tail] = sequence;
+    client->queueCount++;
+}
+
+static void pollUDP(Server *server) {
+    uint8_t buffer[NET_MAX_PACKET_SIZE];
+    struct sockaddr_in addr;
+    socklen_t addrLen = sizeof(addr);
+    ssize_t received;
+
+    while ((received = recvfrom(server->udpSocket, buffer, sizeof(buffer), 0,
+                                (struct sockaddr *)&addr, &addrLen)) > 0) {
+        addrLen = sizeof(addr);
+        SIM_PROFILE_COUNT(SimCounterPacketsReceived, 1);
+        InputPacket packet;
+        if (!netDecodeInput(buffer, (size_t)received, &packet)) continue;
+        if (!isfinite(packet.yaw) || !isfinite(packet.pitch)) continue;
+
+        // Only the client's own machine may steer its player
+        ServerClient *client = clientWithId(server, packet.playerId);
+        if (!client || client->address.sin_addr.s_addr != addr.sin_addr.s_addr) continue;
+
+        if (client->udpPort == 0) {
+            client->udpPort = ntohs(addr.sin_port);
+            fprintf(stderr, "[SERVER] Discovered UDP port %d for player %u\n", client->udpPort, client->playerId);
+        }
+
+        // Only accept newer packets (handle sequence wrap-around)
+        int32_t seqDiff = (int32_t)(packet.sequence - client->lastSequence);
+        if (seqDiff <= 0 && seqDiff >= -1000000) continue;
+        client->lastSequence = packet.sequence;
+        client->lastPacketTime = nowSeconds();
+
+        SimInput input = {0};
+        input.buttons = packet.buttons;
+        input.weaponSlot = (packet.weaponSlot >= 0 && packet.weaponSlot < WeaponTypeCount) ? packet.weaponSlot : -1;
+        input.yaw = packet.yaw;
+        input.pitch = packet.pitch;
+        input.active = packet.active != 0;
+        queueInput(server, client, &input, packet.sequence);
+    }
+}
+
+static void pollDiscovery(Server *server) {
+    if (server->discoverySocket < 0) return;
+
+    uint8_t buffer[NET_MAX_PACKET_SIZE];
+    struct sockaddr_in addr;
+    socklen_t addrLen = sizeof(addr);
+    ssize_t received;
+
+    while ((received = recvfrom(server->discoverySocket, buffer, sizeof(buffer), 0,
+                                (struct sockaddr *)&addr, &addrLen)) > 0) {
+        addrLen = sizeof(addr);
+        SIM_PROFILE_COUNT(SimCounterPacketsReceived, 1);
+        if ((size_t)received < sizeof(PacketHeader) + 1 || netDecodeHeader(buffer, (size_t)received) < 0 ||
+            buffer[sizeof(PacketHeader)] != PacketTypeDiscovery) continue;
+
+        DiscoveryPacket response;
+        memset(&response, 0, sizeof(response));
+        response.packetType = PacketTypeDiscoveryResponse;
+        memcpy(response.serverName, server->name, sizeof(response.serverName));
+        response.currentPlayers = (uint8_t)joinedCount(server);
+        response.maxPlayers = NET_MAX_PLAYERS;
+        response.port = server->port;
+
+        size_t total = buildMessage(server, &response, sizeof(response));
+        addr.sin_port = htons(NET_DISCOVERY_PORT);
+        sendto(server->discoverySocket, server->sendBuffer, total, 0, (struct sockaddr *)&addr, sizeof(addr));
+        SIM_PROFILE_COUNT(SimCounterPacketsSent, 1);
+    }
+}
+
+// ============================================
+// SERVER
+// ============================================
+
+static BOOL serverStart(Server *server, uint16_t port) {
+    server->port = port;
+    server->udpSocket = createBoundSocket(SOCK_DGRAM, port);
+    server->tcpListenSocket = createBoundSocket(SOCK_STREAM, port);
+    if (server->udpSocket < 0 || server->tcpListenSocket < 0) return NO;
+
+    if (listen(server->tcpListenSocket, NET_MAX_PLAYERS) < 0) {
+        fprintf(stderr, "[SERVER] Failed to listen on TCP socket: %s\n", strerror(errno));
+        return NO;
+    }
+
+    // Discovery is optional - a game client on this machine may already hold the port
+    server->discoverySocket = createBoundSocket(SOCK_DGRAM, NET_DISCOVERY_PORT);
+    if (server->discoverySocket >= 0) {
+        int opt = 1;
+        setsockopt(server->discoverySocket, SOL_SOCKET, SO_BROADCAST, &opt, sizeof(opt));
+    } else {
+        fprintf(stderr, "[SERVER] LAN discovery disabled, clients must join by address\n");
+    }
+    return YES;
+}
+
+static void serverStop(Server *server) {
+    // Player 1 leaving is how clients learn the host is gone
+    GamePacket packet = makeGamePacket(server, PacketTypeDisconnect, NET_HOST_PLAYER_ID);
+    relayReliable(server, &packet, sizeof(packet), 0);
+
+    for (int i = 0; i < NET_MAX_PLAYERS; i++) {
+        if (server->clients[i].active) close(server->clients[i].tcpSocket);
+    }
+    if (server->udpSocket >= 0) close(server->udpSocket);
+    if (server->tcpListenSocket >= 0) close(server->tcpListenSocket);
+    if (server->discoverySocket >= 0) close(server->discoverySocket);
+}
+
+// Where a player stood before a tick it sat out
+typedef struct {
+    SimVec3 position;
+    SimVec3 velocity;
+    BOOL onGround;
+} HeldPlayer;
+
+// Each player's next queued input for this tick. A client with none queued hasn't run this tick
+// itself - its player keeps looking the same way with no buttons held, and is marked in held to
+// be put back where it stood after the step.
+static void takeInputs(Server *server, SimInput *inputs, BOOL *held) {
+    for (int i = 0; i < SIM_MAX_PLAYERS; i++) {
+        inputs[i] = (SimInput){.weaponSlot = -1};
+        held[i] = NO;
+    }
+    for (int i = 0; i < NET_MAX_PLAYERS; i++) {
+        ServerClient *client = &server->clients[i];
+        if (!client->joined) continue;
+
+        if (client->queueCount == 0) {
+            inputs[i] = client->input;
+            inputs[i].buttons = 0;
+            inputs[i].weaponSlot = -1;
+            held[i] = YES;
+            continue;
+        }
+
+        client->input = client->queuedInputs[client->queueHead];
+        client->inputSequence = client->queuedSequences[client->queueHead];
+        client->queueHead = (client->queueHead + 1) % INPUT_QUEUE_LENGTH;
+        client->queueCount--;
+        inputs[i] = client->input;
+    }
+}
+
+// Hits and kills from the step to every client - the victim's game shows the damage, all of them keep score
+static void reportCombat(Server *server) {
+    SimWorld *world = server->world;
+    for (int i = 0; i < world->eventCount; i++) {
+        const SimEvent *event = &world->events[i];
+        if (event->type != SimEventPlayerHit && event->type != SimEventPlayerKill) continue;
+
+        const SimPlayer *target = &world->players[event->target];
+        if (event->type == SimEventPlayerHit) {
+            GamePacket packet = makeGamePacket(server, PacketTypeHit, (uint32_t)target->playerId);
+            packet.player.health = event->amount;  // Damage, as a hosting client sends it
+            relayReliable(server, &packet, sizeof(packet), 0);
+        } else {
+            const SimPlayer *killer = &world->players[event->player];
+            KillPacket packet = {PacketTypeKill, (uint32_t)target->playerId, (uint32_t)killer->playerId};
+            relayReliable(server, &packet, sizeof(packet), 0);
+            fprintf(stderr, "[SERVER] Player %d killed player %d (%d kills)\n",
+                    killer->playerId, target->playerId, killer->kills);
+        }
+    }
+}
+
+// Players come back after RESPAWN_DELAY at the spawn furthest from the others, as in simRunMatch
+static void updateRespawn(Server *server, int slot) {
+    SimWorld *world = server->world;
+    SimPlayer *player = &world->players[slot];
+    if (!server->clients[slot].joined || player->alive || player->respawnTimer <= 0) return;
+    if (--player->respawnTimer > 0) return;
+
+    simRevivePlayer(world, slot);
+    simRespawnPlayer(world, slot, simChooseSpawnPoint(world, slot));
+
+    GamePacket packet = makeGamePacket(server, PacketTypeRespawn, (uint32_t)player->playerId);
+    netStateFromPlayer(&packet.player, player);
+    relayReliable(server, &packet, sizeof(packet), 0);
+}
+
+typedef struct {
+    const Server *server;
+    GamePacket packets[NET_MAX_PLAYERS];
+    int packetCount;
+} StateSend;
+
+// One client's state updates, encoded into a buffer of its own - clients go out in parallel
+static void sendStatesToClient(void *context, int i) {
+    const StateSend *states = context;
+    const ServerClient *client = &states->server->clients[i];
+    if (!client->joined || client->udpPort == 0) return;
+
+    struct sockaddr_in addr = client->address;
+    addr.sin_port = htons(client->udpPort);
+    uint8_t buffer[NET_MAX_PACKET_SIZE];
+    for (int p = 0; p < states->packetCount; p++) {
+        size_t total = netEncodeMessage(buffer, sizeof(buffer), &states->packets[p], sizeof(states->packets[p]));
+        sendto(states->server->udpSocket, buffer, total, 0, (struct sockaddr *)&addr, sizeof(addr));
+        SIM_PROFILE_COUNT(SimCounterPacketsSent, 1);
+    }
+}
+
+// Every player's state to every client, its owner included - the owner corrects its prediction from it
+static void sendStates(Server *server) {
+    SIM_PROFILE_ZONE("sendStates");
+    StateSend states = {.server = server};
+    for (int i = 0; i < NET_MAX_PLAYERS; i++) {
+        if (!server->clients[i].joined) continue;
+
+        const SimPlayer *player = &server->world->players[i];
+        GamePacket *packet = &states.packets[states.packetCount++];
+        *packet = makeGamePacket(server, PacketTypeStateUpdate, (uint32_t)player->playerId);
+        packet->sequence = server->clients[i].inputSequence;  // Input the tick ran, to check the owner's prediction against
+        netStateFromPlayer(&packet->player, player);
+    }
+    if (states.packetCount > 0) {
+        simJobParallelFor(server->jobs, NET_MAX_PLAYERS, sendStatesToClient, &states);
+    }
+}
+
+static void serverTick(Server *server) {
+    SIM_PROFILE_ZONE("serverTick");
+
+    SIM_PROFILE_BEGIN(networkZone, "network");
+    acceptNewConnections(server);
+    for (int i = 0; i < NET_MAX_PLAYERS; i++) {
+        if (server->clients[i].active) pollClient(server, &server->clients[i]);
+    }
+    pollUDP(server);
+    pollDiscovery(server);
+    removeStaleClients(server);
+    SIM_PROFILE_END(networkZone);
+
+    SimWorld *world = server->world;
+    SimInput inputs[SIM_MAX_PLAYERS];
+    BOOL held[SIM_MAX_PLAYERS];
+    takeInputs(server, inputs, held);
+
+    HeldPlayer heldPlayers[SIM_MAX_PLAYERS];
+    for (int i = 0; i < NET_MAX_PLAYERS; i++) {
+        const SimPlayer *player = &world->players[i];
+        heldPlayers[i] = (HeldPlayer){player->position, player->velocity, player->onGround};
+    }
+
+    BOOL wasWon = world->gameWon;
+    simStep(world, inputs);
+    for (int i = 0; i < NET_MAX_PLAYERS; i++) {
+        if (!held[i]) continue;
+        SimPlayer *player = &world->players[i];
+        player->position = heldPlayers[i].position;
+        player->velocity = heldPlayers[i].velocity;
+        player->onGround = heldPlayers[i].onGround;
+    }
+    reportCombat(server);
+    if (!wasWon && world->gameWon) {
+        fprintf(stderr, "[SERVER] Player %d wins, next match in %d s\n", world->winnerId, MATCH_RESTART_DELAY / 60);
+        server->matchRestartTimer = MATCH_RESTART_DELAY;
+    }
+    for (int i = 0; i < NET_MAX_PLAYERS; i++) {
+        updateRespawn(server, i);
+    }
+    sendStates(server);
+
+    if (server->matchRestartTimer > 0 && --server->matchRestartTimer == 0) {
+        startMatch(server);
+    }
+}
+
+static void addNanoseconds(struct timespec *ts, long ns) {
+    ts->tv_nsec += ns;
+    while (ts->tv_nsec >= 1000000000L) {
+        ts->tv_nsec -= 1000000000L;
+        ts->tv_sec++;
+    }
+}
+
+static BOOL timespecBefore(const struct timespec *a, const struct timespec *b) {
+    return a->tv_sec < b->tv_sec || (a->tv_sec == b->tv_sec && a->tv_nsec < b->tv_nsec);
+}
+
+// Sleep until an absolute CLOCK_MONOTONIC deadline, so the tick rate doesn't drift with tick cost
+static void sleepUntil(const struct timespec *deadline) {
+#if defined(__linux__)
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, deadline, NULL) == EINTR && running) {
+    }
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    if (!timespecBefore(&now, deadline)) return;
+
+    struct timespec delay = {deadline->tv_sec - now.tv_sec, deadline->tv_nsec - now.tv_nsec};
+    if (delay.tv_nsec < 0) {
+        delay.tv_nsec += 1000000000L;
+        delay.tv_sec--;
+    }
+    nanosleep(&delay, NULL);
+#endif
+}
+
+int main(int argc, char **argv) {
+    long port = (argc > 1) ? strtol(argv[1], NULL, 10) : NET_DEFAULT_PORT;
+    if (port <= 0 || port > 65535) {
+        fprintf(stderr, "usage: %s [port] [name]\n", argv[0]);
+        return 1;
+    }
+
+    Server *server = calloc(1, sizeof(Server));
+    if (!server) {
+        fprintf(stderr, "[SERVER] Out of memory\n");
+        return 1;
+    }
+    strncpy(server->name, (argc > 2) ? argv[2] : "Dedicated Server", sizeof(server->name) - 1);
+    server->udpSocket = server->tcpListenSocket = server->discoverySocket = -1;
+    for (int i = 0; i < NET_MAX_PLAYERS; i++) {
+        server->clients[i].tcpSocket = -1;
+    }
+
+    server->collision = simCollisionCreate();
+    if (!server->collision) {
+        fprintf(stderr, "[SERVER] Out of memory\n");
+        return 1;
+    }
+    char cachePath[1024];
+    simCollisionLoadOrBuildMilitaryBase(server->collision,
+                                        simCollisionDefaultCachePath(cachePath, (int)sizeof(cachePath)) ? cachePath : NULL);
+
+    // One player per client slot, moved here from that client's inputs
+    server->world = simCreate(server->collision);
+    server->jobs = simJobSystemCreate(-1);
+    if (!server->world || !server->jobs) {
+        fprintf(stderr, "[SERVER] Out of memory\n");
+        return 1;
+    }
+    simCollisionSetJobSystem(server->collision, server->jobs);
+    simSetJobSystem(server->world, server->jobs);
+    while (server->world->playerCount < NET_MAX_PLAYERS) {
+        simAddPlayer(server->world, 0, NO);
+    }
+
+    signal(SIGINT, handleSignal);
+    signal(SIGTERM, handleSignal);
+    signal(SIGPIPE, SIG_IGN);  // A client closing mid-send shows up as a recv error instead
+    signal(SIGUSR1, handleTraceSignal);
+    const char *tracePath = getenv("FPS_TRACE");
+    SIM_PROFILE_THREAD_NAME("server");
+
+    if (!serverStart(server, (uint16_t)port)) {
+        serverStop(server);
+        return 1;
+    }
+    startMatch(server);
+    fprintf(stderr, "[SERVER] '%s' listening on port %ld for up to %d players\n",
+            server->name, port, NET_MAX_PLAYERS);
+
+    const long tickNanoseconds = (long)(NET_STATE_UPDATE_INTERVAL * 1e9);
+    struct timespec nextTick;
+    clock_gettime(CLOCK_MONOTONIC, &nextTick);
+
+    double lastStatus = nowSeconds();
+    double worstTick = 0.0;
+    long resyncs = 0;
+
+    while (running) {
+        double tickStart = nowSeconds();
+        serverTick(server);
+        SIM_PROFILE_FRAME();
+        double tickTime = nowSeconds() - tickStart;
+        if (tickTime > worstTick) worstTick = tickTime;
+
+        addNanoseconds(&nextTick, tickNanoseconds);
+
+        // After a stall (suspend, debugger) restart the schedule rather than catching up in a burst
+        struct timespec now, limit = nextTick;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        addNanoseconds(&limit, tickNanoseconds * MAX_TICKS_BEHIND);
+        if (timespecBefore(&limit, &now)) {
+            resyncs++;
+            nextTick = now;
+        }
+
+        if (tickStart - lastStatus >= STATUS_INTERVAL) {
+            fprintf(stderr, "[SERVER] %d/%d players, tick %u, worst tick %.2f ms, %ld resyncs, %ld inputs dropped\n",
+                    joinedCount(server), NET_MAX_PLAYERS, server->world->tick, worstTick * 1000.0, resyncs,
+                    server->droppedInputs);
+            lastStatus = tickStart;
+            worstTick = 0.0;
+            server->droppedInputs = 0;
+        }
+
+        if (traceRequested) {
+            traceRequested = 0;
+            simProfileWriteChromeTrace(tracePath ? tracePath : "fps_server_trace.json");
+        }
+
+        sleepUntil(&nextTick);
+    }
+
+    fprintf(stderr, "[SERVER] Shutting down\n");
+    if (tracePath) simProfileWriteChromeTrace(tracePath);
+    serverStop(server);
+    simDestroy(server->world);
+    simCollisionDestroy(server->collision);
+    simJobSystemDestroy(server->jobs);
+    free(server);
+    return 0;
+}
@@ -0,0 +1,312 @@
+// SimServerCheck.c - Plays one predicting client against a real FPSServer over loopback
+//
+// Usage: FPSServerCheck [server] [port]
+// Starts the server (default ./FPSServer, on a port picked from the process id), joins it and
+// walks, strafes and jumps around for a few seconds, sending controls at CHECK_INPUT_RATE - not
+// the server's 60 Hz - with jittered frame times. The client predicts its own movement with its
+// own SimWorld and corrects it from the server's state updates the way MultiplayerController
+// does. Fails with exit code 3 unless the server ran every input once, in order, and the
+// predictions converged on the server's positions; build_sim.sh runs it.
+#include "SimWorld.h"
+#include "NetProtocol.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <math.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+enum {
+    CHECK_INPUT_RATE = 45,          // Client frames per second
+    CHECK_INPUTS = 4 * CHECK_INPUT_RATE,
+    CHECK_SETTLE_INPUTS = CHECK_INPUT_RATE,  // Corrections allowed while the client finds its spawn
+    PREDICTION_HISTORY = 64,        // As MultiplayerController
+};
+
+static const double CHECK_CONNECT_TIMEOUT = 30.0;  // The server may have to build the collision cache
+static const double CHECK_DRAIN_TIME = 0.5;        // For the last inputs' states to come back
+static const float SERVER_CORRECTION_DISTANCE = 0.5f;  // As MultiplayerController
+static const float CHECK_CONVERGED_DISTANCE = 0.01f;
+
+typedef struct {
+    uint32_t inputSequence;         // Input that took the player here, 0 when unused
+    SimVec3 position;
+} PredictedPosition;
+
+typedef struct {
+    int tcpSocket;
+    int udpSocket;
+    struct sockaddr_in server;
+    uint32_t playerId;
+    uint32_t sendSequence;
+    uint32_t lastInputSequence;
+    PredictedPosition predicted[PREDICTION_HISTORY];
+
+    // What the server's state updates said
+    uint32_t lastAck;               // Newest input sequence acked
+    int outOfOrderAcks;
+    int corrections;
+    int lateCorrections;            // After CHECK_SETTLE_INPUTS
+    float lastError;
+    float worstLateError;
+} CheckClient;
+
+static double nowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static void sleepSeconds(double seconds) {
+    if (seconds <= 0.0) return;
+    struct timespec ts = {(time_t)seconds, (long)((seconds - (double)(time_t)seconds) * 1e9)};
+    while (nanosleep(&ts, &ts) < 0 && errno == EINTR) {
+    }
+}
+
+static pid_t startServer(const char *path, int port) {
+    pid_t pid = fork();
+    if (pid == 0) {
+        char portArg[16];
+        snprintf(portArg, sizeof(portArg), "%d", port);
+        int devNull = open("/dev/null", O_WRONLY);
+        if (devNull >= 0) dup2(devNull, STDERR_FILENO);
+        execl(path, path, portArg, "Server Check", (char *)NULL);
+        _exit(127);
+    }
+    return pid;
+}
+
+// TCP to the server, retried while it starts up
+static BOOL connectClient(CheckClient *client, int port) {
+    memset(&client->server, 0, sizeof(client->server));
+    client->server.sin_family = AF_INET;
+    client->server.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    client->server.sin_port = htons((uint16_t)port);
+
+    double deadline = nowSeconds() + CHECK_CONNECT_TIMEOUT;
+    while (nowSeconds() < deadline) {
+        int sock = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+        if (sock < 0) return NO;
+        if (connect(sock, (struct sockaddr *)&client->server, sizeof(client->server)) == 0) {
+            client->tcpSocket = sock;
+            break;
+        }
+        close(sock);
+        sleepSeconds(0.05);
+    }
+    if (client->tcpSocket < 0) return NO;
+
+    client->udpSocket = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (client->udpSocket < 0) return NO;
+    int flags = fcntl(client->udpSocket, F_GETFL, 0);
+    fcntl(client->udpSocket, F_SETFL, flags | O_NONBLOCK);
+    return YES;
+}
+
+// Wait for ConnectAccept, then join
+static BOOL joinServer(CheckClient *client) {
+    uint8_t buffer[NET_MAX_PACKET_SIZE];
+    size_t length = 0;
+    double deadline = nowSeconds() + CHECK_CONNECT_TIMEOUT;
+
+    while (nowSeconds() < deadline) {
+        ssize_t received = recv(client->tcpSocket, buffer + length, sizeof(buffer) - length, 0);
+        if (received <= 0) return NO;
+        length += (size_t)received;
+
+        int payload = netDecodeHeader(buffer, length);
+        if (payload < 0 && length >= sizeof(PacketHeader)) return NO;
+        if (payload < (int)sizeof(ConnectionPacket) || length < sizeof(PacketHeader) + (size_t)payload) continue;
+
+        ConnectionPacket accept;
+        memcpy(&accept, buffer + sizeof(PacketHeader), sizeof(accept));
+        if (accept.packetType != PacketTypeConnectAccept || !(accept.hostFlags & NET_HOST_AUTHORITATIVE)) return NO;
+        client->playerId = accept.playerId;
+
+        ConnectionPacket connectPacket;
+        memset(&connectPacket, 0, sizeof(connectPacket));
+        connectPacket.packetType = PacketTypeConnect;
+        connectPacket.playerId = client->playerId;
+        strncpy(connectPacket.playerName, "Check", sizeof(connectPacket.playerName) - 1);
+        size_t total = netEncodeMessage(buffer, sizeof(buffer), &connectPacket, sizeof(connectPacket));
+        return send(client->tcpSocket, buffer, total, 0) == (ssize_t)total;
+    }
+    return NO;
+}
+
+// Walk forward while sweeping the view, strafe in bursts and jump now and then
+static SimInput scriptedInput(int frame) {
+    SimInput input = {0};
+    input.active = YES;
+    input.weaponSlot = -1;
+    input.yaw = (float)frame * 0.02f;
+    input.buttons = SimButtonForward;
+    if ((frame / 30) % 2 == 0) input.buttons |= SimButtonLeft;
+    if (frame % 50 == 25) input.buttons |= SimButtonJump;
+    return input;
+}
+
+// MultiplayerController's sendLocalInput, after the step: send the input, then remember where it took us
+static void sendInput(CheckClient *client, const SimWorld *world, const SimInput *input) {
+    InputPacket packet = {0};
+    packet.packetType = PacketTypeInput;
+    packet.sequence = ++client->sendSequence;
+    packet.playerId = client->playerId;
+    packet.buttons = (uint16_t)input->buttons;
+    packet.weaponSlot = (int8_t)input->weaponSlot;
+    packet.yaw = input->yaw;
+    packet.pitch = input->pitch;
+    packet.active = input->active ? 1 : 0;
+
+    uint8_t buffer[NET_MAX_PACKET_SIZE];
+    size_t total = netEncodeMessage(buffer, sizeof(buffer), &packet, sizeof(packet));
+    sendto(client->udpSocket, buffer, total, 0, (struct sockaddr *)&client->server, sizeof(client->server));
+    client->lastInputSequence = packet.sequence;
+
+    PredictedPosition *entry = &client->predicted[packet.sequence % PREDICTION_HISTORY];
+    entry->inputSequence = packet.sequence;
+    entry->position = world->players[0].position;
+}
+
+// MultiplayerController's applyServerState, keeping score of the errors
+static void applyServerState(CheckClient *client, SimWorld *world, const GamePacket *packet, int frame) {
+    uint32_t inputSequence = packet->sequence;
+    if (inputSequence == 0) return;
+    if ((int32_t)(inputSequence - client->lastAck) < 0) client->outOfOrderAcks++;
+    client->lastAck = inputSequence;
+
+    PredictedPosition *entry = &client->predicted[inputSequence % PREDICTION_HISTORY];
+    if (entry->inputSequence != inputSequence) return;
+
+    float dx = packet->player.posX - entry->position.x;
+    float dy = packet->player.posY - entry->position.y;
+    float dz = packet->player.posZ - entry->position.z;
+    float error = sqrtf(dx * dx + dy * dy + dz * dz);
+    client->lastError = error;
+    BOOL late = frame >= CHECK_SETTLE_INPUTS;
+    if (late && error > client->worstLateError) client->worstLateError = error;
+    if (error <= SERVER_CORRECTION_DISTANCE) return;
+
+    client->corrections++;
+    if (late) client->lateCorrections++;
+    SimPlayer *player = &world->players[0];
+    player->position = simVec3(player->position.x + dx, player->position.y + dy, player->position.z + dz);
+    for (int i = 0; i < PREDICTION_HISTORY; i++) {
+        client->predicted[i].position = simVec3(client->predicted[i].position.x + dx,
+                                                client->predicted[i].position.y + dy,
+                                                client->predicted[i].position.z + dz);
+    }
+}
+
+static void pollStates(CheckClient *client, SimWorld *world, int frame) {
+    uint8_t buffer[NET_MAX_PACKET_SIZE];
+    ssize_t received;
+    while ((received = recv(client->udpSocket, buffer, sizeof(buffer), 0)) > 0) {
+        GamePacket packet;
+        if (netDecodeStateUpdate(buffer, (size_t)received, &packet) && packet.player.playerId == client->playerId) {
+            applyServerState(client, world, &packet, frame);
+        }
+    }
+
+    // Hits, respawns and the like aren't checked - keep the stream from backing up
+    while (recv(client->tcpSocket, buffer, sizeof(buffer), MSG_DONTWAIT) > 0) {
+    }
+}
+
+// Frame times wander around 1 / CHECK_INPUT_RATE, the way a loaded client's do
+static double frameTime(int frame) {
+    static const double JITTER[] = {0.0, 0.004, -0.003, 0.006, -0.005, 0.002, -0.004, 0.0};
+    return 1.0 / CHECK_INPUT_RATE + JITTER[frame % (int)(sizeof(JITTER) / sizeof(JITTER[0]))];
+}
+
+static int runCheck(CheckClient *client) {
+    SimCollision *collision = simCollisionCreate();
+    if (!collision) return 1;
+    char cachePath[1024];
+    simCollisionLoadOrBuildMilitaryBase(collision,
+                                        simCollisionDefaultCachePath(cachePath, (int)sizeof(cachePath)) ? cachePath : NULL);
+    SimWorld *world = simCreate(collision);
+    if (!world) return 1;
+    simResetForMultiplayer(world, NO);
+
+    SimInput inputs[SIM_MAX_PLAYERS];
+    double nextFrame = nowSeconds();
+    for (int frame = 0; frame < CHECK_INPUTS; frame++) {
+        pollStates(client, world, frame);
+
+        memset(inputs, 0, sizeof(inputs));
+        inputs[0] = scriptedInput(frame);
+        simStep(world, inputs);
+        sendInput(client, world, &inputs[0]);
+
+        nextFrame += frameTime(frame);
+        sleepSeconds(nextFrame - nowSeconds());
+    }
+
+    // Let the last inputs' states come back
+    double drainEnd = nowSeconds() + CHECK_DRAIN_TIME;
+    while (nowSeconds() < drainEnd) {
+        pollStates(client, world, CHECK_INPUTS);
+        sleepSeconds(0.005);
+    }
+
+    printf("[CHECK] Server check: %d inputs at %d Hz, last ack %u, %d corrections (%d after settling), "
+           "worst error after settling %.3f, final error %.3f\n",
+           CHECK_INPUTS, CHECK_INPUT_RATE, client->lastAck, client->corrections, client->lateCorrections,
+           client->worstLateError, client->lastError);
+
+    int result = 0;
+    if (client->lastAck != client->lastInputSequence || client->outOfOrderAcks > 0) {
+        printf("[CHECK] The server didn't run every input in order\n");
+        result = 3;
+    }
+    if (client->lateCorrections > 0 || client->worstLateError > CHECK_CONVERGED_DISTANCE) {
+        printf("[CHECK] Predictions didn't converge on the server's positions\n");
+        result = 3;
+    }
+
+    simDestroy(world);
+    simCollisionDestroy(collision);
+    return result;
+}
+
+int main(int argc, char **argv) {
+    const char *serverPath = (argc > 1) ? argv[1] : "./FPSServer";
+    int port = (argc > 2) ? (int)strtol(argv[2], NULL, 10) : 20000 + (int)(getpid() % 20000);
+    if (port <= 0 || port > 65535) {
+        fprintf(stderr, "usage: %s [server] [port]\n", argv[0]);
+        return 1;
+    }
+
+    pid_t server = startServer(serverPath, port);
+    if (server < 0) {
+        fprintf(stderr, "[CHECK] Couldn't start %s\n", serverPath);
+        return 1;
+    }
+
+    CheckClient client;
+    memset(&client, 0, sizeof(client));
+    client.tcpSocket = client.udpSocket = -1;
+
+    int result;
+    if (!connectClient(&client, port) || !joinServer(&client)) {
+        printf("[CHECK] Couldn't join %s on port %d\n", serverPath, port);
+        result = 3;
+    } else {
+        result = runCheck(&client);
+    }
+
+    if (client.tcpSocket >= 0) close(client.tcpSocket);
+    if (client.udpSocket >= 0) close(client.udpSocket);
+    kill(server, SIGTERM);
+    waitpid(server, NULL, 0);
+    return result;
+}
@@ -0,0 +1,140 @@
+// SimSnapshot.c - Whole-world snapshots and snapshot ring implementation
+#include "SimSnapshot.h"
+#include <stdlib.h>
+#include <string.h>
+
+BOOL simSnapshotLoad(SimWorld *world, const SimWorld *saved) {
+    if (saved->size != world->size) return NO;
+    if (world == saved) return YES;
+
+    SimCollision *collision = world->collision;
+    SimJobSystem *jobs = world->jobs;
+    int doorShapeId = world->doorShapeId;
+    memcpy(world, saved, saved->size);
+    world->collision = collision;
+    world->jobs = jobs;
+    world->doorShapeId = doorShapeId;
+
+    // The door shape lives in the collision world, outside the snapshot
+    if (collision) {
+        simSyncDoorCollision(world);
+    }
+    return YES;
+}
+
+// ============================================
+// RING BUFFER
+// ============================================
+
+struct SimSnapshotRing {
+    unsigned char *slots;       // capacity worlds in one block
+    size_t worldSize;           // Bytes per slot
+    int capacity;
+    int oldest;                 // Slot of the oldest snapshot
+    int count;
+};
+
+SimSnapshotRing *simSnapshotRingCreate(int capacity, const SimWorld *world) {
+    if (capacity <= 0) return NULL;
+
+    SimSnapshotRing *ring = calloc(1, sizeof(SimSnapshotRing));
+    if (!ring) return NULL;
+
+    // World sizes are 16-byte multiples, so every slot stays aligned
+    ring->worldSize = world->size;
+    ring->slots = malloc(ring->worldSize * (size_t)capacity);
+    if (!ring->slots) {
+        free(ring);
+        return NULL;
+    }
+    ring->capacity = capacity;
+    return ring;
+}
+
+void simSnapshotRingDestroy(SimSnapshotRing *ring) {
+    if (!ring) return;
+    free(ring->slots);
+    free(ring);
+}
+
+void simSnapshotRingClear(SimSnapshotRing *ring) {
+    ring->oldest = 0;
+    ring->count = 0;
+}
+
+int simSnapshotRingCapacity(const SimSnapshotRing *ring) {
+    return ring->capacity;
+}
+
+int simSnapshotRingCount(const SimSnapshotRing *ring) {
+    return ring->count;
+}
+
+static SimWorld *slotAt(const SimSnapshotRing *ring, int age) {
+    size_t slot = (size_t)((ring->oldest + age) % ring->capacity);
+    return (SimWorld *)(ring->slots + slot * ring->worldSize);
+}
+
+BOOL simSnapshotSave(SimSnapshotRing *ring, const SimWorld *world) {
+    if (world->size != ring->worldSize) return NO;
+
+    // Ticks rise from oldest to newest - drop the ones this tick replaces
+    // (a re-simulation after a restore, or the tick count restarting with a new game)
+    while (ring->count > 0 && slotAt(ring, ring->count - 1)->tick >= world->tick) {
+        ring->count--;
+    }
+
+    if (ring->count == ring->capacity) {
+        ring->oldest = (ring->oldest + 1) % ring->capacity;
+        ring->count--;
+    }
+
+    memcpy(slotAt(ring, ring->count), world, ring->worldSize);
+    ring->count++;
+    return YES;
+}
+
+const SimWorld *simSnapshotAt(const SimSnapshotRing *ring, unsigned int tick) {
+    if (ring->count == 0) return NULL;
+
+    // Usually one snapshot per tick, so the tick's age is a direct guess
+    unsigned int oldestTick = slotAt(ring, 0)->tick;
+    if (tick < oldestTick) return NULL;
+    unsigned int guess = tick - oldestTick;
+    if (guess < (unsigned int)ring->count && slotAt(ring, (int)guess)->tick == tick) {
+        return slotAt(ring, (int)guess);
+    }
+
+    // Gaps in the ticks saved - binary search
+    int lo = 0;
+    int hi = ring->count - 1;
+    while (lo <= hi) {
+        int mid = (lo + hi) / 2;
+        const SimWorld *snapshot = slotAt(ring, mid);
+        if (snapshot->tick == tick) return snapshot;
+        if (snapshot->tick < tick) {
+            lo = mid + 1;
+        } else {
+            hi = mid - 1;
+        }
+    }
+    return NULL;
+}
+
+BOOL simSnapshotOldestTick(const SimSnapshotRing *ring, unsigned int *outTick) {
+    if (ring->count == 0) return NO;
+    *outTick = slotAt(ring, 0)->tick;
+    return YES;
+}
+
+BOOL simSnapshotNewestTick(const SimSnapshotRing *ring, unsigned int *outTick) {
+    if (ring->count == 0) return NO;
+    *outTick = slotAt(ring, ring->count - 1)->tick;
+    return YES;
+}
+
+BOOL simSnapshotRestore(const SimSnapshotRing *ring, SimWorld *world, unsigned int tick) {
+    const SimWorld *snapshot = simSnapshotAt(ring, tick);
+    if (!snapshot) return NO;
+    return simSnapshotLoad(world, snapshot);
+}
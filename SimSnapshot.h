@@ -0,0 +1,52 @@
+// SimSnapshot.h - Whole-world snapshots and a preallocated ring of them for rollback and rewind
+#ifndef SIMSNAPSHOT_H
+#define SIMSNAPSHOT_H
+
+#include "SimWorld.h"
+
+// A SimWorld holds all simulation state in one block of world->size bytes with no pointers
+// into the heap (bots, their AI, weapons and pickups included), so a snapshot is one memcpy
+// of it. Snapshots only load into worlds of the same size - the same bot capacity.
+// The only handles are into the collision world, which is built once per map and is
+// not part of the state, and to the job system: loading a snapshot keeps the world's own
+// handles and moves the door's collision shape to the snapshot's door angle.
+
+// 2 seconds at 60 ticks/s
+#define SIM_SNAPSHOT_DEFAULT_CAPACITY 120
+
+// Copy saved over world, keeping world's collision and job system handles. Returns NO if their sizes differ.
+BOOL simSnapshotLoad(SimWorld *world, const SimWorld *saved);
+
+// ============================================
+// RING BUFFER
+// ============================================
+
+typedef struct SimSnapshotRing SimSnapshotRing;
+
+// Room for capacity snapshots of worlds the size of world, all allocated here - saving and
+// restoring never allocate. Returns NULL if out of memory.
+SimSnapshotRing *simSnapshotRingCreate(int capacity, const SimWorld *world);
+void simSnapshotRingDestroy(SimSnapshotRing *ring);
+
+// Forget every snapshot
+void simSnapshotRingClear(SimSnapshotRing *ring);
+
+int simSnapshotRingCapacity(const SimSnapshotRing *ring);
+int simSnapshotRingCount(const SimSnapshotRing *ring);
+
+// Save world under its current tick, replacing the oldest snapshot when full.
+// Snapshots at or after this tick are dropped first, so re-simulating after a
+// restore simply saves over the ticks it replaces. Returns NO if world is the wrong size.
+BOOL simSnapshotSave(SimSnapshotRing *ring, const SimWorld *world);
+
+// Snapshot taken at tick, or NULL if it isn't in the ring
+const SimWorld *simSnapshotAt(const SimSnapshotRing *ring, unsigned int tick);
+
+// Oldest and newest ticks held. Return NO when the ring is empty.
+BOOL simSnapshotOldestTick(const SimSnapshotRing *ring, unsigned int *outTick);
+BOOL simSnapshotNewestTick(const SimSnapshotRing *ring, unsigned int *outTick);
+
+// Load the snapshot taken at tick into world. Returns NO if it isn't in the ring.
+BOOL simSnapshotRestore(const SimSnapshotRing *ring, SimWorld *world, unsigned int tick);
+
+#endif // SIMSNAPSHOT_H
@@ -0,0 +1,107 @@
+// SimTypes.h - Portable math and base types for the simulation library (no simd.h, no Cocoa)
+#ifndef SIMTYPES_H
+#define SIMTYPES_H
+
+#include <math.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// For Objective-C, BOOL is already defined by the runtime
+// For pure C, we need to define it
+#ifdef __OBJC__
+#import <objc/objc.h>  // Provides BOOL, YES, NO in Objective-C
+#else
+typedef bool BOOL;
+#define YES true
+#define NO false
+#endif
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// Simulation world - defined in SimWorld.h
+typedef struct SimWorld SimWorld;
+
+// ============================================
+// VECTORS
+// ============================================
+
+typedef struct {
+    float x, y, z;
+} SimVec3;
+
+static inline SimVec3 simVec3(float x, float y, float z) {
+    SimVec3 v = {x, y, z};
+    return v;
+}
+
+static inline SimVec3 simAdd(SimVec3 a, SimVec3 b) {
+    return simVec3(a.x + b.x, a.y + b.y, a.z + b.z);
+}
+
+static inline SimVec3 simSub(SimVec3 a, SimVec3 b) {
+    return simVec3(a.x - b.x, a.y - b.y, a.z - b.z);
+}
+
+static inline SimVec3 simScale(SimVec3 v, float s) {
+    return simVec3(v.x * s, v.y * s, v.z * s);
+}
+
+// a + b * s
+static inline SimVec3 simMulAdd(SimVec3 a, SimVec3 b, float s) {
+    return simVec3(a.x + b.x * s, a.y + b.y * s, a.z + b.z * s);
+}
+
+static inline float simDot(SimVec3 a, SimVec3 b) {
+    return a.x * b.x + a.y * b.y + a.z * b.z;
+}
+
+static inline SimVec3 simCross(SimVec3 a, SimVec3 b) {
+    return simVec3(a.y * b.z - a.z * b.y,
+                   a.z * b.x - a.x * b.z,
+                   a.x * b.y - a.y * b.x);
+}
+
+static inline float simLength(SimVec3 v) {
+    return sqrtf(simDot(v, v));
+}
+
+static inline float simDistance(SimVec3 a, SimVec3 b) {
+    return simLength(simSub(a, b));
+}
+
+static inline SimVec3 simNormalize(SimVec3 v) {
+    return simScale(v, 1.0f / simLength(v));
+}
+
+// ============================================
+// CAMERA
+// ============================================
+
+// Same basis as computeCameraBasis, for code that can't use simd
+typedef struct {
+    SimVec3 forward;
+    SimVec3 right;
+    SimVec3 up;
+} SimCameraBasis;
+
+static inline SimCameraBasis simCameraBasis(float yaw, float pitch) {
+    SimCameraBasis basis;
+    basis.forward = simVec3(sinf(yaw) * cosf(pitch), sinf(pitch), -cosf(yaw) * cosf(pitch));
+    basis.right = simVec3(cosf(yaw), 0.0f, sinf(yaw));
+    basis.up = simCross(basis.right, basis.forward);
+    return basis;
+}
+
+// ============================================
+// PARALLEL WORK
+// ============================================
+
+// One iteration of a parallel job - see SimJobs.h. Iterations may run concurrently.
+typedef void (*SimParallelFn)(void *context, int index);
+
+// Thread pool the simulation splits its work over (SimJobs.h)
+typedef struct SimJobSystem SimJobSystem;
+
+#endif // SIMTYPES_H
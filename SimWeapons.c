@@ -0,0 +1,340 @@
+// SimWeapons.c - Weapon stats and per-player weapon state
+#include "SimWeapons.h"
+#include <math.h>
+#include <stdlib.h>
+
+// Weapon statistics definitions
+static const WeaponStats WEAPON_STATS[WeaponTypeCount] = {
+    // Pistol: Default, unlimited ammo, medium fire rate, 15 damage
+    {
+        .damage = 15,
+        .fireRate = 12,          // ~5 shots per second
+        .spread = 0.0f,          // Perfectly accurate
+        .projectileCount = 1,
+        .magSize = 0,            // Unlimited (no magazine)
+        .maxReserve = 0,         // Unlimited reserve
+        .reloadTime = 0,         // No reload needed
+        .range = FAR_PLANE,      // Full range
+        .splashRadius = 0.0f,
+        .splashDamage = 0
+    },
+    // Shotgun: Slow fire rate, 8 pellets x 12 damage, spread pattern, 8 shells max
+    {
+        .damage = 12,
+        .fireRate = 45,          // ~1.3 shots per second
+        .spread = 0.12f,         // ~7 degree spread cone
+        .projectileCount = 8,    // 8 pellets
+        .magSize = 8,            // 8 shells in tube
+        .maxReserve = 0,         // Shells loaded directly into mag
+        .reloadTime = 30,        // 0.5 sec per shell (simplified as full reload)
+        .range = 15.0f,          // Short range effectiveness
+        .splashRadius = 0.0f,
+        .splashDamage = 0
+    },
+    // Assault Rifle: Fast fire rate, 20 damage, 30 rounds mag, 90 reserve
+    {
+        .damage = 20,
+        .fireRate = 6,           // ~10 shots per second
+        .spread = 0.02f,         // Slight spread
+        .projectileCount = 1,
+        .magSize = 30,
+        .maxReserve = 90,
+        .reloadTime = 90,        // 1.5 sec reload
+        .range = FAR_PLANE,
+        .splashRadius = 0.0f,
+        .splashDamage = 0
+    },
+    // Rocket Launcher: Slow, 100 damage + splash, 4 rockets max
+    {
+        .damage = 100,
+        .fireRate = 90,          // ~0.67 shots per second
+        .spread = 0.0f,          // Perfectly accurate
+        .projectileCount = 1,
+        .magSize = 4,            // 4 rockets
+        .maxReserve = 0,         // Rockets loaded directly
+        .reloadTime = 120,       // 2 sec reload
+        .range = FAR_PLANE,
+        .splashRadius = 3.0f,    // 3 unit splash radius
+        .splashDamage = 50       // 50 splash damage
+    }
+};
+
+WeaponStats weaponStats(WeaponType weaponType) {
+    if (weaponType < 0 || weaponType >= WeaponTypeCount) {
+        return WEAPON_STATS[WeaponTypePistol];
+    }
+    return WEAPON_STATS[weaponType];
+}
+
+void weaponReset(WeaponState *state) {
+    state->currentWeapon = WeaponTypePistol;
+    state->isReloading = NO;
+    state->reloadTimer = 0;
+    state->fireTimer = 0;
+
+    // Initialize ammo for each weapon
+    for (int i = 0; i < WeaponTypeCount; i++) {
+        WeaponStats stats = WEAPON_STATS[i];
+        // Start with full magazine
+        state->currentAmmo[i] = stats.magSize;  // 0 for unlimited
+        // Start with full reserve
+        state->reserveAmmo[i] = stats.maxReserve;
+    }
+}
+
+BOOL weaponSwitch(WeaponState *state, WeaponType weaponType, const BOOL *owned) {
+    if (weaponType < 0 || weaponType >= WeaponTypeCount) {
+        return NO;
+    }
+
+    // Can't switch while reloading (optional: could cancel reload instead)
+    if (state->isReloading) {
+        return NO;
+    }
+
+    // Already using this weapon
+    if (state->currentWeapon == weaponType) {
+        return NO;
+    }
+
+    // Pistol is always available
+    if (weaponType != WeaponTypePistol && !owned[weaponType]) {
+        return NO;
+    }
+
+    state->currentWeapon = weaponType;
+    state->fireTimer = 0;  // Reset fire timer on switch
+
+    return YES;
+}
+
+BOOL weaponCanFire(const WeaponState *state) {
+    if (state->isReloading) {
+        return NO;
+    }
+
+    if (state->fireTimer > 0) {
+        return NO;
+    }
+
+    WeaponStats stats = WEAPON_STATS[state->currentWeapon];
+
+    // Check if we have ammo (0 magSize means unlimited)
+    if (stats.magSize > 0 && state->currentAmmo[state->currentWeapon] <= 0) {
+        return NO;
+    }
+
+    return YES;
+}
+
+BOOL weaponNeedsReload(const WeaponState *state) {
+    WeaponStats stats = WEAPON_STATS[state->currentWeapon];
+
+    // Unlimited ammo weapons never need reload
+    if (stats.magSize == 0) {
+        return NO;
+    }
+
+    // Check if magazine is empty or not full and has reserve
+    int currentMag = state->currentAmmo[state->currentWeapon];
+    int reserve = state->reserveAmmo[state->currentWeapon];
+
+    // Need reload if mag is empty, or if mag is not full and we have reserve/can reload
+    if (currentMag == 0) {
+        return YES;
+    }
+
+    // For weapons with no reserve (shotgun, rocket), allow reload if not full
+    if (stats.maxReserve == 0 && currentMag < stats.magSize) {
+        return YES;
+    }
+
+    // For weapons with reserve, allow reload if not full and have reserve
+    if (reserve > 0 && currentMag < stats.magSize) {
+        return YES;
+    }
+
+    return NO;
+}
+
+// Unit vectors perpendicular to dir, for offsetting spread directions
+static void spreadBasis(SimVec3 dir, SimVec3 *outRight, SimVec3 *outUp) {
+    SimVec3 up = simVec3(0, 1, 0);
+    if (fabsf(dir.y) > 0.9f) {
+        up = simVec3(1, 0, 0);
+    }
+
+    *outRight = simNormalize(simCross(dir, up));
+    *outUp = simCross(*outRight, dir);
+}
+
+BOOL weaponFire(WeaponState *state, SimRng *rng, SimVec3 baseDir, SpreadDirections *outSpread) {
+    if (!weaponCanFire(state)) {
+        return NO;
+    }
+
+    WeaponStats stats = WEAPON_STATS[state->currentWeapon];
+
+    // Consume ammo (if not unlimited)
+    if (stats.magSize > 0) {
+        state->currentAmmo[state->currentWeapon]--;
+    }
+
+    // Set fire cooldown
+    state->fireTimer = stats.fireRate;
+
+    // Calculate spread directions
+    if (outSpread != NULL) {
+        outSpread->count = stats.projectileCount;
+
+        // Normalize base direction
+        float len = simLength(baseDir);
+        if (len > 0) {
+            baseDir = simVec3(baseDir.x / len, baseDir.y / len, baseDir.z / len);
+        }
+
+        for (int i = 0; i < stats.projectileCount && i < MAX_SPREAD_DIRECTIONS; i++) {
+            if (stats.spread > 0 && stats.projectileCount > 1) {
+                // Generate spread for shotgun pellets
+                // Use a cone distribution around the base direction
+                float angle = ((float)i / (float)stats.projectileCount) * 2.0f * M_PI;
+                float spreadMagnitude = stats.spread * simRngFloat(rng);
+
+                SimVec3 right, actualUp;
+                spreadBasis(baseDir, &right, &actualUp);
+
+                // Apply spread
+                float offsetX = cosf(angle) * spreadMagnitude;
+                float offsetY = sinf(angle) * spreadMagnitude;
+
+                SimVec3 spreadDir = simMulAdd(simMulAdd(baseDir, right, offsetX), actualUp, offsetY);
+                outSpread->directions[i] = simNormalize(spreadDir);
+            } else if (stats.spread > 0) {
+                // Single projectile with spread (assault rifle)
+                float spreadX = (simRngFloat(rng) * 2.0f - 1.0f) * stats.spread;
+                float spreadY = (simRngFloat(rng) * 2.0f - 1.0f) * stats.spread;
+
+                SimVec3 right, actualUp;
+                spreadBasis(baseDir, &right, &actualUp);
+
+                SimVec3 spreadDir = simMulAdd(simMulAdd(baseDir, right, spreadX), actualUp, spreadY);
+                outSpread->directions[i] = simNormalize(spreadDir);
+            } else {
+                // No spread - perfectly accurate
+                outSpread->directions[i] = baseDir;
+            }
+        }
+    }
+
+    return YES;
+}
+
+BOOL weaponReload(WeaponState *state) {
+    // Already reloading
+    if (state->isReloading) {
+        return NO;
+    }
+
+    WeaponStats stats = WEAPON_STATS[state->currentWeapon];
+
+    // Can't reload unlimited ammo weapons
+    if (stats.magSize == 0) {
+        return NO;
+    }
+
+    int currentMag = state->currentAmmo[state->currentWeapon];
+    int reserve = state->reserveAmmo[state->currentWeapon];
+
+    // Already full
+    if (currentMag >= stats.magSize) {
+        return NO;
+    }
+
+    // For weapons with reserve, check if we have any
+    if (stats.maxReserve > 0 && reserve <= 0) {
+        return NO;
+    }
+
+    // Start reloading
+    state->isReloading = YES;
+    state->reloadTimer = stats.reloadTime;
+
+    return YES;
+}
+
+void weaponUpdate(WeaponState *state) {
+    // Update fire timer
+    if (state->fireTimer > 0) {
+        state->fireTimer--;
+    }
+
+    // Update reload timer
+    if (state->isReloading) {
+        state->reloadTimer--;
+
+        if (state->reloadTimer <= 0) {
+            // Reload complete
+            state->isReloading = NO;
+
+            WeaponStats stats = WEAPON_STATS[state->currentWeapon];
+            int currentMag = state->currentAmmo[state->currentWeapon];
+            int reserve = state->reserveAmmo[state->currentWeapon];
+            int needed = stats.magSize - currentMag;
+
+            if (stats.maxReserve > 0) {
+                // Transfer ammo from reserve to magazine
+                int toTransfer = (reserve < needed) ? reserve : needed;
+                state->currentAmmo[state->currentWeapon] += toTransfer;
+                state->reserveAmmo[state->currentWeapon] -= toTransfer;
+            } else {
+                // Weapons without reserve (shotgun, rocket) just refill
+                state->currentAmmo[state->currentWeapon] = stats.magSize;
+            }
+        }
+    } else {
+        // Auto-reload when magazine is empty and we have more ammo
+        WeaponStats stats = WEAPON_STATS[state->currentWeapon];
+        if (stats.magSize > 0) {  // Not unlimited ammo weapon
+            int currentMag = state->currentAmmo[state->currentWeapon];
+            if (currentMag == 0) {
+                // Check if we have ammo to reload
+                if (stats.maxReserve > 0) {
+                    // Weapons with reserve - check reserve ammo
+                    if (state->reserveAmmo[state->currentWeapon] > 0) {
+                        weaponReload(state);
+                    }
+                } else {
+                    // Weapons without reserve (shotgun, rocket) - always can reload
+                    weaponReload(state);
+                }
+            }
+        }
+    }
+}
+
+void weaponAddAmmo(WeaponState *state, WeaponType weaponType, int amount) {
+    if (weaponType < 0 || weaponType >= WeaponTypeCount) {
+        return;
+    }
+
+    WeaponStats stats = WEAPON_STATS[weaponType];
+
+    // Unlimited ammo weapons don't need ammo pickups
+    if (stats.magSize == 0) {
+        return;
+    }
+
+    if (stats.maxReserve > 0) {
+        // Add to reserve
+        state->reserveAmmo[weaponType] += amount;
+        if (state->reserveAmmo[weaponType] > stats.maxReserve) {
+            state->reserveAmmo[weaponType] = stats.maxReserve;
+        }
+    } else {
+        // Add directly to magazine (for shotgun, rocket launcher)
+        state->currentAmmo[weaponType] += amount;
+        if (state->currentAmmo[weaponType] > stats.magSize) {
+            state->currentAmmo[weaponType] = stats.magSize;
+        }
+    }
+}
@@ -0,0 +1,77 @@
+// SimWeapons.h - Weapon stats and per-player weapon state (portable C)
+#ifndef SIMWEAPONS_H
+#define SIMWEAPONS_H
+
+#include "SimTypes.h"
+#include "SimRandom.h"
+#include "GameConfig.h"
+
+// Weapon type enumeration
+typedef enum {
+    WeaponTypePistol = 0,       // Default, unlimited ammo, medium fire rate
+    WeaponTypeShotgun,          // Slow fire rate, spread pattern
+    WeaponTypeAssaultRifle,     // Fast fire rate, large magazine
+    WeaponTypeRocketLauncher,   // Slow, high damage + splash
+    WeaponTypeCount             // Number of weapon types
+} WeaponType;
+
+// Maximum number of spread directions (for shotgun pellets)
+#define MAX_SPREAD_DIRECTIONS 8
+
+// Weapon statistics structure
+typedef struct {
+    int damage;                 // Damage per projectile/pellet
+    int fireRate;               // Frames between shots (lower = faster)
+    float spread;               // Spread angle in radians (0 = perfectly accurate)
+    int projectileCount;        // Number of projectiles per shot (1 for most, 8 for shotgun)
+    int magSize;                // Magazine size (0 = unlimited)
+    int maxReserve;             // Maximum reserve ammo (0 = unlimited)
+    int reloadTime;             // Frames to reload (60 frames = 1 second at 60fps)
+    float range;                // Maximum effective range
+    float splashRadius;         // Splash damage radius (0 = no splash)
+    int splashDamage;           // Splash damage amount
+} WeaponStats;
+
+// Weapon state structure
+typedef struct {
+    WeaponType currentWeapon;
+    int currentAmmo[WeaponTypeCount];   // Ammo in current magazine for each weapon
+    int reserveAmmo[WeaponTypeCount];   // Reserve ammo for each weapon
+    BOOL isReloading;
+    int reloadTimer;                     // Frames remaining in reload
+    int fireTimer;                       // Frames until can fire again
+} WeaponState;
+
+// Spread direction result (for shotgun and other spread weapons)
+typedef struct {
+    int count;                           // Number of directions
+    SimVec3 directions[MAX_SPREAD_DIRECTIONS];
+} SpreadDirections;
+
+// Stats for a weapon type (pistol for out-of-range types)
+WeaponStats weaponStats(WeaponType weaponType);
+
+// Pistol selected, full magazines and reserves
+void weaponReset(WeaponState *state);
+
+// Switch weapons - owned[type] says which weapons the player has picked up (pistol is always owned).
+// Returns NO while reloading, for the current weapon, or for a weapon not owned.
+BOOL weaponSwitch(WeaponState *state, WeaponType weaponType, const BOOL *owned);
+
+BOOL weaponCanFire(const WeaponState *state);
+BOOL weaponNeedsReload(const WeaponState *state);
+
+// Fire the current weapon - fills outSpread (optional) with one direction per projectile.
+// Returns YES if the weapon fired.
+BOOL weaponFire(WeaponState *state, SimRng *rng, SimVec3 baseDir, SpreadDirections *outSpread);
+
+// Start reloading the current weapon
+BOOL weaponReload(WeaponState *state);
+
+// Advance fire and reload timers by one tick (auto-reloads an empty magazine)
+void weaponUpdate(WeaponState *state);
+
+// Add ammo for a specific weapon type
+void weaponAddAmmo(WeaponState *state, WeaponType weaponType, int amount);
+
+#endif // SIMWEAPONS_H
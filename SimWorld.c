@@ -0,0 +1,551 @@
+// SimWorld.c - Simulation world state and the fixed-tick step
+#include "SimWorld.h"
+#include "SimProfile.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+static void initSpawnPoints(SimWorld *world) {
+    // Spawn points in SAFE locations with cover nearby
+    // All spawns face toward center of map where action is
+
+    // Spawn 0: Inside command building (protected by walls on 3 sides)
+    // Position near back wall, facing the door
+    world->spawnPoints[0] = (SpawnPoint){
+        .x = CMD_BUILDING_X,
+        .y = FLOOR_Y + PLAYER_HEIGHT,
+        .z = CMD_BUILDING_Z - (CMD_BUILDING_DEPTH / 2.0f) + 1.5f,  // Near back wall
+        .yaw = 0.0f  // Face south toward door/exit
+    };
+
+    // Spawn 1: Inside bunker (underground, fully protected)
+    // Position in center of bunker room
+    world->spawnPoints[1] = (SpawnPoint){
+        .x = BUNKER_X,
+        .y = BASEMENT_LEVEL + PLAYER_HEIGHT,  // Underground level
+        .z = BUNKER_Z,
+        .yaw = M_PI * 0.5f  // Face east toward stairs/exit
+    };
+
+    // Spawn 2: Behind cargo containers (east side, has cover nearby)
+    // Position behind container cluster
+    world->spawnPoints[2] = (SpawnPoint){
+        .x = 12.0f,  // Behind containers on east side
+        .y = FLOOR_Y + PLAYER_HEIGHT,
+        .z = -6.0f,
+        .yaw = M_PI * 0.75f  // Face toward center (northwest)
+    };
+
+    // Spawn 3: On northeast guard tower platform (elevated, railings for cover)
+    world->spawnPoints[3] = (SpawnPoint){
+        .x = TOWER_OFFSET,
+        .y = PLATFORM_LEVEL + PLAYER_HEIGHT,  // On tower platform
+        .z = TOWER_OFFSET,
+        .yaw = M_PI * 1.25f  // Face toward center (southwest)
+    };
+
+    // Spawn 4: Behind sandbag wall near west side (good cover position)
+    world->spawnPoints[4] = (SpawnPoint){
+        .x = -12.0f,  // West side behind sandbags
+        .y = FLOOR_Y + PLAYER_HEIGHT,
+        .z = 0.0f,
+        .yaw = 0.0f  // Face east toward center
+    };
+
+    // Spawn 5: On southwest guard tower platform (elevated, opposite corner from spawn 3)
+    world->spawnPoints[5] = (SpawnPoint){
+        .x = -TOWER_OFFSET,
+        .y = PLATFORM_LEVEL + PLAYER_HEIGHT,  // On tower platform
+        .z = -TOWER_OFFSET,
+        .yaw = M_PI * 0.25f  // Face toward center (northeast)
+    };
+}
+
+// Full health, pistol only, starting ammo
+static void resetPlayer(SimPlayer *player) {
+    player->alive = YES;
+    player->health = PLAYER_MAX_HEALTH;
+    player->armor = 0;
+    player->bloodLevel = 0.0f;
+    player->bloodFlashTimer = 0;
+    player->damageCooldownTimer = 0;
+    player->regenTickTimer = 0;
+    player->footstepTimer = 0;
+    player->spawnProtectionTimer = SPAWN_PROTECTION_TIME;  // 3 seconds of spawn protection
+    player->muzzleFlashTimer = 0;
+    player->shooting = NO;
+    player->nearDoor = NO;
+
+    // Weapon ownership (start with pistol only)
+    weaponReset(&player->weapons);
+    for (int w = 0; w < WeaponTypeCount; w++) {
+        player->hasWeapon[w] = (w == WeaponTypePistol);
+    }
+
+    // Ammo counts
+    player->ammoSmall = 50;    // Starting pistol/rifle ammo
+    player->ammoHeavy = 0;     // No heavy ammo to start
+
+    player->kills = 0;
+    player->botKills = 0;
+    player->respawnTimer = 0;
+}
+
+static void resetDoorAndCombat(SimWorld *world) {
+    // Door state
+    world->doorOpen = NO;
+    world->doorAngle = 0.0f;
+
+    // Combat state
+    world->enemyMuzzleFlashTimer = 0;
+    world->enemyMuzzlePos = simVec3(0, 0, 0);
+    world->lastFiringEnemy = -1;
+
+    world->gameWon = NO;
+    world->winnerId = -1;
+    world->eventCount = 0;
+}
+
+// Restart every random stream from the match seed
+static void seedStreams(SimWorld *world) {
+    simRngSeed(&world->rng, world->seed, simRngStreamId(SimRngStreamWorld, 0));
+    for (int p = 0; p < world->playerCount; p++) {
+        simRngSeed(&world->players[p].rng, world->seed, simRngStreamId(SimRngStreamPlayer, (uint32_t)p));
+    }
+
+    SimBots bots = simBots(world);
+    for (int e = 0; e < bots.count; e++) {
+        simRngSeed(&bots.ai[e].rng, world->seed, simRngStreamId(SimRngStreamBot, (uint32_t)e));
+    }
+}
+
+SimWorld *simCreate(SimCollision *collision) {
+    return simCreateWithBots(collision, NUM_ENEMIES);
+}
+
+SimWorld *simCreateWithBots(SimCollision *collision, int botCapacity) {
+    if (botCapacity < 0) return NULL;
+
+    size_t size = simWorldSizeForBots(botCapacity);
+    SimWorld *world = calloc(1, size);
+    if (!world) return NULL;
+
+    world->size = size;
+    world->botPool.capacity = botCapacity;
+    world->botPool.freeHead = -1;
+    world->collision = collision;
+    world->doorShapeId = -1;
+    world->killLimit = DEFAULT_KILL_LIMIT;
+    world->botSchedule.thinkBudget = SIM_BOT_THINK_BUDGET;
+    world->botPerception.tolerance = SIM_SIGHT_TOLERANCE;
+    world->botPerception.maxAge = SIM_SIGHT_MAX_AGE;
+    world->seed = SIM_DEFAULT_SEED;
+    simInitEntityHashes(world);
+    initSpawnPoints(world);
+    simInitPickups(world);
+
+    simAddPlayer(world, 0, NO);
+    simResetGame(world);
+    return world;
+}
+
+void simDestroy(SimWorld *world) {
+    free(world);
+}
+
+void simSetJobSystem(SimWorld *world, SimJobSystem *jobs) {
+    world->jobs = jobs;
+}
+
+void simResetGame(SimWorld *world) {
+    world->isMultiplayer = NO;
+    world->tick = 0;
+    seedStreams(world);
+
+    for (int p = 0; p < world->playerCount; p++) {
+        SimPlayer *player = &world->players[p];
+        resetPlayer(player);
+
+        // Remote players are inactive in single-player
+        if (player->isRemote) {
+            player->alive = NO;
+            player->health = 0;
+            player->position = simVec3(0, 0, 0);
+            player->yaw = 0.0f;
+            player->pitch = 0.0f;
+        }
+    }
+
+    // Enemy state (for single-player mode) - the roster on a new world or after multiplayer
+    if (world->botPool.spawnedCount == 0) {
+        simSpawnBotRoster(world);
+    } else {
+        simRespawnBots(world);
+    }
+
+    // Note: killLimit is preserved (set in simCreate or by caller)
+    resetDoorAndCombat(world);
+}
+
+void simResetForMultiplayer(SimWorld *world, BOOL isHost) {
+    world->isMultiplayer = YES;
+    world->tick = 0;
+    seedStreams(world);
+
+    // Position players at OPPOSITE spawn points - deterministic based on host/client
+    // Spawn 0 (command building) and Spawn 2 (east cargo) are far apart
+    // Host ALWAYS gets spawn 0, Client ALWAYS gets spawn 2
+    int hostSpawnIndex = 0;   // Command building
+    int clientSpawnIndex = 2; // East cargo (opposite side of map)
+
+    for (int p = 0; p < world->playerCount; p++) {
+        SimPlayer *player = &world->players[p];
+
+        // Weapons carry over - only a respawn resets them
+        WeaponState weapons = player->weapons;
+        resetPlayer(player);
+        player->weapons = weapons;
+
+        if (p < 2) {
+            BOOL hostSide = (p == 0) == isHost;
+            player->spawnIndex = hostSide ? hostSpawnIndex : clientSpawnIndex;
+        } else {
+            player->spawnIndex = p % NUM_SPAWN_POINTS;
+        }
+
+        // Local players are placed by simRespawnPlayer, remote ones wait for their first update
+        SpawnPoint *spawn = simGetSpawnPoint(world, player->spawnIndex);
+        if (player->isRemote && spawn) {
+            player->position = simVec3(spawn->x, spawn->y, spawn->z);
+            player->yaw = spawn->yaw;
+            player->pitch = 0.0f;
+        }
+    }
+
+    // Disable AI enemies in multiplayer mode
+    simClearBots(world);
+
+    resetDoorAndCombat(world);
+}
+
+int simAddPlayer(SimWorld *world, int playerId, BOOL isRemote) {
+    if (world->playerCount >= SIM_MAX_PLAYERS) return -1;
+
+    int index = world->playerCount++;
+    SimPlayer *player = &world->players[index];
+    memset(player, 0, sizeof(*player));
+    player->playerId = playerId;
+    player->isRemote = isRemote;
+    simRngSeed(&player->rng, world->seed, simRngStreamId(SimRngStreamPlayer, (uint32_t)index));
+    resetPlayer(player);
+
+    player->spawnIndex = index % NUM_SPAWN_POINTS;
+    simRespawnPlayer(world, index, player->spawnIndex);
+    return index;
+}
+
+SpawnPoint *simGetSpawnPoint(SimWorld *world, int index) {
+    if (index < 0 || index >= NUM_SPAWN_POINTS) {
+        return NULL;
+    }
+    return &world->spawnPoints[index];
+}
+
+int simChooseSpawnPoint(SimWorld *world, int playerIndex) {
+    if (!world->isMultiplayer) {
+        // Single-player: randomly select from safe spawn points
+        return simRngRange(&world->rng, NUM_SPAWN_POINTS);
+    }
+
+    // In multiplayer, find the spawn point furthest from the other players
+    int bestSpawn = world->players[playerIndex].spawnIndex;  // Default to assigned spawn
+    float bestDistance = 0.0f;
+
+    for (int i = 0; i < NUM_SPAWN_POINTS; i++) {
+        const SpawnPoint *spawn = &world->spawnPoints[i];
+
+        // Distance to the closest other living player
+        float dist = INFINITY;
+        for (int p = 0; p < world->playerCount; p++) {
+            if (p == playerIndex || !world->players[p].alive) continue;
+            float dx = spawn->x - world->players[p].position.x;
+            float dz = spawn->z - world->players[p].position.z;
+            dist = fminf(dist, sqrtf(dx * dx + dz * dz));
+        }
+
+        // Prefer spawn points far from other players
+        if (dist != INFINITY && dist > bestDistance) {
+            bestDistance = dist;
+            bestSpawn = i;
+        }
+    }
+
+    return bestSpawn;
+}
+
+void simRespawnPlayer(SimWorld *world, int playerIndex, int spawnIndex) {
+    SimPlayer *player = &world->players[playerIndex];
+    SpawnPoint *spawn = simGetSpawnPoint(world, spawnIndex);
+    if (!spawn) {
+        // Fallback to spawn 0 (inside command building)
+        spawn = &world->spawnPoints[0];
+    }
+
+    // Reset spawn protection timer
+    player->spawnProtectionTimer = SPAWN_PROTECTION_TIME;
+
+    player->position = simVec3(spawn->x, spawn->y, spawn->z);
+    player->yaw = spawn->yaw;
+    player->pitch = 0.0f;
+    player->velocity = simVec3(0, 0, 0);
+    player->onGround = YES;
+}
+
+BOOL simCheckWinCondition(SimWorld *world) {
+    // Only check in multiplayer mode
+    if (!world->isMultiplayer) {
+        return NO;
+    }
+
+    // Already won
+    if (world->gameWon) {
+        return YES;
+    }
+
+    // Check if any player reached kill limit
+    for (int p = 0; p < world->playerCount; p++) {
+        if (world->players[p].kills >= world->killLimit) {
+            world->gameWon = YES;
+            world->winnerId = world->players[p].playerId;
+            return YES;
+        }
+    }
+
+    return NO;
+}
+
+void simPushEvent(SimWorld *world, SimEventType type, int player, int target, int value, int amount, float volume) {
+    if (world->eventCount >= SIM_MAX_EVENTS) return;
+
+    SimEvent *event = &world->events[world->eventCount++];
+    event->type = type;
+    event->player = player;
+    event->target = target;
+    event->value = value;
+    event->amount = amount;
+    event->volume = volume;
+}
+
+// ============================================
+// PLAYER MOVEMENT
+// ============================================
+
+// Physics update order:
+// 1. Apply input acceleration to velocity
+// 2. Apply gravity to velocity
+// 3. Move player by velocity (swept, with collision detection)
+// 4. Resolve collisions and set onGround flag
+static void movePlayer(SimWorld *world, int playerIndex, const SimInput *input) {
+    SimPlayer *player = &world->players[playerIndex];
+    SimCollision *collision = world->collision;
+    unsigned int buttons = (input && input->active) ? input->buttons : 0;
+
+    // --- STEP 1: Apply input acceleration ---
+    if (input && input->active) {
+        float fwdX = sinf(player->yaw);
+        float fwdZ = -cosf(player->yaw);
+        float rgtX = cosf(player->yaw);
+        float rgtZ = sinf(player->yaw);
+
+        float strafeAccel = MOVE_ACCEL * STRAFE_MULTIPLIER;
+        if (buttons & SimButtonForward) { player->velocity.x += fwdX * MOVE_ACCEL; player->velocity.z += fwdZ * MOVE_ACCEL; }
+        if (buttons & SimButtonBack) { player->velocity.x -= fwdX * MOVE_ACCEL; player->velocity.z -= fwdZ * MOVE_ACCEL; }
+        if (buttons & SimButtonLeft) { player->velocity.x -= rgtX * strafeAccel; player->velocity.z -= rgtZ * strafeAccel; }
+        if (buttons & SimButtonRight) { player->velocity.x += rgtX * strafeAccel; player->velocity.z += rgtZ * strafeAccel; }
+    }
+
+    // Clamp horizontal speed
+    float hSpeed = sqrtf(player->velocity.x * player->velocity.x + player->velocity.z * player->velocity.z);
+    if (hSpeed > MAX_SPEED) {
+        player->velocity.x *= MAX_SPEED / hSpeed;
+        player->velocity.z *= MAX_SPEED / hSpeed;
+    }
+
+    // Apply friction to horizontal movement
+    player->velocity.x *= MOVE_FRICTION;
+    player->velocity.z *= MOVE_FRICTION;
+
+    // --- STEP 2: Apply gravity ---
+    player->velocity.y -= GRAVITY;
+
+    // Clamp terminal velocity
+    if (player->velocity.y < -0.5f) player->velocity.y = -0.5f;
+
+    // --- STEP 3: Move player (swept, so fast moves can't tunnel through thin shapes) ---
+    SweepMoveResult sweepResult = simCollisionSweepPlayer(collision, player->position, player->velocity,
+                                                          PLAYER_RADIUS, PLAYER_HEIGHT);
+    player->position = sweepResult.position;
+    if (sweepResult.hit) {
+        player->velocity = sweepResult.slideVelocity;
+    }
+
+    // --- STEP 4: Ground detection ---
+    player->onGround = NO;
+    GroundResult groundResult = simCollisionCheckGround(collision, player->position.x, player->position.y,
+                                                        player->position.z, PLAYER_RADIUS, PLAYER_HEIGHT);
+
+    // Apply ground collision
+    if (groundResult.onGround) {
+        player->position.y = groundResult.groundY + PLAYER_HEIGHT;
+        player->velocity.y = 0;
+        player->onGround = YES;
+
+        // Auto-jump when holding jump (bunny hop)
+        if (buttons & SimButtonJump) {
+            player->velocity.y = JUMP_VELOCITY;
+            player->onGround = NO;
+
+            // Bhop acceleration - boost horizontal speed each hop
+            float hopSpeed = sqrtf(player->velocity.x * player->velocity.x + player->velocity.z * player->velocity.z);
+            if (hopSpeed > 0.01f && hopSpeed < BHOP_MAX_SPEED) {
+                float boost = fminf(BHOP_SPEED_BOOST, BHOP_MAX_SPEED / hopSpeed);
+                player->velocity.x *= boost;
+                player->velocity.z *= boost;
+            }
+        }
+    }
+
+    // --- Wall collision (overlap push-out after the ground snap) ---
+    MoveResult moveResult = simCollisionMovePlayer(collision, player->position, player->velocity,
+                                                   PLAYER_RADIUS, PLAYER_HEIGHT);
+
+    if (moveResult.collided) {
+        player->position = simAdd(player->position, moveResult.pushOut);
+        player->velocity = moveResult.newVelocity;
+
+        // Check if we landed on something
+        if (moveResult.pushOut.y > 0 && player->velocity.y == 0) {
+            player->onGround = YES;
+        }
+    }
+
+    // --- Footstep sounds ---
+    float currentSpeed = sqrtf(player->velocity.x * player->velocity.x +
+                               player->velocity.z * player->velocity.z);
+    if (player->onGround && currentSpeed > 0.03f) {
+        player->footstepTimer++;
+        if (player->footstepTimer >= 20) {
+            player->footstepTimer = 0;
+            simPushEvent(world, SimEventFootstep, playerIndex, -1, 0, 0, 1.0f);
+        }
+    } else {
+        player->footstepTimer = 12;
+    }
+}
+
+// ============================================
+// STEP
+// ============================================
+
+static BOOL canAct(const SimWorld *world, const SimPlayer *player) {
+    return player->alive && !world->gameWon;
+}
+
+// Pickups - 1 frame delta
+static void updatePickupTimers(void *context, int unused) {
+    (void)unused;
+    simUpdatePickups(context, 1.0f);
+}
+
+void simStep(SimWorld *world, const SimInput *inputs) {
+    SIM_PROFILE_ZONE("simStep");
+    world->eventCount = 0;
+
+    // Look, weapon selection, movement and the door
+    SIM_PROFILE_BEGIN(playersZone, "players");
+    for (int p = 0; p < world->playerCount; p++) {
+        SimPlayer *player = &world->players[p];
+        if (player->isRemote) continue;
+
+        const SimInput *input = inputs ? &inputs[p] : NULL;
+        player->shooting = NO;
+        player->inputActive = input && input->active;
+
+        if (input) {
+            player->yaw = input->yaw;
+            player->pitch = input->pitch;
+        }
+
+        if (canAct(world, player)) {
+            if (input && input->weaponSlot >= 0) {
+                weaponSwitch(&player->weapons, (WeaponType)input->weaponSlot, player->hasWeapon);
+            }
+            if (input && (input->buttons & SimButtonReload)) {
+                weaponReload(&player->weapons);
+            }
+
+            movePlayer(world, p, input);
+        }
+
+        // Update door proximity
+        player->nearDoor = simPlayerNearDoor(player->position);
+        if (input && (input->buttons & SimButtonUse) && player->nearDoor && canAct(world, player)) {
+            world->doorOpen = !world->doorOpen;
+            simPushEvent(world, SimEventDoor, p, -1, world->doorOpen, 0, 1.0f);
+        }
+    }
+    SIM_PROFILE_END(playersZone);
+
+    // Animate door
+    simUpdateDoor(world);
+
+    // Shooting - players are filed where they stand now (remote ones are placed from outside)
+    SIM_PROFILE_BEGIN(shootingZone, "shooting");
+    SpatialHash playerGrid = simEntityHash(world, SimEntityPlayers);
+    for (int p = 0; p < world->playerCount; p++) {
+        spatialHashMove(&playerGrid, p, world->players[p].position.x, world->players[p].position.z);
+    }
+    for (int p = 0; p < world->playerCount; p++) {
+        SimPlayer *player = &world->players[p];
+        if (player->isRemote || !player->inputActive || !canAct(world, player)) continue;
+
+        if (inputs[p].buttons & SimButtonFire) {
+            simProcessPlayerShooting(world, p);
+        }
+    }
+    SIM_PROFILE_END(shootingZone);
+
+    // Enemy AI alongside the pickup timers - they touch separate state
+    SIM_PROFILE_BEGIN(botsZone, "bots and pickups");
+    SimJobGraph graph;
+    simJobGraphInit(&graph);
+    BOOL botsQueued = simAddBotJobs(world, &graph);
+    if (simJobGraphAdd(&graph, updatePickupTimers, world, 1, 1) < 0) {
+        updatePickupTimers(world, 0);
+    }
+    simCollisionPrepareQueries(world->collision);
+    simJobGraphRun(world->jobs, &graph);
+    if (!botsQueued) {
+        // No room in the graph - same update, one stage at a time on this thread
+        simUpdateBotsSerial(world);
+    }
+    SIM_PROFILE_END(botsZone);
+
+    // Pickups
+    for (int p = 0; p < world->playerCount; p++) {
+        SimPlayer *player = &world->players[p];
+        if (!player->isRemote && canAct(world, player)) {
+            simCheckPlayerPickup(world, p);
+        }
+    }
+
+    // Update timers
+    simUpdateCombatTimers(world);
+    for (int p = 0; p < world->playerCount; p++) {
+        if (!world->players[p].isRemote) {
+            simUpdateHealthRegeneration(world, p);
+        }
+    }
+
+    world->tick++;
+}
@@ -0,0 +1,257 @@
+// SimWorld.h - Headless simulation world: players, bots, pickups, door, one fixed tick per simStep
+#ifndef SIMWORLD_H
+#define SIMWORLD_H
+
+#include "SimTypes.h"
+#include "SimRandom.h"
+#include "GameConfig.h"
+#include "SimCollision.h"
+#include "SimJobs.h"
+#include "SimWeapons.h"
+#include "SimPickups.h"
+#include "SimEnemy.h"
+#include "SimCombat.h"
+#include "SimDoor.h"
+#include "SpatialHash.h"
+
+// Multiplayer constants
+static const int RESPAWN_DELAY = 180;  // 3 seconds at 60fps
+static const int DEFAULT_KILL_LIMIT = 10;
+enum { NUM_SPAWN_POINTS = 6 };
+
+// Spawn protection constants
+static const int SPAWN_PROTECTION_TIME = 180;  // 3 seconds at 60fps
+
+// Spawn point structure
+typedef struct {
+    float x;
+    float y;
+    float z;
+    float yaw;  // Initial facing direction
+} SpawnPoint;
+
+// ============================================
+// PLAYERS
+// ============================================
+
+#define SIM_MAX_PLAYERS 8
+
+typedef struct {
+    int playerId;
+    BOOL isRemote;              // Driven from outside (network proxy) - never moved or damaged here
+    BOOL alive;
+    BOOL inputActive;           // Last input had controls captured
+
+    // Movement (position is eye level)
+    SimVec3 position;
+    SimVec3 velocity;
+    float yaw;
+    float pitch;
+    BOOL onGround;
+    BOOL nearDoor;
+    BOOL shooting;              // Fired this tick
+
+    // Health
+    int health;
+    int armor;                  // Armor points (reduces damage by 50%)
+    float bloodLevel;
+    int bloodFlashTimer;
+    int damageCooldownTimer;
+    int regenTickTimer;
+    int footstepTimer;
+    int spawnProtectionTimer;   // Counts down in frames, player invulnerable when > 0
+    int muzzleFlashTimer;
+
+    // Weapons
+    WeaponState weapons;
+    BOOL hasWeapon[WeaponTypeCount];   // Picked up (pistol is always owned)
+    int ammoSmall;              // Pistol/rifle ammo
+    int ammoHeavy;              // Shotgun/rocket ammo
+
+    // Scoring
+    int kills;                  // Multiplayer kills
+    int botKills;               // Bots killed (single-player kill counter)
+    int respawnTimer;           // Counts down in frames (multiplayer)
+    int spawnIndex;             // Spawn point assigned for the match (multiplayer)
+
+    SimRng rng;                 // Weapon spread
+} SimPlayer;
+
+// ============================================
+// INPUT
+// ============================================
+
+typedef enum {
+    SimButtonForward = 1 << 0,
+    SimButtonBack    = 1 << 1,
+    SimButtonLeft    = 1 << 2,
+    SimButtonRight   = 1 << 3,
+    SimButtonJump    = 1 << 4,  // Held - jumps (and bunny hops) whenever grounded
+    SimButtonFire    = 1 << 5,  // Fire this tick (the caller applies its own trigger timing)
+    SimButtonReload  = 1 << 6,
+    SimButtonUse     = 1 << 7,  // Toggle the door when near it
+} SimButton;
+
+// One tick of input for one player
+typedef struct {
+    unsigned int buttons;       // SimButton bits
+    int weaponSlot;             // WeaponType to switch to, or -1
+    float yaw;
+    float pitch;
+    BOOL active;                // Controls captured - when NO the player doesn't accelerate and bots ignore them
+} SimInput;
+
+// ============================================
+// EVENTS
+// ============================================
+
+// Things the host may want to present (sounds, HUD, network) - cleared at the start of each step
+typedef enum {
+    SimEventGunshot,            // player fired
+    SimEventEnemyGunshot,       // bot index in value, volume by distance to the target player
+    SimEventFootstep,           // player
+    SimEventPickup,             // player, value = PickupType, amount
+    SimEventPlayerHit,          // player hit player target for amount (a remote target's owner applies the damage)
+    SimEventPlayerKill,         // player killed local player target
+    SimEventDoor,               // player toggled the door
+} SimEventType;
+
+typedef struct {
+    SimEventType type;
+    int player;                 // Player index the event belongs to
+    int target;                 // Player index hit or killed (SimEventPlayerHit, SimEventPlayerKill)
+    int value;
+    int amount;
+    float volume;
+} SimEvent;
+
+#define SIM_MAX_EVENTS 64
+
+// ============================================
+// ENTITY GRIDS
+// ============================================
+
+// Each kind of entity is filed by XZ position in its own grid, so proximity checks only
+// look at what is nearby. Entries are player, bot and pickup indices.
+typedef enum {
+    SimEntityPlayers,           // Filed at the start of shooting each tick (remote ones move from outside)
+    SimEntityBots,              // Refiled as they spawn, move, respawn and despawn
+    SimEntityPickups,           // Filed once - pickups don't move
+    SimEntityKindCount
+} SimEntityKind;
+
+// Where one kind's grid lives in the world block - an offset rather than pointers, so
+// copies of the world stay valid. Has no padding: the world is hashed and compared as bytes.
+typedef struct {
+    size_t offset;              // Bytes from the world to the grid's arrays
+    float cellSize;
+    int size;                   // Cells per side
+    int entryCount;
+    int reserved;               // Always 0 - fills what would be trailing padding
+} SimEntityGrid;
+
+// ============================================
+// WORLD
+// ============================================
+
+// The world is one allocation: this struct, then the bot arrays (see SimBots), then the
+// entity grids (see simEntityHash). size covers all of it, so a copy of the world is a
+// memcpy of size bytes.
+struct SimWorld {
+    size_t size;                // Bytes in the whole block
+    SimCollision *collision;    // Not owned
+    SimJobSystem *jobs;         // Not owned - NULL runs every update on the calling thread
+    unsigned int tick;
+
+    // Match seed - simResetGame and simResetForMultiplayer reseed every random stream from it,
+    // so a match replays exactly from the same seed and inputs
+    uint64_t seed;
+    SimRng rng;                 // World stream (spawn picking)
+
+    // Players - index 0 is the local player in the app
+    SimPlayer players[SIM_MAX_PLAYERS];
+    int playerCount;
+    BOOL isMultiplayer;
+
+    // Bots (single-player) - the arrays follow this struct, simBots finds them
+    SimBotPool botPool;
+    SimBotSchedule botSchedule;
+    SimBotPerception botPerception;
+    int enemyMuzzleFlashTimer;
+    SimVec3 enemyMuzzlePos;
+    int lastFiringEnemy;
+    SimVec3 pursuitGoal[SIM_MAX_PLAYERS];     // Where the flow field toward each player leads
+    BOOL pursuitGoalSet[SIM_MAX_PLAYERS];
+
+    // Door
+    BOOL doorOpen;
+    float doorAngle;
+    int doorShapeId;            // Dynamic collision shape (re-added if the collision world was rebuilt)
+
+    // Pickups
+    Pickup pickups[MAX_PICKUPS];
+    int pickupCount;
+    float pickupTime;           // For bob animation sync
+
+    // Match
+    int killLimit;
+    BOOL gameWon;
+    int winnerId;
+    SpawnPoint spawnPoints[NUM_SPAWN_POINTS];
+
+    SimEvent events[SIM_MAX_EVENTS];
+    int eventCount;
+
+    SimEntityGrid entityGrids[SimEntityKindCount];
+};
+
+// Create a world over an already built collision world. Starts as a single-player game with
+// one player and the bot roster, with room for NUM_ENEMIES bots.
+SimWorld *simCreate(SimCollision *collision);
+
+// Same, with room for botCapacity bots (stress tests, bot-filled servers)
+SimWorld *simCreateWithBots(SimCollision *collision, int botCapacity);
+void simDestroy(SimWorld *world);
+
+// Worker threads for the per-tick updates (not owned; NULL, the default, runs them inline).
+// Results are the same with or without one.
+void simSetJobSystem(SimWorld *world, SimJobSystem *jobs);
+
+// Reset all state for a single-player game (kill limit is kept). Bots are brought back to
+// their home positions, or the roster spawned if there are none.
+void simResetGame(SimWorld *world);
+
+// Reset for a new multiplayer match - bots off, players 0 and 1 at opposite spawns.
+// Host gets spawn 0, client spawn 2; player 0 is placed by simRespawnPlayer.
+void simResetForMultiplayer(SimWorld *world, BOOL isHost);
+
+// Add a player (YES for one driven from outside). Returns its index, or -1 when full.
+int simAddPlayer(SimWorld *world, int playerId, BOOL isRemote);
+
+// Get spawn point by index (NULL if invalid index)
+SpawnPoint *simGetSpawnPoint(SimWorld *world, int index);
+
+// Spawn point for a player - the one furthest from the other players in multiplayer,
+// a random one in single-player
+int simChooseSpawnPoint(SimWorld *world, int playerIndex);
+
+// Move a player to a spawn point with zero velocity, restart spawn protection
+void simRespawnPlayer(SimWorld *world, int playerIndex, int spawnIndex);
+
+// Check if someone reached kill limit, sets gameWon and winnerId if so.
+// Returns YES if game has been won.
+BOOL simCheckWinCondition(SimWorld *world);
+
+// Advance one fixed tick. inputs[i] drives players[i] (remote players ignore theirs);
+// inputs may be NULL for no input at all.
+void simStep(SimWorld *world, const SimInput *inputs);
+
+void simPushEvent(SimWorld *world, SimEventType type, int player, int target, int value, int amount, float volume);
+
+// Find and empty the world's entity grids (when it is created)
+void simInitEntityHashes(SimWorld *world);
+
+// The grid for one kind of entity, pointing into the world block
+SpatialHash simEntityHash(SimWorld *world, SimEntityKind kind);
+
+#endif // SIMWORLD_H
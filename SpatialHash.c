@@ -0,0 +1,174 @@
+// SpatialHash.c - Uniform XZ grid of moving entries implementation
+#include "SpatialHash.h"
+#include <math.h>
+
+static int clampIndex(int i, int size) {
+    if (i < 0) return 0;
+    if (i >= size) return size - 1;
+    return i;
+}
+
+static int columnOf(const SpatialHash *hash, float x) {
+    return clampIndex((int)floorf((x - hash->minX) / hash->cellSize), hash->sizeX);
+}
+
+static int rowOf(const SpatialHash *hash, float z) {
+    return clampIndex((int)floorf((z - hash->minZ) / hash->cellSize), hash->sizeZ);
+}
+
+static void unlinkEntry(SpatialHash *hash, int entry) {
+    int cell = hash->entryCell[entry];
+    int prev = hash->entryPrev[entry];
+    int next = hash->entryNext[entry];
+    if (prev >= 0) hash->entryNext[prev] = next;
+    else hash->cellHead[cell] = next;
+    if (next >= 0) hash->entryPrev[next] = prev;
+    hash->entryCell[entry] = -1;
+}
+
+void spatialHashClear(SpatialHash *hash) {
+    for (int c = 0; c < hash->cellCount; c++) {
+        hash->cellHead[c] = -1;
+    }
+    for (int i = 0; i < hash->entryCount; i++) {
+        hash->entryCell[i] = -1;
+        hash->entryNext[i] = -1;
+        hash->entryPrev[i] = -1;
+        hash->entryX[i] = 0;
+        hash->entryZ[i] = 0;
+    }
+}
+
+void spatialHashMove(SpatialHash *hash, int entry, float x, float z) {
+    hash->entryX[entry] = x;
+    hash->entryZ[entry] = z;
+
+    int cell = rowOf(hash, z) * hash->sizeX + columnOf(hash, x);
+    if (cell == hash->entryCell[entry]) return;
+
+    if (hash->entryCell[entry] >= 0) unlinkEntry(hash, entry);
+    int head = hash->cellHead[cell];
+    hash->entryCell[entry] = cell;
+    hash->entryPrev[entry] = -1;
+    hash->entryNext[entry] = head;
+    if (head >= 0) hash->entryPrev[head] = entry;
+    hash->cellHead[cell] = entry;
+}
+
+void spatialHashRemove(SpatialHash *hash, int entry) {
+    if (hash->entryCell[entry] >= 0) unlinkEntry(hash, entry);
+}
+
+// ============================================
+// QUERIES
+// ============================================
+
+// Cells come out in grid order and entries in list order - sort what was written by entry
+// (insertion sort: results are short, usually a handful)
+static int finishQuery(int *outEntries, int maxEntries, int found) {
+    int written = found < maxEntries ? found : maxEntries;
+    for (int i = 1; i < written; i++) {
+        int entry = outEntries[i];
+        int j = i;
+        while (j > 0 && outEntries[j - 1] > entry) {
+            outEntries[j] = outEntries[j - 1];
+            j--;
+        }
+        outEntries[j] = entry;
+    }
+    return found;
+}
+
+int spatialHashQueryRadius(const SpatialHash *hash, float x, float z, float radius,
+                           int *outEntries, int maxEntries) {
+    int x0 = columnOf(hash, x - radius);
+    int x1 = columnOf(hash, x + radius);
+    int z0 = rowOf(hash, z - radius);
+    int z1 = rowOf(hash, z + radius);
+
+    int found = 0;
+    float radiusSq = radius * radius;
+    for (int cz = z0; cz <= z1; cz++) {
+        for (int cx = x0; cx <= x1; cx++) {
+            for (int i = hash->cellHead[cz * hash->sizeX + cx]; i >= 0; i = hash->entryNext[i]) {
+                float dx = hash->entryX[i] - x;
+                float dz = hash->entryZ[i] - z;
+                if (dx * dx + dz * dz > radiusSq) continue;
+                if (found < maxEntries) outEntries[found] = i;
+                found++;
+            }
+        }
+    }
+    return finishQuery(outEntries, maxEntries, found);
+}
+
+int spatialHashQueryAABB(const SpatialHash *hash, float minX, float minZ, float maxX, float maxZ,
+                         int *outEntries, int maxEntries) {
+    int x0 = columnOf(hash, minX);
+    int x1 = columnOf(hash, maxX);
+    int z0 = rowOf(hash, minZ);
+    int z1 = rowOf(hash, maxZ);
+
+    int found = 0;
+    for (int cz = z0; cz <= z1; cz++) {
+        for (int cx = x0; cx <= x1; cx++) {
+            for (int i = hash->cellHead[cz * hash->sizeX + cx]; i >= 0; i = hash->entryNext[i]) {
+                float ex = hash->entryX[i];
+                float ez = hash->entryZ[i];
+                if (ex < minX || ex > maxX || ez < minZ || ez > maxZ) continue;
+                if (found < maxEntries) outEntries[found] = i;
+                found++;
+            }
+        }
+    }
+    return finishQuery(outEntries, maxEntries, found);
+}
+
+int spatialHashQuerySegment(const SpatialHash *hash, float x0, float z0, float x1, float z1, float radius,
+                            int *outEntries, int maxEntries) {
+    float dx = x1 - x0;
+    float dz = z1 - z0;
+    float lengthSq = dx * dx + dz * dz;
+    float radiusSq = radius * radius;
+
+    int found = 0;
+    int rowLo = rowOf(hash, fminf(z0, z1) - radius);
+    int rowHi = rowOf(hash, fmaxf(z0, z1) + radius);
+    for (int cz = rowLo; cz <= rowHi; cz++) {
+        // Part of the segment within radius of this row (edge rows also hold everything beyond them)
+        float bandLo = cz == 0 ? -INFINITY : hash->minZ + (float)cz * hash->cellSize - radius;
+        float bandHi = cz == hash->sizeZ - 1 ? INFINITY : hash->minZ + (float)(cz + 1) * hash->cellSize + radius;
+        float tA = 0.0f, tB = 1.0f;
+        if (dz != 0.0f) {
+            tA = (bandLo - z0) / dz;
+            tB = (bandHi - z0) / dz;
+            if (tA > tB) { float t = tA; tA = tB; tB = t; }
+            tA = fmaxf(tA, 0.0f);
+            tB = fminf(tB, 1.0f);
+            if (tA > tB) continue;
+        } else if (z0 < bandLo || z0 > bandHi) {
+            continue;
+        }
+
+        float xA = x0 + dx * tA;
+        float xB = x0 + dx * tB;
+        int colLo = columnOf(hash, fminf(xA, xB) - radius);
+        int colHi = columnOf(hash, fmaxf(xA, xB) + radius);
+        for (int cx = colLo; cx <= colHi; cx++) {
+            for (int i = hash->cellHead[cz * hash->sizeX + cx]; i >= 0; i = hash->entryNext[i]) {
+                // Distance from the entry to the closest point of the segment
+                float px = hash->entryX[i] - x0;
+                float pz = hash->entryZ[i] - z0;
+                float t = lengthSq > 0.0f ? (px * dx + pz * dz) / lengthSq : 0.0f;
+                if (t < 0.0f) t = 0.0f;
+                if (t > 1.0f) t = 1.0f;
+                float ox = px - dx * t;
+                float oz = pz - dz * t;
+                if (ox * ox + oz * oz > radiusSq) continue;
+                if (found < maxEntries) outEntries[found] = i;
+                found++;
+            }
+        }
+    }
+    return finishQuery(outEntries, maxEntries, found);
+}
@@ -0,0 +1,53 @@
+// SpatialHash.h - Uniform XZ grid of moving entries, refiled as they move, for proximity queries
+#ifndef SPATIALHASH_H
+#define SPATIALHASH_H
+
+// ============================================
+// SPATIAL HASH TYPES
+// ============================================
+
+// Entries (0 .. entryCount - 1) filed by XZ position, each in one cell's doubly linked list.
+// The arrays belong to the caller, so the hash can live inside another allocation; positions
+// outside [minX,maxX] x [minZ,maxZ] are filed in the edge cells.
+typedef struct {
+    float minX, minZ;
+    float cellSize;
+    int sizeX, sizeZ;
+    int cellCount;
+    int entryCount;
+    int *cellHead;              // First entry in each cell, -1 for none
+    int *entryCell;             // Cell each entry is filed in, -1 when not filed
+    int *entryNext;             // Next entry in the same cell, -1 at the end
+    int *entryPrev;             // Previous entry in the same cell, -1 at the start
+    float *entryX;              // Position each entry was last filed at
+    float *entryZ;
+} SpatialHash;
+
+// ============================================
+// SPATIAL HASH FUNCTIONS
+// ============================================
+
+// Empty every cell and unfile every entry
+void spatialHashClear(SpatialHash *hash);
+
+// File an entry at (x, z), or move it there. Only relinks when it changes cell.
+void spatialHashMove(SpatialHash *hash, int entry, float x, float z);
+
+// Take an entry out of the hash (no-op if it isn't filed)
+void spatialHashRemove(SpatialHash *hash, int entry);
+
+// Entries filed within radius of (x, z) in XZ, in entry order. Writes up to maxEntries to
+// outEntries; returns the total found (may be more than maxEntries).
+int spatialHashQueryRadius(const SpatialHash *hash, float x, float z, float radius,
+                           int *outEntries, int maxEntries);
+
+// Entries filed inside [minX,maxX] x [minZ,maxZ], in entry order. Same output as the radius query.
+int spatialHashQueryAABB(const SpatialHash *hash, float minX, float minZ, float maxX, float maxZ,
+                         int *outEntries, int maxEntries);
+
+// Entries filed within radius of the XZ segment from (x0, z0) to (x1, z1), in entry order -
+// visits only the cells along the segment. Same output as the radius query.
+int spatialHashQuerySegment(const SpatialHash *hash, float x0, float z0, float x1, float z1, float radius,
+                            int *outEntries, int maxEntries);
+
+#endif // SPATIALHASH_H
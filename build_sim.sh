@@ -0,0 +1,54 @@
+#!/bin/bash
+# Build the headless simulation, replay player, dedicated server, match runner, benchmarks and server check (no Cocoa, Metal or simd) - works on Linux and macOS
+cd "$(dirname "$0")"
+
+CC=${CC:-cc}
+CFLAGS="-std=c11 -O2 -Wall -D_POSIX_C_SOURCE=200809L $EXTRA_CFLAGS"
+SIM_SOURCES="SimWorld.c SimCollision.c SimWeapons.c SimPickups.c SimEnemy.c SimCombat.c SimDoor.c SimReplay.c SimSnapshot.c SimJobs.c SimProfile.c SimMatch.c \
+    Collision.c CollisionBVH.c HeightField.c NavGrid.c CoverMap.c SpatialHash.c CollisionCache.c"
+
+echo "Compiling FPSSim..."
+$CC $CFLAGS -o FPSSim SimHeadless.c $SIM_SOURCES -lm -lpthread 2>&1 || { echo "Compilation failed!"; exit 1; }
+
+echo "Compiling FPSReplay..."
+$CC $CFLAGS -o FPSReplay SimReplayPlayer.c $SIM_SOURCES -lm -lpthread 2>&1 || { echo "Compilation failed!"; exit 1; }
+
+echo "Compiling FPSServer..."
+$CC $CFLAGS -o FPSServer SimServer.c $SIM_SOURCES -lm -lpthread 2>&1 || { echo "Compilation failed!"; exit 1; }
+
+echo "Compiling FPSMatches..."
+$CC $CFLAGS -o FPSMatches SimMatchRunner.c $SIM_SOURCES -lm -lpthread 2>&1 || { echo "Compilation failed!"; exit 1; }
+
+echo "Compiling FPSBench..."
+$CC $CFLAGS -o FPSBench SimBench.c $SIM_SOURCES -lm -lpthread 2>&1 || { echo "Compilation failed!"; exit 1; }
+
+echo "Compiling FPSServerCheck..."
+$CC $CFLAGS -o FPSServerCheck SimServerCheck.c $SIM_SOURCES -lm -lpthread 2>&1 || { echo "Compilation failed!"; exit 1; }
+
+echo "Running self-checks..."
+./FPSBench --check || { echo "Self-check failed!"; exit 1; }
+./FPSServerCheck || { echo "Self-check failed!"; exit 1; }
+
+# The final state hash covers the world's raw bytes, so it must not depend on the optimizer or
+# on what was left in memory - rebuild FPSSim at -O0 and with the undefined-behaviour
+# sanitizer and compare
+echo "Checking the state hash across builds..."
+stateHash() { "$1" 3600 7 - 2>/dev/null | grep "final state hash" | awk '{print $NF}'; }
+EXPECTED=$(stateHash ./FPSSim)
+CHECK_DIR=$(mktemp -d) || exit 1
+for FLAGS in "-O0" "-O2 -fsanitize=undefined"; do
+    if ! $CC -std=c11 $FLAGS -D_POSIX_C_SOURCE=200809L -o "$CHECK_DIR/FPSSim" SimHeadless.c $SIM_SOURCES -lm -lpthread 2>/dev/null; then
+        echo "[CHECK] Skipped $FLAGS - not supported by $CC"
+        continue
+    fi
+    ACTUAL=$(stateHash "$CHECK_DIR/FPSSim")
+    if [ -z "$EXPECTED" ] || [ "$ACTUAL" != "$EXPECTED" ]; then
+        echo "[CHECK] State hash with $FLAGS is $ACTUAL, expected $EXPECTED"
+        rm -rf "$CHECK_DIR"
+        echo "Self-check failed!"; exit 1
+    fi
+    echo "[CHECK] State hash with $FLAGS matches ($ACTUAL)"
+done
+rm -rf "$CHECK_DIR"
+
+echo "Compilation successful. Run ./FPSSim [ticks] [seed] [replay|-] [bots], ./FPSReplay replay, ./FPSServer [port] [name], ./FPSMatches [matches] [seed] [players] or ./FPSBench [results.csv] [baseline.csv] [--check]"
@@ -8,7 +8,6 @@
 #import "LobbyView.h"
 #import "MultiplayerController.h"
 #import "GameState.h"
-#import "Enemy.h"
 #import "PickupSystem.h"
 #import "NetworkManager.h"
 
@@ -89,7 +88,7 @@
     } else {
         [state resetGame];
         // Initialize bot AI for single player mode
-        initializeBotAI();
+        simInitBotAI(state.world);
     }
 
     // Reset pickups for new game
@@ -199,10 +198,23 @@
     gameState.remotePlayerAlive = YES;
 }
 
+- (void)networkManager:(id)manager didReceiveServerState:(PlayerNetState)state forInput:(uint32_t)inputSequence {
+    // Our own player as the authoritative host has it
+    [[MultiplayerController shared] applyServerState:state forInput:inputSequence];
+}
+
 - (void)networkManager:(id)manager didReceiveHit:(int)damage toPlayer:(uint32_t)playerId fromPlayer:(uint32_t)shooterId {
     GameState *gameState = [GameState shared];
     NSLog(@"[NETWORK] Received hit: %d damage to player %u from player %u (local=%d)", damage, playerId, shooterId, gameState.localPlayerId);
 
+    // An authoritative host has already applied it
+    if ([MultiplayerController shared].isServerAuthoritative) {
+        if (playerId == (uint32_t)gameState.localPlayerId) {
+            [[MultiplayerController shared] applyServerHit];
+        }
+        return;
+    }
+
     // Apply damage if we're the target and not already dead
     if (playerId == (uint32_t)gameState.localPlayerId) {
         // Don't apply damage if already dead (prevents respawn timer reset)
@@ -229,12 +241,16 @@
     GameState *gameState = [GameState shared];
     NSLog(@"[NETWORK] Received kill: victim=%u, killer=%u, local=%d", victimId, killerId, gameState.localPlayerId);
 
-    // Update scoreboard
+    // Update scoreboard - an authoritative host also decides our deaths
+    BOOL authoritative = [MultiplayerController shared].isServerAuthoritative;
     if (victimId == (uint32_t)gameState.localPlayerId) {
         // We died, remote player gets a kill
         gameState.remotePlayerKills++;
         NSLog(@"[NETWORK] Remote player kills: %d", gameState.remotePlayerKills);
-    } else {
+        if (authoritative) {
+            [[MultiplayerController shared] applyServerDeath];
+        }
+    } else if (!authoritative || killerId == (uint32_t)gameState.localPlayerId) {
         // Remote player died, we get a kill
         gameState.localPlayerKills++;
         NSLog(@"[NETWORK] Local player kills: %d", gameState.localPlayerKills);
@@ -245,6 +261,12 @@
     GameState *gameState = [GameState shared];
     NSLog(@"[NETWORK] Received respawn: player=%u at (%.1f, %.1f, %.1f)", playerId, netState.posX, netState.posY, netState.posZ);
 
+    // An authoritative host respawns us too
+    if (playerId == (uint32_t)gameState.localPlayerId && [MultiplayerController shared].isServerAuthoritative) {
+        [[MultiplayerController shared] applyServerRespawn:netState];
+        return;
+    }
+
     // Remote player respawned
     if (playerId != (uint32_t)gameState.localPlayerId) {
         gameState.remotePlayerAlive = YES;
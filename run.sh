@@ -4,7 +4,9 @@ cd "$(dirname "$0")"
 echo "Compiling FPSGame..."
 clang -framework Cocoa -framework Metal -framework MetalKit -framework QuartzCore -framework AudioToolbox -framework GameController -fobjc-arc -O2 -o FPSGame \
     main.m AppDelegate.m Renderer.m GameState.m GeometryBuilder.m Collision.c GameMath.c \
-    DoorSystem.m Combat.m WeaponSystem.m SoundManager.m PickupSystem.m Enemy.m \
+    CollisionWorld.m CollisionBVH.c HeightField.c NavGrid.c CoverMap.c SpatialHash.c CollisionCache.c \
+    SimWorld.c SimCollision.c SimWeapons.c SimPickups.c SimEnemy.c SimCombat.c SimDoor.c SimReplay.c SimSnapshot.c SimJobs.c SimProfile.c SimMatch.c \
+    DoorSystem.m WeaponSystem.m SoundManager.m PickupSystem.m \
     NetworkManager.m LobbyView.m InputView.m MultiplayerController.m 2>&1
 
 if [ $? -eq 0 ]; then